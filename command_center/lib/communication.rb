@@ -2,11 +2,22 @@
 require 'socket'
 require 'json'
 
+# Drone telemetry arrives through the C fleet gateway
+# (drone_networking/daemon/fleet_gatewayd), which terminates drone traffic
+# and sends one fleet_snapshot document per tick over TCP, framed as a
+# 4-byte big-endian length followed by the JSON. Delta snapshots carry the
+# drones that changed and those that went stale; full snapshots (sent on
+# connect and periodically) carry the whole fleet.
 class Communication
+  GATEWAY_HOST = ENV.fetch('FLEET_GATEWAY_HOST', '127.0.0.1')
+  GATEWAY_PORT = Integer(ENV.fetch('FLEET_GATEWAY_PORT', '8890'))
+  RECONNECT_DELAY = 1
+
   def initialize
-    @server = UDPServer.new('0.0.0.0', 8888)
     @message_handler = MessageHandler.new
-    start_server
+    @fleet = {}
+    @fleet_lock = Mutex.new
+    start_snapshot_reader
   end
 
   def send_message(drone_id, message)
@@ -16,19 +27,42 @@ class Communication
     # Implementation details...
   end
 
+  # Latest status_update of every live drone, keyed by drone_id
+  def fleet
+    @fleet_lock.synchronize { @fleet.dup }
+  end
+
   private
 
-  def start_server
+  def start_snapshot_reader
     Thread.new do
       loop do
-        data, client = @server.recvfrom(8192)
-        handle_message(data, client)
+        socket = TCPSocket.new(GATEWAY_HOST, GATEWAY_PORT)
+        while (frame = read_frame(socket))
+          handle_snapshot(JSON.parse(frame))
+        end
+      rescue SystemCallError, IOError, JSON::ParserError
+        # Reconnect below; the gateway starts over with a full snapshot
+      ensure
+        socket&.close
+        sleep RECONNECT_DELAY
       end
     end
   end
 
-  def handle_message(data, client)
-    message = JSON.parse(data)
-    @message_handler.process(message)
+  def read_frame(socket)
+    prefix = socket.read(4)
+    return nil unless prefix && prefix.bytesize == 4
+
+    socket.read(prefix.unpack1('N'))
+  end
+
+  def handle_snapshot(snapshot)
+    @fleet_lock.synchronize do
+      @fleet.clear if snapshot['full']
+      snapshot['drones'].each { |status| @fleet[status['drone_id']] = status }
+      snapshot['stale'].each { |drone_id| @fleet.delete(drone_id) }
+    end
+    snapshot['drones'].each { |status| @message_handler.process(status) }
   end
-end
\ No newline at end of file
+end
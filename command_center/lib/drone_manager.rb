@@ -17,7 +17,7 @@ class DroneManager
 
   def send_command(drone_id, command, params = {})
     message = {
-      type: 'command',
+      message_type: 'command',
       drone_id: drone_id,
       command: command,
       params: params,
@@ -1,8 +1,10 @@
 // communication_layer.c
 #include "drone_firmware.h"
+#include "drone_networking/src/protocols/message_formats.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #ifdef __ANDROID__
     #include <jni.h>
@@ -15,24 +17,28 @@
     // Desktop networking
 #endif
 
-typedef struct {
-    char message_type[32];
-    char drone_id[16];
-    position_t position;
-    float battery_level;
-    drone_state_t state;
-} drone_message_t;
+// drone_state_t as the command center spells it (fleet_gateway.c)
+static const char* const state_names[] = {
+    "idle", "flying_to_site", "scanning_terrain", "constructing",
+    "repairing", "returning_home", "emergency_landing"
+};
 
-// Send status update to control center
+// Send status update to control center. The report is the struct generated
+// from shared/message_formats.json, so it cannot drift from the schema.
 int send_drone_status(construction_drone_t* drone) {
-    drone_message_t msg;
-    strcpy(msg.message_type, "STATUS_UPDATE");
-    strcpy(msg.drone_id, drone->drone_info.drone_id);
-    msg.position = drone->drone_info.current_pos;
+    status_update_format_t msg;
+    memset(&msg, 0, sizeof(msg));
+    strncpy(msg.drone_id, drone->drone_info.drone_id, sizeof(msg.drone_id) - 1);
+    msg.position.x = drone->drone_info.current_pos.x;
+    msg.position.y = drone->drone_info.current_pos.y;
+    msg.position.z = drone->drone_info.current_pos.z;
     msg.battery_level = drone->drone_info.battery_level;
-    msg.state = drone->drone_info.state;
+    if ((unsigned)drone->drone_info.state < sizeof(state_names) / sizeof(state_names[0])) {
+        strcpy(msg.state, state_names[drone->drone_info.state]);
+    }
+    msg.timestamp = (int64_t)time(NULL);
     
-    // Send via UDP/TCP to control center
+    // Encode (status_update_format_encode_binary) and send via UDP/TCP to control center
     // Implementation depends on platform
     return 0;
 }
@@ -83,7 +83,7 @@ bool drone_construct_component(construction_drone_t* drone, int component_index)
 void drone_control_loop(construction_drone_t* drone) {
     switch (drone->drone_info.state) {
         case IDLE:
-            printf("Drone %s: IDLE\n", drone->drone_info.drone_id);
+            // Nothing to do until a task is assigned
             break;
             
         case FLYING_TO_SITE:
@@ -0,0 +1,114 @@
+// bench/aead_batch.c
+// Seal throughput of one-message-at-a-time AEAD against the interleaved
+// batch path for bursts of small telemetry-sized messages.
+// Usage: aead_batch [bursts] [burst_size]
+#include "../include/common.h"
+#include "../src/security/aead.h"
+
+#define BENCH_AAD_SIZE 64
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+typedef struct {
+    unsigned char nonce[AEAD_NONCE_SIZE];
+    unsigned char tag[AEAD_TAG_SIZE];
+    unsigned char aad[BENCH_AAD_SIZE];
+    unsigned char* data;
+} bench_message_t;
+
+static void reset_burst(bench_message_t* burst, int burst_size, size_t payload, uint64_t sequence) {
+    for (int i = 0; i < burst_size; i++) {
+        uint64_t counter = sequence + (uint64_t)i;
+        memset(burst[i].nonce, 0, AEAD_NONCE_SIZE);
+        memcpy(burst[i].nonce + 4, &counter, sizeof(counter));
+        memset(burst[i].data, (int)(i & 0xff), payload);
+    }
+}
+
+static int run(int bursts, int burst_size, size_t payload) {
+    unsigned char raw_key[AEAD_KEY_SIZE];
+    for (int i = 0; i < AEAD_KEY_SIZE; i++) raw_key[i] = (unsigned char)(i * 7 + 1);
+    aead_key_t key;
+    aead_key_init(&key, raw_key);
+    
+    bench_message_t* single = (bench_message_t*)calloc((size_t)burst_size, sizeof(bench_message_t));
+    bench_message_t* batched = (bench_message_t*)calloc((size_t)burst_size, sizeof(bench_message_t));
+    aead_batch_item_t* items = (aead_batch_item_t*)calloc((size_t)burst_size, sizeof(aead_batch_item_t));
+    if (!single || !batched || !items) return -1;
+    for (int i = 0; i < burst_size; i++) {
+        single[i].data = (unsigned char*)malloc(payload);
+        batched[i].data = (unsigned char*)malloc(payload);
+        if (!single[i].data || !batched[i].data) return -1;
+    }
+    
+    double single_time = 0, batch_time = 0;
+    int mismatches = 0;
+    
+    for (int b = 0; b < bursts; b++) {
+        uint64_t sequence = (uint64_t)b * (uint64_t)burst_size;
+        reset_burst(single, burst_size, payload, sequence);
+        reset_burst(batched, burst_size, payload, sequence);
+        
+        double started = now_seconds();
+        for (int i = 0; i < burst_size; i++) {
+            aead_seal_in_place(&key, single[i].nonce, single[i].aad, BENCH_AAD_SIZE,
+                               single[i].data, payload, single[i].tag);
+        }
+        single_time += now_seconds() - started;
+        
+        started = now_seconds();
+        for (int i = 0; i < burst_size; i++) {
+            items[i].nonce = batched[i].nonce;
+            items[i].aad = batched[i].aad;
+            items[i].aad_length = BENCH_AAD_SIZE;
+            items[i].data = batched[i].data;
+            items[i].length = payload;
+            items[i].tag = batched[i].tag;
+        }
+        aead_seal_batch(&key, items, (size_t)burst_size);
+        batch_time += now_seconds() - started;
+        
+        for (int i = 0; i < burst_size; i++) {
+            if (memcmp(single[i].tag, batched[i].tag, AEAD_TAG_SIZE) != 0 ||
+                memcmp(single[i].data, batched[i].data, payload) != 0) {
+                mismatches++;
+            }
+        }
+    }
+    
+    double messages = (double)bursts * burst_size;
+    printf("%6zu B  single %8.0f ns/msg %7.1f MB/s   batch %8.0f ns/msg %7.1f MB/s   x%.2f  %d mismatched\n",
+           payload,
+           single_time / messages * 1e9, messages * (double)payload / single_time / 1e6,
+           batch_time / messages * 1e9, messages * (double)payload / batch_time / 1e6,
+           single_time / batch_time, mismatches);
+    
+    for (int i = 0; i < burst_size; i++) {
+        free(single[i].data);
+        free(batched[i].data);
+    }
+    free(single);
+    free(batched);
+    free(items);
+    return mismatches ? -1 : 0;
+}
+
+int main(int argc, char* argv[]) {
+    int bursts = argc > 1 ? atoi(argv[1]) : 2000;
+    int burst_size = argc > 2 ? atoi(argv[2]) : 64;
+    if (bursts <= 0 || burst_size <= 0) {
+        fprintf(stderr, "usage: %s [bursts] [burst_size]\n", argv[0]);
+        return 1;
+    }
+    
+    static const size_t payloads[] = { 56, 120, 256, 1024 };
+    int failed = 0;
+    for (size_t i = 0; i < sizeof(payloads) / sizeof(payloads[0]); i++) {
+        if (run(bursts, burst_size, payloads[i]) != 0) failed = 1;
+    }
+    return failed;
+}
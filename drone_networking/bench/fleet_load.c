@@ -0,0 +1,280 @@
+// bench/fleet_load.c
+// Loopback fleet traffic generator. Simulates N drones sending status
+// updates at a fixed rate to a local receiver and reports throughput, loss
+// and one-way latency percentiles.
+//
+// Usage: fleet_load [--drones N] [--rate HZ] [--seconds S] [--sockets K]
+//                   [--port P] [--uring] [--secure] [--max-loss PCT]
+#include "../src/core/network_core.h"
+#include "../src/core/uring_backend.h"
+#include "../src/protocols/message_protocol.h"
+#ifdef FLEET_LOAD_SECURE
+#include "../src/security/encryption_wrapper.h"
+#include <sys/random.h>
+#endif
+
+#define FLEET_MAX_DRONES 10000
+#define FLEET_MAX_SOCKETS 64
+#define FLEET_MAX_BURST 256
+
+typedef struct {
+    int drones;
+    int rate_hz;
+    int seconds;
+    int sockets;
+    int port;
+    int use_uring;
+    int secure;
+    double max_loss_pct;
+} fleet_options_t;
+
+typedef struct {
+    network_config_t* config;
+    message_dispatcher_t dispatcher;
+    latency_histogram_t latency;
+    unsigned long received;
+    unsigned long bytes;
+    volatile int stop;
+#ifdef FLEET_LOAD_SECURE
+    security_context_t* security;
+#endif
+} fleet_receiver_t;
+
+static double seconds_since(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) + (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void on_status(const message_view_t* view, void* user_data) {
+    fleet_receiver_t* receiver = (fleet_receiver_t*)user_data;
+    uint64_t now = message_timestamp_ns();
+    uint64_t sent = view->as.status->header.timestamp;
+    
+    latency_histogram_record(&receiver->latency, now > sent ? now - sent : 0);
+    receiver->received++;
+    receiver->bytes += view->length;
+}
+
+static void* receive_loop(void* arg) {
+    fleet_receiver_t* receiver = (fleet_receiver_t*)arg;
+    union {
+        uint64_t align;
+        unsigned char bytes[MAX_BUFFER_SIZE];
+    } buffer;
+    
+    while (!receiver->stop) {
+        size_t length = 0;
+        network_result_t result;
+#ifdef FLEET_LOAD_SECURE
+        if (receiver->security) {
+            result = secure_receive_message_from(receiver->security, receiver->config,
+                                                 buffer.bytes, sizeof(buffer.bytes),
+                                                 &length, NULL);
+        } else
+#endif
+        result = network_receive_data_from(receiver->config, buffer.bytes, sizeof(buffer.bytes),
+                                           &length, NULL);
+        if (result == NET_SUCCESS) {
+            message_dispatch(&receiver->dispatcher, buffer.bytes, length);
+        }
+    }
+    return NULL;
+}
+
+static int parse_options(int argc, char* argv[], fleet_options_t* options) {
+    options->drones = 1000;
+    options->rate_hz = 10;
+    options->seconds = 5;
+    options->sockets = 8;
+    options->port = 47820;
+    options->use_uring = 0;
+    options->secure = 0;
+    options->max_loss_pct = -1;
+    
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--uring") == 0) {
+            options->use_uring = 1;
+        } else if (strcmp(arg, "--secure") == 0) {
+            options->secure = 1;
+        } else if (value && strcmp(arg, "--drones") == 0) {
+            options->drones = atoi(value); i++;
+        } else if (value && strcmp(arg, "--rate") == 0) {
+            options->rate_hz = atoi(value); i++;
+        } else if (value && strcmp(arg, "--seconds") == 0) {
+            options->seconds = atoi(value); i++;
+        } else if (value && strcmp(arg, "--sockets") == 0) {
+            options->sockets = atoi(value); i++;
+        } else if (value && strcmp(arg, "--port") == 0) {
+            options->port = atoi(value); i++;
+        } else if (value && strcmp(arg, "--max-loss") == 0) {
+            options->max_loss_pct = atof(value); i++;
+        } else {
+            return -1;
+        }
+    }
+    
+    if (options->drones < 1 || options->drones > FLEET_MAX_DRONES ||
+        options->rate_hz < 1 || options->seconds < 1 ||
+        options->sockets < 1 || options->sockets > FLEET_MAX_SOCKETS) {
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    fleet_options_t options;
+    if (parse_options(argc, argv, &options) != 0) {
+        fprintf(stderr, "usage: %s [--drones 1-%d] [--rate HZ] [--seconds S] [--sockets 1-%d] "
+                "[--port P] [--uring] [--secure] [--max-loss PCT]\n",
+                argv[0], FLEET_MAX_DRONES, FLEET_MAX_SOCKETS);
+        return 2;
+    }
+    
+#ifdef FLEET_LOAD_SECURE
+    security_context_t* security = NULL;
+    if (options.secure) {
+        // Both ends live in this process, so any key will do
+        unsigned char key[AEAD_KEY_SIZE];
+        if (getrandom(key, sizeof(key), 0) != (ssize_t)sizeof(key)) return 1;
+        security = security_init(key, "FLEET_LOAD_IV_16");
+        if (!security) return 1;
+    }
+#else
+    if (options.secure) {
+        fprintf(stderr, "built without the secure path; use 'make bench-secure'\n");
+        return 2;
+    }
+#endif
+    
+    // Receiver
+    fleet_receiver_t* receiver = (fleet_receiver_t*)calloc(1, sizeof(fleet_receiver_t));
+    if (!receiver) return 1;
+    receiver->config = network_init("127.0.0.1", options.port, NETWORK_MODE_SERVER);
+    if (!receiver->config) return 1;
+    receiver->config->local_addr.sin_port = htons(options.port);
+    if (network_connect(receiver->config) != NET_SUCCESS) return 1;
+    
+    int buffer_size = 8 * 1024 * 1024;
+    setsockopt(receiver->config->socket_fd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+    struct timeval timeout = { 0, 100000 };
+    setsockopt(receiver->config->socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (options.use_uring && !options.secure) {
+        network_enable_uring(receiver->config, 0);
+    }
+    
+    latency_histogram_init(&receiver->latency);
+    message_dispatcher_init(&receiver->dispatcher);
+    message_dispatcher_register(&receiver->dispatcher, MSG_STATUS_UPDATE, on_status, receiver);
+#ifdef FLEET_LOAD_SECURE
+    receiver->security = security;
+#endif
+    
+    pthread_t receive_thread;
+    if (pthread_create(&receive_thread, NULL, receive_loop, receiver) != 0) return 1;
+    
+    // Senders: drones share a small set of sockets
+    network_config_t* senders[FLEET_MAX_SOCKETS];
+    for (int s = 0; s < options.sockets; s++) {
+        senders[s] = network_init("127.0.0.1", options.port, NETWORK_MODE_CLIENT);
+        if (!senders[s] || network_connect(senders[s]) != NET_SUCCESS) return 1;
+        if (options.use_uring && !options.secure) {
+            network_enable_uring(senders[s], URING_SUGGESTED_SUBMIT_BATCH); // Flushed per tick
+        }
+    }
+    
+    char (*drone_ids)[MAX_DRONE_ID] = calloc((size_t)options.drones, MAX_DRONE_ID);
+    if (!drone_ids) return 1;
+    for (int d = 0; d < options.drones; d++) {
+        snprintf(drone_ids[d], MAX_DRONE_ID, "DRONE_%05d", d);
+    }
+    
+    printf("Fleet load: %d drones x %d Hz for %d s over %d sockets%s%s\n",
+           options.drones, options.rate_hz, options.seconds, options.sockets,
+           options.use_uring ? ", io_uring" : "", options.secure ? ", secure" : "");
+    
+    double total_rate = (double)options.drones * options.rate_hz;
+    unsigned long target_total = (unsigned long)(total_rate * options.seconds);
+    unsigned long sent = 0;
+    unsigned long send_failures = 0;
+    status_update_message_t status;
+    unsigned char wire[sizeof(status_update_message_t)];
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    
+    while (sent < target_total) {
+        unsigned long due = (unsigned long)(seconds_since(&start) * total_rate);
+        if (due > target_total) due = target_total;
+        if (due <= sent) {
+            struct timespec pause = { 0, 100000 };
+            nanosleep(&pause, NULL);
+            continue;
+        }
+        
+        for (int burst = 0; sent < due && burst < FLEET_MAX_BURST; burst++, sent++) {
+            int drone = (int)(sent % (unsigned long)options.drones);
+            network_config_t* sender = senders[drone % options.sockets];
+            
+            memset(&status, 0, sizeof(status));
+            init_message_header(&status.header, MSG_STATUS_UPDATE, drone_ids[drone]);
+            status.header.payload_length = sizeof(status_update_message_t) - sizeof(message_header_t);
+            status.x = drone;
+            status.y = (double)(sent / (unsigned long)options.drones);
+            status.battery_level = 80.0;
+            status.state = 3;
+            serialize_message(&status, wire, sizeof(wire));
+            
+            network_result_t result;
+#ifdef FLEET_LOAD_SECURE
+            if (security) {
+                result = secure_send_message(security, sender, wire, sizeof(wire));
+            } else
+#endif
+            result = network_send_data(sender, wire, sizeof(wire));
+            if (result != NET_SUCCESS) send_failures++;
+        }
+        for (int s = 0; s < options.sockets; s++) {
+            network_flush(senders[s]);
+        }
+    }
+    double send_elapsed = seconds_since(&start);
+    
+    // Let the receiver drain what is still in flight
+    struct timespec drain;
+    clock_gettime(CLOCK_MONOTONIC, &drain);
+    while (__atomic_load_n(&receiver->received, __ATOMIC_RELAXED) < sent - send_failures &&
+           seconds_since(&drain) < 1.0) {
+        struct timespec pause = { 0, 1000000 };
+        nanosleep(&pause, NULL);
+    }
+    receiver->stop = 1;
+    pthread_join(receive_thread, NULL);
+    
+    unsigned long received = receiver->received;
+    double loss_pct = sent ? 100.0 * (double)(sent - (received < sent ? received : sent)) / sent : 0;
+    
+    printf("Sent: %lu (%lu failed) in %.2f s, %.0f msg/s\n",
+           sent, send_failures, send_elapsed, sent / send_elapsed);
+    printf("Received: %lu, %.2f MB/s, loss %.3f%%, rejected %lu\n",
+           received, receiver->bytes / send_elapsed / 1e6, loss_pct,
+           receiver->dispatcher.rejected);
+    latency_histogram_print(&receiver->latency, "One-Way Latency");
+    
+    for (int s = 0; s < options.sockets; s++) {
+        network_cleanup(senders[s]);
+    }
+    network_cleanup(receiver->config);
+    free(drone_ids);
+    free(receiver);
+#ifdef FLEET_LOAD_SECURE
+    security_cleanup(security);
+#endif
+    
+    if (options.max_loss_pct >= 0 && loss_pct > options.max_loss_pct) {
+        printf("FAIL: loss %.3f%% above %.3f%%\n", loss_pct, options.max_loss_pct);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+// bench/json_codec.c
+// Single-core throughput of the generated command-center JSON codecs:
+// status updates encoded and decoded, and Ruby-style commands detected
+// and decoded. Every decode is checked against the original message.
+// Usage: json_codec [messages] [rounds]
+#include "../include/common.h"
+#include "../src/protocols/message_formats.h"
+
+#define BENCH_JSON_SIZE 256
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static const char* states[] = { "idle", "flying", "hovering", "landing", "returning_home" };
+static const char* commands[] = { "takeoff", "goto", "hover", "land", "status_request" };
+
+static void make_status(status_update_format_t* status, int i) {
+    memset(status, 0, sizeof(*status));
+    snprintf(status->drone_id, sizeof(status->drone_id), "drone-%04d", i % 5000);
+    status->position.x = (double)(i * 37 % 200000 - 100000) / 100.0;
+    status->position.y = (double)(i * 53 % 200000 - 100000) / 100.0;
+    status->position.z = (double)(i * 11 % 12000) / 100.0;
+    status->battery_level = (double)(i % 1001) / 10.0;
+    snprintf(status->state, sizeof(status->state), "%s", states[i % 5]);
+    status->timestamp = 1760000000 + i;
+}
+
+// The command as DroneManager#send_command writes it with JSON.generate
+static int make_command_json(char* out, size_t size, int i) {
+    return snprintf(out, size,
+                    "{\"message_type\":\"command\",\"drone_id\":\"drone-%04d\",\"command\":\"%s\","
+                    "\"params\":{\"x\":%d.5,\"y\":%d,\"speed\":2.5},\"timestamp\":%d}",
+                    i % 5000, commands[i % 5], i % 300, i % 200, 1760000000 + i);
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 10;
+    if (count <= 0 || rounds <= 0) {
+        fprintf(stderr, "usage: %s [messages] [rounds]\n", argv[0]);
+        return 1;
+    }
+    
+    status_update_format_t* statuses = (status_update_format_t*)calloc((size_t)count, sizeof(*statuses));
+    status_update_format_t* decoded = (status_update_format_t*)calloc((size_t)count, sizeof(*decoded));
+    char* json = (char*)malloc((size_t)count * BENCH_JSON_SIZE);
+    int* lengths = (int*)calloc((size_t)count, sizeof(int));
+    command_format_t command;
+    if (!statuses || !decoded || !json || !lengths) return 1;
+    
+    for (int i = 0; i < count; i++) make_status(&statuses[i], i);
+    
+    double encode_time = 0, decode_time = 0;
+    size_t bytes = 0;
+    int failures = 0;
+    for (int r = 0; r < rounds; r++) {
+        double started = now_seconds();
+        for (int i = 0; i < count; i++) {
+            lengths[i] = status_update_format_encode_json(&statuses[i], json + (size_t)i * BENCH_JSON_SIZE,
+                                                          BENCH_JSON_SIZE);
+        }
+        encode_time += now_seconds() - started;
+        
+        started = now_seconds();
+        for (int i = 0; i < count; i++) {
+            if (status_update_format_decode_json(&decoded[i], json + (size_t)i * BENCH_JSON_SIZE,
+                                                 (size_t)lengths[i]) != 0) {
+                failures++;
+            }
+        }
+        decode_time += now_seconds() - started;
+    }
+    for (int i = 0; i < count; i++) {
+        bytes += (size_t)lengths[i];
+        if (memcmp(&statuses[i], &decoded[i], sizeof(decoded[i])) != 0) failures++;
+    }
+    
+    double messages = (double)count * rounds;
+    printf("status_update  %5.0f B avg   encode %5.0f ns %6.2f M msg/s   decode %5.0f ns %6.2f M msg/s\n",
+           (double)bytes / count,
+           encode_time / messages * 1e9, messages / encode_time / 1e6,
+           decode_time / messages * 1e9, messages / decode_time / 1e6);
+    
+    bytes = 0;
+    for (int i = 0; i < count; i++) {
+        lengths[i] = make_command_json(json + (size_t)i * BENCH_JSON_SIZE, BENCH_JSON_SIZE, i);
+        bytes += (size_t)lengths[i];
+    }
+    decode_time = 0;
+    for (int r = 0; r < rounds; r++) {
+        double started = now_seconds();
+        for (int i = 0; i < count; i++) {
+            const char* text = json + (size_t)i * BENCH_JSON_SIZE;
+            if (message_format_detect_json(text, (size_t)lengths[i]) != MESSAGE_FORMAT_COMMAND ||
+                command_format_decode_json(&command, text, (size_t)lengths[i]) != 0 ||
+                command.timestamp != 1760000000 + i) {
+                failures++;
+            }
+        }
+        decode_time += now_seconds() - started;
+    }
+    printf("command        %5.0f B avg   detect+decode %5.0f ns %6.2f M msg/s\n",
+           (double)bytes / count, decode_time / messages * 1e9, messages / decode_time / 1e6);
+    
+    printf("%d failures\n", failures);
+    free(statuses);
+    free(decoded);
+    free(json);
+    free(lengths);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+// bench/telemetry_log.c
+// Telemetry log throughput: a fleet reporting once a second (with up to a
+// second of clock disagreement between drones) is appended while a reader
+// thread follows the log through its own read-only mappings. Then one
+// drone's last ten minutes and a one-minute fleet-wide range are queried
+// and checked against a full scan.
+// Usage: telemetry_log [records] [drones]
+#include "../include/common.h"
+#include "../src/storage/telemetry_log.h"
+
+#define BENCH_EPOCH_NS 1760000000000000000ULL
+#define BENCH_SEGMENT_RECORDS (1u << 18)
+
+typedef struct {
+    const char* path;
+    uint64_t total;
+    int drones;
+    uint64_t followed;
+    int failures;
+} follower_t;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Record i is drone i % drones reporting for the (i / drones)-th time,
+// received at the top of that second
+static uint64_t received_at(uint64_t i, int drones) {
+    return BENCH_EPOCH_NS + i / (uint64_t)drones * 1000000000ULL;
+}
+
+static uint64_t timestamp_of(uint64_t i, int drones) {
+    uint64_t second = i / (uint64_t)drones;
+    uint64_t jitter = (i % (uint64_t)drones) * 7919 % 1000 * 1000000ULL;
+    return BENCH_EPOCH_NS + second * 1000000000ULL + jitter;
+}
+
+static void* follow(void* arg) {
+    follower_t* follower = (follower_t*)arg;
+    telemetry_reader_t* reader = NULL;
+    while (!(reader = telemetry_reader_open(follower->path, 0))) sched_yield();
+    
+    while (follower->followed < follower->total) {
+        uint64_t number;
+        const telemetry_record_t* record = telemetry_reader_next(reader, &number);
+        if (!record) {
+            sched_yield();
+            continue;
+        }
+        if (number != follower->followed ||
+            record->timestamp_ns != timestamp_of(number, follower->drones)) {
+            follower->failures++;
+        }
+        follower->followed++;
+    }
+    
+    const char* first_id = telemetry_reader_drone_id(reader, 0);
+    if (!first_id || strcmp(first_id, "drone-00000") != 0) follower->failures++;
+    telemetry_reader_close(reader);
+    return NULL;
+}
+
+static int count_visit(uint64_t record_number, const telemetry_record_t* record, void* user_data) {
+    (void)record_number;
+    (void)record;
+    (*(long*)user_data)++;
+    return 0;
+}
+
+static void remove_log(const char* path) {
+    char command[TELEMETRY_LOG_PATH_SIZE + 16];
+    snprintf(command, sizeof(command), "rm -rf '%s'", path);
+    if (system(command) != 0) fprintf(stderr, "could not remove %s\n", path);
+}
+
+int main(int argc, char* argv[]) {
+    long records = argc > 1 ? atol(argv[1]) : 10000000;
+    int drones = argc > 2 ? atoi(argv[2]) : 10000;
+    if (records <= 0 || drones <= 0 || drones > TELEMETRY_LOG_DEFAULT_MAX_DRONES) {
+        fprintf(stderr, "usage: %s [records] [drones]\n", argv[0]);
+        return 1;
+    }
+    
+    char path[] = "/tmp/telemetry_log.XXXXXX";
+    if (!mkdtemp(path)) return 1;
+    
+    telemetry_log_config_t config;
+    telemetry_log_default_config(&config);
+    config.segment_records = BENCH_SEGMENT_RECORDS;
+    telemetry_log_t* log = telemetry_log_open(path, &config);
+    if (!log) return 1;
+    
+    char (*ids)[MAX_DRONE_ID] = calloc((size_t)drones, MAX_DRONE_ID);
+    if (!ids) return 1;
+    for (int d = 0; d < drones; d++) snprintf(ids[d], MAX_DRONE_ID, "drone-%05d", d);
+    
+    follower_t follower = { path, (uint64_t)records, drones, 0, 0 };
+    pthread_t thread;
+    pthread_create(&thread, NULL, follow, &follower);
+    
+    int failures = 0;
+    telemetry_record_t record;
+    memset(&record, 0, sizeof(record));
+    double started = now_seconds();
+    for (long i = 0; i < records; i++) {
+        record.timestamp_ns = timestamp_of((uint64_t)i, drones);
+        record.x = (double)i;
+        record.battery_level = (float)(i % 100);
+        if (telemetry_log_append(log, ids[i % drones], &record,
+                                 received_at((uint64_t)i, drones), NULL) != 0) {
+            failures++;
+        }
+    }
+    double append_time = now_seconds() - started;
+    pthread_join(thread, NULL);
+    double follow_time = now_seconds() - started;
+    failures += follower.failures;
+    
+    printf("append   %ld records  %5.1f ns/record  %6.2f M records/s  (%llu segments)\n",
+           records, append_time / records * 1e9, records / append_time / 1e6,
+           (unsigned long long)((records + BENCH_SEGMENT_RECORDS - 1) / BENCH_SEGMENT_RECORDS));
+    printf("follow   %llu records read through the mapping in %.3f s\n",
+           (unsigned long long)follower.followed, follow_time);
+    
+    // Drone 17, last ten minutes of the log
+    uint64_t end_ns = timestamp_of((uint64_t)records - 1, drones);
+    uint64_t from_ns = end_ns > 600000000000ULL ? end_ns - 600000000000ULL : 0;
+    const telemetry_record_t** found = calloc(1000, sizeof(*found));
+    started = now_seconds();
+    int matched = telemetry_log_query_drone(log, ids[17 % drones], from_ns, end_ns, found, 1000);
+    double drone_time = now_seconds() - started;
+    
+    int expected = 0;
+    for (long i = 17 % drones; i < records; i += drones) {
+        uint64_t timestamp = timestamp_of((uint64_t)i, drones);
+        if (timestamp >= from_ns && timestamp <= end_ns) expected++;
+    }
+    if (matched != expected) failures++;
+    for (int i = 1; i < matched; i++) {
+        if (found[i]->timestamp_ns < found[i - 1]->timestamp_ns) failures++;
+    }
+    printf("drone    %s last 10 min: %d records in %.1f us\n",
+           ids[17 % drones], matched, drone_time * 1e6);
+    
+    // One minute in the middle of the log, fleet-wide
+    uint64_t middle_ns = timestamp_of((uint64_t)records / 2, drones);
+    long visited = 0;
+    started = now_seconds();
+    long returned = telemetry_log_query_range(log, middle_ns, middle_ns + 60000000000ULL,
+                                              count_visit, &visited);
+    double range_time = now_seconds() - started;
+    
+    long scanned = 0;
+    for (long i = 0; i < records; i++) {
+        uint64_t timestamp = timestamp_of((uint64_t)i, drones);
+        if (timestamp >= middle_ns && timestamp <= middle_ns + 60000000000ULL) scanned++;
+    }
+    if (returned != scanned || visited != scanned) failures++;
+    printf("range    1 min fleet-wide: %ld records in %.3f ms\n", returned, range_time * 1e3);
+    
+    telemetry_log_close(log);
+    
+    // Reopening rebuilds the drone index from the mapped directory
+    log = telemetry_log_open(path, NULL);
+    if (!log || telemetry_log_size(log) != (uint64_t)records ||
+        telemetry_log_query_drone(log, ids[17 % drones], from_ns, end_ns, found, 1000) != expected) {
+        failures++;
+    }
+    telemetry_log_close(log);
+    remove_log(path);
+    
+    printf("%d failures\n", failures);
+    free(found);
+    free(ids);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,95 @@
+// bench/uring_loopback.c
+// Loopback throughput of the plain sendto/recvfrom path against the
+// io_uring backend. Usage: uring_loopback [messages] [payload_bytes]
+#include "../src/core/network_core.h"
+#include "../src/core/uring_backend.h"
+
+#define BENCH_PORT 47810
+#define BENCH_WINDOW 64
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int run(int use_uring, int messages, size_t payload) {
+    network_config_t* receiver = network_init("127.0.0.1", BENCH_PORT, NETWORK_MODE_SERVER);
+    network_config_t* sender = network_init("127.0.0.1", BENCH_PORT, NETWORK_MODE_CLIENT);
+    if (!receiver || !sender) return -1;
+    
+    receiver->local_addr.sin_port = htons(BENCH_PORT);
+    if (network_connect(receiver) != NET_SUCCESS || network_connect(sender) != NET_SUCCESS) {
+        return -1;
+    }
+    
+    int buffer_size = 4 * 1024 * 1024;
+    setsockopt(receiver->socket_fd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+    struct timeval timeout = { 1, 0 };
+    setsockopt(receiver->socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    
+    if (use_uring && (network_enable_uring(sender, URING_SUGGESTED_SUBMIT_BATCH) != NET_SUCCESS ||
+                      network_enable_uring(receiver, 0) != NET_SUCCESS)) {
+        printf("io_uring unavailable on this kernel\n");
+        network_cleanup(sender);
+        network_cleanup(receiver);
+        return -1;
+    }
+    
+    unsigned char* data = (unsigned char*)calloc(1, payload);
+    unsigned char* buffer = (unsigned char*)malloc(MAX_BUFFER_SIZE);
+    int received = 0;
+    int lost = 0;
+    
+    double started = now_seconds();
+    for (int sent = 0; sent < messages; ) {
+        int window = messages - sent < BENCH_WINDOW ? messages - sent : BENCH_WINDOW;
+        for (int i = 0; i < window; i++) {
+            network_send_data(sender, data, payload);
+        }
+        network_flush(sender);
+        sent += window;
+        
+        for (int i = 0; i < window; i++) {
+            size_t length = 0;
+            if (network_receive_data_from(receiver, buffer, MAX_BUFFER_SIZE,
+                                          &length, NULL) != NET_SUCCESS) {
+                lost += window - i;
+                break;
+            }
+            received++;
+        }
+    }
+    double elapsed = now_seconds() - started;
+    
+    unsigned long syscalls = 2UL * (unsigned long)messages;
+    if (use_uring) {
+        uring_stats_t send_stats, receive_stats;
+        uring_backend_get_stats(sender->uring, &send_stats);
+        uring_backend_get_stats(receiver->uring, &receive_stats);
+        syscalls = send_stats.enter_calls + receive_stats.enter_calls;
+    }
+    
+    printf("%-8s %8d msgs %6zu B  %10.0f msg/s  %8.1f MB/s  %8lu syscalls  %d lost\n",
+           use_uring ? "io_uring" : "plain", received, payload,
+           received / elapsed, received * (double)payload / elapsed / 1e6, syscalls, lost);
+    
+    free(data);
+    free(buffer);
+    network_cleanup(sender);
+    network_cleanup(receiver);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int messages = argc > 1 ? atoi(argv[1]) : 200000;
+    size_t payload = argc > 2 ? (size_t)atoi(argv[2]) : 256;
+    if (messages <= 0 || payload == 0 || payload > MAX_BUFFER_SIZE) {
+        fprintf(stderr, "usage: %s [messages] [payload_bytes <= %d]\n", argv[0], MAX_BUFFER_SIZE);
+        return 1;
+    }
+    
+    run(0, messages, payload);
+    run(1, messages, payload);
+    return 0;
+}
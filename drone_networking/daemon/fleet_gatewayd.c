@@ -0,0 +1,143 @@
+// daemon/fleet_gatewayd.c
+// Telemetry gateway daemon: terminates drone traffic on a UDP port and
+// serves fleet snapshots to the command center over TCP (fleet_gateway.h),
+// optionally keeping every status report in a telemetry log directory
+// (telemetry_log.h). Drones sending protocol frames are clock-probed so
+// their one-way latency is recorded (clock_sync.h).
+//
+// Usage: fleet_gatewayd [--port P] [--snapshot-port P] [--tick-ms MS]
+//                       [--stale-ms MS] [--full-every TICKS]
+//                       [--max-drones N] [--log DIR] [--uring]
+#include "../src/core/network_core.h"
+#include "../src/communication/fleet_gateway.h"
+#include <signal.h>
+
+typedef struct {
+    int port;
+    int snapshot_port;
+    int max_drones;
+    int use_uring;
+    const char* log_path;
+    fleet_gateway_config_t config;
+} gateway_options_t;
+
+static volatile int running = 1;
+
+static void handle_signal(int signal_number) {
+    (void)signal_number;
+    running = 0;
+}
+
+static int parse_options(int argc, char* argv[], gateway_options_t* options) {
+    options->port = FLEET_GATEWAY_DEFAULT_DRONE_PORT;
+    options->snapshot_port = FLEET_GATEWAY_DEFAULT_SNAPSHOT_PORT;
+    options->max_drones = 10000;
+    options->use_uring = 0;
+    options->log_path = NULL;
+    fleet_gateway_default_config(&options->config);
+    
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (strcmp(arg, "--uring") == 0) {
+            options->use_uring = 1;
+        } else if (value && strcmp(arg, "--port") == 0) {
+            options->port = atoi(value); i++;
+        } else if (value && strcmp(arg, "--snapshot-port") == 0) {
+            options->snapshot_port = atoi(value); i++;
+        } else if (value && strcmp(arg, "--tick-ms") == 0) {
+            options->config.tick_ms = (unsigned int)atoi(value); i++;
+        } else if (value && strcmp(arg, "--stale-ms") == 0) {
+            options->config.stale_ms = (unsigned int)atoi(value); i++;
+        } else if (value && strcmp(arg, "--full-every") == 0) {
+            options->config.full_every = (unsigned int)atoi(value); i++;
+        } else if (value && strcmp(arg, "--max-drones") == 0) {
+            options->max_drones = atoi(value); i++;
+        } else if (value && strcmp(arg, "--log") == 0) {
+            options->log_path = value; i++;
+        } else {
+            return -1;
+        }
+    }
+    
+    if (options->port < 1 || options->port > 65535 ||
+        options->snapshot_port < 1 || options->snapshot_port > 65535 ||
+        options->max_drones < 1 || options->config.tick_ms == 0) {
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    gateway_options_t options;
+    if (parse_options(argc, argv, &options) != 0) {
+        fprintf(stderr, "usage: %s [--port P] [--snapshot-port P] [--tick-ms MS] [--stale-ms MS] "
+                "[--full-every TICKS] [--max-drones N] [--log DIR] [--uring]\n", argv[0]);
+        return 2;
+    }
+    
+    fleet_gateway_t* gateway = fleet_gateway_init((size_t)options.max_drones, &options.config);
+    if (!gateway) return 1;
+    
+    telemetry_log_t* log = NULL;
+    if (options.log_path) {
+        log = telemetry_log_open(options.log_path, NULL);
+        if (!log) {
+            fleet_gateway_cleanup(gateway);
+            return 1;
+        }
+        fleet_gateway_set_log(gateway, log);
+    }
+    if (fleet_gateway_listen(gateway, options.snapshot_port) != NET_SUCCESS) {
+        fleet_gateway_cleanup(gateway);
+        telemetry_log_close(log);
+        return 1;
+    }
+    
+    network_config_t* drones = network_init("0.0.0.0", options.port, NETWORK_MODE_SERVER);
+    if (!drones) {
+        fleet_gateway_cleanup(gateway);
+        telemetry_log_close(log);
+        return 1;
+    }
+    drones->local_addr.sin_port = htons(options.port);
+    if (network_connect(drones) != NET_SUCCESS) {
+        network_cleanup(drones);
+        fleet_gateway_cleanup(gateway);
+        telemetry_log_close(log);
+        return 1;
+    }
+    
+    int buffer_size = 8 * 1024 * 1024;
+    setsockopt(drones->socket_fd, SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+    if (options.use_uring) {
+        network_enable_uring(drones, 0);
+    }
+    
+    // Probes and answers leave from the port drones report to
+    udp_context_t udp;
+    memset(&udp, 0, sizeof(udp));
+    udp.net_config = drones;
+    clock_sync_t* clock_sync = clock_sync_init(&udp, "fleet_gateway", options.max_drones);
+    fleet_gateway_set_clock_sync(gateway, clock_sync);
+    
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_signal;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    
+    printf("Fleet gateway: drones on UDP %d, snapshots on TCP %d every %u ms\n",
+           options.port, options.snapshot_port, options.config.tick_ms);
+    fleet_gateway_run(gateway, drones, &running);
+    
+    fleet_gateway_print_stats(gateway);
+    network_cleanup(drones);
+    fleet_gateway_cleanup(gateway);
+    clock_sync_cleanup(clock_sync);
+    if (log) {
+        telemetry_log_sync(log, 1);
+        telemetry_log_close(log);
+    }
+    return 0;
+}
@@ -28,9 +28,26 @@ typedef enum {
     MSG_BUILDING_PLAN,
     MSG_HEARTBEAT,
     MSG_ERROR,
-    MSG_ACKNOWLEDGMENT
+    MSG_ACKNOWLEDGMENT,
+    MSG_PLAN_CHUNK,
+    MSG_PLAN_ACK,
+    MSG_CLOCK_SYNC,
+    MSG_SESSION_HELLO
 } message_type_t;
 
+// Drone states as reported on the wire (status and heartbeat messages);
+// same order as drone_state_t in the firmware's drone_firmware.h
+typedef enum {
+    DRONE_STATE_IDLE,
+    DRONE_STATE_FLYING_TO_SITE,
+    DRONE_STATE_SCANNING_TERRAIN,
+    DRONE_STATE_CONSTRUCTING,
+    DRONE_STATE_REPAIRING,
+    DRONE_STATE_RETURNING_HOME,
+    DRONE_STATE_EMERGENCY_LANDING,
+    DRONE_STATE_COUNT
+} drone_wire_state_t;
+
 // Network modes
 typedef enum {
     NETWORK_MODE_CLIENT,
@@ -0,0 +1,286 @@
+// src/communication/clock_sync.c
+#include "clock_sync.h"
+
+clock_sync_t* clock_sync_init(udp_context_t* udp, const char* local_id, int max_peers) {
+    if (!udp || !local_id) return NULL;
+    
+    clock_sync_t* sync = (clock_sync_t*)calloc(1, sizeof(clock_sync_t));
+    if (!sync) return NULL;
+    
+    sync->max_peers = max_peers > 0 ? max_peers : MAX_DRONES;
+    sync->peers = (clock_peer_t*)calloc((size_t)sync->max_peers, sizeof(clock_peer_t));
+    if (!sync->peers) {
+        free(sync);
+        return NULL;
+    }
+    
+    sync->udp = udp;
+    strncpy(sync->local_id, local_id, MAX_DRONE_ID - 1);
+    pthread_mutex_init(&sync->lock, NULL);
+    return sync;
+}
+
+// Caller holds sync->lock
+static clock_peer_t* find_peer(clock_sync_t* sync, const char* drone_id, int create) {
+    for (int i = 0; i < sync->peer_count; i++) {
+        if (strncmp(sync->peers[i].drone_id, drone_id, MAX_DRONE_ID) == 0) {
+            return &sync->peers[i];
+        }
+    }
+    if (!create || sync->peer_count >= sync->max_peers) return NULL;
+    
+    clock_peer_t* peer = &sync->peers[sync->peer_count++];
+    memset(peer, 0, sizeof(clock_peer_t));
+    strncpy(peer->drone_id, drone_id, MAX_DRONE_ID - 1);
+    latency_histogram_init(&peer->one_way);
+    return peer;
+}
+
+static network_result_t send_sync(clock_sync_t* sync, clock_sync_message_t* message,
+                                  const struct sockaddr_in* destination) {
+    clock_sync_message_t wire;
+    message->header.payload_length = sizeof(clock_sync_message_t) - sizeof(message_header_t);
+    if (serialize_message(message, &wire, sizeof(wire)) < 0) return NET_ERROR;
+    
+    return network_send_data_to(sync->udp->net_config, &wire, sizeof(wire), destination);
+}
+
+network_result_t clock_sync_probe(clock_sync_t* sync, const char* drone_id,
+                                  const struct sockaddr_in* address) {
+    if (!sync || !drone_id || !address) return NET_ERROR;
+    
+    pthread_mutex_lock(&sync->lock);
+    clock_peer_t* peer = find_peer(sync, drone_id, 1);
+    if (!peer) {
+        pthread_mutex_unlock(&sync->lock);
+        return NET_ERROR;
+    }
+    peer->address = *address;
+    peer->probes_sent++;
+    
+    clock_sync_message_t request;
+    memset(&request, 0, sizeof(request));
+    init_message_header(&request.header, MSG_CLOCK_SYNC, sync->local_id);
+    request.probe_id = sync->next_probe_id++;
+    request.origin_ns = message_timestamp_ns(); // Late, to keep t1 close to the send
+    
+    clock_probe_t* probe = &peer->outstanding[peer->next_outstanding];
+    probe->probe_id = request.probe_id;
+    probe->origin_ns = request.origin_ns;
+    probe->pending = 1;
+    peer->next_outstanding = (peer->next_outstanding + 1) % CLOCK_SYNC_OUTSTANDING;
+    peer->last_probe_ns = request.origin_ns;
+    pthread_mutex_unlock(&sync->lock);
+    
+    return send_sync(sync, &request, address);
+}
+
+network_result_t clock_sync_probe_if_due(clock_sync_t* sync, const char* drone_id,
+                                         const struct sockaddr_in* address, uint64_t interval_ns) {
+    if (!sync || !drone_id || !address) return NET_ERROR;
+    
+    pthread_mutex_lock(&sync->lock);
+    clock_peer_t* peer = find_peer(sync, drone_id, 0);
+    int due = !peer || message_timestamp_ns() - peer->last_probe_ns >= interval_ns;
+    pthread_mutex_unlock(&sync->lock);
+    
+    return due ? clock_sync_probe(sync, drone_id, address) : NET_TIMEOUT;
+}
+
+// Caller holds sync->lock. Retire the outstanding probe a response answers,
+// 0 if there is none.
+static int take_probe(clock_peer_t* peer, const clock_sync_message_t* response) {
+    for (int i = 0; i < CLOCK_SYNC_OUTSTANDING; i++) {
+        clock_probe_t* probe = &peer->outstanding[i];
+        if (probe->pending && probe->probe_id == response->probe_id &&
+            probe->origin_ns == response->origin_ns) {
+            probe->pending = 0;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Caller holds sync->lock. Re-derive offset and drift from the sample window.
+static void update_estimate(clock_peer_t* peer) {
+    const clock_sample_t* best = &peer->samples[0];
+    for (int i = 1; i < peer->sample_count; i++) {
+        if (peer->samples[i].delay_ns < best->delay_ns) {
+            best = &peer->samples[i];
+        }
+    }
+    
+    peer->estimate.offset_ns = best->offset_ns;
+    peer->estimate.delay_ns = best->delay_ns;
+    peer->estimate.reference_ns = best->local_ns;
+    peer->estimate.samples = peer->sample_count;
+    
+    // Least-squares slope of offset over time, with times taken relative to
+    // the oldest sample so the doubles keep nanosecond precision
+    uint64_t newest = peer->samples[0].local_ns;
+    uint64_t oldest = newest;
+    for (int i = 1; i < peer->sample_count; i++) {
+        if (peer->samples[i].local_ns > newest) newest = peer->samples[i].local_ns;
+        if (peer->samples[i].local_ns < oldest) oldest = peer->samples[i].local_ns;
+    }
+    if (peer->sample_count < 3 || newest - oldest < CLOCK_SYNC_MIN_DRIFT_SPAN_NS) return;
+    
+    double mean_t = 0, mean_o = 0;
+    for (int i = 0; i < peer->sample_count; i++) {
+        mean_t += (double)(int64_t)(peer->samples[i].local_ns - oldest);
+        mean_o += (double)peer->samples[i].offset_ns;
+    }
+    mean_t /= peer->sample_count;
+    mean_o /= peer->sample_count;
+    
+    double covariance = 0, variance = 0;
+    for (int i = 0; i < peer->sample_count; i++) {
+        double dt = (double)(int64_t)(peer->samples[i].local_ns - oldest) - mean_t;
+        covariance += dt * ((double)peer->samples[i].offset_ns - mean_o);
+        variance += dt * dt;
+    }
+    if (variance > 0) {
+        peer->estimate.drift_ppm = covariance / variance * 1e6;
+    }
+}
+
+int clock_sync_handle_message(clock_sync_t* sync, const message_view_t* view,
+                              const struct sockaddr_in* source, uint64_t receive_ns) {
+    if (!sync || !view || view->type != MSG_CLOCK_SYNC) return -1;
+    
+    const clock_sync_message_t* message = view->as.clock_sync;
+    
+    if (!message->is_response) {
+        if (!source) return -1;
+        clock_sync_message_t response;
+        memset(&response, 0, sizeof(response));
+        init_message_header(&response.header, MSG_CLOCK_SYNC, sync->local_id);
+        response.is_response = 1;
+        response.probe_id = message->probe_id;
+        response.origin_ns = message->origin_ns;
+        response.receive_ns = receive_ns;
+        response.transmit_ns = message_timestamp_ns();
+        return send_sync(sync, &response, source) == NET_SUCCESS ? 0 : -1;
+    }
+    
+    char drone_id[MAX_DRONE_ID];
+    memcpy(drone_id, message->header.drone_id, MAX_DRONE_ID);
+    drone_id[MAX_DRONE_ID - 1] = '\0';
+    
+    pthread_mutex_lock(&sync->lock);
+    clock_peer_t* peer = find_peer(sync, drone_id, 0);
+    if (!peer) {
+        pthread_mutex_unlock(&sync->lock);
+        return -1; // We never probed this drone
+    }
+    if (!take_probe(peer, message)) {
+        peer->unmatched++;
+        pthread_mutex_unlock(&sync->lock);
+        return -1;
+    }
+    
+    int64_t t1 = (int64_t)message->origin_ns;
+    int64_t t2 = (int64_t)message->receive_ns;
+    int64_t t3 = (int64_t)message->transmit_ns;
+    int64_t t4 = (int64_t)receive_ns;
+    int64_t delay = (t4 - t1) - (t3 - t2);
+    if (delay < 0) {
+        pthread_mutex_unlock(&sync->lock);
+        return -1; // Clock stepped mid-probe
+    }
+    
+    clock_sample_t* sample = &peer->samples[peer->next_sample];
+    sample->local_ns = receive_ns;
+    sample->offset_ns = ((t2 - t1) + (t3 - t4)) / 2;
+    sample->delay_ns = delay;
+    peer->next_sample = (peer->next_sample + 1) % CLOCK_SYNC_SAMPLES;
+    if (peer->sample_count < CLOCK_SYNC_SAMPLES) peer->sample_count++;
+    peer->responses++;
+    
+    update_estimate(peer);
+    pthread_mutex_unlock(&sync->lock);
+    return 1;
+}
+
+int clock_sync_get_estimate(clock_sync_t* sync, const char* drone_id,
+                            clock_estimate_t* estimate) {
+    if (!sync || !drone_id || !estimate) return -1;
+    
+    pthread_mutex_lock(&sync->lock);
+    clock_peer_t* peer = find_peer(sync, drone_id, 0);
+    int found = peer && peer->sample_count > 0;
+    if (found) {
+        *estimate = peer->estimate;
+    }
+    pthread_mutex_unlock(&sync->lock);
+    
+    return found ? 0 : -1;
+}
+
+// Offset predicted for a local time, drift applied from the reference sample
+static int64_t offset_at(const clock_estimate_t* estimate, uint64_t local_ns) {
+    double elapsed = (double)(int64_t)(local_ns - estimate->reference_ns);
+    return estimate->offset_ns + (int64_t)(elapsed * estimate->drift_ppm / 1e6);
+}
+
+int clock_sync_to_local(clock_sync_t* sync, const char* drone_id, uint64_t remote_ns,
+                        uint64_t* local_ns) {
+    clock_estimate_t estimate;
+    if (!local_ns || clock_sync_get_estimate(sync, drone_id, &estimate) != 0) return -1;
+    
+    // Drift is evaluated at the uncorrected local time; the error is negligible
+    *local_ns = remote_ns - (uint64_t)offset_at(&estimate, remote_ns - (uint64_t)estimate.offset_ns);
+    return 0;
+}
+
+network_result_t clock_sync_record_arrival(clock_sync_t* sync, const message_header_t* header,
+                                           uint64_t receive_ns) {
+    if (!sync || !header) return NET_ERROR;
+    
+    char drone_id[MAX_DRONE_ID];
+    memcpy(drone_id, header->drone_id, MAX_DRONE_ID);
+    drone_id[MAX_DRONE_ID - 1] = '\0';
+    
+    pthread_mutex_lock(&sync->lock);
+    clock_peer_t* peer = find_peer(sync, drone_id, 0);
+    if (!peer || peer->sample_count == 0) {
+        pthread_mutex_unlock(&sync->lock);
+        return NET_ERROR;
+    }
+    
+    int64_t sent_local = (int64_t)header->timestamp - offset_at(&peer->estimate, receive_ns);
+    int64_t latency = (int64_t)receive_ns - sent_local;
+    if (latency < 0) {
+        peer->negative_latency++;
+    } else {
+        latency_histogram_record(&peer->one_way, (uint64_t)latency);
+    }
+    
+    pthread_mutex_unlock(&sync->lock);
+    return NET_SUCCESS;
+}
+
+void clock_sync_print_stats(clock_sync_t* sync) {
+    if (!sync) return;
+    
+    pthread_mutex_lock(&sync->lock);
+    printf("=== Clock Sync ===\n");
+    for (int i = 0; i < sync->peer_count; i++) {
+        clock_peer_t* peer = &sync->peers[i];
+        printf("%s: offset=%lldns drift=%.3fppm delay=%lldns samples=%d probes=%lu "
+               "unmatched=%lu\n",
+               peer->drone_id, (long long)peer->estimate.offset_ns, peer->estimate.drift_ppm,
+               (long long)peer->estimate.delay_ns, peer->estimate.samples, peer->probes_sent,
+               peer->unmatched);
+        latency_histogram_print(&peer->one_way, "  One-Way Latency");
+    }
+    pthread_mutex_unlock(&sync->lock);
+}
+
+void clock_sync_cleanup(clock_sync_t* sync) {
+    if (sync) {
+        pthread_mutex_destroy(&sync->lock);
+        free(sync->peers);
+        free(sync);
+    }
+}
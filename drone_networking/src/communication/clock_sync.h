@@ -0,0 +1,116 @@
+// src/communication/clock_sync.h
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include "common.h"
+#include "udp_comm.h"
+#include "../core/latency_histogram.h"
+
+// Clock offset and drift estimation between the station and each drone.
+//
+// The station probes a drone with MSG_CLOCK_SYNC. From the four timestamps
+// of one round (t1 sent, t2 received remotely, t3 answered remotely, t4
+// received) NTP gives offset = ((t2 - t1) + (t3 - t4)) / 2 and
+// delay = (t4 - t1) - (t3 - t2). The estimate uses the lowest-delay sample
+// of the last CLOCK_SYNC_SAMPLES, the one least distorted by queueing, and
+// drift is the least-squares slope of offset over local time. With an
+// offset known, every header timestamp from that drone yields a one-way
+// latency sample, collected per drone.
+//
+// A response only counts if it echoes the probe_id and origin time of a
+// probe still outstanding for that drone; each probe is answered once, so
+// duplicated, late and unsolicited responses are dropped.
+
+#define CLOCK_SYNC_SAMPLES 8
+#define CLOCK_SYNC_MIN_DRIFT_SPAN_NS 1000000000ULL // Need 1 s of history for drift
+#define CLOCK_SYNC_OUTSTANDING 4    // Probes per drone awaiting a response
+#define CLOCK_SYNC_DEFAULT_PROBE_MS 10000   // Re-probe period for clock_sync_probe_if_due
+
+// One probe round, in local time
+typedef struct {
+    uint64_t local_ns;          // t4
+    int64_t offset_ns;
+    int64_t delay_ns;
+} clock_sample_t;
+
+// A probe sent and not yet answered
+typedef struct {
+    uint32_t probe_id;
+    uint64_t origin_ns;         // t1
+    int pending;
+} clock_probe_t;
+
+// Current view of one remote clock
+typedef struct {
+    int64_t offset_ns;          // Remote clock minus local clock
+    double drift_ppm;           // Rate of change of offset
+    int64_t delay_ns;           // Round-trip delay of the sample used
+    uint64_t reference_ns;      // Local time offset_ns was measured at
+    int samples;
+} clock_estimate_t;
+
+typedef struct {
+    char drone_id[MAX_DRONE_ID];
+    struct sockaddr_in address;
+    clock_sample_t samples[CLOCK_SYNC_SAMPLES];
+    int sample_count;
+    int next_sample;
+    clock_estimate_t estimate;
+    clock_probe_t outstanding[CLOCK_SYNC_OUTSTANDING];  // Oldest replaced first
+    int next_outstanding;
+    uint64_t last_probe_ns;     // t1 of the latest probe
+    latency_histogram_t one_way;    // Remote send to local receive
+    unsigned long probes_sent;
+    unsigned long responses;
+    unsigned long unmatched;        // Responses to no outstanding probe
+    unsigned long negative_latency; // Samples below zero: estimate still settling
+} clock_peer_t;
+
+typedef struct {
+    udp_context_t* udp;
+    char local_id[MAX_DRONE_ID];
+    clock_peer_t* peers;
+    int peer_count;
+    int max_peers;
+    uint32_t next_probe_id;
+    pthread_mutex_t lock;
+} clock_sync_t;
+
+// Create a synchronizer for up to max_peers remote clocks (0 selects MAX_DRONES)
+clock_sync_t* clock_sync_init(udp_context_t* udp, const char* local_id, int max_peers);
+
+// Send a probe to a drone
+network_result_t clock_sync_probe(clock_sync_t* sync, const char* drone_id,
+                                  const struct sockaddr_in* address);
+
+// Probe a drone unless it was probed less than interval_ns ago. Returns
+// NET_TIMEOUT if no probe was due.
+network_result_t clock_sync_probe_if_due(clock_sync_t* sync, const char* drone_id,
+                                         const struct sockaddr_in* address, uint64_t interval_ns);
+
+// Handle a received MSG_CLOCK_SYNC. Requests are answered, responses update
+// the estimate. receive_ns should be taken (message_timestamp_ns) as soon as
+// the datagram arrives. Returns 1 if an estimate changed, 0 if answered, -1 on
+// error or a response that matches no outstanding probe.
+int clock_sync_handle_message(clock_sync_t* sync, const message_view_t* view,
+                              const struct sockaddr_in* source, uint64_t receive_ns);
+
+// Current estimate for a drone, 0 or -1 if none yet
+int clock_sync_get_estimate(clock_sync_t* sync, const char* drone_id,
+                            clock_estimate_t* estimate);
+
+// Convert a remote timestamp to local time using the drift-corrected offset
+int clock_sync_to_local(clock_sync_t* sync, const char* drone_id, uint64_t remote_ns,
+                        uint64_t* local_ns);
+
+// Record the one-way latency of a received message from its header timestamp
+network_result_t clock_sync_record_arrival(clock_sync_t* sync, const message_header_t* header,
+                                           uint64_t receive_ns);
+
+// Print per-drone offset, drift and one-way latency
+void clock_sync_print_stats(clock_sync_t* sync);
+
+// Free the synchronizer (the UDP context is not freed)
+void clock_sync_cleanup(clock_sync_t* sync);
+
+#endif
@@ -0,0 +1,618 @@
+// src/communication/fleet_gateway.c
+#include "fleet_gateway.h"
+#include "../protocols/json_codec.h"
+#include "../protocols/message_protocol.h"
+#include "../core/log.h"
+#include <stddef.h>
+
+static const char* const state_names[DRONE_STATE_COUNT] = {
+    "idle", "flying_to_site", "scanning_terrain", "constructing",
+    "repairing", "returning_home", "emergency_landing"
+};
+
+const char* fleet_gateway_state_name(int state) {
+    return (unsigned)state < sizeof(state_names) / sizeof(state_names[0]) ? state_names[state]
+                                                                          : "unknown";
+}
+
+static int state_number(const char* name) {
+    for (size_t i = 0; i < sizeof(state_names) / sizeof(state_names[0]); i++) {
+        if (strcmp(state_names[i], name) == 0) return (int)i;
+    }
+    return -1;
+}
+
+void fleet_gateway_default_config(fleet_gateway_config_t* config) {
+    if (!config) return;
+    
+    config->tick_ms = FLEET_GATEWAY_DEFAULT_TICK_MS;
+    config->stale_ms = FLEET_GATEWAY_DEFAULT_STALE_MS;
+    config->full_every = FLEET_GATEWAY_DEFAULT_FULL_EVERY;
+    config->clock_probe_ms = CLOCK_SYNC_DEFAULT_PROBE_MS;
+}
+
+// Caller holds gateway->lock
+static fleet_drone_t* find_drone(fleet_gateway_t* gateway, const char* drone_id, int create) {
+    long entry = drone_index_find(&gateway->index, drone_id);
+    if (entry >= 0) return &gateway->drones[entry];
+    
+    if (!create || gateway->drone_count >= gateway->max_drones) return NULL;
+    
+    fleet_drone_t* drone = &gateway->drones[gateway->drone_count];
+    memset(drone, 0, sizeof(fleet_drone_t));
+    memcpy(drone->status.drone_id, drone_id, strnlen(drone_id, MAX_DRONE_ID - 1));
+    drone_index_insert(&gateway->index, (uint32_t)gateway->drone_count++);
+    return drone;
+}
+
+fleet_gateway_t* fleet_gateway_init(size_t max_drones, const fleet_gateway_config_t* config) {
+    if (max_drones == 0) return NULL;
+    
+    // A full snapshot must fit one tcp_comm frame
+    size_t snapshot_capacity = max_drones * FLEET_GATEWAY_DRONE_JSON_SIZE +
+                               FLEET_GATEWAY_SNAPSHOT_OVERHEAD;
+    if (snapshot_capacity > TCP_MAX_FRAME_SIZE) {
+        fprintf(stderr, "Fleet gateway: %zu drones exceed the snapshot frame limit\n", max_drones);
+        return NULL;
+    }
+    
+    fleet_gateway_t* gateway = (fleet_gateway_t*)calloc(1, sizeof(fleet_gateway_t));
+    if (!gateway) return NULL;
+    
+    if (config) {
+        gateway->config = *config;
+    } else {
+        fleet_gateway_default_config(&gateway->config);
+    }
+    if (gateway->config.tick_ms == 0) gateway->config.tick_ms = FLEET_GATEWAY_DEFAULT_TICK_MS;
+    if (gateway->config.stale_ms == 0) gateway->config.stale_ms = FLEET_GATEWAY_DEFAULT_STALE_MS;
+    if (gateway->config.clock_probe_ms == 0) gateway->config.clock_probe_ms = CLOCK_SYNC_DEFAULT_PROBE_MS;
+    
+    gateway->drones = (fleet_drone_t*)calloc(max_drones, sizeof(fleet_drone_t));
+    gateway->changed = (uint32_t*)calloc(max_drones, sizeof(uint32_t));
+    gateway->went_stale = (uint32_t*)calloc(max_drones, sizeof(uint32_t));
+    gateway->snapshot = (char*)malloc(snapshot_capacity);
+    if (!gateway->drones || !gateway->changed || !gateway->went_stale || !gateway->snapshot ||
+        drone_index_init(&gateway->index, max_drones, gateway->drones, sizeof(fleet_drone_t),
+                         offsetof(fleet_drone_t, status.drone_id)) < 0) {
+        fleet_gateway_cleanup(gateway);
+        return NULL;
+    }
+    gateway->max_drones = max_drones;
+    gateway->snapshot_capacity = snapshot_capacity;
+    gateway->full_pending = 1;
+    
+    pthread_mutex_init(&gateway->lock, NULL);
+    return gateway;
+}
+
+// Copy with strings NUL-padded, so held statuses compare field by field
+static void normalize_status(status_update_format_t* out, const status_update_format_t* in) {
+    memset(out, 0, sizeof(*out));
+    memcpy(out->drone_id, in->drone_id, strnlen(in->drone_id, sizeof(out->drone_id) - 1));
+    out->position = in->position;
+    out->battery_level = in->battery_level;
+    memcpy(out->state, in->state, strnlen(in->state, sizeof(out->state) - 1));
+    out->timestamp = in->timestamp;
+}
+
+// Same report apart from its timestamp
+static int same_status(const status_update_format_t* a, const status_update_format_t* b) {
+    return a->position.x == b->position.x && a->position.y == b->position.y &&
+           a->position.z == b->position.z && a->battery_level == b->battery_level &&
+           strcmp(a->state, b->state) == 0;
+}
+
+// Caller holds gateway->lock
+static int record_status(fleet_gateway_t* gateway, const status_update_format_t* status,
+                         uint64_t now_ns) {
+    if (status->drone_id[0] == '\0') return -1;
+    
+    fleet_drone_t* drone = find_drone(gateway, status->drone_id, 1);
+    if (!drone) {
+        gateway->stats.overflow++;
+        return -1;
+    }
+    
+    int changed = drone->reports == 0 || drone->stale || !same_status(&drone->status, status);
+    drone->status = *status;
+    drone->last_seen_ns = now_ns;
+    drone->reports++;
+    drone->stale = 0;
+    
+    if (!changed) {
+        gateway->stats.unchanged++;
+        return 0;
+    }
+    if (!drone->dirty) {
+        drone->dirty = 1;
+        gateway->changed[gateway->changed_count++] = (uint32_t)(drone - gateway->drones);
+    }
+    return 1;
+}
+
+int fleet_gateway_update(fleet_gateway_t* gateway, const status_update_format_t* status,
+                         uint64_t now_ns) {
+    if (!gateway || !status) return -1;
+    
+    status_update_format_t normalized;
+    normalize_status(&normalized, status);
+    
+    pthread_mutex_lock(&gateway->lock);
+    gateway->stats.status_reports++;
+    int result = record_status(gateway, &normalized, now_ns);
+    pthread_mutex_unlock(&gateway->lock);
+    return result;
+}
+
+void fleet_gateway_set_log(fleet_gateway_t* gateway, telemetry_log_t* log) {
+    if (!gateway) return;
+    
+    pthread_mutex_lock(&gateway->lock);
+    gateway->log = log;
+    pthread_mutex_unlock(&gateway->lock);
+}
+
+void fleet_gateway_set_clock_sync(fleet_gateway_t* gateway, clock_sync_t* sync) {
+    if (!gateway) return;
+    
+    pthread_mutex_lock(&gateway->lock);
+    gateway->clock_sync = sync;
+    pthread_mutex_unlock(&gateway->lock);
+}
+
+// Shared-format reports carry whole seconds and no velocity. Out-of-range
+// seconds saturate; the log then replaces them with the receive time.
+static void log_status(fleet_gateway_t* gateway, const status_update_format_t* status) {
+    if (!gateway->log) return;
+    
+    telemetry_record_t record;
+    memset(&record, 0, sizeof(record));
+    if (status->timestamp <= 0) {
+        record.timestamp_ns = 0;
+    } else if ((uint64_t)status->timestamp > UINT64_MAX / 1000000000ULL) {
+        record.timestamp_ns = UINT64_MAX;
+    } else {
+        record.timestamp_ns = (uint64_t)status->timestamp * 1000000000ULL;
+    }
+    record.state = (int16_t)state_number(status->state);
+    record.x = status->position.x;
+    record.y = status->position.y;
+    record.z = status->position.z;
+    record.battery_level = (float)status->battery_level;
+    
+    char drone_id[MAX_DRONE_ID];
+    memset(drone_id, 0, sizeof(drone_id));
+    memcpy(drone_id, status->drone_id, strnlen(status->drone_id, sizeof(drone_id) - 1));
+    if (telemetry_log_append(gateway->log, drone_id, &record, message_timestamp_ns(), NULL) != 0) {
+        __atomic_fetch_add(&gateway->stats.log_failures, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void status_from_message(status_update_format_t* status, const status_update_message_t* message) {
+    memset(status, 0, sizeof(*status));
+    memcpy(status->drone_id, message->header.drone_id,
+           strnlen(message->header.drone_id, sizeof(status->drone_id) - 1));
+    status->position.x = message->x;
+    status->position.y = message->y;
+    status->position.z = message->z;
+    status->battery_level = message->battery_level;
+    strcpy(status->state, fleet_gateway_state_name(message->state));
+    status->timestamp = (int64_t)(message->header.timestamp / 1000000000ULL);
+}
+
+// A heartbeat carries state and battery; position stays as last reported
+static int record_heartbeat(fleet_gateway_t* gateway, const heartbeat_message_t* heartbeat,
+                            uint64_t now_ns) {
+    status_update_format_t status;
+    memset(&status, 0, sizeof(status));
+    memcpy(status.drone_id, heartbeat->header.drone_id,
+           strnlen(heartbeat->header.drone_id, sizeof(status.drone_id) - 1));
+    
+    pthread_mutex_lock(&gateway->lock);
+    gateway->stats.heartbeats++;
+    fleet_drone_t* drone = find_drone(gateway, status.drone_id, 0);
+    if (drone) status.position = drone->status.position;
+    status.battery_level = heartbeat->battery_level;
+    strcpy(status.state, fleet_gateway_state_name(heartbeat->state));
+    status.timestamp = (int64_t)(heartbeat->header.timestamp / 1000000000ULL);
+    int result = record_status(gateway, &status, now_ns);
+    pthread_mutex_unlock(&gateway->lock);
+    return result;
+}
+
+// One-way latency of a drone's frame, and a fresh probe when one is due
+static void time_frame(fleet_gateway_t* gateway, const message_header_t* header,
+                       const struct sockaddr_in* source, uint64_t received_ns) {
+    clock_sync_record_arrival(gateway->clock_sync, header, received_ns);
+    if (!source) return;
+    
+    char drone_id[MAX_DRONE_ID];
+    memcpy(drone_id, header->drone_id, MAX_DRONE_ID);
+    drone_id[MAX_DRONE_ID - 1] = '\0';
+    clock_sync_probe_if_due(gateway->clock_sync, drone_id, source,
+                            (uint64_t)gateway->config.clock_probe_ms * 1000000ULL);
+}
+
+network_result_t fleet_gateway_handle_datagram(fleet_gateway_t* gateway, const void* data,
+                                               size_t length, uint64_t now_ns) {
+    return fleet_gateway_handle_datagram_from(gateway, data, length, NULL, now_ns);
+}
+
+network_result_t fleet_gateway_handle_datagram_from(fleet_gateway_t* gateway, const void* data,
+                                                    size_t length,
+                                                    const struct sockaddr_in* source,
+                                                    uint64_t now_ns) {
+    if (!gateway || !data || length == 0) return NET_ERROR;
+    
+    const unsigned char* bytes = (const unsigned char*)data;
+    __atomic_fetch_add(&gateway->stats.datagrams, 1, __ATOMIC_RELAXED);
+    
+    // Shared-format reports: JSON objects or the compact binary form
+    if (bytes[0] == '{' || bytes[0] == MESSAGE_FORMAT_STATUS_UPDATE) {
+        status_update_format_t status;
+        int decoded = bytes[0] == '{'
+            ? status_update_format_decode_json(&status, (const char*)data, length)
+            : status_update_format_decode_binary(&status, bytes, length);
+        if (decoded == 0 && fleet_gateway_update(gateway, &status, now_ns) >= 0) {
+            log_status(gateway, &status);
+            return NET_SUCCESS;
+        }
+        __atomic_fetch_add(&gateway->stats.rejected, 1, __ATOMIC_RELAXED);
+        return NET_ERROR;
+    }
+    
+    // Protocol frames; views need an aligned buffer
+    union {
+        uint64_t align;
+        unsigned char bytes[MAX_BUFFER_SIZE];
+    } scratch;
+    if ((uintptr_t)data % __alignof__(status_update_message_t) != 0) {
+        if (length > sizeof(scratch.bytes)) {
+            __atomic_fetch_add(&gateway->stats.rejected, 1, __ATOMIC_RELAXED);
+            return NET_ERROR;
+        }
+        memcpy(scratch.bytes, data, length);
+        data = scratch.bytes;
+    }
+    
+    uint64_t received_ns = message_timestamp_ns();
+    message_view_t view;
+    int result = -1;
+    if (message_view_init(&view, data, length) == 0) {
+        if (gateway->clock_sync && (view.type == MSG_STATUS_UPDATE || view.type == MSG_HEARTBEAT)) {
+            time_frame(gateway, view.as.header, source, received_ns);
+        }
+        
+        if (view.type == MSG_STATUS_UPDATE) {
+            status_update_format_t status;
+            status_from_message(&status, view.as.status);
+            result = fleet_gateway_update(gateway, &status, now_ns);
+            // Frames keep nanosecond timestamps and velocity in the log
+            if (result >= 0 && gateway->log &&
+                telemetry_log_append_status(gateway->log, view.as.status, received_ns) != 0) {
+                __atomic_fetch_add(&gateway->stats.log_failures, 1, __ATOMIC_RELAXED);
+            }
+        } else if (view.type == MSG_HEARTBEAT) {
+            result = record_heartbeat(gateway, view.as.heartbeat, now_ns);
+        } else if (view.type == MSG_CLOCK_SYNC && gateway->clock_sync) {
+            result = clock_sync_handle_message(gateway->clock_sync, &view, source, received_ns);
+        }
+    }
+    if (result < 0) {
+        __atomic_fetch_add(&gateway->stats.rejected, 1, __ATOMIC_RELAXED);
+        return NET_ERROR;
+    }
+    return NET_SUCCESS;
+}
+
+// Caller holds gateway->lock
+static void mark_stale(fleet_gateway_t* gateway, uint64_t now_ns) {
+    uint64_t stale_ns = (uint64_t)gateway->config.stale_ms * 1000000ULL;
+    for (size_t i = 0; i < gateway->drone_count; i++) {
+        fleet_drone_t* drone = &gateway->drones[i];
+        if (drone->stale || now_ns - drone->last_seen_ns < stale_ns) continue;
+        
+        drone->stale = 1;
+        gateway->went_stale[gateway->went_stale_count++] = (uint32_t)i;
+        gateway->stats.went_stale++;
+    }
+}
+
+// Append one generated status_update document to the snapshot
+static void write_status(json_writer_t* writer, const status_update_format_t* status) {
+    if (writer->overflow) return;
+    int length = status_update_format_encode_json(status, writer->out + writer->length,
+                                                  writer->capacity - writer->length);
+    if (length < 0) {
+        writer->overflow = 1;
+        return;
+    }
+    writer->length += (size_t)length;
+}
+
+int fleet_gateway_build_snapshot(fleet_gateway_t* gateway, int full, uint64_t now_ns) {
+    if (!gateway) return -1;
+    
+    pthread_mutex_lock(&gateway->lock);
+    mark_stale(gateway, now_ns);
+    full = full || gateway->full_pending;
+    
+    size_t live = 0;
+    for (size_t i = 0; i < gateway->drone_count; i++) {
+        if (!gateway->drones[i].stale) live++;
+    }
+    
+    json_writer_t writer;
+    json_writer_init(&writer, gateway->snapshot, gateway->snapshot_capacity);
+    json_write_raw(&writer, "{\"message_type\":\"fleet_snapshot\",\"sequence\":", 44);
+    json_write_int64(&writer, (int64_t)gateway->sequence);
+    json_write_raw(&writer, ",\"timestamp\":", 13);
+    json_write_int64(&writer, (int64_t)time(NULL));
+    json_write_raw(&writer, full ? ",\"full\":true" : ",\"full\":false", full ? 12 : 13);
+    json_write_raw(&writer, ",\"drone_count\":", 15);
+    json_write_int64(&writer, (int64_t)live);
+    
+    size_t sent = 0;
+    json_write_raw(&writer, ",\"drones\":[", 11);
+    if (full) {
+        for (size_t i = 0; i < gateway->drone_count; i++) {
+            if (gateway->drones[i].stale) continue;
+            if (sent++) json_write_raw(&writer, ",", 1);
+            write_status(&writer, &gateway->drones[i].status);
+        }
+    } else {
+        for (size_t i = 0; i < gateway->changed_count; i++) {
+            const fleet_drone_t* drone = &gateway->drones[gateway->changed[i]];
+            if (drone->stale) continue;
+            if (sent++) json_write_raw(&writer, ",", 1);
+            write_status(&writer, &drone->status);
+        }
+    }
+    
+    json_write_raw(&writer, "],\"stale\":[", 11);
+    size_t stale_written = 0;
+    for (size_t i = 0; i < (full ? gateway->drone_count : gateway->went_stale_count); i++) {
+        const fleet_drone_t* drone = &gateway->drones[full ? i : gateway->went_stale[i]];
+        if (!drone->stale) continue;
+        if (stale_written++) json_write_raw(&writer, ",", 1);
+        json_write_string(&writer, drone->status.drone_id, sizeof(drone->status.drone_id));
+    }
+    json_write_raw(&writer, "]}", 2);
+    
+    // Everything held is now reflected downstream
+    for (size_t i = 0; i < gateway->changed_count; i++) {
+        gateway->drones[gateway->changed[i]].dirty = 0;
+    }
+    gateway->changed_count = 0;
+    gateway->went_stale_count = 0;
+    
+    int length = json_writer_finish(&writer);
+    gateway->snapshot_length = length < 0 ? 0 : (size_t)length;
+    if (length >= 0) {
+        gateway->snapshot_full = full;
+        gateway->sequence++;
+        gateway->full_pending = 0;
+        gateway->stats.snapshots++;
+        if (full) gateway->stats.full_snapshots++;
+        gateway->stats.snapshot_bytes += (unsigned long)length;
+        gateway->stats.drones_sent += (unsigned long)sent;
+    } else {
+        gateway->full_pending = 1;
+    }
+    pthread_mutex_unlock(&gateway->lock);
+    return length;
+}
+
+network_result_t fleet_gateway_listen(fleet_gateway_t* gateway, int port) {
+    if (!gateway || gateway->listener) return NET_ERROR;
+    if (port == 0) return NET_SUCCESS;
+    
+    gateway->listener = tcp_listen(port);
+    return gateway->listener ? NET_SUCCESS : NET_ERROR;
+}
+
+static void drop_subscriber(fleet_gateway_t* gateway, int slot) {
+    tcp_close(gateway->subscribers[slot].connection);
+    free(gateway->subscribers[slot].backlog);
+    gateway->subscribers[slot] = gateway->subscribers[--gateway->subscriber_count];
+    gateway->stats.subscribers_dropped++;
+}
+
+// Push what the socket takes of a subscriber's backlog. 1 once it is
+// empty, 0 while the socket is still full, -1 if the connection broke
+static int flush_backlog(fleet_subscriber_t* subscriber) {
+    if (subscriber->backlog_sent == subscriber->backlog_length) return 1;
+    
+    struct iovec rest;
+    rest.iov_base = subscriber->backlog + subscriber->backlog_sent;
+    rest.iov_len = subscriber->backlog_length - subscriber->backlog_sent;
+    long written = tcp_write_nowait(subscriber->connection, &rest, 1);
+    if (written < 0) return -1;
+    
+    subscriber->backlog_sent += (size_t)written;
+    if (subscriber->backlog_sent < subscriber->backlog_length) return 0;
+    subscriber->connection->frames_sent++;
+    return 1;
+}
+
+// Write the current snapshot as one tcp_comm frame; whatever the socket
+// does not take now goes to the backlog. 0 or -1
+static int send_snapshot(fleet_gateway_t* gateway, fleet_subscriber_t* subscriber,
+                         size_t length, uint64_t now_ns) {
+    uint32_t prefix = htonl((uint32_t)length);
+    struct iovec frame[2];
+    frame[0].iov_base = &prefix;
+    frame[0].iov_len = sizeof(prefix);
+    frame[1].iov_base = gateway->snapshot;
+    frame[1].iov_len = length;
+    
+    long written = tcp_write_nowait(subscriber->connection, frame, 2);
+    if (written < 0) return -1;
+    if ((size_t)written == sizeof(prefix) + length) {
+        subscriber->connection->frames_sent++;
+        return 0;
+    }
+    
+    if (!subscriber->backlog) {
+        subscriber->backlog = (unsigned char*)malloc(sizeof(prefix) + gateway->snapshot_capacity);
+        if (!subscriber->backlog) return -1;
+    }
+    
+    // Keep the unsent tail, including any of the length prefix
+    size_t done = (size_t)written;
+    size_t kept = 0;
+    if (done < sizeof(prefix)) {
+        kept = sizeof(prefix) - done;
+        memcpy(subscriber->backlog, (unsigned char*)&prefix + done, kept);
+        done = 0;
+    } else {
+        done -= sizeof(prefix);
+    }
+    memcpy(subscriber->backlog + kept, gateway->snapshot + done, length - done);
+    subscriber->backlog_length = kept + length - done;
+    subscriber->backlog_sent = 0;
+    subscriber->stalled_since_ns = now_ns;
+    return 0;
+}
+
+int fleet_gateway_tick(fleet_gateway_t* gateway, uint64_t now_ns) {
+    if (!gateway) return -1;
+    
+    tcp_connection_t* connection;
+    while (gateway->listener && (connection = tcp_accept(gateway->listener)) != NULL) {
+        if (gateway->subscriber_count >= FLEET_GATEWAY_MAX_SUBSCRIBERS) {
+            LOG_WARN("Fleet gateway: subscriber limit reached, refusing connection");
+            tcp_close(connection);
+            continue;
+        }
+        fleet_subscriber_t* subscriber = &gateway->subscribers[gateway->subscriber_count++];
+        memset(subscriber, 0, sizeof(*subscriber));
+        subscriber->connection = connection;
+        gateway->full_pending = 1;
+    }
+    
+    // Subscribers still taking an earlier snapshot; one that has caught up
+    // after skipping some asks for a full snapshot this tick
+    for (int i = gateway->subscriber_count - 1; i >= 0; i--) {
+        fleet_subscriber_t* subscriber = &gateway->subscribers[i];
+        uint64_t timeout_ns = (uint64_t)subscriber->connection->io_timeout_ms * 1000000ULL;
+        int flushed = flush_backlog(subscriber);
+        if (flushed < 0 || (flushed == 0 && now_ns - subscriber->stalled_since_ns >= timeout_ns)) {
+            LOG_WARN("Fleet gateway: subscriber stopped reading, dropping it");
+            drop_subscriber(gateway, i);
+        } else if (flushed == 1 && subscriber->needs_full) {
+            gateway->full_pending = 1;
+        }
+    }
+    
+    // Snapshots are built with no subscribers too, so deltas never pile up
+    int full = gateway->config.full_every > 0 &&
+               gateway->sequence % gateway->config.full_every == 0;
+    int length = fleet_gateway_build_snapshot(gateway, full, now_ns);
+    if (length < 0) return -1;
+    
+    int reached = 0;
+    for (int i = gateway->subscriber_count - 1; i >= 0; i--) {
+        fleet_subscriber_t* subscriber = &gateway->subscribers[i];
+        if (subscriber->backlog_sent < subscriber->backlog_length ||
+            (subscriber->needs_full && !gateway->snapshot_full)) {
+            subscriber->needs_full = 1;
+            gateway->stats.snapshots_skipped++;
+            continue;
+        }
+        if (send_snapshot(gateway, subscriber, (size_t)length, now_ns) != 0) {
+            LOG_WARN("Fleet gateway: snapshot send failed, dropping subscriber");
+            drop_subscriber(gateway, i);
+            continue;
+        }
+        subscriber->needs_full = 0;
+        reached++;
+    }
+    return reached;
+}
+
+network_result_t fleet_gateway_run(fleet_gateway_t* gateway, network_config_t* net_config,
+                                   volatile int* running) {
+    if (!gateway || !net_config || !running) return NET_ERROR;
+    
+    // Wake often enough to tick on time when drones are quiet
+    unsigned int wait_ms = gateway->config.tick_ms / 4 ? gateway->config.tick_ms / 4 : 1;
+    if (network_set_receive_timeout(net_config, (int)wait_ms) != NET_SUCCESS) return NET_ERROR;
+    
+    union {
+        uint64_t align;
+        unsigned char bytes[MAX_BUFFER_SIZE];
+    } buffer;
+    uint64_t tick_ns = (uint64_t)gateway->config.tick_ms * 1000000ULL;
+    uint64_t next_tick = network_monotonic_ns() + tick_ns;
+    
+    while (*running) {
+        size_t length = 0;
+        struct sockaddr_in source;
+        network_result_t result = network_receive_data_from(net_config, buffer.bytes,
+                                                            sizeof(buffer.bytes), &length, &source);
+        uint64_t now = network_monotonic_ns();
+        if (result == NET_SUCCESS) {
+            fleet_gateway_handle_datagram_from(gateway, buffer.bytes, length, &source, now);
+        }
+        
+        if (now >= next_tick) {
+            fleet_gateway_tick(gateway, now);
+            next_tick += tick_ns;
+            if (next_tick <= now) next_tick = now + tick_ns;
+        }
+    }
+    return NET_SUCCESS;
+}
+
+void fleet_gateway_get_stats(fleet_gateway_t* gateway, fleet_gateway_stats_t* stats) {
+    if (!gateway || !stats) return;
+    
+    pthread_mutex_lock(&gateway->lock);
+    *stats = gateway->stats;
+    stats->datagrams = __atomic_load_n(&gateway->stats.datagrams, __ATOMIC_RELAXED);
+    stats->rejected = __atomic_load_n(&gateway->stats.rejected, __ATOMIC_RELAXED);
+    stats->log_failures = __atomic_load_n(&gateway->stats.log_failures, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&gateway->lock);
+}
+
+void fleet_gateway_print_stats(fleet_gateway_t* gateway) {
+    if (!gateway) return;
+    
+    fleet_gateway_stats_t stats;
+    fleet_gateway_get_stats(gateway, &stats);
+    printf("=== Fleet Gateway ===\n");
+    printf("Drones: %zu tracked, %lu went stale, %lu over capacity\n",
+           gateway->drone_count, stats.went_stale, stats.overflow);
+    printf("Datagrams: %lu (%lu status, %lu heartbeats, %lu unchanged, %lu rejected)\n",
+           stats.datagrams, stats.status_reports, stats.heartbeats, stats.unchanged,
+           stats.rejected);
+    printf("Snapshots: %lu (%lu full), %lu drone entries, %lu bytes\n",
+           stats.snapshots, stats.full_snapshots, stats.drones_sent, stats.snapshot_bytes);
+    printf("Subscribers: %d connected, %lu dropped, %lu snapshots skipped\n",
+           gateway->subscriber_count, stats.subscribers_dropped, stats.snapshots_skipped);
+    if (gateway->log) {
+        printf("Telemetry log: %llu records, %lu refused\n",
+               (unsigned long long)telemetry_log_size(gateway->log), stats.log_failures);
+    }
+}
+
+void fleet_gateway_cleanup(fleet_gateway_t* gateway) {
+    if (!gateway) return;
+    
+    for (int i = 0; i < gateway->subscriber_count; i++) {
+        tcp_close(gateway->subscribers[i].connection);
+        free(gateway->subscribers[i].backlog);
+    }
+    tcp_listener_close(gateway->listener);
+    if (gateway->max_drones) {
+        pthread_mutex_destroy(&gateway->lock);
+    }
+    free(gateway->drones);
+    drone_index_free(&gateway->index);
+    free(gateway->changed);
+    free(gateway->went_stale);
+    free(gateway->snapshot);
+    free(gateway);
+}
@@ -0,0 +1,190 @@
+// src/communication/fleet_gateway.h
+#ifndef FLEET_GATEWAY_H
+#define FLEET_GATEWAY_H
+
+#include "common.h"
+#include "tcp_comm.h"
+#include "clock_sync.h"
+#include "../core/network_core.h"
+#include "../core/drone_index.h"
+#include "../protocols/message_formats.h"
+#include "../storage/telemetry_log.h"
+
+// Telemetry gateway between the fleet and the Ruby command center.
+//
+// The gateway terminates drone traffic on one UDP port: protocol frames
+// (MSG_STATUS_UPDATE, MSG_HEARTBEAT) and the shared status_update format
+// in JSON or compact binary. Each drone's latest status lives in an
+// open-addressed table; a report identical to the held one (timestamp
+// aside) only refreshes last-seen, and several reports in one tick
+// collapse into the newest, so each drone appears at most once per
+// snapshot however fast it reports.
+//
+// Every tick the gateway writes one JSON document and sends it to each
+// command-center subscriber as a tcp_comm frame:
+//
+//   {"message_type":"fleet_snapshot","sequence":N,"timestamp":<unix s>,
+//    "full":false,"drone_count":N,"drones":[<status_update>...],
+//    "stale":["drone_id"...]}
+//
+// Delta snapshots carry the drones that changed since the previous tick
+// and those that went stale (silent for stale_ms). A full snapshot, sent
+// every full_every ticks and whenever a subscriber joins, carries every
+// live drone and every stale one, so a fresh subscriber needs no history.
+// The snapshot buffer is sized for max_drones at init; ticks allocate
+// nothing.
+//
+// Ticks run on the receive thread, so snapshots are written without ever
+// waiting on a subscriber. What a subscriber's socket will not take at
+// once is copied to that subscriber's backlog (allocated on its first
+// stall) and pushed on later ticks. A subscriber still behind when the
+// next snapshot is ready skips snapshots until its backlog drains and
+// then gets a full one; one behind for its connection's I/O timeout is
+// dropped and gets a full snapshot when it reconnects.
+//
+// With a telemetry log attached, every status report (not heartbeats) is
+// also appended to it as it arrives, unchanged ones included.
+//
+// With a clock synchronizer attached, the gateway probes each drone that
+// sends protocol frames every clock_probe_ms, feeds MSG_CLOCK_SYNC
+// responses to it, and records the one-way latency of every status and
+// heartbeat frame against the drone's estimated clock (clock_sync.h).
+
+#define FLEET_GATEWAY_DEFAULT_DRONE_PORT DEFAULT_PORT
+#define FLEET_GATEWAY_DEFAULT_SNAPSHOT_PORT 8890
+#define FLEET_GATEWAY_DEFAULT_TICK_MS 100
+#define FLEET_GATEWAY_DEFAULT_STALE_MS 5000
+#define FLEET_GATEWAY_DEFAULT_FULL_EVERY 50     // Ticks between full snapshots
+#define FLEET_GATEWAY_MAX_SUBSCRIBERS 8
+#define FLEET_GATEWAY_DRONE_JSON_SIZE 640       // Worst-case escaped status_update
+#define FLEET_GATEWAY_SNAPSHOT_OVERHEAD 256
+
+typedef struct {
+    unsigned int tick_ms;
+    unsigned int stale_ms;
+    unsigned int full_every;
+    unsigned int clock_probe_ms;    // Re-probe period with a clock synchronizer
+} fleet_gateway_config_t;
+
+typedef struct {
+    status_update_format_t status;  // Latest report, as the command center sees it
+    uint64_t last_seen_ns;
+    int dirty;                      // Changed since the last snapshot
+    int stale;
+    unsigned long reports;
+} fleet_drone_t;
+
+typedef struct {
+    tcp_connection_t* connection;
+    unsigned char* backlog;         // Unsent tail of a snapshot frame
+    size_t backlog_length;
+    size_t backlog_sent;
+    uint64_t stalled_since_ns;
+    int needs_full;                 // Skipped a snapshot; only a full one may follow
+} fleet_subscriber_t;
+
+typedef struct {
+    unsigned long datagrams;
+    unsigned long status_reports;
+    unsigned long heartbeats;
+    unsigned long unchanged;        // Reports identical to the held status
+    unsigned long rejected;         // Unparseable or of an unhandled type
+    unsigned long overflow;         // Drones beyond max_drones
+    unsigned long snapshots;
+    unsigned long full_snapshots;
+    unsigned long snapshot_bytes;
+    unsigned long drones_sent;
+    unsigned long went_stale;
+    unsigned long subscribers_dropped;
+    unsigned long snapshots_skipped;    // Not sent to a subscriber still behind
+    unsigned long log_failures;     // Reports the telemetry log refused
+} fleet_gateway_stats_t;
+
+typedef struct {
+    fleet_gateway_config_t config;
+    fleet_drone_t* drones;
+    size_t drone_count;
+    size_t max_drones;
+    drone_index_t index;
+    uint32_t* changed;              // Slots of dirty drones, in order of change
+    size_t changed_count;
+    uint32_t* went_stale;           // Slots that went stale since the last snapshot
+    size_t went_stale_count;
+    
+    char* snapshot;                 // Last snapshot written
+    size_t snapshot_capacity;
+    size_t snapshot_length;
+    int snapshot_full;
+    uint64_t sequence;
+    int full_pending;               // Next snapshot must be full
+    
+    tcp_listener_t* listener;
+    fleet_subscriber_t subscribers[FLEET_GATEWAY_MAX_SUBSCRIBERS];
+    int subscriber_count;
+    
+    telemetry_log_t* log;           // Optional, not owned
+    clock_sync_t* clock_sync;       // Optional, not owned
+    
+    fleet_gateway_stats_t stats;
+    pthread_mutex_t lock;
+} fleet_gateway_t;
+
+// Fill a configuration with the defaults above
+void fleet_gateway_default_config(fleet_gateway_config_t* config);
+
+// Create a gateway tracking up to max_drones (config may be NULL)
+fleet_gateway_t* fleet_gateway_init(size_t max_drones, const fleet_gateway_config_t* config);
+
+// Append every status report to log from now on (NULL detaches)
+void fleet_gateway_set_log(fleet_gateway_t* gateway, telemetry_log_t* log);
+
+// Probe drones and record one-way latency with sync from now on (NULL
+// detaches). Its UDP context must send on the socket drones report to.
+void fleet_gateway_set_clock_sync(fleet_gateway_t* gateway, clock_sync_t* sync);
+
+// Record a status report received at now_ns (CLOCK_MONOTONIC). Returns 1 if
+// it changed the drone's state, 0 if it only refreshed it, -1 if rejected.
+int fleet_gateway_update(fleet_gateway_t* gateway, const status_update_format_t* status,
+                         uint64_t now_ns);
+
+// Feed one received datagram of any supported kind
+network_result_t fleet_gateway_handle_datagram(fleet_gateway_t* gateway, const void* data,
+                                               size_t length, uint64_t now_ns);
+
+// Feed one received datagram and the address it came from, which clock
+// probes and answers go to (source may be NULL)
+network_result_t fleet_gateway_handle_datagram_from(fleet_gateway_t* gateway, const void* data,
+                                                    size_t length,
+                                                    const struct sockaddr_in* source,
+                                                    uint64_t now_ns);
+
+// Mark drones silent for stale_ms and write the next snapshot into
+// gateway->snapshot. Returns its length or -1.
+int fleet_gateway_build_snapshot(fleet_gateway_t* gateway, int full, uint64_t now_ns);
+
+// Accept subscribers on port (0 disables the listener)
+network_result_t fleet_gateway_listen(fleet_gateway_t* gateway, int port);
+
+// Accept waiting subscribers, build the tick's snapshot and send it
+// without blocking. Returns the number of subscribers handed the snapshot,
+// including any whose socket has only taken part of it so far.
+int fleet_gateway_tick(fleet_gateway_t* gateway, uint64_t now_ns);
+
+// Serve drone traffic from net_config until *running is cleared,
+// ticking every tick_ms
+network_result_t fleet_gateway_run(fleet_gateway_t* gateway, network_config_t* net_config,
+                                   volatile int* running);
+
+// Snapshot counters
+void fleet_gateway_get_stats(fleet_gateway_t* gateway, fleet_gateway_stats_t* stats);
+
+// Print counters
+void fleet_gateway_print_stats(fleet_gateway_t* gateway);
+
+// Close subscribers and free the gateway
+void fleet_gateway_cleanup(fleet_gateway_t* gateway);
+
+// Name of a drone_state_t value as the command center spells it
+const char* fleet_gateway_state_name(int state);
+
+#endif
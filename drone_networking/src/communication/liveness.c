@@ -0,0 +1,358 @@
+// src/communication/liveness.c
+#include "liveness.h"
+#include "../core/log.h"
+#include <stddef.h>
+
+#define LN10 2.302585092994046
+
+static const char* const state_names[] = { "UNKNOWN", "ALIVE", "SUSPECT", "DEAD" };
+
+const char* liveness_state_name(liveness_state_t state) {
+    return (unsigned)state < 4 ? state_names[state] : "INVALID";
+}
+
+void liveness_default_config(liveness_config_t* config) {
+    if (!config) return;
+    
+    config->phi_suspect = LIVENESS_DEFAULT_PHI_SUSPECT;
+    config->phi_dead = LIVENESS_DEFAULT_PHI_DEAD;
+    config->tick_ms = LIVENESS_DEFAULT_TICK_MS;
+    config->default_interval_ms = LIVENESS_DEFAULT_INTERVAL_MS;
+    config->max_detection_ms = LIVENESS_DEFAULT_MAX_DETECTION_MS;
+}
+
+static void list_init(liveness_timer_t* head) {
+    head->next = head;
+    head->prev = head;
+}
+
+static void timer_unlink(liveness_timer_t* timer) {
+    if (!timer->next) return;
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->next = NULL;
+    timer->prev = NULL;
+}
+
+// Caller holds liveness->lock. Place a timer in the level whose span covers
+// its distance from the current tick.
+static void timer_schedule(liveness_t* liveness, liveness_timer_t* timer, uint64_t expires_tick) {
+    if (expires_tick <= liveness->current_tick) {
+        expires_tick = liveness->current_tick + 1;
+    }
+    timer->expires_tick = expires_tick;
+    
+    uint64_t distance = expires_tick - liveness->current_tick;
+    int level = 0;
+    while (level < LIVENESS_WHEEL_LEVELS - 1 &&
+           distance >= (1ULL << (LIVENESS_WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    
+    // Past the top level's span: park in the last slot it can reach
+    uint64_t max_distance = 1ULL << (LIVENESS_WHEEL_BITS * LIVENESS_WHEEL_LEVELS);
+    uint64_t slot_tick = distance < max_distance ? expires_tick
+                                                 : liveness->current_tick + max_distance - 1;
+    unsigned slot = (unsigned)(slot_tick >> (LIVENESS_WHEEL_BITS * level)) &
+                    (LIVENESS_WHEEL_SLOTS - 1);
+    
+    liveness_timer_t* head = &liveness->wheel[level][slot];
+    timer->next = head;
+    timer->prev = head->prev;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+// Caller holds liveness->lock
+static liveness_drone_t* find_drone(liveness_t* liveness, const char* drone_id, int create) {
+    long entry = drone_index_find(&liveness->index, drone_id);
+    if (entry >= 0) return &liveness->drones[entry];
+    
+    if (!create || liveness->drone_count >= liveness->max_drones) return NULL;
+    
+    liveness_drone_t* drone = &liveness->drones[liveness->drone_count];
+    memset(drone, 0, sizeof(liveness_drone_t));
+    strncpy(drone->drone_id, drone_id, MAX_DRONE_ID - 1);
+    drone->state = LIVENESS_UNKNOWN;
+    drone->mean_interval_ms = liveness->config.default_interval_ms;
+    drone_index_insert(&liveness->index, (uint32_t)liveness->drone_count++);
+    liveness->stats.tracked++;
+    return drone;
+}
+
+liveness_t* liveness_init(size_t max_drones, const liveness_config_t* config,
+                          liveness_callback_t on_change, void* user_data) {
+    if (max_drones == 0) return NULL;
+    
+    liveness_t* liveness = (liveness_t*)calloc(1, sizeof(liveness_t));
+    if (!liveness) return NULL;
+    
+    if (config) {
+        liveness->config = *config;
+    } else {
+        liveness_default_config(&liveness->config);
+    }
+    if (liveness->config.tick_ms == 0) liveness->config.tick_ms = LIVENESS_DEFAULT_TICK_MS;
+    if (liveness->config.default_interval_ms == 0) {
+        liveness->config.default_interval_ms = LIVENESS_DEFAULT_INTERVAL_MS;
+    }
+    
+    liveness->drones = (liveness_drone_t*)calloc(max_drones, sizeof(liveness_drone_t));
+    if (!liveness->drones ||
+        drone_index_init(&liveness->index, max_drones, liveness->drones,
+                         sizeof(liveness_drone_t), offsetof(liveness_drone_t, drone_id)) < 0) {
+        liveness_cleanup(liveness);
+        return NULL;
+    }
+    liveness->max_drones = max_drones;
+    
+    for (int level = 0; level < LIVENESS_WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < LIVENESS_WHEEL_SLOTS; slot++) {
+            list_init(&liveness->wheel[level][slot]);
+        }
+    }
+    
+    liveness->on_change = on_change;
+    liveness->user_data = user_data;
+    pthread_mutex_init(&liveness->lock, NULL);
+    return liveness;
+}
+
+static uint64_t to_tick(const liveness_t* liveness, uint64_t now_ns) {
+    return now_ns / ((uint64_t)liveness->config.tick_ms * 1000000ULL);
+}
+
+// Time after the last heartbeat at which phi reaches threshold
+static double threshold_ms(const liveness_t* liveness, const liveness_drone_t* drone,
+                           double phi) {
+    double ms = phi * drone->mean_interval_ms * LN10;
+    if (liveness->config.max_detection_ms && ms > liveness->config.max_detection_ms) {
+        ms = liveness->config.max_detection_ms;
+    }
+    return ms;
+}
+
+// Caller holds liveness->lock
+static void change_state(liveness_t* liveness, liveness_drone_t* drone,
+                         liveness_state_t new_state) {
+    liveness_state_t old_state = drone->state;
+    if (old_state == new_state) return;
+    
+    drone->state = new_state;
+    if (new_state == LIVENESS_SUSPECT) liveness->stats.suspected++;
+    if (new_state == LIVENESS_DEAD) liveness->stats.declared_dead++;
+    if (new_state == LIVENESS_ALIVE && old_state != LIVENESS_UNKNOWN) liveness->stats.recovered++;
+    
+    LOG_INFO("Drone %s: %s -> %s", drone->drone_id, liveness_state_name(old_state),
+             liveness_state_name(new_state));
+    if (liveness->on_change) {
+        liveness->on_change(drone->drone_id, old_state, new_state, liveness->user_data);
+    }
+}
+
+// Caller holds liveness->lock. Arm the timer for the next threshold.
+static void arm_timer(liveness_t* liveness, liveness_drone_t* drone) {
+    double phi = drone->state == LIVENESS_ALIVE ? liveness->config.phi_suspect
+                                                : liveness->config.phi_dead;
+    uint64_t deadline_ns = drone->last_heartbeat_ns +
+                           (uint64_t)(threshold_ms(liveness, drone, phi) * 1e6);
+    uint64_t tick_ns = (uint64_t)liveness->config.tick_ms * 1000000ULL;
+    
+    timer_unlink(&drone->timer);
+    timer_schedule(liveness, &drone->timer, (deadline_ns + tick_ns - 1) / tick_ns);
+}
+
+network_result_t liveness_heartbeat(liveness_t* liveness, const char* drone_id,
+                                    uint32_t sequence, uint32_t interval_ms, uint64_t now_ns) {
+    if (!liveness || !drone_id) return NET_ERROR;
+    
+    pthread_mutex_lock(&liveness->lock);
+    
+    if (!liveness->started) {
+        liveness->current_tick = to_tick(liveness, now_ns);
+        liveness->started = 1;
+    }
+    
+    liveness_drone_t* drone = find_drone(liveness, drone_id, 1);
+    if (!drone) {
+        pthread_mutex_unlock(&liveness->lock);
+        return NET_ERROR;
+    }
+    
+    if (drone->heartbeats > 0) {
+        if (now_ns > drone->last_heartbeat_ns) {
+            // Observed spacing per heartbeat sent, so losses don't inflate it
+            uint32_t sent = sequence - drone->last_sequence;
+            if (sent == 0 || sent > 0x7FFFFFFF) sent = 1;
+            double observed_ms = (double)(now_ns - drone->last_heartbeat_ns) / 1e6 / sent;
+            drone->mean_interval_ms += (observed_ms - drone->mean_interval_ms) / 8.0;
+            drone->missed += sent - 1;
+            liveness->stats.missed_heartbeats += sent - 1;
+        }
+    } else if (interval_ms) {
+        drone->mean_interval_ms = interval_ms;
+    }
+    
+    drone->last_heartbeat_ns = now_ns;
+    drone->last_sequence = sequence;
+    drone->heartbeats++;
+    liveness->stats.heartbeats++;
+    
+    change_state(liveness, drone, LIVENESS_ALIVE);
+    arm_timer(liveness, drone);
+    
+    pthread_mutex_unlock(&liveness->lock);
+    return NET_SUCCESS;
+}
+
+network_result_t liveness_handle_message(liveness_t* liveness, const message_view_t* view,
+                                         uint64_t now_ns) {
+    if (!liveness || !view || view->type != MSG_HEARTBEAT) return NET_ERROR;
+    
+    const heartbeat_message_t* heartbeat = view->as.heartbeat;
+    char drone_id[MAX_DRONE_ID];
+    memcpy(drone_id, heartbeat->header.drone_id, MAX_DRONE_ID);
+    drone_id[MAX_DRONE_ID - 1] = '\0';
+    
+    return liveness_heartbeat(liveness, drone_id, heartbeat->sequence,
+                              heartbeat->interval_ms, now_ns);
+}
+
+// Caller holds liveness->lock
+static int expire_timer(liveness_t* liveness, liveness_drone_t* drone) {
+    liveness->stats.timers_fired++;
+    
+    if (drone->state == LIVENESS_ALIVE) {
+        change_state(liveness, drone, LIVENESS_SUSPECT);
+        arm_timer(liveness, drone);
+        return 1;
+    }
+    if (drone->state == LIVENESS_SUSPECT) {
+        change_state(liveness, drone, LIVENESS_DEAD); // No timer until it speaks again
+        return 1;
+    }
+    return 0;
+}
+
+// Caller holds liveness->lock. Move a higher-level slot's timers down.
+static void cascade(liveness_t* liveness, int level) {
+    unsigned slot = (unsigned)(liveness->current_tick >> (LIVENESS_WHEEL_BITS * level)) &
+                    (LIVENESS_WHEEL_SLOTS - 1);
+    liveness_timer_t* head = &liveness->wheel[level][slot];
+    
+    liveness_timer_t pending;
+    if (head->next == head) return;
+    pending.next = head->next;
+    pending.prev = head->prev;
+    pending.next->prev = &pending;
+    pending.prev->next = &pending;
+    list_init(head);
+    
+    while (pending.next != &pending) {
+        liveness_timer_t* timer = pending.next;
+        timer_unlink(timer);
+        timer_schedule(liveness, timer, timer->expires_tick);
+    }
+}
+
+int liveness_advance(liveness_t* liveness, uint64_t now_ns) {
+    if (!liveness) return 0;
+    
+    int changes = 0;
+    pthread_mutex_lock(&liveness->lock);
+    
+    uint64_t target = to_tick(liveness, now_ns);
+    if (!liveness->started) {
+        liveness->current_tick = target;
+        liveness->started = 1;
+    }
+    
+    while (liveness->current_tick < target) {
+        liveness->current_tick++;
+        
+        // Refill lower levels whenever their index wraps
+        for (int level = 1; level < LIVENESS_WHEEL_LEVELS; level++) {
+            uint64_t mask = (1ULL << (LIVENESS_WHEEL_BITS * level)) - 1;
+            if (liveness->current_tick & mask) break;
+            cascade(liveness, level);
+        }
+        
+        liveness_timer_t* head =
+            &liveness->wheel[0][liveness->current_tick & (LIVENESS_WHEEL_SLOTS - 1)];
+        while (head->next != head) {
+            liveness_timer_t* timer = head->next;
+            timer_unlink(timer);
+            if (timer->expires_tick > liveness->current_tick) {
+                timer_schedule(liveness, timer, timer->expires_tick); // Parked far timer
+                continue;
+            }
+            changes += expire_timer(liveness, (liveness_drone_t*)timer);
+        }
+    }
+    
+    pthread_mutex_unlock(&liveness->lock);
+    return changes;
+}
+
+liveness_state_t liveness_get_state(liveness_t* liveness, const char* drone_id) {
+    if (!liveness || !drone_id) return LIVENESS_UNKNOWN;
+    
+    pthread_mutex_lock(&liveness->lock);
+    liveness_drone_t* drone = find_drone(liveness, drone_id, 0);
+    liveness_state_t state = drone ? drone->state : LIVENESS_UNKNOWN;
+    pthread_mutex_unlock(&liveness->lock);
+    
+    return state;
+}
+
+double liveness_phi(liveness_t* liveness, const char* drone_id, uint64_t now_ns) {
+    if (!liveness || !drone_id) return -1;
+    
+    pthread_mutex_lock(&liveness->lock);
+    liveness_drone_t* drone = find_drone(liveness, drone_id, 0);
+    double phi = -1;
+    if (drone && drone->heartbeats > 0) {
+        double elapsed_ms = now_ns > drone->last_heartbeat_ns
+                          ? (double)(now_ns - drone->last_heartbeat_ns) / 1e6 : 0.0;
+        phi = elapsed_ms / (drone->mean_interval_ms * LN10);
+    }
+    pthread_mutex_unlock(&liveness->lock);
+    
+    return phi;
+}
+
+void liveness_get_stats(liveness_t* liveness, liveness_stats_t* stats) {
+    if (!liveness || !stats) return;
+    
+    pthread_mutex_lock(&liveness->lock);
+    *stats = liveness->stats;
+    pthread_mutex_unlock(&liveness->lock);
+}
+
+void liveness_cleanup(liveness_t* liveness) {
+    if (!liveness) return;
+    
+    if (liveness->max_drones) {
+        pthread_mutex_destroy(&liveness->lock);
+    }
+    free(liveness->drones);
+    drone_index_free(&liveness->index);
+    free(liveness);
+}
+
+network_result_t liveness_send_heartbeat(udp_context_t* context, const char* drone_id,
+                                         uint32_t sequence, uint32_t interval_ms,
+                                         int state, float battery_level) {
+    if (!context || !drone_id) return NET_ERROR;
+    
+    heartbeat_message_t heartbeat;
+    memset(&heartbeat, 0, sizeof(heartbeat));
+    init_message_header(&heartbeat.header, MSG_HEARTBEAT, drone_id);
+    heartbeat.header.payload_length = sizeof(heartbeat_message_t) - sizeof(message_header_t);
+    heartbeat.sequence = sequence;
+    heartbeat.interval_ms = interval_ms;
+    heartbeat.state = state;
+    heartbeat.battery_level = battery_level;
+    
+    return udp_send_message(context, &heartbeat.header, sizeof(heartbeat));
+}
@@ -0,0 +1,133 @@
+// src/communication/liveness.h
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
+#include "common.h"
+#include "udp_comm.h"
+#include "../core/drone_index.h"
+
+// Heartbeat tracking and failure detection for large fleets.
+//
+// Every tracked drone owns one timer on a hierarchical timing wheel
+// (4 levels of 64 slots). A heartbeat unlinks the drone's timer and links
+// it again at its new deadline, both O(1); advancing the wheel only touches
+// timers that actually expire, so there is no periodic scan of the fleet.
+//
+// Suspicion follows the exponential phi-accrual approximation: with a mean
+// heartbeat interval m, the time since the last heartbeat t gives
+// phi = t / (m * ln 10). A drone becomes SUSPECT when phi crosses
+// phi_suspect and DEAD at phi_dead; both deadlines are computed when the
+// heartbeat arrives and capped at max_detection_ms, which bounds detection
+// time regardless of how irregular a drone's history has been.
+
+#define LIVENESS_WHEEL_LEVELS 4
+#define LIVENESS_WHEEL_BITS 6
+#define LIVENESS_WHEEL_SLOTS (1 << LIVENESS_WHEEL_BITS)
+#define LIVENESS_DEFAULT_TICK_MS 10
+#define LIVENESS_DEFAULT_INTERVAL_MS 1000
+#define LIVENESS_DEFAULT_PHI_SUSPECT 2.0    // About 4.6 mean intervals
+#define LIVENESS_DEFAULT_PHI_DEAD 4.0       // About 9.2 mean intervals
+#define LIVENESS_DEFAULT_MAX_DETECTION_MS 10000
+
+typedef enum {
+    LIVENESS_UNKNOWN,
+    LIVENESS_ALIVE,
+    LIVENESS_SUSPECT,
+    LIVENESS_DEAD
+} liveness_state_t;
+
+// Called (with the liveness lock held) whenever a drone changes state
+typedef void (*liveness_callback_t)(const char* drone_id, liveness_state_t old_state,
+                                    liveness_state_t new_state, void* user_data);
+
+// Timer wheel link, embedded in each drone record
+typedef struct liveness_timer {
+    struct liveness_timer* next;
+    struct liveness_timer* prev;
+    uint64_t expires_tick;
+} liveness_timer_t;
+
+typedef struct {
+    liveness_timer_t timer;     // First member: timer pointer == drone pointer
+    char drone_id[MAX_DRONE_ID];
+    liveness_state_t state;
+    uint64_t last_heartbeat_ns;
+    double mean_interval_ms;    // EWMA of observed heartbeat spacing
+    uint32_t last_sequence;
+    unsigned long heartbeats;
+    unsigned long missed;       // Sequence gaps
+} liveness_drone_t;
+
+typedef struct {
+    double phi_suspect;
+    double phi_dead;
+    unsigned int tick_ms;
+    unsigned int default_interval_ms;   // Until a drone reports or shows its own
+    unsigned int max_detection_ms;
+} liveness_config_t;
+
+typedef struct {
+    unsigned long tracked;
+    unsigned long heartbeats;
+    unsigned long missed_heartbeats;
+    unsigned long timers_fired;
+    unsigned long suspected;
+    unsigned long declared_dead;
+    unsigned long recovered;
+} liveness_stats_t;
+
+typedef struct {
+    liveness_config_t config;
+    liveness_drone_t* drones;
+    size_t drone_count;
+    size_t max_drones;
+    drone_index_t index;
+    liveness_timer_t wheel[LIVENESS_WHEEL_LEVELS][LIVENESS_WHEEL_SLOTS]; // List heads
+    uint64_t current_tick;
+    int started;
+    liveness_callback_t on_change;
+    void* user_data;
+    liveness_stats_t stats;
+    pthread_mutex_t lock;
+} liveness_t;
+
+// Fill a configuration with the defaults above
+void liveness_default_config(liveness_config_t* config);
+
+// Create a detector for up to max_drones (config may be NULL for defaults)
+liveness_t* liveness_init(size_t max_drones, const liveness_config_t* config,
+                          liveness_callback_t on_change, void* user_data);
+
+// Record a heartbeat at now_ns (CLOCK_MONOTONIC). Unknown drones are
+// tracked from their first heartbeat. interval_ms 0 if not announced.
+network_result_t liveness_heartbeat(liveness_t* liveness, const char* drone_id,
+                                    uint32_t sequence, uint32_t interval_ms, uint64_t now_ns);
+
+// Feed a received MSG_HEARTBEAT
+network_result_t liveness_handle_message(liveness_t* liveness, const message_view_t* view,
+                                         uint64_t now_ns);
+
+// Run expired timers up to now_ns; returns the number of state changes
+int liveness_advance(liveness_t* liveness, uint64_t now_ns);
+
+// Current state of a drone (LIVENESS_UNKNOWN if not tracked)
+liveness_state_t liveness_get_state(liveness_t* liveness, const char* drone_id);
+
+// Current suspicion level of a drone (-1 if not tracked)
+double liveness_phi(liveness_t* liveness, const char* drone_id, uint64_t now_ns);
+
+// Snapshot counters
+void liveness_get_stats(liveness_t* liveness, liveness_stats_t* stats);
+
+// Name of a state for logs
+const char* liveness_state_name(liveness_state_t state);
+
+// Free the detector
+void liveness_cleanup(liveness_t* liveness);
+
+// Send a heartbeat from drone_id to the context's server
+network_result_t liveness_send_heartbeat(udp_context_t* context, const char* drone_id,
+                                         uint32_t sequence, uint32_t interval_ms,
+                                         int state, float battery_level);
+
+#endif
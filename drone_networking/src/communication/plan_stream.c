@@ -0,0 +1,262 @@
+// src/communication/plan_stream.c
+#include "plan_stream.h"
+#include "../core/log.h"
+#include <stddef.h>
+
+_Static_assert(sizeof(plan_chunk_message_t) <= UDP_COALESCE_MTU,
+               "a full plan chunk must fit one unfragmented datagram");
+
+plan_sender_t* plan_sender_start(udp_context_t* udp, const char* local_id, uint32_t plan_id,
+                                 const char* building_name, int32_t building_type,
+                                 const plan_component_t* components, uint32_t count,
+                                 uint32_t window) {
+    if (!udp || !local_id || !components || count == 0) return NULL;
+    if (count > PLAN_MAX_COMPONENTS) {
+        LOG_ERROR("Plan %u has %u components, limit is %u", plan_id, count, PLAN_MAX_COMPONENTS);
+        return NULL;
+    }
+    
+    plan_sender_t* sender = (plan_sender_t*)malloc(sizeof(plan_sender_t));
+    if (!sender) return NULL;
+    
+    memset(sender, 0, sizeof(plan_sender_t));
+    sender->total_chunks = (count + PLAN_COMPONENTS_PER_CHUNK - 1) / PLAN_COMPONENTS_PER_CHUNK;
+    sender->chunks = (plan_chunk_state_t*)calloc(sender->total_chunks, sizeof(plan_chunk_state_t));
+    if (!sender->chunks) {
+        free(sender);
+        return NULL;
+    }
+    
+    sender->udp = udp;
+    strncpy(sender->local_id, local_id, MAX_DRONE_ID - 1);
+    sender->plan_id = plan_id;
+    sender->building_type = building_type;
+    if (building_name) {
+        strncpy(sender->building_name, building_name, sizeof(sender->building_name) - 1);
+    }
+    sender->components = components;
+    sender->total_components = count;
+    sender->window = window ? window : PLAN_STREAM_DEFAULT_WINDOW;
+    
+    LOG_INFO("Streaming plan %u: %u components in %u chunks",
+             plan_id, count, sender->total_chunks);
+    return sender;
+}
+
+static network_result_t send_chunk(plan_sender_t* sender, uint32_t index) {
+    plan_chunk_message_t chunk;
+    uint32_t first = index * PLAN_COMPONENTS_PER_CHUNK;
+    uint32_t count = sender->total_components - first;
+    if (count > PLAN_COMPONENTS_PER_CHUNK) count = PLAN_COMPONENTS_PER_CHUNK;
+    
+    init_message_header(&chunk.header, MSG_PLAN_CHUNK, sender->local_id);
+    chunk.plan_id = sender->plan_id;
+    chunk.chunk_index = index;
+    chunk.total_chunks = sender->total_chunks;
+    chunk.total_components = sender->total_components;
+    chunk.component_count = (uint16_t)count;
+    chunk.reserved = 0;
+    chunk.building_type = sender->building_type;
+    memcpy(chunk.building_name, sender->building_name, sizeof(chunk.building_name));
+    memcpy(chunk.components, sender->components + first, count * sizeof(plan_component_t));
+    
+    size_t length = offsetof(plan_chunk_message_t, components) + count * sizeof(plan_component_t);
+    chunk.header.payload_length = (uint32_t)(length - sizeof(message_header_t));
+    
+    network_result_t result = udp_send_message(sender->udp, &chunk.header, length);
+    
+    plan_chunk_state_t* state = &sender->chunks[index];
+    if (state->sent) {
+        sender->chunks_retransmitted++;
+    }
+    state->sent = 1;
+    state->last_sent_ns = network_monotonic_ns();
+    sender->chunks_sent++;
+    return result;
+}
+
+network_result_t plan_sender_pump(plan_sender_t* sender) {
+    if (!sender) return NET_ERROR;
+    
+    uint64_t now = network_monotonic_ns();
+    uint64_t timeout_ns = (uint64_t)PLAN_STREAM_RETRANSMIT_MS * 1000000ULL;
+    uint32_t end = sender->base + sender->window;
+    if (end > sender->total_chunks) end = sender->total_chunks;
+    
+    for (uint32_t i = sender->base; i < end; i++) {
+        plan_chunk_state_t* state = &sender->chunks[i];
+        if (state->acknowledged) continue;
+        
+        if (!state->sent || now - state->last_sent_ns >= timeout_ns) {
+            network_result_t result = send_chunk(sender, i);
+            if (result != NET_SUCCESS) return result;
+        }
+    }
+    
+    return NET_SUCCESS;
+}
+
+void plan_sender_handle_ack(plan_sender_t* sender, const plan_ack_message_t* ack) {
+    if (!sender || !ack || ack->plan_id != sender->plan_id) return;
+    
+    uint32_t contiguous = ack->contiguous_chunks;
+    if (contiguous > sender->total_chunks) contiguous = sender->total_chunks;
+    
+    for (uint32_t i = sender->base; i < contiguous; i++) {
+        sender->chunks[i].acknowledged = 1;
+    }
+    
+    int highest_selective = -1;
+    for (int bit = 0; bit < 64; bit++) {
+        uint32_t index = contiguous + 1 + (uint32_t)bit;
+        if (index >= sender->total_chunks) break;
+        if ((ack->chunk_bitmap >> bit) & 1) {
+            sender->chunks[index].acknowledged = 1;
+            highest_selective = (int)index;
+        }
+    }
+    
+    // Later chunks arrived but the one at the contiguous point did not:
+    // resend it on the next pump instead of waiting for the timeout
+    if (highest_selective >= 0 && contiguous < sender->total_chunks &&
+        !sender->chunks[contiguous].acknowledged) {
+        sender->chunks[contiguous].last_sent_ns = 0;
+    }
+    
+    while (sender->base < sender->total_chunks && sender->chunks[sender->base].acknowledged) {
+        sender->base++;
+    }
+}
+
+int plan_sender_is_complete(const plan_sender_t* sender) {
+    return sender && sender->base >= sender->total_chunks;
+}
+
+void plan_sender_cleanup(plan_sender_t* sender) {
+    if (sender) {
+        free(sender->chunks);
+        free(sender);
+    }
+}
+
+void plan_receiver_init(plan_receiver_t* receiver, const char* local_id,
+                        plan_component_handler_t handler, void* user_data) {
+    if (!receiver) return;
+    
+    memset(receiver, 0, sizeof(plan_receiver_t));
+    if (local_id) {
+        strncpy(receiver->local_id, local_id, MAX_DRONE_ID - 1);
+    }
+    receiver->on_component = handler;
+    receiver->user_data = user_data;
+}
+
+static int start_transfer(plan_receiver_t* receiver, const plan_chunk_message_t* chunk) {
+    uint32_t expected_chunks = (chunk->total_components + PLAN_COMPONENTS_PER_CHUNK - 1) /
+                               PLAN_COMPONENTS_PER_CHUNK;
+    if (chunk->total_components == 0 || chunk->total_chunks != expected_chunks) return -1;
+    if (chunk->total_components > PLAN_MAX_COMPONENTS) {
+        LOG_WARN("Rejecting plan %u: %u components, limit is %u",
+                 chunk->plan_id, chunk->total_components, PLAN_MAX_COMPONENTS);
+        return -1;
+    }
+    
+    plan_receiver_cleanup(receiver);
+    
+    receiver->received = (unsigned char*)calloc(chunk->total_chunks, 1);
+    receiver->components = (plan_component_t*)malloc(chunk->total_components *
+                                                     sizeof(plan_component_t));
+    if (!receiver->received || !receiver->components) {
+        plan_receiver_cleanup(receiver);
+        return -1;
+    }
+    
+    receiver->plan_id = chunk->plan_id;
+    receiver->started = 1;
+    receiver->building_type = chunk->building_type;
+    memcpy(receiver->building_name, chunk->building_name, sizeof(receiver->building_name));
+    receiver->building_name[sizeof(receiver->building_name) - 1] = '\0';
+    receiver->total_components = chunk->total_components;
+    receiver->total_chunks = chunk->total_chunks;
+    receiver->contiguous_chunks = 0;
+    
+    LOG_INFO("Receiving plan %u (%s): %u components",
+             receiver->plan_id, receiver->building_name, receiver->total_components);
+    return 0;
+}
+
+static void fill_ack(const plan_receiver_t* receiver, plan_ack_message_t* ack) {
+    memset(ack, 0, sizeof(plan_ack_message_t));
+    init_message_header(&ack->header, MSG_PLAN_ACK, receiver->local_id);
+    ack->header.payload_length = sizeof(plan_ack_message_t) - sizeof(message_header_t);
+    ack->plan_id = receiver->plan_id;
+    ack->contiguous_chunks = receiver->contiguous_chunks;
+    
+    for (int bit = 0; bit < 64; bit++) {
+        uint32_t index = receiver->contiguous_chunks + 1 + (uint32_t)bit;
+        if (index >= receiver->total_chunks) break;
+        if (receiver->received[index]) {
+            ack->chunk_bitmap |= 1ULL << bit;
+        }
+    }
+}
+
+int plan_receiver_handle_chunk(plan_receiver_t* receiver, const plan_chunk_message_t* chunk,
+                               size_t length, plan_ack_message_t* ack) {
+    if (!receiver || !chunk || !ack) return -1;
+    if (length < offsetof(plan_chunk_message_t, components)) return -1;
+    
+    if (!receiver->started || chunk->plan_id != receiver->plan_id) {
+        // Serial-number order, so plan ids may wrap
+        if (receiver->started && (int32_t)(chunk->plan_id - receiver->plan_id) < 0) return -1;
+        if (start_transfer(receiver, chunk) != 0) return -1;
+    }
+    
+    uint32_t index = chunk->chunk_index;
+    uint32_t first = index * PLAN_COMPONENTS_PER_CHUNK;
+    if (index >= receiver->total_chunks ||
+        chunk->total_components != receiver->total_components) {
+        return -1;
+    }
+    
+    uint32_t expected = receiver->total_components - first;
+    if (expected > PLAN_COMPONENTS_PER_CHUNK) expected = PLAN_COMPONENTS_PER_CHUNK;
+    if (chunk->component_count != expected ||
+        length < offsetof(plan_chunk_message_t, components) + expected * sizeof(plan_component_t)) {
+        return -1;
+    }
+    
+    if (!receiver->received[index]) {
+        memcpy(receiver->components + first, chunk->components,
+               expected * sizeof(plan_component_t));
+        receiver->received[index] = 1;
+        
+        // Release every component that is now part of the contiguous prefix
+        while (receiver->contiguous_chunks < receiver->total_chunks &&
+               receiver->received[receiver->contiguous_chunks]) {
+            uint32_t start = receiver->contiguous_chunks * PLAN_COMPONENTS_PER_CHUNK;
+            uint32_t stop = start + PLAN_COMPONENTS_PER_CHUNK;
+            if (stop > receiver->total_components) stop = receiver->total_components;
+            
+            if (receiver->on_component) {
+                for (uint32_t c = start; c < stop; c++) {
+                    receiver->on_component(&receiver->components[c], c, receiver->user_data);
+                }
+            }
+            receiver->contiguous_chunks++;
+        }
+    }
+    
+    fill_ack(receiver, ack);
+    return receiver->contiguous_chunks == receiver->total_chunks ? 1 : 0;
+}
+
+void plan_receiver_cleanup(plan_receiver_t* receiver) {
+    if (receiver) {
+        free(receiver->received);
+        free(receiver->components);
+        receiver->received = NULL;
+        receiver->components = NULL;
+        receiver->started = 0;
+    }
+}
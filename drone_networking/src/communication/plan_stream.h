@@ -0,0 +1,102 @@
+// src/communication/plan_stream.h
+#ifndef PLAN_STREAM_H
+#define PLAN_STREAM_H
+
+#include "common.h"
+#include "udp_comm.h"
+
+// Streaming transfer of large building plans over UDP.
+//
+// The sender splits the plan into PLAN_COMPONENTS_PER_CHUNK-component chunks
+// and keeps up to `window` of them in flight. The receiver hands components
+// to the application in order as soon as a contiguous prefix of chunks has
+// arrived, buffers out-of-order chunks, and reports progress with a
+// cumulative count plus a bitmap. Lost chunks are resent from the last
+// contiguous point; nothing that already arrived is sent again.
+//
+// Plan ids increase per transfer. A chunk of a newer plan restarts the
+// receiver; chunks of older plans (late retransmissions) are ignored.
+//
+// The receiver sizes its buffers from the first chunk, so plans are capped
+// at PLAN_MAX_COMPONENTS (about 29 MB buffered); larger announcements are
+// rejected on both sides.
+
+#define PLAN_STREAM_DEFAULT_WINDOW 48     // About 64 KB in flight
+#define PLAN_STREAM_RETRANSMIT_MS 250
+#define PLAN_MAX_COMPONENTS (1u << 18)
+
+typedef struct {
+    uint64_t last_sent_ns;
+    int sent;
+    int acknowledged;
+} plan_chunk_state_t;
+
+// Sender side of one plan transfer
+typedef struct {
+    udp_context_t* udp;
+    char local_id[MAX_DRONE_ID];
+    uint32_t plan_id;
+    int32_t building_type;
+    char building_name[64];
+    const plan_component_t* components; // Caller-owned, must outlive the transfer
+    uint32_t total_components;
+    uint32_t total_chunks;
+    uint32_t window;
+    uint32_t base;                      // First unacknowledged chunk
+    plan_chunk_state_t* chunks;
+    unsigned long chunks_sent;
+    unsigned long chunks_retransmitted;
+} plan_sender_t;
+
+// Called in plan order for each component as soon as it can be executed
+typedef void (*plan_component_handler_t)(const plan_component_t* component,
+                                         uint32_t index, void* user_data);
+
+// Receiver side of one plan transfer
+typedef struct {
+    char local_id[MAX_DRONE_ID];
+    uint32_t plan_id;
+    int started;
+    int32_t building_type;
+    char building_name[64];
+    uint32_t total_components;
+    uint32_t total_chunks;
+    uint32_t contiguous_chunks;         // Chunks delivered to the handler
+    unsigned char* received;            // One flag per chunk
+    plan_component_t* components;       // Buffered components
+    plan_component_handler_t on_component;
+    void* user_data;
+} plan_receiver_t;
+
+// Start sending a plan; returns NULL on error or past PLAN_MAX_COMPONENTS
+plan_sender_t* plan_sender_start(udp_context_t* udp, const char* local_id, uint32_t plan_id,
+                                 const char* building_name, int32_t building_type,
+                                 const plan_component_t* components, uint32_t count,
+                                 uint32_t window);
+
+// Send new chunks that fit the window and resend timed-out ones
+network_result_t plan_sender_pump(plan_sender_t* sender);
+
+// Apply a receiver progress report
+void plan_sender_handle_ack(plan_sender_t* sender, const plan_ack_message_t* ack);
+
+// Check whether every chunk has been acknowledged
+int plan_sender_is_complete(const plan_sender_t* sender);
+
+// Free a sender
+void plan_sender_cleanup(plan_sender_t* sender);
+
+// Initialize a receiver that accepts the next plan transfer
+void plan_receiver_init(plan_receiver_t* receiver, const char* local_id,
+                        plan_component_handler_t handler, void* user_data);
+
+// Process a chunk and fill in the progress report to send back.
+// Returns 1 once the plan is complete, 0 while in progress, -1 on error
+// or for a chunk of an earlier plan (no report is filled in).
+int plan_receiver_handle_chunk(plan_receiver_t* receiver, const plan_chunk_message_t* chunk,
+                               size_t length, plan_ack_message_t* ack);
+
+// Free buffers held by a receiver
+void plan_receiver_cleanup(plan_receiver_t* receiver);
+
+#endif
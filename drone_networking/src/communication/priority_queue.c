@@ -0,0 +1,384 @@
+// src/communication/priority_queue.c
+#include "priority_queue.h"
+#include "../core/buffer_pool.h"
+#include <stddef.h>
+
+static const char* const class_names[QUEUE_CLASS_COUNT] = {
+    "Emergency", "Control", "Telemetry", "Bulk"
+};
+
+priority_queue_t* priority_queue_init(size_t capacity_per_class) {
+    priority_queue_t* queue = (priority_queue_t*)calloc(1, sizeof(priority_queue_t));
+    if (!queue) return NULL;
+    
+    // Before anything that can fail, so cleanup always has them to destroy
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    
+    if (capacity_per_class == 0) {
+        capacity_per_class = PRIORITY_QUEUE_DEFAULT_CAPACITY;
+    }
+    
+    for (int c = 0; c < QUEUE_CLASS_COUNT; c++) {
+        queue_ring_t* ring = &queue->rings[c];
+        ring->entries = (queue_entry_t*)calloc(capacity_per_class, sizeof(queue_entry_t));
+        if (!ring->entries) {
+            priority_queue_cleanup(queue);
+            return NULL;
+        }
+        ring->capacity = capacity_per_class;
+        latency_histogram_init(&ring->stats.queue_delay);
+    }
+    
+    return queue;
+}
+
+queue_class_t priority_queue_classify(const void* message, size_t length) {
+    if (!message || length < sizeof(message_header_t)) return QUEUE_CLASS_BULK;
+    
+    const message_header_t* header = (const message_header_t*)message;
+    switch ((message_type_t)header->message_type) {
+        case MSG_COMMAND:
+            if (length >= offsetof(command_message_t, payload)) {
+                int priority;
+                memcpy(&priority, (const unsigned char*)message +
+                       offsetof(command_message_t, priority), sizeof(priority));
+                if (priority >= COMMAND_PRIORITY_EMERGENCY) return QUEUE_CLASS_EMERGENCY;
+            }
+            return QUEUE_CLASS_CONTROL;
+        case MSG_STATUS_UPDATE:
+            if (length >= sizeof(status_update_message_t)) {
+                int state;
+                memcpy(&state, (const unsigned char*)message +
+                       offsetof(status_update_message_t, state), sizeof(state));
+                if (state == DRONE_STATE_EMERGENCY_LANDING) return QUEUE_CLASS_EMERGENCY;
+            }
+            return QUEUE_CLASS_TELEMETRY;
+        case MSG_HEARTBEAT:
+        case MSG_ERROR:
+        case MSG_ACKNOWLEDGMENT:
+        case MSG_PLAN_ACK:
+        case MSG_CLOCK_SYNC:
+        case MSG_SESSION_HELLO:
+            return QUEUE_CLASS_CONTROL;
+        case MSG_BUILDING_PLAN:
+        case MSG_PLAN_CHUNK:
+            return QUEUE_CLASS_BULK;
+    }
+    return QUEUE_CLASS_BULK;
+}
+
+static queue_entry_t* ring_at(queue_ring_t* ring, size_t index) {
+    return &ring->entries[(ring->head + index) % ring->capacity];
+}
+
+// Caller holds queue->lock. The queued status update from the same drone
+// as message, if any.
+static queue_entry_t* find_status(queue_ring_t* ring, const void* message) {
+    const message_header_t* incoming = (const message_header_t*)message;
+    if (incoming->message_type != MSG_STATUS_UPDATE) return NULL;
+    
+    for (size_t i = 0; i < ring->count; i++) {
+        queue_entry_t* entry = ring_at(ring, i);
+        const message_header_t* queued = (const message_header_t*)entry->data;
+        if (queued->message_type == MSG_STATUS_UPDATE &&
+            strncmp(queued->drone_id, incoming->drone_id, MAX_DRONE_ID) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Caller holds queue->lock. Status updates from the same drone supersede
+// each other, so overwrite the queued one and keep its place in line.
+static int merge_status(queue_ring_t* ring, const void* message, size_t length) {
+    queue_entry_t* entry = find_status(ring, message);
+    if (!entry) return 0;
+    
+    memcpy(entry->data, message, length);
+    entry->length = length;
+    ring->stats.merged++;
+    return 1;
+}
+
+network_result_t priority_queue_push_class(priority_queue_t* queue, queue_class_t queue_class,
+                                           const void* message, size_t length) {
+    if (!queue || !message || (unsigned)queue_class >= QUEUE_CLASS_COUNT) return NET_ERROR;
+    if (length < sizeof(message_header_t) || length > BUFFER_POOL_BUFFER_SIZE) return NET_ERROR;
+    
+    queue_ring_t* ring = &queue->rings[queue_class];
+    
+    pthread_mutex_lock(&queue->lock);
+    
+    if (queue_class == QUEUE_CLASS_TELEMETRY && merge_status(ring, message, length)) {
+        pthread_mutex_unlock(&queue->lock);
+        return NET_SUCCESS;
+    }
+    
+    if (ring->count + ring->in_flight >= ring->capacity) {
+        if (queue_class != QUEUE_CLASS_TELEMETRY || ring->count == 0) {
+            ring->stats.rejected++;
+            pthread_mutex_unlock(&queue->lock);
+            return NET_TIMEOUT;
+        }
+        // Oldest telemetry is the least useful; make room for the new one
+        queue_entry_t* oldest = ring_at(ring, 0);
+        buffer_pool_release(oldest->data);
+        ring->head = (ring->head + 1) % ring->capacity;
+        ring->count--;
+        ring->stats.dropped++;
+    }
+    
+    void* data = buffer_pool_acquire();
+    if (!data) {
+        ring->stats.rejected++;
+        pthread_mutex_unlock(&queue->lock);
+        return NET_ERROR;
+    }
+    memcpy(data, message, length);
+    
+    queue_entry_t* entry = ring_at(ring, ring->count);
+    entry->data = data;
+    entry->length = length;
+    entry->enqueued_ns = network_monotonic_ns();
+    ring->count++;
+    
+    ring->stats.enqueued++;
+    ring->stats.depth = ring->count;
+    if (ring->count > ring->stats.high_water) {
+        ring->stats.high_water = ring->count;
+    }
+    
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+    return NET_SUCCESS;
+}
+
+network_result_t priority_queue_push(priority_queue_t* queue, const void* message, size_t length) {
+    return priority_queue_push_class(queue, priority_queue_classify(message, length),
+                                     message, length);
+}
+
+// Caller holds queue->lock
+static queue_ring_t* next_ring(priority_queue_t* queue) {
+    if (queue->rings[QUEUE_CLASS_EMERGENCY].count) return &queue->rings[QUEUE_CLASS_EMERGENCY];
+    if (queue->rings[QUEUE_CLASS_CONTROL].count) return &queue->rings[QUEUE_CLASS_CONTROL];
+    
+    queue_ring_t* telemetry = &queue->rings[QUEUE_CLASS_TELEMETRY];
+    queue_ring_t* bulk = &queue->rings[QUEUE_CLASS_BULK];
+    if (!telemetry->count) return bulk->count ? bulk : NULL;
+    if (!bulk->count) return telemetry;
+    
+    // Both waiting: give bulk a fixed share so plan uploads cannot starve
+    return (queue->low_priority_turn++ % PRIORITY_QUEUE_BULK_SHARE) == 0 ? bulk : telemetry;
+}
+
+// Caller holds queue->lock. Unlinks the head entry; its buffer now
+// belongs to the caller.
+static queue_entry_t ring_take_head(queue_ring_t* ring) {
+    queue_entry_t* head = ring_at(ring, 0);
+    queue_entry_t entry = *head;
+    latency_histogram_record(&ring->stats.queue_delay, network_monotonic_ns() - entry.enqueued_ns);
+    head->data = NULL;
+    
+    ring->head = (ring->head + 1) % ring->capacity;
+    ring->count--;
+    ring->stats.dequeued++;
+    ring->stats.depth = ring->count;
+    return entry;
+}
+
+// Caller holds queue->lock
+static void ring_remove_head(queue_ring_t* ring) {
+    buffer_pool_release(ring_take_head(ring).data);
+}
+
+// Caller holds queue->lock. Like ring_take_head, but the slot stays
+// reserved until ring_finish_send or ring_restore_head.
+static queue_entry_t ring_take_for_send(queue_ring_t* ring) {
+    ring->in_flight++;
+    return ring_take_head(ring);
+}
+
+// Caller holds queue->lock
+static void ring_finish_send(queue_ring_t* ring) {
+    ring->in_flight--;
+}
+
+// Caller holds queue->lock. Puts an entry whose send failed back in front
+// into the slot it kept. With merge set, a status update superseded
+// meanwhile is dropped instead.
+static void ring_restore_head(queue_ring_t* ring, const queue_entry_t* entry, int merge) {
+    ring->in_flight--;
+    ring->stats.dequeued--;
+    if (merge && find_status(ring, entry->data)) {
+        buffer_pool_release(entry->data);
+        ring->stats.merged++;
+        return;
+    }
+    
+    ring->head = (ring->head + ring->capacity - 1) % ring->capacity;
+    *ring_at(ring, 0) = *entry;
+    ring->count++;
+    ring->stats.depth = ring->count;
+}
+
+static void deadline_after(struct timespec* deadline, int timeout_ms) {
+    clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_sec += timeout_ms / 1000;
+    deadline->tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L) {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+network_result_t priority_queue_pop(priority_queue_t* queue, void* buffer, size_t buffer_size,
+                                    size_t* length, queue_class_t* queue_class, int timeout_ms) {
+    if (!queue || !buffer) return NET_ERROR;
+    
+    struct timespec deadline;
+    if (timeout_ms > 0) {
+        deadline_after(&deadline, timeout_ms);
+    }
+    
+    pthread_mutex_lock(&queue->lock);
+    
+    queue_ring_t* ring;
+    while (!(ring = next_ring(queue))) {
+        if (timeout_ms == 0) {
+            pthread_mutex_unlock(&queue->lock);
+            return NET_TIMEOUT;
+        }
+        if (timeout_ms < 0) {
+            pthread_cond_wait(&queue->not_empty, &queue->lock);
+        } else if (pthread_cond_timedwait(&queue->not_empty, &queue->lock, &deadline) == ETIMEDOUT) {
+            pthread_mutex_unlock(&queue->lock);
+            return NET_TIMEOUT;
+        }
+    }
+    
+    queue_entry_t* entry = ring_at(ring, 0);
+    if (entry->length > buffer_size) {
+        pthread_mutex_unlock(&queue->lock);
+        return NET_ERROR;
+    }
+    
+    memcpy(buffer, entry->data, entry->length);
+    if (length) {
+        *length = entry->length;
+    }
+    if (queue_class) {
+        *queue_class = (queue_class_t)(ring - queue->rings);
+    }
+    ring_remove_head(ring);
+    
+    pthread_mutex_unlock(&queue->lock);
+    return NET_SUCCESS;
+}
+
+int priority_queue_send(priority_queue_t* queue, udp_context_t* udp, int max_messages) {
+    if (!queue || !udp) return 0;
+    
+    int sent = 0;
+    queue_ring_t* sent_ring = NULL;     // Slot to release at the next lock
+    while (sent < max_messages) {
+        pthread_mutex_lock(&queue->lock);
+        if (sent_ring) {
+            ring_finish_send(sent_ring);
+            sent_ring = NULL;
+        }
+        queue_ring_t* ring = next_ring(queue);
+        if (!ring) {
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        
+        queue_entry_t entry = ring_take_for_send(ring);
+        pthread_mutex_unlock(&queue->lock);
+        
+        // Stamp the checksum in place and send straight from the taken buffer
+        message_header_t* header = (message_header_t*)entry.data;
+        size_t message_size = sizeof(message_header_t) + header->payload_length;
+        if (message_size > entry.length) {
+            message_size = entry.length;
+        }
+        header->checksum = calculate_message_checksum(entry.data, message_size);
+        
+        network_result_t result = network_send_data(udp->net_config, entry.data, message_size);
+        if (result != NET_SUCCESS) {
+            // Failed sends stay queued for the next call
+            pthread_mutex_lock(&queue->lock);
+            ring_restore_head(ring, &entry, ring == &queue->rings[QUEUE_CLASS_TELEMETRY]);
+            pthread_mutex_unlock(&queue->lock);
+            break;
+        }
+        buffer_pool_release(entry.data);
+        sent_ring = ring;
+        sent++;
+    }
+    if (sent_ring) {
+        pthread_mutex_lock(&queue->lock);
+        ring_finish_send(sent_ring);
+        pthread_mutex_unlock(&queue->lock);
+    }
+    
+    network_flush(udp->net_config);
+    return sent;
+}
+
+size_t priority_queue_depth(priority_queue_t* queue) {
+    if (!queue) return 0;
+    
+    pthread_mutex_lock(&queue->lock);
+    size_t depth = 0;
+    for (int c = 0; c < QUEUE_CLASS_COUNT; c++) {
+        depth += queue->rings[c].count;
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return depth;
+}
+
+void priority_queue_get_stats(priority_queue_t* queue, queue_class_t queue_class,
+                              queue_class_stats_t* stats) {
+    if (!queue || !stats || (unsigned)queue_class >= QUEUE_CLASS_COUNT) return;
+    
+    pthread_mutex_lock(&queue->lock);
+    *stats = queue->rings[queue_class].stats;
+    pthread_mutex_unlock(&queue->lock);
+}
+
+void priority_queue_print_stats(priority_queue_t* queue) {
+    if (!queue) return;
+    
+    printf("=== Priority Queues ===\n");
+    for (int c = 0; c < QUEUE_CLASS_COUNT; c++) {
+        pthread_mutex_lock(&queue->lock);
+        const queue_class_stats_t* stats = &queue->rings[c].stats;
+        printf("%s: enqueued=%lu dequeued=%lu merged=%lu dropped=%lu rejected=%lu "
+               "depth=%zu high_water=%zu\n",
+               class_names[c], stats->enqueued, stats->dequeued, stats->merged,
+               stats->dropped, stats->rejected, stats->depth, stats->high_water);
+        latency_histogram_print(&stats->queue_delay, "  Queue Delay");
+        pthread_mutex_unlock(&queue->lock);
+    }
+}
+
+void priority_queue_cleanup(priority_queue_t* queue) {
+    if (!queue) return;
+    
+    for (int c = 0; c < QUEUE_CLASS_COUNT; c++) {
+        queue_ring_t* ring = &queue->rings[c];
+        if (!ring->entries) continue;
+        while (ring->count) {
+            buffer_pool_release(ring_at(ring, 0)->data);
+            ring->head = (ring->head + 1) % ring->capacity;
+            ring->count--;
+        }
+        free(ring->entries);
+    }
+    
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->not_empty);
+    free(queue);
+}
@@ -0,0 +1,109 @@
+// src/communication/priority_queue.h
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include "common.h"
+#include "udp_comm.h"
+#include "../core/latency_histogram.h"
+
+// Multi-level message queues for the outbound and inbound paths.
+//
+// Outbound, udp_set_outbound_queue routes udp_send_message through a queue
+// and priority_queue_send drains it onto the socket. Inbound, a receive
+// thread pushes what it reads and workers take it with priority_queue_pop.
+//
+// Every message is classified on entry: emergency commands (and status
+// reports from a drone in EMERGENCY_LANDING), control traffic, telemetry
+// and bulk plan transfer each get their own bounded ring. Emergency and
+// control are served strictly first; telemetry and bulk share what is left
+// so a plan upload keeps moving under a telemetry flood. A newer status
+// update replaces one still queued for the same drone instead of queueing
+// behind it, and a full telemetry ring drops its oldest entry. Full
+// emergency, control and bulk rings push back on the caller (NET_TIMEOUT).
+//
+// A message taken for sending keeps its slot until the send completes, so
+// one whose send fails always fits back at the head of its ring.
+
+#define PRIORITY_QUEUE_DEFAULT_CAPACITY 256
+#define PRIORITY_QUEUE_BULK_SHARE 4         // Bulk gets 1 of every N low-priority slots
+
+typedef enum {
+    QUEUE_CLASS_EMERGENCY,
+    QUEUE_CLASS_CONTROL,
+    QUEUE_CLASS_TELEMETRY,
+    QUEUE_CLASS_BULK,
+    QUEUE_CLASS_COUNT
+} queue_class_t;
+
+// Queued message held in a buffer_pool buffer
+typedef struct {
+    void* data;
+    size_t length;
+    uint64_t enqueued_ns;
+} queue_entry_t;
+
+// Per-class counters
+typedef struct {
+    unsigned long enqueued;
+    unsigned long dequeued;
+    unsigned long merged;       // Replaced a queued status update in place
+    unsigned long dropped;      // Evicted as stale
+    unsigned long rejected;     // Refused because the ring was full
+    size_t depth;
+    size_t high_water;
+    latency_histogram_t queue_delay;
+} queue_class_stats_t;
+
+typedef struct {
+    queue_entry_t* entries;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    size_t in_flight;           // Taken by priority_queue_send, slot still held
+    queue_class_stats_t stats;
+} queue_ring_t;
+
+typedef struct priority_queue {
+    queue_ring_t rings[QUEUE_CLASS_COUNT];
+    unsigned int low_priority_turn;  // Telemetry/bulk interleave position
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+} priority_queue_t;
+
+// Create a queue with the given capacity per class (0 selects the default)
+priority_queue_t* priority_queue_init(size_t capacity_per_class);
+
+// Pick the class for a serialized message
+queue_class_t priority_queue_classify(const void* message, size_t length);
+
+// Copy a message into the queue under its own class
+network_result_t priority_queue_push(priority_queue_t* queue, const void* message, size_t length);
+
+// Copy a message into the queue under an explicit class
+network_result_t priority_queue_push_class(priority_queue_t* queue, queue_class_t queue_class,
+                                           const void* message, size_t length);
+
+// Take the most urgent message. timeout_ms < 0 waits forever, 0 polls.
+// NET_TIMEOUT when empty, NET_ERROR if the buffer is too small (message kept).
+network_result_t priority_queue_pop(priority_queue_t* queue, void* buffer, size_t buffer_size,
+                                    size_t* length, queue_class_t* queue_class, int timeout_ms);
+
+// Send up to max_messages in priority order, returns how many were sent.
+// The queue is not locked during the send itself; a message whose send
+// fails goes back to the head of its ring.
+int priority_queue_send(priority_queue_t* queue, udp_context_t* udp, int max_messages);
+
+// Messages waiting across all classes
+size_t priority_queue_depth(priority_queue_t* queue);
+
+// Snapshot one class's counters
+void priority_queue_get_stats(priority_queue_t* queue, queue_class_t queue_class,
+                              queue_class_stats_t* stats);
+
+// Print counters and queueing delay per class
+void priority_queue_print_stats(priority_queue_t* queue);
+
+// Free queued messages and the queue
+void priority_queue_cleanup(priority_queue_t* queue);
+
+#endif
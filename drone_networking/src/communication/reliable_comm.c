@@ -0,0 +1,765 @@
+// src/communication/reliable_comm.c
+#include "reliable_comm.h"
+#include "../protocols/checksum.h"
+#include "../core/log.h"
+#include <stddef.h>
+#include <sys/random.h>
+
+// A command given up on, reported once ctx->lock is released
+typedef struct {
+    char drone_id[MAX_DRONE_ID];
+    command_message_t message;
+} reliable_failure_t;
+
+typedef struct {
+    reliable_failure_t* entries;
+    int count;
+    int capacity;
+} failure_list_t;
+
+reliable_context_t* reliable_init(udp_context_t* udp, const char* local_id) {
+    if (!udp || !local_id) return NULL;
+    
+    reliable_context_t* ctx = (reliable_context_t*)malloc(sizeof(reliable_context_t));
+    if (!ctx) return NULL;
+    
+    memset(ctx, 0, sizeof(reliable_context_t));
+    ctx->udp = udp;
+    strncpy(ctx->local_id, local_id, MAX_DRONE_ID - 1);
+    ctx->local_id[MAX_DRONE_ID - 1] = '\0';
+    
+    while (ctx->epoch == 0) {
+        if (getrandom(&ctx->epoch, sizeof(ctx->epoch), 0) != (ssize_t)sizeof(ctx->epoch)) {
+            free(ctx);
+            return NULL;
+        }
+    }
+    pthread_mutex_init(&ctx->lock, NULL);
+    
+    return ctx;
+}
+
+// Caller holds ctx->lock
+static reliable_peer_t* find_peer(reliable_context_t* ctx, const char* drone_id) {
+    for (int i = 0; i < ctx->peer_count; i++) {
+        if (strncmp(ctx->peers[i].drone_id, drone_id, MAX_DRONE_ID) == 0) {
+            return &ctx->peers[i];
+        }
+    }
+    return NULL;
+}
+
+// Caller holds ctx->lock
+static reliable_peer_t* add_peer(reliable_context_t* ctx, const char* drone_id,
+                                 const struct sockaddr_in* address) {
+    if (ctx->peer_count >= RELIABLE_MAX_PEERS) return NULL;
+    
+    reliable_peer_t* peer = &ctx->peers[ctx->peer_count++];
+    memset(peer, 0, sizeof(reliable_peer_t));
+    strncpy(peer->drone_id, drone_id, MAX_DRONE_ID - 1);
+    peer->drone_id[MAX_DRONE_ID - 1] = '\0';
+    peer->address = *address;
+    peer->rto_ms = RELIABLE_INITIAL_RTO_MS;
+    return peer;
+}
+
+network_result_t reliable_add_peer(reliable_context_t* ctx, const char* drone_id,
+                                   const char* ip, int port) {
+    if (!ctx || !drone_id || !ip) return NET_ERROR;
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip, &address.sin_addr) != 1) {
+        return NET_ERROR;
+    }
+    
+    pthread_mutex_lock(&ctx->lock);
+    reliable_peer_t* peer = find_peer(ctx, drone_id);
+    if (peer) {
+        peer->address = address;
+    } else {
+        peer = add_peer(ctx, drone_id, &address);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+    
+    if (!peer) {
+        LOG_WARN("reliable: cannot add peer %s, table full at %d", drone_id, RELIABLE_MAX_PEERS);
+        return NET_ERROR;
+    }
+    return NET_SUCCESS;
+}
+
+void reliable_set_failure_handler(reliable_context_t* ctx,
+                                  reliable_failure_handler_t handler, void* user_data) {
+    if (ctx) {
+        ctx->on_failure = handler;
+        ctx->failure_user_data = user_data;
+    }
+}
+
+// Wire tag of a group, never 0 (0 marks a unicast ACK)
+static uint16_t group_tag(const char* wire_name) {
+    uint32_t crc = crc32c(wire_name, strnlen(wire_name, MAX_DRONE_ID));
+    uint16_t tag = (uint16_t)(crc ^ (crc >> 16));
+    return tag ? tag : 1;
+}
+
+// Caller holds ctx->lock
+static reliable_group_t* find_group(reliable_context_t* ctx, const char* group_name) {
+    for (int i = 0; i < ctx->group_count; i++) {
+        if (strncmp(ctx->groups[i]->name + 1, group_name, MAX_DRONE_ID - 1) == 0) {
+            return ctx->groups[i];
+        }
+    }
+    return NULL;
+}
+
+// Caller holds ctx->lock
+static reliable_group_t* find_group_by_tag(reliable_context_t* ctx, uint16_t tag) {
+    for (int i = 0; i < ctx->group_count; i++) {
+        if (ctx->groups[i]->tag == tag) {
+            return ctx->groups[i];
+        }
+    }
+    return NULL;
+}
+
+network_result_t reliable_add_group(reliable_context_t* ctx, const char* group_name,
+                                    const char* ip, int port) {
+    if (!ctx || !group_name || !ip || strlen(group_name) >= MAX_DRONE_ID - 1) return NET_ERROR;
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip, &address.sin_addr) != 1) {
+        return NET_ERROR;
+    }
+    
+    pthread_mutex_lock(&ctx->lock);
+    
+    reliable_group_t* group = find_group(ctx, group_name);
+    if (group) {
+        group->address = address;
+        pthread_mutex_unlock(&ctx->lock);
+        return NET_SUCCESS;
+    }
+    
+    char wire_name[MAX_DRONE_ID];
+    snprintf(wire_name, sizeof(wire_name), "%c%s", RELIABLE_GROUP_PREFIX, group_name);
+    uint16_t tag = group_tag(wire_name);
+    
+    if (ctx->group_count >= RELIABLE_MAX_GROUPS) {
+        pthread_mutex_unlock(&ctx->lock);
+        LOG_WARN("reliable: cannot add group %s, limit is %d", group_name, RELIABLE_MAX_GROUPS);
+        return NET_ERROR;
+    }
+    // Tags must be unique among our groups or ACKs would be misattributed
+    if (find_group_by_tag(ctx, tag)) {
+        pthread_mutex_unlock(&ctx->lock);
+        LOG_WARN("reliable: cannot add group %s, its tag collides with another group", group_name);
+        return NET_ERROR;
+    }
+    
+    group = (reliable_group_t*)calloc(1, sizeof(reliable_group_t));
+    if (!group) {
+        pthread_mutex_unlock(&ctx->lock);
+        return NET_ERROR;
+    }
+    memcpy(group->name, wire_name, sizeof(wire_name));
+    group->tag = tag;
+    group->address = address;
+    ctx->groups[ctx->group_count++] = group;
+    
+    pthread_mutex_unlock(&ctx->lock);
+    return NET_SUCCESS;
+}
+
+// Pending bitmap of one window slot
+static uint64_t* slot_pending(const reliable_group_t* group, const reliable_group_slot_t* slot) {
+    return group->pending + (size_t)(slot - group->window) * group->member_words;
+}
+
+// First member at or after from still pending in bitmap, -1 if none
+static int next_pending(const uint64_t* bitmap, size_t words, int from) {
+    for (size_t word = (size_t)from / 64; word < words; word++) {
+        uint64_t bits = bitmap[word];
+        if (word == (size_t)from / 64) bits &= ~0ULL << (from % 64);
+        if (bits) return (int)(word * 64) + __builtin_ctzll(bits);
+    }
+    return -1;
+}
+
+// Caller holds ctx->lock. Make room for one more member, widening every
+// slot's bitmap if needed; commands in flight keep their pending bits.
+static int grow_members(reliable_group_t* group) {
+    if (group->member_count < group->member_capacity) return 0;
+    
+    int capacity = group->member_capacity ? group->member_capacity * 2
+                                          : RELIABLE_GROUP_INITIAL_MEMBERS;
+    int* members = (int*)realloc(group->members, (size_t)capacity * sizeof(int));
+    if (!members) return -1;
+    group->members = members;
+    
+    size_t words = ((size_t)capacity + 63) / 64;
+    if (words > group->member_words) {
+        uint64_t* pending = (uint64_t*)calloc(RELIABLE_WINDOW_SIZE * words, sizeof(uint64_t));
+        if (!pending) return -1;
+        for (size_t i = 0; i < RELIABLE_WINDOW_SIZE && group->pending; i++) {
+            memcpy(pending + i * words, group->pending + i * group->member_words,
+                   group->member_words * sizeof(uint64_t));
+        }
+        free(group->pending);
+        group->pending = pending;
+        group->member_words = words;
+    }
+    group->member_capacity = capacity;
+    return 0;
+}
+
+network_result_t reliable_group_add_member(reliable_context_t* ctx, const char* group_name,
+                                           const char* drone_id) {
+    if (!ctx || !group_name || !drone_id) return NET_ERROR;
+    
+    pthread_mutex_lock(&ctx->lock);
+    
+    reliable_group_t* group = find_group(ctx, group_name);
+    reliable_peer_t* peer = find_peer(ctx, drone_id);
+    if (!group || !peer) {
+        pthread_mutex_unlock(&ctx->lock);
+        LOG_WARN("reliable: cannot add %s to group %s, %s is not registered", drone_id,
+                 group_name, group ? "the peer" : "the group");
+        return NET_ERROR;
+    }
+    
+    int peer_index = (int)(peer - ctx->peers);
+    for (int i = 0; i < group->member_count; i++) {
+        if (group->members[i] == peer_index) {
+            pthread_mutex_unlock(&ctx->lock);
+            return NET_SUCCESS;
+        }
+    }
+    if (grow_members(group) != 0) {
+        pthread_mutex_unlock(&ctx->lock);
+        LOG_WARN("reliable: cannot add %s to group %s, out of memory", drone_id, group_name);
+        return NET_ERROR;
+    }
+    // Commands already in flight were not addressed to the new member
+    group->members[group->member_count++] = peer_index;
+    
+    pthread_mutex_unlock(&ctx->lock);
+    return NET_SUCCESS;
+}
+
+// Caller holds ctx->lock. Oldest sequence still awaiting acknowledgment,
+// or the next one to be sent if none is.
+static uint16_t peer_window_base(const reliable_peer_t* peer) {
+    for (uint16_t back = RELIABLE_WINDOW_SIZE; back > 0; back--) {
+        uint16_t sequence = (uint16_t)(peer->next_sequence - back);
+        const reliable_slot_t* slot = &peer->window[sequence % RELIABLE_WINDOW_SIZE];
+        if (slot->in_use && slot->sequence == sequence) return sequence;
+    }
+    return peer->next_sequence;
+}
+
+// Caller holds ctx->lock
+static uint16_t group_window_base(const reliable_group_t* group) {
+    for (uint16_t back = RELIABLE_WINDOW_SIZE; back > 0; back--) {
+        uint16_t sequence = (uint16_t)(group->next_sequence - back);
+        const reliable_group_slot_t* slot = &group->window[sequence % RELIABLE_WINDOW_SIZE];
+        if (slot->in_use && slot->sequence == sequence) return sequence;
+    }
+    return group->next_sequence;
+}
+
+network_result_t reliable_send_group(reliable_context_t* ctx, const char* group_name,
+                                     command_message_t* command) {
+    if (!ctx || !group_name || !command) return NET_ERROR;
+    
+    pthread_mutex_lock(&ctx->lock);
+    
+    reliable_group_t* group = find_group(ctx, group_name);
+    if (!group || group->member_count == 0) {
+        pthread_mutex_unlock(&ctx->lock);
+        return NET_ERROR;
+    }
+    
+    reliable_group_slot_t* slot = &group->window[group->next_sequence % RELIABLE_WINDOW_SIZE];
+    if (slot->in_use) {
+        pthread_mutex_unlock(&ctx->lock);
+        return NET_TIMEOUT; // Some member is still behind on an old command
+    }
+    
+    // Receivers key their window on the group, not on us
+    command->header.message_type = MSG_COMMAND;
+    command->header.message_id = group->next_sequence;
+    memcpy(command->header.drone_id, group->name, MAX_DRONE_ID);
+    command->sender_epoch = ctx->epoch;
+    command->window_base = group_window_base(group);
+    
+    int serialized_size = serialize_message(command, &slot->message, sizeof(slot->message));
+    if (serialized_size < 0) {
+        pthread_mutex_unlock(&ctx->lock);
+        return NET_ERROR;
+    }
+    
+    slot->in_use = 1;
+    slot->sequence = group->next_sequence;
+    slot->retransmits = 0;
+    slot->length = (size_t)serialized_size;
+    uint64_t* pending = slot_pending(group, slot);
+    for (size_t word = 0; word < group->member_words; word++) {
+        int first = (int)(word * 64);
+        int left = group->member_count - first;
+        pending[word] = left >= 64 ? ~0ULL : left > 0 ? (1ULL << left) - 1 : 0;
+    }
+    slot->pending_count = group->member_count;
+    slot->first_sent_ns = network_monotonic_ns();
+    slot->last_sent_ns = slot->first_sent_ns;
+    group->next_sequence++;
+    group->in_flight++;
+    ctx->group_commands_sent++;
+    
+    network_result_t result = network_send_data_to(ctx->udp->net_config, &slot->message,
+                                                   slot->length, &group->address);
+    
+    pthread_mutex_unlock(&ctx->lock);
+    
+    // Whoever missed it is caught by reliable_poll
+    return result == NET_ERROR ? NET_SUCCESS : result;
+}
+
+network_result_t reliable_send_command(reliable_context_t* ctx, const char* drone_id,
+                                       command_message_t* command) {
+    if (!ctx || !drone_id || !command) return NET_ERROR;
+    
+    pthread_mutex_lock(&ctx->lock);
+    
+    reliable_peer_t* peer = find_peer(ctx, drone_id);
+    if (!peer) {
+        pthread_mutex_unlock(&ctx->lock);
+        return NET_ERROR;
+    }
+    
+    reliable_slot_t* slot = &peer->window[peer->next_sequence % RELIABLE_WINDOW_SIZE];
+    if (slot->in_use) {
+        pthread_mutex_unlock(&ctx->lock);
+        return NET_TIMEOUT; // Window full, caller should back off
+    }
+    
+    command->header.message_type = MSG_COMMAND;
+    command->header.message_id = peer->next_sequence;
+    command->sender_epoch = ctx->epoch;
+    command->window_base = peer_window_base(peer);
+    
+    int serialized_size = serialize_message(command, &slot->message, sizeof(slot->message));
+    if (serialized_size < 0) {
+        pthread_mutex_unlock(&ctx->lock);
+        return NET_ERROR;
+    }
+    
+    slot->in_use = 1;
+    slot->sequence = peer->next_sequence;
+    slot->retransmits = 0;
+    slot->length = (size_t)serialized_size;
+    slot->first_sent_ns = network_monotonic_ns();
+    slot->last_sent_ns = slot->first_sent_ns;
+    peer->next_sequence++;
+    peer->in_flight++;
+    ctx->commands_sent++;
+    
+    network_result_t result = network_send_data_to(ctx->udp->net_config, &slot->message,
+                                                   slot->length, &peer->address);
+    
+    pthread_mutex_unlock(&ctx->lock);
+    
+    // A failed first transmission is retried by reliable_poll like a lost one
+    return result == NET_ERROR ? NET_SUCCESS : result;
+}
+
+// RFC 6298 smoothed RTT and retransmission timeout
+static void update_rtt(reliable_peer_t* peer, double sample_ms) {
+    if (!peer->has_rtt_sample) {
+        peer->srtt_ms = sample_ms;
+        peer->rttvar_ms = sample_ms / 2.0;
+        peer->has_rtt_sample = 1;
+    } else {
+        double error = peer->srtt_ms - sample_ms;
+        if (error < 0) error = -error;
+        peer->rttvar_ms = 0.75 * peer->rttvar_ms + 0.25 * error;
+        peer->srtt_ms = 0.875 * peer->srtt_ms + 0.125 * sample_ms;
+    }
+    
+    peer->rto_ms = peer->srtt_ms + 4.0 * peer->rttvar_ms;
+    if (peer->rto_ms < RELIABLE_MIN_RTO_MS) peer->rto_ms = RELIABLE_MIN_RTO_MS;
+    if (peer->rto_ms > RELIABLE_MAX_RTO_MS) peer->rto_ms = RELIABLE_MAX_RTO_MS;
+}
+
+static int sequence_acknowledged(uint16_t sequence, const acknowledgment_message_t* ack) {
+    uint16_t distance = (uint16_t)(sequence - ack->cumulative_ack);
+    if (distance >= 0x8000) {
+        return 1; // Before the cumulative point
+    }
+    if (distance >= 1 && distance <= 64) {
+        return (int)((ack->sack_bitmap >> (distance - 1)) & 1);
+    }
+    return 0;
+}
+
+// Caller holds ctx->lock
+static void process_acknowledgment(reliable_context_t* ctx, reliable_peer_t* peer,
+                                   const acknowledgment_message_t* ack) {
+    uint64_t now = network_monotonic_ns();
+    
+    for (int i = 0; i < RELIABLE_WINDOW_SIZE && peer->in_flight > 0; i++) {
+        reliable_slot_t* slot = &peer->window[i];
+        if (!slot->in_use) continue;
+        
+        if (!sequence_acknowledged(slot->sequence, ack)) continue;
+        
+        // Karn's rule: only unambiguous samples feed the RTT estimate
+        if (slot->retransmits == 0) {
+            update_rtt(peer, (double)(now - slot->first_sent_ns) / 1e6);
+            network_record_round_trip(ctx->udp->net_config, now - slot->first_sent_ns);
+        }
+        
+        slot->in_use = 0;
+        peer->in_flight--;
+        ctx->commands_acknowledged++;
+    }
+}
+
+// Caller holds ctx->lock
+static void process_group_acknowledgment(reliable_context_t* ctx, reliable_group_t* group,
+                                         reliable_peer_t* peer,
+                                         const acknowledgment_message_t* ack) {
+    int peer_index = (int)(peer - ctx->peers);
+    int member = -1;
+    for (int i = 0; i < group->member_count; i++) {
+        if (group->members[i] == peer_index) {
+            member = i;
+            break;
+        }
+    }
+    if (member < 0) return;
+    
+    uint64_t now = network_monotonic_ns();
+    size_t word = (size_t)member / 64;
+    uint64_t member_bit = 1ULL << (member % 64);
+    
+    for (int i = 0; i < RELIABLE_WINDOW_SIZE && group->in_flight > 0; i++) {
+        reliable_group_slot_t* slot = &group->window[i];
+        uint64_t* pending = slot_pending(group, slot);
+        if (!slot->in_use || !(pending[word] & member_bit)) continue;
+        if (!sequence_acknowledged(slot->sequence, ack)) continue;
+        
+        if (slot->retransmits == 0) {
+            update_rtt(peer, (double)(now - slot->first_sent_ns) / 1e6);
+            network_record_round_trip(ctx->udp->net_config, now - slot->first_sent_ns);
+        }
+        
+        pending[word] &= ~member_bit;
+        if (--slot->pending_count == 0) {
+            slot->in_use = 0;
+            group->in_flight--;
+            ctx->commands_acknowledged++;
+        }
+    }
+}
+
+// Caller holds ctx->lock. receive_next has arrived: step past it and over
+// anything that already arrived out of order behind it.
+static void slide_window(reliable_peer_t* peer) {
+    peer->receive_next++;
+    while (peer->receive_bitmap & 1) {
+        peer->receive_bitmap >>= 1;
+        peer->receive_next++;
+    }
+    peer->receive_bitmap >>= 1;
+}
+
+// Caller holds ctx->lock. Returns 1 if the sequence is new.
+static int record_received(reliable_peer_t* peer, uint16_t sequence) {
+    uint16_t distance = (uint16_t)(sequence - peer->receive_next);
+    
+    if (distance >= 0x8000) {
+        return 0; // Already delivered
+    }
+    
+    if (distance > 64) {
+        // Sender is further ahead than our window, treat the gap as lost.
+        // The sequence that becomes receive_next may already have arrived.
+        uint16_t advance = (uint16_t)(distance - 64);
+        int landed = advance <= 64 && ((peer->receive_bitmap >> (advance - 1)) & 1);
+        peer->receive_bitmap = advance >= 64 ? 0 : peer->receive_bitmap >> advance;
+        peer->receive_next = (uint16_t)(peer->receive_next + advance);
+        if (landed) {
+            slide_window(peer);
+        }
+        distance = (uint16_t)(sequence - peer->receive_next);
+    }
+    
+    if (distance == 0) {
+        slide_window(peer);
+        return 1;
+    }
+    
+    uint64_t bit = 1ULL << (distance - 1);
+    if (peer->receive_bitmap & bit) {
+        return 0;
+    }
+    peer->receive_bitmap |= bit;
+    return 1;
+}
+
+// Caller holds ctx->lock. Returns 1 if the command is new, 0 if it is a
+// duplicate or a straggler from the sender's previous run.
+static int receive_command(reliable_peer_t* peer, const command_message_t* command) {
+    if (command->sender_epoch != peer->receive_epoch) {
+        if (peer->receive_epoch != 0 && command->sender_epoch == peer->stale_epoch) {
+            return 0;
+        }
+        // New sender run, or our first command from it: nothing before its
+        // oldest unacknowledged command can still be owed to us
+        peer->stale_epoch = peer->receive_epoch;
+        peer->receive_epoch = command->sender_epoch;
+        peer->receive_next = command->window_base;
+        peer->receive_bitmap = 0;
+    }
+    return record_received(peer, command->header.message_id);
+}
+
+// Caller holds ctx->lock
+static void send_acknowledgment(reliable_context_t* ctx, reliable_peer_t* peer) {
+    acknowledgment_message_t ack;
+    memset(&ack, 0, sizeof(ack));
+    init_message_header(&ack.header, MSG_ACKNOWLEDGMENT, ctx->local_id);
+    ack.header.payload_length = sizeof(acknowledgment_message_t) - sizeof(message_header_t);
+    ack.cumulative_ack = peer->receive_next;
+    ack.sack_bitmap = peer->receive_bitmap;
+    ack.sender_epoch = peer->receive_epoch;
+    if (peer->drone_id[0] == RELIABLE_GROUP_PREFIX) {
+        ack.group_tag = group_tag(peer->drone_id);
+    }
+    
+    acknowledgment_message_t wire;
+    if (serialize_message(&ack, &wire, sizeof(wire)) > 0) {
+        network_send_data_to(ctx->udp->net_config, &wire, sizeof(wire), &peer->address);
+    }
+}
+
+int reliable_handle_message(reliable_context_t* ctx, const void* buffer, size_t length,
+                            const struct sockaddr_in* source) {
+    if (!ctx || !buffer) return -1;
+    if (!validate_message(buffer, length)) {
+        network_record_checksum_failure(ctx->udp->net_config);
+        return -1;
+    }
+    
+    const message_header_t* header = (const message_header_t*)buffer;
+    char drone_id[MAX_DRONE_ID];
+    memcpy(drone_id, header->drone_id, MAX_DRONE_ID);
+    drone_id[MAX_DRONE_ID - 1] = '\0';
+    
+    pthread_mutex_lock(&ctx->lock);
+    
+    reliable_peer_t* peer = find_peer(ctx, drone_id);
+    int result = 0;
+    
+    if (header->message_type == MSG_ACKNOWLEDGMENT) {
+        if (peer && length >= sizeof(acknowledgment_message_t)) {
+            acknowledgment_message_t ack;
+            memcpy(&ack, buffer, sizeof(ack));
+            if (ack.sender_epoch != ctx->epoch) {
+                // Acknowledges an earlier run of ours, not these sequences
+            } else if (ack.group_tag == 0) {
+                process_acknowledgment(ctx, peer, &ack);
+            } else {
+                reliable_group_t* group = find_group_by_tag(ctx, ack.group_tag);
+                if (group) {
+                    process_group_acknowledgment(ctx, group, peer, &ack);
+                }
+            }
+        }
+    } else if (header->message_type == MSG_COMMAND) {
+        if (length < offsetof(command_message_t, payload)) {
+            pthread_mutex_unlock(&ctx->lock);
+            return -1;
+        }
+        command_message_t command;
+        memcpy(&command, buffer, offsetof(command_message_t, payload));
+        
+        if (!peer && source) {
+            peer = add_peer(ctx, drone_id, source);
+        }
+        if (!peer) {
+            result = -1;
+        } else {
+            if (source) {
+                peer->address = *source;
+            }
+            result = receive_command(peer, &command);
+            if (!result) {
+                ctx->duplicates_received++;
+            }
+            // Acknowledge duplicates too, the earlier ACK may have been lost
+            send_acknowledgment(ctx, peer);
+        }
+    } else {
+        result = -1;
+    }
+    
+    pthread_mutex_unlock(&ctx->lock);
+    return result;
+}
+
+// Caller holds ctx->lock
+static void record_failure(reliable_context_t* ctx, failure_list_t* list, const char* drone_id,
+                           const command_message_t* message) {
+    ctx->failures++;
+    if (!ctx->on_failure) return;
+    
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 8;
+        reliable_failure_t* entries = (reliable_failure_t*)realloc(
+            list->entries, (size_t)capacity * sizeof(reliable_failure_t));
+        if (!entries) {
+            LOG_WARN("reliable: cannot report failed command to %s", drone_id);
+            return;
+        }
+        list->entries = entries;
+        list->capacity = capacity;
+    }
+    
+    reliable_failure_t* entry = &list->entries[list->count++];
+    memcpy(entry->drone_id, drone_id, MAX_DRONE_ID);
+    entry->message = *message;
+}
+
+// Caller holds ctx->lock. Resends expired group commands by unicast to
+// the members that have not acknowledged them; returns members given up on.
+static int poll_group(reliable_context_t* ctx, reliable_group_t* group, uint64_t now,
+                      failure_list_t* failures) {
+    int failed = 0;
+    if (group->in_flight == 0) return 0;
+    
+    for (int i = 0; i < RELIABLE_WINDOW_SIZE; i++) {
+        reliable_group_slot_t* slot = &group->window[i];
+        if (!slot->in_use) continue;
+        const uint64_t* pending = slot_pending(group, slot);
+        size_t words = group->member_words;
+        
+        // Wait as long as the slowest straggler needs
+        double rto_ms = RELIABLE_MIN_RTO_MS;
+        for (int m = next_pending(pending, words, 0); m >= 0;
+             m = next_pending(pending, words, m + 1)) {
+            double member_rto = ctx->peers[group->members[m]].rto_ms;
+            if (member_rto > rto_ms) rto_ms = member_rto;
+        }
+        double timeout_ms = rto_ms * (double)(1 << slot->retransmits);
+        if (timeout_ms > RELIABLE_MAX_RTO_MS) timeout_ms = RELIABLE_MAX_RTO_MS;
+        if ((double)(now - slot->last_sent_ns) / 1e6 < timeout_ms) continue;
+        
+        if (slot->retransmits >= RELIABLE_MAX_RETRANSMITS) {
+            for (int m = next_pending(pending, words, 0); m >= 0;
+                 m = next_pending(pending, words, m + 1)) {
+                failed++;
+                record_failure(ctx, failures, ctx->peers[group->members[m]].drone_id,
+                               &slot->message);
+            }
+            slot->in_use = 0;
+            group->in_flight--;
+            continue;
+        }
+        
+        slot->retransmits++;
+        slot->last_sent_ns = now;
+        for (int m = next_pending(pending, words, 0); m >= 0;
+             m = next_pending(pending, words, m + 1)) {
+            ctx->straggler_retransmissions++;
+            network_send_data_to(ctx->udp->net_config, &slot->message, slot->length,
+                                 &ctx->peers[group->members[m]].address);
+        }
+    }
+    
+    return failed;
+}
+
+int reliable_poll(reliable_context_t* ctx) {
+    if (!ctx) return 0;
+    
+    uint64_t now = network_monotonic_ns();
+    int failed = 0;
+    failure_list_t failures = { NULL, 0, 0 };
+    
+    pthread_mutex_lock(&ctx->lock);
+    
+    for (int p = 0; p < ctx->peer_count; p++) {
+        reliable_peer_t* peer = &ctx->peers[p];
+        if (peer->in_flight == 0) continue;
+        
+        for (int i = 0; i < RELIABLE_WINDOW_SIZE; i++) {
+            reliable_slot_t* slot = &peer->window[i];
+            if (!slot->in_use) continue;
+            
+            // Exponential backoff per retransmission
+            double timeout_ms = peer->rto_ms * (double)(1 << slot->retransmits);
+            if (timeout_ms > RELIABLE_MAX_RTO_MS) timeout_ms = RELIABLE_MAX_RTO_MS;
+            if ((double)(now - slot->last_sent_ns) / 1e6 < timeout_ms) continue;
+            
+            if (slot->retransmits >= RELIABLE_MAX_RETRANSMITS) {
+                slot->in_use = 0;
+                peer->in_flight--;
+                failed++;
+                record_failure(ctx, &failures, peer->drone_id, &slot->message);
+                continue;
+            }
+            
+            slot->retransmits++;
+            slot->last_sent_ns = now;
+            ctx->retransmissions++;
+            network_send_data_to(ctx->udp->net_config, &slot->message, slot->length,
+                                 &peer->address);
+        }
+    }
+    
+    for (int g = 0; g < ctx->group_count; g++) {
+        failed += poll_group(ctx, ctx->groups[g], now, &failures);
+    }
+    
+    reliable_failure_handler_t on_failure = ctx->on_failure;
+    void* user_data = ctx->failure_user_data;
+    pthread_mutex_unlock(&ctx->lock);
+    
+    // The handler may resend, which takes ctx->lock
+    for (int i = 0; i < failures.count && on_failure; i++) {
+        on_failure(failures.entries[i].drone_id, &failures.entries[i].message, user_data);
+    }
+    free(failures.entries);
+    return failed;
+}
+
+double reliable_peer_rto(reliable_context_t* ctx, const char* drone_id) {
+    if (!ctx || !drone_id) return -1;
+    
+    pthread_mutex_lock(&ctx->lock);
+    reliable_peer_t* peer = find_peer(ctx, drone_id);
+    double rto = peer ? peer->rto_ms : -1;
+    pthread_mutex_unlock(&ctx->lock);
+    
+    return rto;
+}
+
+void reliable_cleanup(reliable_context_t* ctx) {
+    if (ctx) {
+        for (int g = 0; g < ctx->group_count; g++) {
+            free(ctx->groups[g]->members);
+            free(ctx->groups[g]->pending);
+            free(ctx->groups[g]);
+        }
+        pthread_mutex_destroy(&ctx->lock);
+        free(ctx);
+    }
+}
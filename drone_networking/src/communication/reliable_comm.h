@@ -0,0 +1,177 @@
+// src/communication/reliable_comm.h
+#ifndef RELIABLE_COMM_H
+#define RELIABLE_COMM_H
+
+#include "common.h"
+#include "udp_comm.h"
+
+// Reliable delivery of command messages over UDP.
+//
+// Each peer gets its own sequence space (carried in header.message_id), a
+// sliding send window and a receive window. Receivers acknowledge every
+// command with a cumulative ACK plus a 64-bit selective ACK bitmap, and
+// deliver commands as soon as they arrive, so one lost command never holds
+// up the ones behind it. Senders retransmit on an RTT-derived timeout.
+//
+// Every context picks a random sender epoch when it starts. Commands carry
+// it along with the sender's oldest unacknowledged sequence, and ACKs echo
+// it. A receiver that sees a new epoch (the sender restarted) or has no
+// window yet (the receiver restarted) restarts its window at that oldest
+// sequence, and senders ignore ACKs for another epoch, so a restart on
+// either side never turns live commands into acknowledged duplicates.
+//
+// Group commands are sent once to a multicast or broadcast address with
+// header.drone_id set to "@<group>", so every receiver keeps one receive
+// window per group. Receivers acknowledge to the sender as usual, tagging
+// the ACK with the group; the sender tracks which members are still
+// missing each command and retransmits by unicast to those stragglers only.
+//
+// A group can take every peer in the table; its member list and the
+// per-command bitmaps of members yet to acknowledge grow as members join.
+// A context holds at most RELIABLE_MAX_PEERS peers and RELIABLE_MAX_GROUPS
+// groups, and registrations past either limit fail with a warning.
+
+#define RELIABLE_WINDOW_SIZE 64
+#define RELIABLE_MAX_PEERS MAX_DRONES
+#define RELIABLE_INITIAL_RTO_MS 200
+#define RELIABLE_MIN_RTO_MS 20
+#define RELIABLE_MAX_RTO_MS 4000
+#define RELIABLE_MAX_RETRANSMITS 8
+#define RELIABLE_MAX_GROUPS 8
+#define RELIABLE_GROUP_INITIAL_MEMBERS 8
+#define RELIABLE_GROUP_PREFIX '@'
+
+// In-flight command awaiting acknowledgment
+typedef struct {
+    int in_use;
+    uint16_t sequence;
+    int retransmits;
+    uint64_t first_sent_ns;
+    uint64_t last_sent_ns;
+    size_t length;
+    command_message_t message;  // Serialized copy, checksum included
+} reliable_slot_t;
+
+// Per-peer delivery state
+typedef struct {
+    char drone_id[MAX_DRONE_ID];
+    struct sockaddr_in address;
+    
+    // Sender side
+    uint16_t next_sequence;
+    int in_flight;
+    reliable_slot_t window[RELIABLE_WINDOW_SIZE];
+    int has_rtt_sample;
+    double srtt_ms;
+    double rttvar_ms;
+    double rto_ms;
+    
+    // Receiver side
+    uint32_t receive_epoch;     // Sender epoch the window belongs to, 0 before the first command
+    uint32_t stale_epoch;       // Epoch it replaced; late commands from it are dropped
+    uint16_t receive_next;      // Lowest sequence not yet received
+    uint64_t receive_bitmap;    // Bit i set: receive_next + 1 + i received
+} reliable_peer_t;
+
+// In-flight group command and the members yet to acknowledge it
+typedef struct {
+    int in_use;
+    uint16_t sequence;
+    int retransmits;
+    uint64_t first_sent_ns;
+    uint64_t last_sent_ns;
+    int pending_count;          // Members yet to acknowledge; see reliable_group_t.pending
+    size_t length;
+    command_message_t message;
+} reliable_group_slot_t;
+
+// Sender-side state of one group
+typedef struct {
+    char name[MAX_DRONE_ID];    // With RELIABLE_GROUP_PREFIX, as sent on the wire
+    uint16_t tag;               // Carried in acknowledgment_message_t.group_tag
+    struct sockaddr_in address; // Multicast or broadcast destination
+    int* members;               // Indexes into the peer table
+    int member_count;
+    int member_capacity;
+    size_t member_words;        // uint64_t words in each pending bitmap
+    uint64_t* pending;          // One bitmap per window slot; bit m set: member m
+                                // has not acknowledged that slot's command
+    uint16_t next_sequence;
+    int in_flight;
+    reliable_group_slot_t window[RELIABLE_WINDOW_SIZE];
+} reliable_group_t;
+
+// Called when a command exhausts its retransmissions, without ctx->lock
+// held, so the handler may send again
+typedef void (*reliable_failure_handler_t)(const char* drone_id,
+                                           const command_message_t* command,
+                                           void* user_data);
+
+typedef struct {
+    udp_context_t* udp;
+    char local_id[MAX_DRONE_ID];
+    uint32_t epoch;             // Random, non-zero, per context
+    reliable_peer_t peers[RELIABLE_MAX_PEERS];
+    int peer_count;
+    reliable_group_t* groups[RELIABLE_MAX_GROUPS];
+    int group_count;
+    reliable_failure_handler_t on_failure;
+    void* failure_user_data;
+    unsigned long commands_sent;
+    unsigned long commands_acknowledged;
+    unsigned long retransmissions;
+    unsigned long failures;
+    unsigned long duplicates_received;
+    unsigned long group_commands_sent;
+    unsigned long straggler_retransmissions;
+    pthread_mutex_t lock;
+} reliable_context_t;
+
+// Initialize reliable delivery on top of a UDP context
+reliable_context_t* reliable_init(udp_context_t* udp, const char* local_id);
+
+// Register a peer and its address; NET_ERROR once RELIABLE_MAX_PEERS are known
+network_result_t reliable_add_peer(reliable_context_t* ctx, const char* drone_id,
+                                   const char* ip, int port);
+
+// Set handler for commands that could not be delivered
+void reliable_set_failure_handler(reliable_context_t* ctx,
+                                  reliable_failure_handler_t handler, void* user_data);
+
+// Send a command reliably. Assigns the sequence number and returns
+// NET_TIMEOUT when the peer's send window is full.
+network_result_t reliable_send_command(reliable_context_t* ctx, const char* drone_id,
+                                       command_message_t* command);
+
+// Register a group and its multicast/broadcast address; NET_ERROR once
+// RELIABLE_MAX_GROUPS are registered
+network_result_t reliable_add_group(reliable_context_t* ctx, const char* group_name,
+                                    const char* ip, int port);
+
+// Add a known peer (see reliable_add_peer) to a group
+network_result_t reliable_group_add_member(reliable_context_t* ctx, const char* group_name,
+                                           const char* drone_id);
+
+// Send a command once to a whole group. NET_TIMEOUT when the group's
+// window is full. Undelivered members are reported per drone to the
+// failure handler.
+network_result_t reliable_send_group(reliable_context_t* ctx, const char* group_name,
+                                     command_message_t* command);
+
+// Process a received datagram. Acknowledgments update the send window,
+// commands are acknowledged. Returns 1 if the datagram is a new command the
+// caller should execute, 0 if consumed (ACK or duplicate), -1 on error.
+int reliable_handle_message(reliable_context_t* ctx, const void* buffer, size_t length,
+                            const struct sockaddr_in* source);
+
+// Retransmit expired commands; call periodically. Returns the number of
+// commands given up on during this call.
+int reliable_poll(reliable_context_t* ctx);
+
+// Current retransmission timeout for a peer in milliseconds (-1 if unknown peer)
+double reliable_peer_rto(reliable_context_t* ctx, const char* drone_id);
+
+// Cleanup reliable context (the UDP context is not freed)
+void reliable_cleanup(reliable_context_t* ctx);
+
+#endif
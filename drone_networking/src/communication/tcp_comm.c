@@ -0,0 +1,578 @@
+// src/communication/tcp_comm.c
+#include "tcp_comm.h"
+#include <fcntl.h>
+#include <poll.h>
+#include <netinet/tcp.h>
+
+static int set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0) return -1;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static int wait_for(int fd, short events, int timeout_ms) {
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = events;
+    pfd.revents = 0;
+    
+    int ready;
+    do {
+        ready = poll(&pfd, 1, timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+    
+    return ready;
+}
+
+static tcp_connection_t* connection_create(int fd, const struct sockaddr_in* peer) {
+    tcp_connection_t* connection = (tcp_connection_t*)malloc(sizeof(tcp_connection_t));
+    if (!connection) return NULL;
+    
+    memset(connection, 0, sizeof(tcp_connection_t));
+    connection->receive_buffer = (unsigned char*)malloc(TCP_INITIAL_RECEIVE_BUFFER);
+    if (!connection->receive_buffer) {
+        free(connection);
+        return NULL;
+    }
+    
+    connection->receive_capacity = TCP_INITIAL_RECEIVE_BUFFER;
+    connection->socket_fd = fd;
+    connection->peer_addr = *peer;
+    connection->is_connected = 1;
+    connection->io_timeout_ms = TCP_IO_TIMEOUT_MS;
+    
+    tcp_set_nodelay(connection, 1);
+    return connection;
+}
+
+tcp_connection_t* tcp_connect(const char* server_ip, int port) {
+    if (!server_ip) return NULL;
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, server_ip, &address.sin_addr) != 1) {
+        fprintf(stderr, "Invalid TCP address %s\n", server_ip);
+        return NULL;
+    }
+    
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        perror("TCP socket creation failed");
+        return NULL;
+    }
+    
+    if (set_nonblocking(fd) < 0) {
+        perror("TCP nonblocking mode failed");
+        close(fd);
+        return NULL;
+    }
+    
+    if (connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        if (errno != EINPROGRESS) {
+            perror("TCP connect failed");
+            close(fd);
+            return NULL;
+        }
+        
+        // Wait for the handshake to finish
+        int error = 0;
+        socklen_t error_len = sizeof(error);
+        if (wait_for(fd, POLLOUT, TCP_IO_TIMEOUT_MS) <= 0 ||
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &error_len) < 0 || error != 0) {
+            fprintf(stderr, "TCP connect to %s:%d failed\n", server_ip, port);
+            close(fd);
+            return NULL;
+        }
+    }
+    
+    tcp_connection_t* connection = connection_create(fd, &address);
+    if (!connection) {
+        close(fd);
+        return NULL;
+    }
+    
+    printf("TCP connection established to %s:%d\n", server_ip, port);
+    return connection;
+}
+
+void tcp_close(tcp_connection_t* connection) {
+    if (connection) {
+        if (connection->socket_fd >= 0) {
+            close(connection->socket_fd);
+        }
+        free(connection->receive_buffer);
+        free(connection);
+    }
+}
+
+tcp_listener_t* tcp_listen(int port) {
+    tcp_listener_t* listener = (tcp_listener_t*)malloc(sizeof(tcp_listener_t));
+    if (!listener) return NULL;
+    
+    listener->port = port;
+    listener->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listener->listen_fd < 0) {
+        perror("TCP listen socket creation failed");
+        free(listener);
+        return NULL;
+    }
+    
+    int reuse = 1;
+    setsockopt(listener->listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = INADDR_ANY;
+    
+    if (bind(listener->listen_fd, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        listen(listener->listen_fd, SOMAXCONN) < 0 ||
+        set_nonblocking(listener->listen_fd) < 0) {
+        perror("TCP listen failed");
+        close(listener->listen_fd);
+        free(listener);
+        return NULL;
+    }
+    
+    printf("TCP listening on port %d\n", port);
+    return listener;
+}
+
+tcp_connection_t* tcp_accept(tcp_listener_t* listener) {
+    if (!listener) return NULL;
+    
+    struct sockaddr_in peer;
+    socklen_t peer_len = sizeof(peer);
+    int fd = accept(listener->listen_fd, (struct sockaddr*)&peer, &peer_len);
+    if (fd < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            perror("TCP accept failed");
+        }
+        return NULL;
+    }
+    
+    if (set_nonblocking(fd) < 0) {
+        close(fd);
+        return NULL;
+    }
+    
+    tcp_connection_t* connection = connection_create(fd, &peer);
+    if (!connection) {
+        close(fd);
+    }
+    return connection;
+}
+
+void tcp_listener_close(tcp_listener_t* listener) {
+    if (listener) {
+        close(listener->listen_fd);
+        free(listener);
+    }
+}
+
+network_result_t tcp_set_nodelay(tcp_connection_t* connection, int enabled) {
+    if (!connection) return NET_ERROR;
+    
+    int value = enabled ? 1 : 0;
+    if (setsockopt(connection->socket_fd, IPPROTO_TCP, TCP_NODELAY, &value, sizeof(value)) < 0) {
+        perror("Set TCP_NODELAY failed");
+        return NET_ERROR;
+    }
+    return NET_SUCCESS;
+}
+
+network_result_t tcp_set_cork(tcp_connection_t* connection, int enabled) {
+    if (!connection) return NET_ERROR;
+
+#ifdef TCP_CORK
+    int value = enabled ? 1 : 0;
+    if (setsockopt(connection->socket_fd, IPPROTO_TCP, TCP_CORK, &value, sizeof(value)) < 0) {
+        perror("Set TCP_CORK failed");
+        return NET_ERROR;
+    }
+    return NET_SUCCESS;
+#else
+    (void)enabled;
+    return NET_ERROR;
+#endif
+}
+
+network_result_t tcp_set_io_timeout(tcp_connection_t* connection, int timeout_ms) {
+    if (!connection || timeout_ms < 0) return NET_ERROR;
+    
+    connection->io_timeout_ms = timeout_ms;
+    return NET_SUCCESS;
+}
+
+// Write every byte described by iov, waiting for buffer space as needed.
+// iov is modified as it is consumed. A timeout after part of iov went out
+// leaves a frame cut short on the stream, so the connection is marked
+// broken; a timeout before any byte went out leaves it usable.
+static network_result_t write_all(tcp_connection_t* connection, struct iovec* iov, int count) {
+    int progressed = 0;
+    while (count > 0) {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t)count;
+        
+        // sendmsg is writev plus MSG_NOSIGNAL, so a dropped peer is an error not SIGPIPE
+        ssize_t written = sendmsg(connection->socket_fd, &msg, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                if (wait_for(connection->socket_fd, POLLOUT, connection->io_timeout_ms) <= 0) {
+                    if (progressed) {
+                        fprintf(stderr, "TCP send timed out mid-frame, closing\n");
+                        connection->is_connected = 0;
+                    }
+                    return NET_TIMEOUT;
+                }
+                continue;
+            }
+            perror("TCP send failed");
+            connection->is_connected = 0;
+            return (errno == EPIPE || errno == ECONNRESET) ? NET_DISCONNECTED : NET_ERROR;
+        }
+        
+        connection->bytes_sent += (unsigned long)written;
+        progressed = 1;
+        
+        // Skip fully written vectors, trim a partially written one
+        size_t remaining = (size_t)written;
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*)iov->iov_base + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+    
+    return NET_SUCCESS;
+}
+
+long tcp_write_nowait(tcp_connection_t* connection, const struct iovec* iov, int count) {
+    if (!connection || !iov || count <= 0 || !connection->is_connected) return -1;
+    
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = (struct iovec*)iov;
+    msg.msg_iovlen = (size_t)count;
+    
+    ssize_t written;
+    do {
+        written = sendmsg(connection->socket_fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT);
+    } while (written < 0 && errno == EINTR);
+    
+    if (written < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+        perror("TCP send failed");
+        connection->is_connected = 0;
+        return -1;
+    }
+    connection->bytes_sent += (unsigned long)written;
+    return (long)written;
+}
+
+network_result_t tcp_send_frame(tcp_connection_t* connection, const void* data, size_t length) {
+    struct iovec frame;
+    frame.iov_base = (void*)data;
+    frame.iov_len = length;
+    return tcp_send_frames(connection, &frame, 1);
+}
+
+network_result_t tcp_send_frames(tcp_connection_t* connection,
+                                 const struct iovec* frames, int frame_count) {
+    if (!connection || !frames || !connection->is_connected) return NET_ERROR;
+    
+    struct iovec iov[TCP_MAX_IOVEC];
+    uint32_t prefixes[TCP_MAX_IOVEC / 2];
+    
+    while (frame_count > 0) {
+        int batch = frame_count < TCP_MAX_IOVEC / 2 ? frame_count : TCP_MAX_IOVEC / 2;
+        
+        for (int i = 0; i < batch; i++) {
+            if (frames[i].iov_len > TCP_MAX_FRAME_SIZE) return NET_ERROR;
+            prefixes[i] = htonl((uint32_t)frames[i].iov_len);
+            iov[2 * i].iov_base = &prefixes[i];
+            iov[2 * i].iov_len = sizeof(uint32_t);
+            iov[2 * i + 1] = frames[i];
+        }
+        
+        network_result_t result = write_all(connection, iov, 2 * batch);
+        if (result != NET_SUCCESS) return result;
+        
+        connection->frames_sent += (unsigned long)batch;
+        frames += batch;
+        frame_count -= batch;
+    }
+    
+    return NET_SUCCESS;
+}
+
+network_result_t tcp_send_message(tcp_connection_t* connection, const message_header_t* message) {
+    if (!connection || !message) return NET_ERROR;
+    
+    size_t message_size = sizeof(message_header_t) + message->payload_length;
+    if (message_size > TCP_MAX_FRAME_SIZE) return NET_ERROR;
+    
+    // Only the header is copied to stamp the checksum
+    message_header_t header = *message;
+    header.checksum = calculate_message_checksum(message, message_size);
+    
+    uint32_t prefix = htonl((uint32_t)message_size);
+    struct iovec iov[3];
+    iov[0].iov_base = &prefix;
+    iov[0].iov_len = sizeof(prefix);
+    iov[1].iov_base = &header;
+    iov[1].iov_len = sizeof(header);
+    iov[2].iov_base = (char*)message + sizeof(message_header_t);
+    iov[2].iov_len = message->payload_length;
+    
+    network_result_t result = write_all(connection, iov, message->payload_length ? 3 : 2);
+    if (result == NET_SUCCESS) {
+        connection->frames_sent++;
+    }
+    return result;
+}
+
+// Make room for at least `needed` more bytes after receive_used
+static int reserve_receive_space(tcp_connection_t* connection, size_t needed) {
+    if (connection->receive_capacity - connection->receive_used >= needed) return 0;
+    
+    // Compact consumed bytes first
+    if (connection->receive_start > 0) {
+        memmove(connection->receive_buffer,
+                connection->receive_buffer + connection->receive_start,
+                connection->receive_used - connection->receive_start);
+        connection->receive_used -= connection->receive_start;
+        connection->receive_start = 0;
+        if (connection->receive_capacity - connection->receive_used >= needed) return 0;
+    }
+    
+    // Room for the largest frame and its prefix, plus one read's worth
+    size_t limit = TCP_MAX_FRAME_SIZE + sizeof(uint32_t) + TCP_INITIAL_RECEIVE_BUFFER;
+    if (connection->receive_used + needed > limit) {
+        return -1;
+    }
+    
+    size_t capacity = connection->receive_capacity;
+    while (capacity - connection->receive_used < needed) {
+        capacity *= 2;
+    }
+    if (capacity > limit) {
+        capacity = limit;
+    }
+    
+    unsigned char* grown = (unsigned char*)realloc(connection->receive_buffer, capacity);
+    if (!grown) return -1;
+    
+    connection->receive_buffer = grown;
+    connection->receive_capacity = capacity;
+    return 0;
+}
+
+// Returns the length of a complete buffered frame, 0 if incomplete, -1 if invalid
+static long buffered_frame_length(const tcp_connection_t* connection) {
+    size_t available = connection->receive_used - connection->receive_start;
+    if (available < sizeof(uint32_t)) return 0;
+    
+    uint32_t prefix;
+    memcpy(&prefix, connection->receive_buffer + connection->receive_start, sizeof(prefix));
+    uint32_t length = ntohl(prefix);
+    if (length > TCP_MAX_FRAME_SIZE) return -1;
+    
+    return available - sizeof(uint32_t) >= length ? (long)length : 0;
+}
+
+network_result_t tcp_receive_frame(tcp_connection_t* connection, void* buffer,
+                                   size_t buffer_size, size_t* frame_length) {
+    if (!connection || !buffer || !connection->is_connected) return NET_ERROR;
+    
+    long length = buffered_frame_length(connection);
+    
+    // Drain the socket until a full frame is buffered or it would block
+    while (length == 0) {
+        if (reserve_receive_space(connection, TCP_INITIAL_RECEIVE_BUFFER / 4) < 0) {
+            return NET_ERROR;
+        }
+        
+        ssize_t received = recv(connection->socket_fd,
+                                connection->receive_buffer + connection->receive_used,
+                                connection->receive_capacity - connection->receive_used, 0);
+        if (received == 0) {
+            connection->is_connected = 0;
+            return NET_DISCONNECTED;
+        }
+        if (received < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return NET_TIMEOUT;
+            perror("TCP receive failed");
+            connection->is_connected = 0;
+            return NET_ERROR;
+        }
+        
+        connection->receive_used += (size_t)received;
+        connection->bytes_received += (unsigned long)received;
+        length = buffered_frame_length(connection);
+    }
+    
+    if (length < 0) {
+        fprintf(stderr, "TCP frame exceeds %d bytes, closing\n", TCP_MAX_FRAME_SIZE);
+        connection->is_connected = 0;
+        return NET_ERROR;
+    }
+    if ((size_t)length > buffer_size) {
+        return NET_ERROR; // Frame stays buffered for a larger buffer
+    }
+    
+    memcpy(buffer, connection->receive_buffer + connection->receive_start + sizeof(uint32_t),
+           (size_t)length);
+    connection->receive_start += sizeof(uint32_t) + (size_t)length;
+    if (connection->receive_start == connection->receive_used) {
+        connection->receive_start = 0;
+        connection->receive_used = 0;
+    }
+    
+    connection->frames_received++;
+    if (frame_length) {
+        *frame_length = (size_t)length;
+    }
+    return NET_SUCCESS;
+}
+
+tcp_pool_t* tcp_pool_init(void) {
+    tcp_pool_t* pool = (tcp_pool_t*)malloc(sizeof(tcp_pool_t));
+    if (!pool) return NULL;
+    
+    memset(pool, 0, sizeof(tcp_pool_t));
+    pthread_mutex_init(&pool->lock, NULL);
+    return pool;
+}
+
+// Caller holds pool->lock
+static tcp_pool_entry_t* find_entry(tcp_pool_t* pool, const char* drone_id) {
+    for (int i = 0; i < pool->entry_count; i++) {
+        if (strncmp(pool->entries[i].drone_id, drone_id, MAX_DRONE_ID) == 0) {
+            return &pool->entries[i];
+        }
+    }
+    return NULL;
+}
+
+network_result_t tcp_pool_add_drone(tcp_pool_t* pool, const char* drone_id,
+                                    const char* ip, int port) {
+    if (!pool || !drone_id || !ip) return NET_ERROR;
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, ip, &address.sin_addr) != 1) return NET_ERROR;
+    
+    pthread_mutex_lock(&pool->lock);
+    
+    tcp_pool_entry_t* entry = find_entry(pool, drone_id);
+    if (!entry) {
+        if (pool->entry_count >= MAX_DRONES) {
+            pthread_mutex_unlock(&pool->lock);
+            return NET_ERROR;
+        }
+        entry = &pool->entries[pool->entry_count++];
+        memset(entry, 0, sizeof(tcp_pool_entry_t));
+        strncpy(entry->drone_id, drone_id, MAX_DRONE_ID - 1);
+    }
+    entry->address = address;
+    
+    pthread_mutex_unlock(&pool->lock);
+    return NET_SUCCESS;
+}
+
+tcp_connection_t* tcp_pool_acquire(tcp_pool_t* pool, const char* drone_id) {
+    if (!pool || !drone_id) return NULL;
+    
+    pthread_mutex_lock(&pool->lock);
+    
+    tcp_pool_entry_t* entry = find_entry(pool, drone_id);
+    if (!entry) {
+        pthread_mutex_unlock(&pool->lock);
+        return NULL;
+    }
+    
+    for (int i = 0; i < entry->connection_count; i++) {
+        tcp_connection_t* connection = entry->connections[i];
+        if (!connection->in_use && connection->is_connected) {
+            connection->in_use = 1;
+            pthread_mutex_unlock(&pool->lock);
+            return connection;
+        }
+    }
+    
+    if (entry->connection_count >= TCP_POOL_CONNECTIONS) {
+        pthread_mutex_unlock(&pool->lock);
+        return NULL; // All connections busy
+    }
+    
+    struct sockaddr_in address = entry->address;
+    pthread_mutex_unlock(&pool->lock);
+    
+    // Connect without holding the pool lock
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &address.sin_addr, ip, sizeof(ip));
+    tcp_connection_t* connection = tcp_connect(ip, ntohs(address.sin_port));
+    if (!connection) return NULL;
+    
+    pthread_mutex_lock(&pool->lock);
+    if (entry->connection_count >= TCP_POOL_CONNECTIONS) {
+        pthread_mutex_unlock(&pool->lock);
+        tcp_close(connection);
+        return NULL;
+    }
+    connection->in_use = 1;
+    entry->connections[entry->connection_count++] = connection;
+    pthread_mutex_unlock(&pool->lock);
+    
+    return connection;
+}
+
+void tcp_pool_release(tcp_pool_t* pool, tcp_connection_t* connection, int healthy) {
+    if (!pool || !connection) return;
+    
+    pthread_mutex_lock(&pool->lock);
+    
+    for (int e = 0; e < pool->entry_count; e++) {
+        tcp_pool_entry_t* entry = &pool->entries[e];
+        for (int i = 0; i < entry->connection_count; i++) {
+            if (entry->connections[i] != connection) continue;
+            
+            if (healthy && connection->is_connected) {
+                connection->in_use = 0;
+            } else {
+                entry->connections[i] = entry->connections[--entry->connection_count];
+                tcp_close(connection);
+            }
+            pthread_mutex_unlock(&pool->lock);
+            return;
+        }
+    }
+    
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void tcp_pool_cleanup(tcp_pool_t* pool) {
+    if (pool) {
+        for (int e = 0; e < pool->entry_count; e++) {
+            for (int i = 0; i < pool->entries[e].connection_count; i++) {
+                tcp_close(pool->entries[e].connections[i]);
+            }
+        }
+        pthread_mutex_destroy(&pool->lock);
+        free(pool);
+    }
+}
@@ -0,0 +1,121 @@
+// src/communication/tcp_comm.h
+#ifndef TCP_COMM_H
+#define TCP_COMM_H
+
+#include "common.h"
+#include "../core/network_core.h"
+#include "../protocols/message_protocol.h"
+#include <sys/uio.h>
+
+// Bulk transport for payloads that do not fit a MAX_BUFFER_SIZE datagram
+// (building plans, firmware). Sockets are nonblocking; every frame on the
+// stream is [uint32_t length, network byte order][length bytes].
+
+#define TCP_MAX_FRAME_SIZE (16 * 1024 * 1024)
+#define TCP_INITIAL_RECEIVE_BUFFER 65536
+#define TCP_IO_TIMEOUT_MS 5000
+#define TCP_POOL_CONNECTIONS 4
+#define TCP_MAX_IOVEC 64
+
+// A single TCP connection
+typedef struct {
+    int socket_fd;
+    struct sockaddr_in peer_addr;
+    int is_connected;
+    int in_use;                 // Checked out of a pool
+    int io_timeout_ms;          // Longest wait for send buffer space
+    unsigned char* receive_buffer;
+    size_t receive_capacity;
+    size_t receive_start;       // Start of unconsumed data
+    size_t receive_used;        // End of buffered data
+    unsigned long bytes_sent;
+    unsigned long bytes_received;
+    unsigned long frames_sent;
+    unsigned long frames_received;
+} tcp_connection_t;
+
+// Listening socket for incoming bulk connections
+typedef struct {
+    int listen_fd;
+    int port;
+} tcp_listener_t;
+
+// Connections to one drone
+typedef struct {
+    char drone_id[MAX_DRONE_ID];
+    struct sockaddr_in address;
+    tcp_connection_t* connections[TCP_POOL_CONNECTIONS];
+    int connection_count;
+} tcp_pool_entry_t;
+
+// Connection pool keyed by drone ID
+typedef struct {
+    tcp_pool_entry_t entries[MAX_DRONES];
+    int entry_count;
+    pthread_mutex_t lock;
+} tcp_pool_t;
+
+// Open a nonblocking connection (TCP_NODELAY on by default)
+tcp_connection_t* tcp_connect(const char* server_ip, int port);
+
+// Close and free a connection
+void tcp_close(tcp_connection_t* connection);
+
+// Start listening on a port
+tcp_listener_t* tcp_listen(int port);
+
+// Accept a pending connection, NULL if none is waiting
+tcp_connection_t* tcp_accept(tcp_listener_t* listener);
+
+// Close and free a listener
+void tcp_listener_close(tcp_listener_t* listener);
+
+// Enable/disable Nagle bypass
+network_result_t tcp_set_nodelay(tcp_connection_t* connection, int enabled);
+
+// Hold back partial segments until uncorked (Linux TCP_CORK)
+network_result_t tcp_set_cork(tcp_connection_t* connection, int enabled);
+
+// Longest a send waits for the peer to make room, TCP_IO_TIMEOUT_MS by
+// default; 0 gives up as soon as the send buffer is full
+network_result_t tcp_set_io_timeout(tcp_connection_t* connection, int timeout_ms);
+
+// Send one length-prefixed frame. NET_TIMEOUT if the peer stops reading
+// for the connection's I/O timeout; if that happens mid-frame the
+// connection is marked disconnected, since the stream can no longer be framed.
+network_result_t tcp_send_frame(tcp_connection_t* connection, const void* data, size_t length);
+
+// Write what the socket takes right now, never waiting. Returns the bytes
+// written (0 when the send buffer is full) or -1 if the connection broke;
+// the caller frames the bytes and resumes a partial write.
+long tcp_write_nowait(tcp_connection_t* connection, const struct iovec* iov, int count);
+
+// Send several frames with a single writev
+network_result_t tcp_send_frames(tcp_connection_t* connection,
+                                 const struct iovec* frames, int frame_count);
+
+// Send a protocol message of any size; the payload is not copied
+network_result_t tcp_send_message(tcp_connection_t* connection, const message_header_t* message);
+
+// Read whatever is available and return the next complete frame.
+// NET_TIMEOUT if no complete frame is buffered yet, NET_DISCONNECTED on EOF.
+network_result_t tcp_receive_frame(tcp_connection_t* connection, void* buffer,
+                                   size_t buffer_size, size_t* frame_length);
+
+// Create an empty pool
+tcp_pool_t* tcp_pool_init(void);
+
+// Register a drone's bulk endpoint
+network_result_t tcp_pool_add_drone(tcp_pool_t* pool, const char* drone_id,
+                                    const char* ip, int port);
+
+// Borrow an idle connection to a drone, connecting if needed
+tcp_connection_t* tcp_pool_acquire(tcp_pool_t* pool, const char* drone_id);
+
+// Return a connection; unhealthy connections are closed
+void tcp_pool_release(tcp_pool_t* pool, tcp_connection_t* connection, int healthy);
+
+// Close every pooled connection and free the pool
+void tcp_pool_cleanup(tcp_pool_t* pool);
+
+#endif
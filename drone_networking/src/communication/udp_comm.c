@@ -1,5 +1,7 @@
 // src/communication/udp_comm.c
 #include "udp_comm.h"
+#include "../core/buffer_pool.h"
+#include "priority_queue.h"
 
 udp_context_t* udp_init(const char* server_ip, int port) {
     udp_context_t* context = (udp_context_t*)malloc(sizeof(udp_context_t));
@@ -26,14 +28,24 @@ network_result_t udp_send_message(udp_context_t* context,
                                  size_t message_size) {
     if (!context || !message) return NET_ERROR;
     
-    // Serialize message
-    char buffer[MAX_BUFFER_SIZE];
-    int serialized_size = serialize_message(message, buffer, sizeof(buffer));
+    // Queued messages are checksummed when priority_queue_send takes them
+    if (context->outbound) {
+        return priority_queue_push(context->outbound, message, message_size);
+    }
+    
+    // Serialize message into a pooled buffer
+    void* buffer = buffer_pool_acquire();
+    if (!buffer) return NET_ERROR;
+    
+    int serialized_size = serialize_message(message, buffer, MAX_BUFFER_SIZE);
     if (serialized_size < 0) {
+        buffer_pool_release(buffer);
         return NET_ERROR;
     }
     
-    return network_send_data(context->net_config, buffer, serialized_size);
+    network_result_t result = network_send_data(context->net_config, buffer, serialized_size);
+    buffer_pool_release(buffer);
+    return result;
 }
 
 network_result_t udp_receive_message(udp_context_t* context, 
@@ -41,10 +53,13 @@ network_result_t udp_receive_message(udp_context_t* context,
                                    size_t buffer_size) {
     if (!context || !buffer) return NET_ERROR;
     
-    network_result_t result = network_receive_data(context->net_config, buffer, buffer_size);
+    size_t received = 0;
+    network_result_t result = network_receive_data_from(context->net_config, buffer, buffer_size,
+                                                        &received, &context->net_config->server_addr);
     if (result == NET_SUCCESS) {
-        // Validate received message
-        if (!validate_message(buffer, buffer_size)) {
+        // Validate over what arrived; the rest of the buffer is stale
+        if (!validate_message(buffer, received)) {
+            network_record_checksum_failure(context->net_config);
             return NET_ERROR;
         }
     }
@@ -52,6 +67,49 @@ network_result_t udp_receive_message(udp_context_t* context,
     return result;
 }
 
+network_result_t udp_receive_dispatch(udp_context_t* context,
+                                      message_dispatcher_t* dispatcher) {
+    if (!context || !dispatcher) return NET_ERROR;
+    
+    // Aligned so a plain message can be viewed in place
+    union {
+        uint64_t align;
+        unsigned char bytes[MAX_BUFFER_SIZE];
+    } buffer;
+    size_t received = 0;
+    
+    network_result_t result = network_receive_data_from(context->net_config, buffer.bytes,
+                                                        sizeof(buffer.bytes), &received, NULL);
+    if (result != NET_SUCCESS) return result;
+    
+    if (!udp_is_coalesced_frame(buffer.bytes, received)) {
+        if (message_dispatch(dispatcher, buffer.bytes, received) < 0) {
+            network_record_checksum_failure(context->net_config);
+            return NET_ERROR;
+        }
+        return NET_SUCCESS;
+    }
+    
+    size_t offset = 0;
+    const void* record;
+    size_t record_length;
+    int status;
+    while ((status = udp_coalesced_next(buffer.bytes, received, &offset,
+                                        &record, &record_length)) == 1) {
+        if (message_dispatch(dispatcher, record, record_length) < 0) {
+            network_record_checksum_failure(context->net_config);
+        }
+    }
+    
+    return status == 0 ? NET_SUCCESS : NET_ERROR;
+}
+
+void udp_set_outbound_queue(udp_context_t* context, struct priority_queue* queue) {
+    if (context) {
+        context->outbound = queue;
+    }
+}
+
 void udp_set_broadcast(udp_context_t* context, int enabled) {
     if (context) {
         context->broadcast_enabled = enabled;
@@ -64,6 +122,133 @@ void udp_set_broadcast(udp_context_t* context, int enabled) {
     }
 }
 
+// Serialize into a pooled buffer and send to an explicit destination
+static network_result_t send_message_to(udp_context_t* context, const message_header_t* message,
+                                        const struct sockaddr_in* destination) {
+    void* buffer = buffer_pool_acquire();
+    if (!buffer) return NET_ERROR;
+    
+    int serialized_size = serialize_message(message, buffer, MAX_BUFFER_SIZE);
+    if (serialized_size < 0) {
+        buffer_pool_release(buffer);
+        return NET_ERROR;
+    }
+    
+    network_result_t result = network_send_data_to(context->net_config, buffer,
+                                                   (size_t)serialized_size, destination);
+    buffer_pool_release(buffer);
+    return result;
+}
+
+network_result_t udp_send_broadcast(udp_context_t* context,
+                                    const message_header_t* message,
+                                    size_t message_size) {
+    if (!context || !message || !context->broadcast_enabled) return NET_ERROR;
+    (void)message_size;
+    
+    struct sockaddr_in destination;
+    memset(&destination, 0, sizeof(destination));
+    destination.sin_family = AF_INET;
+    destination.sin_port = htons(context->broadcast_port);
+    if (inet_pton(AF_INET, context->broadcast_address, &destination.sin_addr) != 1) {
+        return NET_ERROR;
+    }
+    
+    return send_message_to(context, message, &destination);
+}
+
+static udp_group_t* find_group(udp_context_t* context, const char* name) {
+    for (int i = 0; i < context->group_count; i++) {
+        if (strncmp(context->groups[i].name, name, UDP_GROUP_NAME_LENGTH) == 0) {
+            return &context->groups[i];
+        }
+    }
+    return NULL;
+}
+
+network_result_t udp_group_add(udp_context_t* context, const char* name,
+                               const char* group_ip, int port) {
+    if (!context || !name || !group_ip) return NET_ERROR;
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, group_ip, &address.sin_addr) != 1) {
+        return NET_ERROR;
+    }
+    
+    udp_group_t* group = find_group(context, name);
+    if (!group) {
+        if (context->group_count >= UDP_MAX_GROUPS) return NET_ERROR;
+        group = &context->groups[context->group_count++];
+        memset(group, 0, sizeof(udp_group_t));
+        strncpy(group->name, name, UDP_GROUP_NAME_LENGTH - 1);
+    }
+    group->address = address;
+    return NET_SUCCESS;
+}
+
+const udp_group_t* udp_group_find(const udp_context_t* context, const char* name) {
+    if (!context || !name) return NULL;
+    return find_group((udp_context_t*)context, name);
+}
+
+static network_result_t set_membership(udp_context_t* context, const char* name, int join) {
+    if (!context || !name || context->net_config->socket_fd < 0) return NET_ERROR;
+    
+    udp_group_t* group = find_group(context, name);
+    if (!group || !IN_MULTICAST(ntohl(group->address.sin_addr.s_addr))) return NET_ERROR;
+    if (group->joined == join) return NET_SUCCESS;
+    
+    struct ip_mreq request;
+    request.imr_multiaddr = group->address.sin_addr;
+    request.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (setsockopt(context->net_config->socket_fd, IPPROTO_IP,
+                   join ? IP_ADD_MEMBERSHIP : IP_DROP_MEMBERSHIP,
+                   &request, sizeof(request)) < 0) {
+        perror(join ? "Join multicast group failed" : "Leave multicast group failed");
+        return NET_ERROR;
+    }
+    
+    group->joined = join;
+    return NET_SUCCESS;
+}
+
+network_result_t udp_group_join(udp_context_t* context, const char* name) {
+    return set_membership(context, name, 1);
+}
+
+network_result_t udp_group_leave(udp_context_t* context, const char* name) {
+    return set_membership(context, name, 0);
+}
+
+network_result_t udp_set_multicast_options(udp_context_t* context, int ttl, int loopback) {
+    if (!context || context->net_config->socket_fd < 0) return NET_ERROR;
+    
+    unsigned char ttl_value = (unsigned char)(ttl > 0 ? ttl : UDP_MULTICAST_DEFAULT_TTL);
+    unsigned char loop_value = loopback ? 1 : 0;
+    if (setsockopt(context->net_config->socket_fd, IPPROTO_IP, IP_MULTICAST_TTL,
+                   &ttl_value, sizeof(ttl_value)) < 0 ||
+        setsockopt(context->net_config->socket_fd, IPPROTO_IP, IP_MULTICAST_LOOP,
+                   &loop_value, sizeof(loop_value)) < 0) {
+        perror("Set multicast options failed");
+        return NET_ERROR;
+    }
+    return NET_SUCCESS;
+}
+
+network_result_t udp_send_group(udp_context_t* context, const char* name,
+                                const message_header_t* message, size_t message_size) {
+    if (!context || !name || !message) return NET_ERROR;
+    (void)message_size;
+    
+    udp_group_t* group = find_group(context, name);
+    if (!group) return NET_ERROR;
+    
+    return send_message_to(context, message, &group->address);
+}
+
 void udp_cleanup(udp_context_t* context) {
     if (context) {
         if (context->net_config) {
@@ -71,4 +256,220 @@ void udp_cleanup(udp_context_t* context) {
         }
         free(context);
     }
-}
\ No newline at end of file
+}
+
+udp_coalescer_t* udp_coalescer_init(udp_context_t* context, size_t flush_threshold,
+                                    unsigned int max_delay_ms) {
+    if (!context) return NULL;
+    
+    udp_coalescer_t* coalescer = (udp_coalescer_t*)malloc(sizeof(udp_coalescer_t));
+    if (!coalescer) return NULL;
+    
+    memset(coalescer, 0, sizeof(udp_coalescer_t));
+    
+    if (flush_threshold == 0 || flush_threshold > UDP_COALESCE_MTU) {
+        flush_threshold = UDP_COALESCE_MTU;
+    }
+    if (max_delay_ms == 0) {
+        max_delay_ms = UDP_COALESCE_DEFAULT_DELAY_MS;
+    }
+    
+    coalescer->udp = context;
+    coalescer->used = sizeof(coalesced_frame_header_t);
+    coalescer->flush_threshold = flush_threshold;
+    coalescer->max_delay_ns = (uint64_t)max_delay_ms * 1000000ULL;
+    pthread_mutex_init(&coalescer->lock, NULL);
+    
+    return coalescer;
+}
+
+_Static_assert(sizeof(coalesced_frame_header_t) % UDP_COALESCE_ALIGN == 0 &&
+               UDP_COALESCE_MTU % UDP_COALESCE_ALIGN == 0,
+               "coalesced records must stay aligned");
+_Static_assert(__alignof__(status_update_message_t) <= UDP_COALESCE_ALIGN,
+               "message_dispatch views aligned records in place");
+
+// Frame bytes taken by a record: aligned length prefix, body, padding
+static size_t coalesced_record_space(size_t length) {
+    size_t mask = UDP_COALESCE_ALIGN - 1;
+    return UDP_COALESCE_ALIGN + ((length + mask) & ~mask);
+}
+
+// Caller holds coalescer->lock
+static network_result_t coalescer_flush_locked(udp_coalescer_t* coalescer) {
+    if (coalescer->record_count == 0) return NET_SUCCESS;
+    
+    coalesced_frame_header_t header;
+    header.magic_number = UDP_COALESCE_MAGIC;
+    header.record_count = coalescer->record_count;
+    header.frame_length = (uint16_t)coalescer->used;
+    memcpy(coalescer->frame, &header, sizeof(header));
+    
+    network_result_t result = network_send_data(coalescer->udp->net_config,
+                                                coalescer->frame, coalescer->used);
+    
+    coalescer->frames_sent++;
+    coalescer->records_sent += coalescer->record_count;
+    coalescer->used = sizeof(coalesced_frame_header_t);
+    coalescer->record_count = 0;
+    return result;
+}
+
+// Reserve room for a record of the given length, flushing first if needed.
+// Returns the record body position or NULL if the record can never fit.
+static unsigned char* coalescer_reserve_locked(udp_coalescer_t* coalescer, size_t length,
+                                               network_result_t* result) {
+    size_t needed = coalesced_record_space(length);
+    
+    *result = NET_SUCCESS;
+    if (sizeof(coalesced_frame_header_t) + needed > UDP_COALESCE_MTU) {
+        return NULL;
+    }
+    if (coalescer->used + needed > UDP_COALESCE_MTU) {
+        *result = coalescer_flush_locked(coalescer);
+    }
+    
+    unsigned char* slot = coalescer->frame + coalescer->used;
+    uint16_t record_length = (uint16_t)length;
+    memset(slot, 0, UDP_COALESCE_ALIGN);
+    memcpy(slot, &record_length, sizeof(record_length));
+    return slot + UDP_COALESCE_ALIGN;
+}
+
+// Account for a record written by the caller
+static network_result_t coalescer_commit_locked(udp_coalescer_t* coalescer, size_t length) {
+    if (coalescer->record_count == 0) {
+        coalescer->oldest_record_ns = network_monotonic_ns();
+    }
+    size_t space = coalesced_record_space(length);
+    unsigned char* padding = coalescer->frame + coalescer->used + UDP_COALESCE_ALIGN + length;
+    memset(padding, 0, space - UDP_COALESCE_ALIGN - length);
+    coalescer->used += space;
+    coalescer->record_count++;
+    
+    if (coalescer->used >= coalescer->flush_threshold) {
+        return coalescer_flush_locked(coalescer);
+    }
+    return NET_SUCCESS;
+}
+
+network_result_t udp_coalesce_data(udp_coalescer_t* coalescer,
+                                   const void* data, size_t length) {
+    if (!coalescer || !data) return NET_ERROR;
+    
+    pthread_mutex_lock(&coalescer->lock);
+    
+    network_result_t result;
+    unsigned char* body = coalescer_reserve_locked(coalescer, length, &result);
+    if (!body) {
+        pthread_mutex_unlock(&coalescer->lock);
+        // Too large to coalesce, send on its own
+        return network_send_data(coalescer->udp->net_config, data, length);
+    }
+    
+    memcpy(body, data, length);
+    network_result_t commit_result = coalescer_commit_locked(coalescer, length);
+    
+    pthread_mutex_unlock(&coalescer->lock);
+    return result != NET_SUCCESS ? result : commit_result;
+}
+
+network_result_t udp_coalesce_message(udp_coalescer_t* coalescer,
+                                      const message_header_t* message) {
+    if (!coalescer || !message) return NET_ERROR;
+    
+    size_t length = sizeof(message_header_t) + message->payload_length;
+    
+    pthread_mutex_lock(&coalescer->lock);
+    
+    network_result_t result;
+    unsigned char* body = coalescer_reserve_locked(coalescer, length, &result);
+    if (!body) {
+        pthread_mutex_unlock(&coalescer->lock);
+        return udp_send_message(coalescer->udp, message, length);
+    }
+    
+    // Serialize straight into the frame
+    int serialized_size = serialize_message(message, body, length);
+    network_result_t commit_result = NET_ERROR;
+    if (serialized_size >= 0) {
+        commit_result = coalescer_commit_locked(coalescer, (size_t)serialized_size);
+    }
+    
+    pthread_mutex_unlock(&coalescer->lock);
+    return result != NET_SUCCESS ? result : commit_result;
+}
+
+network_result_t udp_coalescer_poll(udp_coalescer_t* coalescer) {
+    if (!coalescer) return NET_ERROR;
+    
+    network_result_t result = NET_SUCCESS;
+    
+    pthread_mutex_lock(&coalescer->lock);
+    if (coalescer->record_count > 0 &&
+        network_monotonic_ns() - coalescer->oldest_record_ns >= coalescer->max_delay_ns) {
+        result = coalescer_flush_locked(coalescer);
+    }
+    pthread_mutex_unlock(&coalescer->lock);
+    
+    return result;
+}
+
+network_result_t udp_coalescer_flush(udp_coalescer_t* coalescer) {
+    if (!coalescer) return NET_ERROR;
+    
+    pthread_mutex_lock(&coalescer->lock);
+    network_result_t result = coalescer_flush_locked(coalescer);
+    pthread_mutex_unlock(&coalescer->lock);
+    
+    return result;
+}
+
+void udp_coalescer_cleanup(udp_coalescer_t* coalescer) {
+    if (coalescer) {
+        udp_coalescer_flush(coalescer);
+        pthread_mutex_destroy(&coalescer->lock);
+        free(coalescer);
+    }
+}
+
+int udp_is_coalesced_frame(const void* buffer, size_t length) {
+    if (!buffer || length < sizeof(coalesced_frame_header_t)) return 0;
+    
+    coalesced_frame_header_t header;
+    memcpy(&header, buffer, sizeof(header));
+    return header.magic_number == UDP_COALESCE_MAGIC &&
+           header.frame_length <= length;
+}
+
+int udp_coalesced_next(const void* frame, size_t length, size_t* offset,
+                       const void** record, size_t* record_length) {
+    if (!udp_is_coalesced_frame(frame, length) || !offset || !record || !record_length) {
+        return -1;
+    }
+    
+    const unsigned char* bytes = (const unsigned char*)frame;
+    coalesced_frame_header_t header;
+    memcpy(&header, frame, sizeof(header));
+    
+    if (*offset == 0) {
+        *offset = sizeof(coalesced_frame_header_t);
+    }
+    if (*offset >= header.frame_length) {
+        return 0;
+    }
+    if (*offset + UDP_COALESCE_ALIGN > header.frame_length) {
+        return -1;
+    }
+    
+    uint16_t size;
+    memcpy(&size, bytes + *offset, sizeof(size));
+    if (*offset + coalesced_record_space(size) > header.frame_length) {
+        return -1;
+    }
+    
+    *record = bytes + *offset + UDP_COALESCE_ALIGN;
+    *record_length = size;
+    *offset += coalesced_record_space(size);
+    return 1;
+}
@@ -3,33 +3,145 @@
 #define UDP_COMM_H
 
 #include "common.h"
+#include "../core/network_core.h"
 #include "../protocols/message_protocol.h"
 
+// Telemetry coalescing
+#define UDP_COALESCE_MAGIC 0xC0A1E5CE
+#define UDP_COALESCE_MTU 1400
+#define UDP_COALESCE_DEFAULT_DELAY_MS 10
+#define UDP_COALESCE_ALIGN 8            // Record alignment inside a frame
+
+// Group addressing
+#define UDP_MAX_GROUPS 16
+#define UDP_GROUP_NAME_LENGTH 32
+#define UDP_MULTICAST_DEFAULT_TTL 1     // Stay on the site network
+
+// Named multicast (or broadcast) destination, e.g. one per site or building
+typedef struct {
+    char name[UDP_GROUP_NAME_LENGTH];
+    struct sockaddr_in address;
+    int joined;                 // This socket receives the group's traffic
+} udp_group_t;
+
+struct priority_queue;
+
 // UDP communication context
 typedef struct {
     network_config_t* net_config;
+    struct priority_queue* outbound;    // udp_send_message queues here when set
     int broadcast_enabled;
     char broadcast_address[16];
     int broadcast_port;
+    udp_group_t groups[UDP_MAX_GROUPS];
+    int group_count;
 } udp_context_t;
 
+// Header of a coalesced frame, followed by record_count records of
+// [uint16_t length][6 zero bytes][length bytes][zero padding to 8 bytes],
+// so every record starts 8-byte aligned and dispatches in place
+typedef struct {
+    uint32_t magic_number;      // UDP_COALESCE_MAGIC
+    uint16_t record_count;      // Records in this frame
+    uint16_t frame_length;      // Total frame length including this header
+} coalesced_frame_header_t;
+
+// Packs many small messages into one MTU-sized datagram
+typedef struct {
+    udp_context_t* udp;
+    unsigned char frame[UDP_COALESCE_MTU];
+    size_t used;                // Bytes used in frame, including header
+    uint16_t record_count;
+    size_t flush_threshold;     // Flush once the frame reaches this size
+    uint64_t max_delay_ns;      // Flush once the oldest record is this old
+    uint64_t oldest_record_ns;
+    unsigned long frames_sent;
+    unsigned long records_sent;
+    pthread_mutex_t lock;       // Relays may feed one coalescer from several threads
+} udp_coalescer_t;
+
 // Initialize UDP communication
 udp_context_t* udp_init(const char* server_ip, int port);
 
-// Send message via UDP
+// Send message via UDP, or queue it if an outbound queue is set
 network_result_t udp_send_message(udp_context_t* context, 
                                  const message_header_t* message, 
                                  size_t message_size);
 
-// Receive message via UDP
+// Receive one plain message via UDP (not coalesced or delta frames)
 network_result_t udp_receive_message(udp_context_t* context, 
                                    void* buffer, 
                                    size_t buffer_size);
 
+// Receive one datagram and dispatch it (each record, if coalesced) through
+// the handler table without copying aligned messages. Delta telemetry
+// frames go to the dispatcher's delta handler
+// (message_dispatcher_set_delta_handler).
+network_result_t udp_receive_dispatch(udp_context_t* context,
+                                      message_dispatcher_t* dispatcher);
+
+// Route udp_send_message through a priority queue (NULL sends directly).
+// The caller drains it with priority_queue_send(queue, context, ...).
+void udp_set_outbound_queue(udp_context_t* context, struct priority_queue* queue);
+
 // Enable/disable broadcast
 void udp_set_broadcast(udp_context_t* context, int enabled);
 
+// Send a message to broadcast_address (broadcast must be enabled)
+network_result_t udp_send_broadcast(udp_context_t* context,
+                                    const message_header_t* message,
+                                    size_t message_size);
+
+// Register a named group address (multicast 224.0.0.0/4 or broadcast)
+network_result_t udp_group_add(udp_context_t* context, const char* name,
+                               const char* group_ip, int port);
+
+// Look up a registered group
+const udp_group_t* udp_group_find(const udp_context_t* context, const char* name);
+
+// Start receiving a multicast group; the socket must be bound to its port
+network_result_t udp_group_join(udp_context_t* context, const char* name);
+
+// Stop receiving a multicast group
+network_result_t udp_group_leave(udp_context_t* context, const char* name);
+
+// Set multicast TTL and whether our own group sends loop back to us
+network_result_t udp_set_multicast_options(udp_context_t* context, int ttl, int loopback);
+
+// Send one copy of a message to every member of a group
+network_result_t udp_send_group(udp_context_t* context, const char* name,
+                                const message_header_t* message, size_t message_size);
+
 // Cleanup UDP context
 void udp_cleanup(udp_context_t* context);
 
+// Create a coalescer (0 selects UDP_COALESCE_MTU / UDP_COALESCE_DEFAULT_DELAY_MS)
+udp_coalescer_t* udp_coalescer_init(udp_context_t* context, size_t flush_threshold,
+                                    unsigned int max_delay_ms);
+
+// Queue a message; sends the frame when full or past the size threshold
+network_result_t udp_coalesce_message(udp_coalescer_t* coalescer,
+                                      const message_header_t* message);
+
+// Queue an already encoded record (e.g. a status delta frame)
+network_result_t udp_coalesce_data(udp_coalescer_t* coalescer,
+                                   const void* data, size_t length);
+
+// Send the frame if its oldest record has waited longer than max delay
+network_result_t udp_coalescer_poll(udp_coalescer_t* coalescer);
+
+// Send any queued records now
+network_result_t udp_coalescer_flush(udp_coalescer_t* coalescer);
+
+// Flush and free a coalescer (the UDP context is not freed)
+void udp_coalescer_cleanup(udp_coalescer_t* coalescer);
+
+// Check whether a received datagram is a coalesced frame
+int udp_is_coalesced_frame(const void* buffer, size_t length);
+
+// Iterate the records of a coalesced frame without copying. Start with
+// *offset = 0; returns 1 with record/record_length set, 0 at the end, -1 if malformed
+int udp_coalesced_next(const void* frame, size_t length, size_t* offset,
+                       const void** record, size_t* record_length);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,157 @@
+// src/core/buffer_pool.c
+#include "buffer_pool.h"
+
+#define FREELIST_EMPTY 0xFFFFFFFFu
+
+// Shared freelist: a Treiber stack of buffer indices. The head packs a
+// 32-bit ABA tag above the 32-bit top index so a CAS can't succeed against
+// a head that was popped and pushed back in between.
+static unsigned char* pool_slab = NULL;
+static uint32_t pool_next[BUFFER_POOL_BUFFER_COUNT];
+static uint64_t pool_head = FREELIST_EMPTY;
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+static pthread_key_t pool_cache_key;
+
+static unsigned long pool_cache_hits = 0;
+static unsigned long pool_shared_hits = 0;
+static unsigned long pool_misses = 0;
+static unsigned long pool_in_use = 0;
+
+// Per-thread cache of free buffer indices
+typedef struct {
+    uint32_t count;
+    uint32_t indices[BUFFER_POOL_CACHE_SIZE];
+} buffer_cache_t;
+
+static __thread buffer_cache_t thread_cache;
+static __thread int thread_cache_registered = 0;
+
+static uint64_t make_head(uint32_t tag, uint32_t index) {
+    return ((uint64_t)tag << 32) | index;
+}
+
+static void freelist_push(uint32_t index) {
+    uint64_t head = __atomic_load_n(&pool_head, __ATOMIC_RELAXED);
+    uint64_t next_head;
+    do {
+        __atomic_store_n(&pool_next[index], (uint32_t)head, __ATOMIC_RELAXED);
+        next_head = make_head((uint32_t)(head >> 32) + 1, index);
+    } while (!__atomic_compare_exchange_n(&pool_head, &head, next_head, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+static uint32_t freelist_pop(void) {
+    uint64_t head = __atomic_load_n(&pool_head, __ATOMIC_ACQUIRE);
+    uint64_t next_head;
+    do {
+        uint32_t index = (uint32_t)head;
+        if (index == FREELIST_EMPTY) return FREELIST_EMPTY;
+        uint32_t next = __atomic_load_n(&pool_next[index], __ATOMIC_RELAXED);
+        next_head = make_head((uint32_t)(head >> 32) + 1, next);
+    } while (!__atomic_compare_exchange_n(&pool_head, &head, next_head, 1,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+    return (uint32_t)head;
+}
+
+// Hand a finished thread's cached buffers back to the shared freelist
+static void release_thread_cache(void* cache_ptr) {
+    buffer_cache_t* cache = (buffer_cache_t*)cache_ptr;
+    while (cache->count > 0) {
+        freelist_push(cache->indices[--cache->count]);
+    }
+}
+
+static void pool_setup(void) {
+    if (posix_memalign((void**)&pool_slab, 64,
+                       (size_t)BUFFER_POOL_BUFFER_COUNT * BUFFER_POOL_BUFFER_SIZE) != 0) {
+        fprintf(stderr, "Failed to allocate buffer pool, using malloc\n");
+        pool_slab = NULL;
+        return;
+    }
+    
+    pthread_key_create(&pool_cache_key, release_thread_cache);
+    for (uint32_t i = BUFFER_POOL_BUFFER_COUNT; i > 0; i--) {
+        freelist_push(i - 1);
+    }
+}
+
+static buffer_cache_t* get_thread_cache(void) {
+    if (!thread_cache_registered) {
+        pthread_setspecific(pool_cache_key, &thread_cache);
+        thread_cache_registered = 1;
+    }
+    return &thread_cache;
+}
+
+void* buffer_pool_acquire(void) {
+    pthread_once(&pool_once, pool_setup);
+    
+    if (pool_slab) {
+        buffer_cache_t* cache = get_thread_cache();
+        
+        if (cache->count > 0) {
+            __atomic_fetch_add(&pool_cache_hits, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&pool_in_use, 1, __ATOMIC_RELAXED);
+            return pool_slab + (size_t)cache->indices[--cache->count] * BUFFER_POOL_BUFFER_SIZE;
+        }
+        
+        // Refill half the cache in one visit to the shared list
+        uint32_t index = freelist_pop();
+        if (index != FREELIST_EMPTY) {
+            while (cache->count < BUFFER_POOL_CACHE_SIZE / 2) {
+                uint32_t extra = freelist_pop();
+                if (extra == FREELIST_EMPTY) break;
+                cache->indices[cache->count++] = extra;
+            }
+            __atomic_fetch_add(&pool_shared_hits, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&pool_in_use, 1, __ATOMIC_RELAXED);
+            return pool_slab + (size_t)index * BUFFER_POOL_BUFFER_SIZE;
+        }
+    }
+    
+    __atomic_fetch_add(&pool_misses, 1, __ATOMIC_RELAXED);
+    return malloc(BUFFER_POOL_BUFFER_SIZE);
+}
+
+void buffer_pool_release(void* buffer) {
+    if (!buffer) return;
+    
+    unsigned char* bytes = (unsigned char*)buffer;
+    size_t slab_size = (size_t)BUFFER_POOL_BUFFER_COUNT * BUFFER_POOL_BUFFER_SIZE;
+    if (!pool_slab || bytes < pool_slab || bytes >= pool_slab + slab_size) {
+        free(buffer); // Overflow allocation from a miss
+        return;
+    }
+    
+    uint32_t index = (uint32_t)((size_t)(bytes - pool_slab) / BUFFER_POOL_BUFFER_SIZE);
+    buffer_cache_t* cache = get_thread_cache();
+    
+    // Spill half the cache when full so the next releases stay local
+    if (cache->count == BUFFER_POOL_CACHE_SIZE) {
+        while (cache->count > BUFFER_POOL_CACHE_SIZE / 2) {
+            freelist_push(cache->indices[--cache->count]);
+        }
+    }
+    cache->indices[cache->count++] = index;
+    __atomic_fetch_sub(&pool_in_use, 1, __ATOMIC_RELAXED);
+}
+
+void buffer_pool_get_stats(buffer_pool_stats_t* stats) {
+    if (!stats) return;
+    
+    stats->cache_hits = __atomic_load_n(&pool_cache_hits, __ATOMIC_RELAXED);
+    stats->shared_hits = __atomic_load_n(&pool_shared_hits, __ATOMIC_RELAXED);
+    stats->misses = __atomic_load_n(&pool_misses, __ATOMIC_RELAXED);
+    stats->in_use = __atomic_load_n(&pool_in_use, __ATOMIC_RELAXED);
+}
+
+void buffer_pool_print_stats(void) {
+    buffer_pool_stats_t stats;
+    buffer_pool_get_stats(&stats);
+    
+    printf("=== Buffer Pool ===\n");
+    printf("Thread Cache Hits: %lu\n", stats.cache_hits);
+    printf("Shared Hits: %lu\n", stats.shared_hits);
+    printf("Misses: %lu\n", stats.misses);
+    printf("In Use: %lu\n", stats.in_use);
+}
@@ -0,0 +1,39 @@
+// src/core/buffer_pool.h
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include "common.h"
+
+// Preallocated message buffers for the send/receive hot path.
+//
+// Buffers come from one slab allocated on first use. Each thread keeps a
+// small cache of free buffers and exchanges them in batches with a shared
+// lock-free freelist, so steady-state acquire/release never touches the heap
+// or a lock. When the pool is exhausted acquire falls back to malloc and
+// counts a miss; release hands such buffers back to free.
+
+#define BUFFER_POOL_BUFFER_SIZE (MAX_BUFFER_SIZE + 1024) // Message plus security overhead
+#define BUFFER_POOL_BUFFER_COUNT 512
+#define BUFFER_POOL_CACHE_SIZE 32
+
+// Pool counters
+typedef struct {
+    unsigned long cache_hits;   // Served from the calling thread's cache
+    unsigned long shared_hits;  // Served from the shared freelist
+    unsigned long misses;       // Pool exhausted, fell back to malloc
+    unsigned long in_use;       // Pool buffers currently handed out
+} buffer_pool_stats_t;
+
+// Get a buffer of BUFFER_POOL_BUFFER_SIZE bytes (NULL only if malloc fails)
+void* buffer_pool_acquire(void);
+
+// Return a buffer obtained from buffer_pool_acquire
+void buffer_pool_release(void* buffer);
+
+// Snapshot of pool counters
+void buffer_pool_get_stats(buffer_pool_stats_t* stats);
+
+// Print pool counters
+void buffer_pool_print_stats(void);
+
+#endif
@@ -0,0 +1,53 @@
+// src/core/drone_index.c
+#include "drone_index.h"
+#include "../protocols/checksum.h"
+
+static size_t id_length(const char* drone_id) {
+    return strnlen(drone_id, MAX_DRONE_ID - 1);
+}
+
+int drone_index_init(drone_index_t* index, size_t max_entries, const void* entries,
+                     size_t entry_size, size_t id_offset) {
+    if (!index) return -1;
+    
+    size_t size = 1;
+    while (size < max_entries * 2) size <<= 1;
+    
+    index->slots = (uint32_t*)calloc(size, sizeof(uint32_t));
+    if (!index->slots) return -1;
+    index->mask = size - 1;
+    index->ids = (const char*)entries + id_offset;
+    index->stride = entry_size;
+    return 0;
+}
+
+long drone_index_find(const drone_index_t* index, const char* drone_id) {
+    size_t position = crc32c(drone_id, id_length(drone_id)) & index->mask;
+    
+    for (;;) {
+        uint32_t slot = index->slots[position];
+        if (slot == 0) return -1;
+        if (strncmp(index->ids + (size_t)(slot - 1) * index->stride, drone_id,
+                    MAX_DRONE_ID - 1) == 0) {
+            return (long)(slot - 1);
+        }
+        position = (position + 1) & index->mask;
+    }
+}
+
+void drone_index_insert(drone_index_t* index, uint32_t entry) {
+    const char* drone_id = index->ids + (size_t)entry * index->stride;
+    size_t position = crc32c(drone_id, id_length(drone_id)) & index->mask;
+    
+    while (index->slots[position] != 0) {
+        position = (position + 1) & index->mask;
+    }
+    index->slots[position] = entry + 1;
+}
+
+void drone_index_free(drone_index_t* index) {
+    if (index) {
+        free(index->slots);
+        index->slots = NULL;
+    }
+}
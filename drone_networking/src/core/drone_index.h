@@ -0,0 +1,37 @@
+// src/core/drone_index.h
+#ifndef DRONE_INDEX_H
+#define DRONE_INDEX_H
+
+#include "common.h"
+
+// Open-addressed drone_id lookup over a caller-owned array of entries.
+//
+// The index holds entry numbers only; each entry keeps its own drone_id at
+// a fixed offset, which is where lookups compare. Ids are hashed with
+// crc32c and matched on their first MAX_DRONE_ID - 1 bytes, the part a
+// drone_id field can hold. The table is sized at init to stay at most half
+// full for the entry capacity, so probes stay short and never wrap. Callers
+// provide the locking.
+
+typedef struct {
+    uint32_t* slots;            // 0 = empty, else entry + 1
+    size_t mask;
+    const char* ids;            // drone_id of entry i at ids + i * stride
+    size_t stride;
+} drone_index_t;
+
+// Index up to max_entries entries of entry_size bytes with their drone_id
+// at id_offset. Returns 0, or -1 if out of memory.
+int drone_index_init(drone_index_t* index, size_t max_entries, const void* entries,
+                     size_t entry_size, size_t id_offset);
+
+// Entry number holding drone_id, -1 if none
+long drone_index_find(const drone_index_t* index, const char* drone_id);
+
+// Link an entry whose drone_id is already filled in
+void drone_index_insert(drone_index_t* index, uint32_t entry);
+
+// Free the table (the entries belong to the caller)
+void drone_index_free(drone_index_t* index);
+
+#endif
@@ -0,0 +1,102 @@
+// src/core/latency_histogram.c
+#include "latency_histogram.h"
+
+static int bucket_index(uint64_t value) {
+    if (value < LATENCY_HISTOGRAM_SUB_BUCKETS) {
+        return (int)value; // Exact below the first power-of-two range
+    }
+    
+    int magnitude = 63 - __builtin_clzll(value);
+    int shift = magnitude - LATENCY_HISTOGRAM_SUB_BITS;
+    int sub_bucket = (int)((value >> shift) & (LATENCY_HISTOGRAM_SUB_BUCKETS - 1));
+    return (shift + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS + sub_bucket;
+}
+
+static uint64_t bucket_upper_bound(int index) {
+    int range = index / LATENCY_HISTOGRAM_SUB_BUCKETS;
+    uint64_t sub_bucket = (uint64_t)(index % LATENCY_HISTOGRAM_SUB_BUCKETS);
+    
+    if (range == 0) {
+        return sub_bucket;
+    }
+    
+    int shift = range - 1;
+    uint64_t base = ((uint64_t)LATENCY_HISTOGRAM_SUB_BUCKETS | sub_bucket) << shift;
+    return base + ((1ULL << shift) - 1);
+}
+
+void latency_histogram_init(latency_histogram_t* histogram) {
+    if (histogram) {
+        memset(histogram, 0, sizeof(latency_histogram_t));
+    }
+}
+
+void latency_histogram_record(latency_histogram_t* histogram, uint64_t value_ns) {
+    if (!histogram) return;
+    
+    __atomic_fetch_add(&histogram->counts[bucket_index(value_ns)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->total_count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&histogram->total_ns, value_ns, __ATOMIC_RELAXED);
+    
+    uint64_t max = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+    while (value_ns > max &&
+           !__atomic_compare_exchange_n(&histogram->max_ns, &max, value_ns, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+uint64_t latency_histogram_percentile(const latency_histogram_t* histogram, double percentile) {
+    if (!histogram) return 0;
+    
+    // Sum the buckets rather than trusting total_count, which a concurrent
+    // recorder may have bumped after the bucket we are about to read
+    unsigned long counts[LATENCY_HISTOGRAM_BUCKETS];
+    unsigned long total = 0;
+    for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+        counts[i] = __atomic_load_n(&histogram->counts[i], __ATOMIC_RELAXED);
+        total += counts[i];
+    }
+    if (total == 0) return 0;
+    
+    if (percentile < 0) percentile = 0;
+    if (percentile > 100) percentile = 100;
+    
+    unsigned long target = (unsigned long)((percentile / 100.0) * (double)total + 0.5);
+    if (target == 0) target = 1;
+    
+    unsigned long seen = 0;
+    for (int i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            uint64_t bound = bucket_upper_bound(i);
+            uint64_t max = __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+            return bound < max ? bound : max;
+        }
+    }
+    
+    return __atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED);
+}
+
+unsigned long latency_histogram_count(const latency_histogram_t* histogram) {
+    return histogram ? __atomic_load_n(&histogram->total_count, __ATOMIC_RELAXED) : 0;
+}
+
+double latency_histogram_mean(const latency_histogram_t* histogram) {
+    unsigned long count = latency_histogram_count(histogram);
+    if (count == 0) return 0.0;
+    
+    return (double)__atomic_load_n(&histogram->total_ns, __ATOMIC_RELAXED) / (double)count;
+}
+
+void latency_histogram_print(const latency_histogram_t* histogram, const char* name) {
+    if (!histogram) return;
+    
+    printf("%s: count=%lu mean=%.0fns p50=%luns p99=%luns p999=%luns max=%luns\n",
+           name ? name : "latency",
+           latency_histogram_count(histogram),
+           latency_histogram_mean(histogram),
+           (unsigned long)latency_histogram_percentile(histogram, 50.0),
+           (unsigned long)latency_histogram_percentile(histogram, 99.0),
+           (unsigned long)latency_histogram_percentile(histogram, 99.9),
+           (unsigned long)__atomic_load_n(&histogram->max_ns, __ATOMIC_RELAXED));
+}
@@ -0,0 +1,44 @@
+// src/core/latency_histogram.h
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include "common.h"
+
+// HDR-style latency histogram in nanoseconds.
+//
+// Values are bucketed by power of two and then split into
+// 2^LATENCY_HISTOGRAM_SUB_BITS linear sub-buckets, giving a fixed relative
+// error (about 6% with 4 sub-bits) from 1 ns up to 2^64 ns with no
+// allocation. Recording is a couple of relaxed atomic adds, so any number of
+// threads may record while another thread reads without locks.
+
+#define LATENCY_HISTOGRAM_SUB_BITS 4
+#define LATENCY_HISTOGRAM_SUB_BUCKETS (1 << LATENCY_HISTOGRAM_SUB_BITS)
+#define LATENCY_HISTOGRAM_BUCKETS ((64 - LATENCY_HISTOGRAM_SUB_BITS + 1) * LATENCY_HISTOGRAM_SUB_BUCKETS)
+
+typedef struct {
+    unsigned long counts[LATENCY_HISTOGRAM_BUCKETS];
+    unsigned long total_count;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} latency_histogram_t;
+
+// Reset a histogram to empty
+void latency_histogram_init(latency_histogram_t* histogram);
+
+// Record one sample
+void latency_histogram_record(latency_histogram_t* histogram, uint64_t value_ns);
+
+// Value at a percentile (0-100), upper bound of the containing bucket
+uint64_t latency_histogram_percentile(const latency_histogram_t* histogram, double percentile);
+
+// Number of samples recorded
+unsigned long latency_histogram_count(const latency_histogram_t* histogram);
+
+// Mean of all samples in nanoseconds
+double latency_histogram_mean(const latency_histogram_t* histogram);
+
+// Print count, mean, p50/p99/p999 and max
+void latency_histogram_print(const latency_histogram_t* histogram, const char* name);
+
+#endif
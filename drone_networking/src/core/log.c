@@ -0,0 +1,363 @@
+// src/core/log.c
+#include "log.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#define LOG_MAX_RINGS 256
+#define LOG_LINE_SIZE 512
+#define LOG_IDLE_SLEEP_NS 1000000
+
+typedef struct {
+    const char* format;
+    uint8_t level;
+    uint8_t arg_count;
+    log_arg_t args[LOG_MAX_ARGS];
+    char strings[LOG_MAX_ARGS][LOG_STRING_ARG_SIZE];
+} log_record_t;
+
+// Single producer (owning thread), single consumer (writer thread)
+typedef struct {
+    log_record_t records[LOG_RING_SIZE];
+    unsigned long head;         // Next slot the producer fills
+    unsigned long tail;         // Next slot the consumer drains
+    int closed;                 // Owning thread exited
+    int busy;                   // Producer is between its log_running check and publishing
+} log_ring_t;
+
+static log_ring_t* log_rings[LOG_MAX_RINGS];
+static int log_ring_count = 0;
+static pthread_mutex_t log_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t log_ring_key;
+static pthread_once_t log_key_once = PTHREAD_ONCE_INIT;
+static __thread log_ring_t* thread_ring = NULL;
+
+static FILE* log_output = NULL;
+static pthread_t log_writer;
+static int log_running = 0;
+static int log_stop_requested = 0;
+static unsigned long log_written = 0;
+static unsigned long log_dropped = 0;
+
+static const char* const log_level_names[] = { "DEBUG", "INFO", "WARN", "ERROR" };
+
+log_arg_t log_arg_int(long long value) {
+    log_arg_t arg;
+    arg.type = LOG_ARG_INT;
+    arg.value.i = value;
+    return arg;
+}
+
+log_arg_t log_arg_uint(unsigned long long value) {
+    log_arg_t arg;
+    arg.type = LOG_ARG_UINT;
+    arg.value.u = value;
+    return arg;
+}
+
+log_arg_t log_arg_double(double value) {
+    log_arg_t arg;
+    arg.type = LOG_ARG_DOUBLE;
+    arg.value.d = value;
+    return arg;
+}
+
+log_arg_t log_arg_pointer(const void* value) {
+    log_arg_t arg;
+    arg.type = LOG_ARG_POINTER;
+    arg.value.p = value;
+    return arg;
+}
+
+log_arg_t log_arg_string(const char* value) {
+    log_arg_t arg;
+    arg.type = LOG_ARG_STRING;
+    arg.value.s = value;
+    return arg;
+}
+
+// Format one conversion; spec holds flags/width/precision without length modifiers
+static int format_argument(char* out, size_t size, const char* spec, char conversion,
+                           const log_arg_t* arg) {
+    char full[32];
+    long long as_int = arg->type == LOG_ARG_DOUBLE ? (long long)arg->value.d : arg->value.i;
+    double as_double = arg->type == LOG_ARG_DOUBLE ? arg->value.d
+                     : arg->type == LOG_ARG_UINT ? (double)arg->value.u : (double)arg->value.i;
+    
+    switch (conversion) {
+        case 'd': case 'i':
+            snprintf(full, sizeof(full), "%%%sll%c", spec, conversion);
+            return snprintf(out, size, full, as_int);
+        case 'u': case 'x': case 'X': case 'o':
+            snprintf(full, sizeof(full), "%%%sll%c", spec, conversion);
+            return snprintf(out, size, full, (unsigned long long)as_int);
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            snprintf(full, sizeof(full), "%%%s%c", spec, conversion);
+            return snprintf(out, size, full, as_double);
+        case 'c':
+            snprintf(full, sizeof(full), "%%%sc", spec);
+            return snprintf(out, size, full, (int)as_int);
+        case 's':
+            snprintf(full, sizeof(full), "%%%ss", spec);
+            return snprintf(out, size, full,
+                            arg->type == LOG_ARG_STRING && arg->value.s ? arg->value.s : "(?)");
+        default:
+            snprintf(full, sizeof(full), "%%%sp", spec);
+            return snprintf(out, size, full, arg->value.p);
+    }
+}
+
+// Render a record into a line ending in '\n'
+static size_t format_record(const log_record_t* record, char* line, size_t size) {
+    const char* level = record->level < 4 ? log_level_names[record->level] : "LOG";
+    size_t used = (size_t)snprintf(line, size, "[%s] ", level);
+    int next_arg = 0;
+    
+    for (const char* p = record->format; *p && used < size - 2; p++) {
+        if (*p != '%') {
+            line[used++] = *p;
+            continue;
+        }
+        if (p[1] == '%') {
+            line[used++] = '%';
+            p++;
+            continue;
+        }
+        
+        // Collect flags, width and precision; drop length modifiers
+        char spec[16];
+        size_t spec_len = 0;
+        p++;
+        while (*p && strchr("-+ #0123456789.", *p)) {
+            if (spec_len < sizeof(spec) - 1) spec[spec_len++] = *p;
+            p++;
+        }
+        spec[spec_len] = '\0';
+        while (*p && strchr("hlLqjzt", *p)) {
+            p++;
+        }
+        if (!*p) break;
+        
+        if (next_arg >= record->arg_count) {
+            continue; // Missing argument, skip the conversion
+        }
+        
+        int written = format_argument(line + used, size - used - 1, spec, *p,
+                                      &record->args[next_arg++]);
+        if (written > 0) {
+            used += (size_t)written < size - used - 1 ? (size_t)written : size - used - 2;
+        }
+    }
+    
+    line[used++] = '\n';
+    line[used] = '\0';
+    return used;
+}
+
+static void write_line(const char* line, size_t length) {
+    fwrite(line, 1, length, log_output ? log_output : stdout);
+}
+
+static void release_ring(void* ring_ptr) {
+    log_ring_t* ring = (log_ring_t*)ring_ptr;
+    __atomic_store_n(&ring->closed, 1, __ATOMIC_RELEASE);
+}
+
+static void create_ring_key(void) {
+    pthread_key_create(&log_ring_key, release_ring);
+}
+
+static log_ring_t* get_thread_ring(void) {
+    if (thread_ring) return thread_ring;
+    
+    pthread_once(&log_key_once, create_ring_key);
+    
+    log_ring_t* ring = NULL;
+    int free_slot = -1;
+    
+    pthread_mutex_lock(&log_registry_lock);
+    for (int i = 0; i < log_ring_count && !ring; i++) {
+        log_ring_t* candidate = log_rings[i];
+        if (!candidate) {
+            if (free_slot < 0) free_slot = i;
+        } else if (__atomic_load_n(&candidate->closed, __ATOMIC_ACQUIRE)) {
+            // Take over an exited thread's ring; whatever it left queued is
+            // still drained ahead of our records
+            __atomic_store_n(&candidate->closed, 0, __ATOMIC_RELAXED);
+            ring = candidate;
+        }
+    }
+    if (!ring) {
+        if (free_slot < 0 && log_ring_count < LOG_MAX_RINGS) free_slot = log_ring_count;
+        if (free_slot >= 0) ring = (log_ring_t*)calloc(1, sizeof(log_ring_t));
+        if (ring) {
+            __atomic_store_n(&log_rings[free_slot], ring, __ATOMIC_RELEASE);
+            if (free_slot == log_ring_count) {
+                __atomic_store_n(&log_ring_count, log_ring_count + 1, __ATOMIC_RELEASE);
+            }
+        }
+    }
+    pthread_mutex_unlock(&log_registry_lock);
+    if (!ring) return NULL;
+    
+    pthread_setspecific(log_ring_key, ring);
+    thread_ring = ring;
+    return ring;
+}
+
+static void capture_record(log_record_t* record, int level, const char* format,
+                           int arg_count, const log_arg_t* args) {
+    if (arg_count > LOG_MAX_ARGS) arg_count = LOG_MAX_ARGS;
+    
+    record->format = format;
+    record->level = (uint8_t)level;
+    record->arg_count = (uint8_t)arg_count;
+    
+    for (int i = 0; i < arg_count; i++) {
+        record->args[i] = args[i];
+        if (args[i].type == LOG_ARG_STRING) {
+            // The caller's string may not outlive this call
+            const char* source = args[i].value.s ? args[i].value.s : "(null)";
+            strncpy(record->strings[i], source, LOG_STRING_ARG_SIZE - 1);
+            record->strings[i][LOG_STRING_ARG_SIZE - 1] = '\0';
+            record->args[i].value.s = record->strings[i];
+        }
+    }
+}
+
+void log_write(int level, const char* format, int arg_count, const log_arg_t* args) {
+    if (!format) return;
+    
+    if (!__atomic_load_n(&log_running, __ATOMIC_ACQUIRE)) {
+        // No writer thread, format inline
+        log_record_t record;
+        char line[LOG_LINE_SIZE];
+        capture_record(&record, level, format, arg_count, args);
+        write_line(line, format_record(&record, line, sizeof(line)));
+        return;
+    }
+    
+    log_ring_t* ring = get_thread_ring();
+    if (!ring) {
+        __atomic_fetch_add(&log_dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    
+    // Pairs with log_stop: either it sees us busy and waits for the record,
+    // or we see the writer stopping and format inline
+    __atomic_store_n(&ring->busy, 1, __ATOMIC_SEQ_CST);
+    if (!__atomic_load_n(&log_running, __ATOMIC_SEQ_CST)) {
+        __atomic_store_n(&ring->busy, 0, __ATOMIC_RELEASE);
+        log_record_t record;
+        char line[LOG_LINE_SIZE];
+        capture_record(&record, level, format, arg_count, args);
+        write_line(line, format_record(&record, line, sizeof(line)));
+        return;
+    }
+    
+    unsigned long head = ring->head;
+    unsigned long tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= LOG_RING_SIZE) {
+        __atomic_store_n(&ring->busy, 0, __ATOMIC_RELEASE);
+        __atomic_fetch_add(&log_dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    
+    capture_record(&ring->records[head & (LOG_RING_SIZE - 1)], level, format, arg_count, args);
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&ring->busy, 0, __ATOMIC_RELEASE);
+}
+
+// Drain every ring once; returns the number of records written
+static unsigned long drain_rings(void) {
+    char line[LOG_LINE_SIZE];
+    unsigned long written = 0;
+    int count = __atomic_load_n(&log_ring_count, __ATOMIC_ACQUIRE);
+    
+    for (int i = 0; i < count; i++) {
+        log_ring_t* ring = __atomic_load_n(&log_rings[i], __ATOMIC_ACQUIRE);
+        if (!ring) continue;
+        
+        unsigned long tail = ring->tail;
+        unsigned long head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        
+        while (tail != head) {
+            const log_record_t* record = &ring->records[tail & (LOG_RING_SIZE - 1)];
+            write_line(line, format_record(record, line, sizeof(line)));
+            tail++;
+            written++;
+        }
+        __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+    }
+    
+    if (written > 0) {
+        fflush(log_output ? log_output : stdout);
+        __atomic_fetch_add(&log_written, written, __ATOMIC_RELAXED);
+    }
+    return written;
+}
+
+static void* log_writer_thread(void* arg) {
+    (void)arg;
+    
+    while (!__atomic_load_n(&log_stop_requested, __ATOMIC_ACQUIRE)) {
+        if (drain_rings() == 0) {
+            struct timespec idle = { 0, LOG_IDLE_SLEEP_NS };
+            nanosleep(&idle, NULL);
+        }
+    }
+    
+    drain_rings();
+    return NULL;
+}
+
+int log_start(FILE* output) {
+    if (__atomic_load_n(&log_running, __ATOMIC_ACQUIRE)) return 0;
+    
+    log_output = output;
+    log_stop_requested = 0;
+    if (pthread_create(&log_writer, NULL, log_writer_thread, NULL) != 0) {
+        return -1;
+    }
+    
+    __atomic_store_n(&log_running, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void log_stop(void) {
+    if (!__atomic_load_n(&log_running, __ATOMIC_ACQUIRE)) return;
+    
+    // New records go inline from here on; wait out producers that checked
+    // before this store so their records are queued before the last drain
+    __atomic_store_n(&log_running, 0, __ATOMIC_SEQ_CST);
+    int count = __atomic_load_n(&log_ring_count, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++) {
+        log_ring_t* ring = __atomic_load_n(&log_rings[i], __ATOMIC_ACQUIRE);
+        while (ring && __atomic_load_n(&ring->busy, __ATOMIC_SEQ_CST)) sched_yield();
+    }
+    __atomic_store_n(&log_stop_requested, 1, __ATOMIC_RELEASE);
+    pthread_join(log_writer, NULL);
+    
+    // Anything published after the writer's final pass
+    drain_rings();
+    
+    // Free rings whose threads have exited
+    pthread_mutex_lock(&log_registry_lock);
+    for (int i = 0; i < log_ring_count; i++) {
+        if (log_rings[i] && __atomic_load_n(&log_rings[i]->closed, __ATOMIC_ACQUIRE)) {
+            free(log_rings[i]);
+            log_rings[i] = NULL;
+        }
+    }
+    pthread_mutex_unlock(&log_registry_lock);
+}
+
+void log_get_stats(log_stats_t* stats) {
+    if (!stats) return;
+    
+    stats->records_written = __atomic_load_n(&log_written, __ATOMIC_RELAXED);
+    stats->records_dropped = __atomic_load_n(&log_dropped, __ATOMIC_RELAXED);
+    stats->rings = (unsigned long)__atomic_load_n(&log_ring_count, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,139 @@
+// src/core/log.h
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Asynchronous leveled logging.
+//
+// LOG_* macros capture the format pointer and up to LOG_MAX_ARGS arguments
+// as a binary record in a per-thread single-producer/single-consumer ring.
+// A thread that exits hands its ring to the next thread that logs.
+// A background thread started by log_start formats and writes the records,
+// so producers never take the stdio lock or run printf. Until log_start is
+// called (or after log_stop) records are formatted inline instead.
+//
+// Formats must be string literals. String arguments are copied into the
+// record (truncated to LOG_STRING_ARG_SIZE - 1 bytes).
+//
+// Calls below LOG_LEVEL are removed at compile time, e.g. -DLOG_LEVEL=LOG_LEVEL_WARN.
+
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_NONE  4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_MAX_ARGS 6
+#define LOG_STRING_ARG_SIZE 32
+#define LOG_RING_SIZE 512           // Records per thread, power of two
+
+typedef enum {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_POINTER,
+    LOG_ARG_STRING
+} log_arg_type_t;
+
+// One captured argument
+typedef struct {
+    log_arg_type_t type;
+    union {
+        long long i;
+        unsigned long long u;
+        double d;
+        const void* p;
+        const char* s;
+    } value;
+} log_arg_t;
+
+// Logging counters
+typedef struct {
+    unsigned long records_written;
+    unsigned long records_dropped;  // Producer ring was full
+    unsigned long rings;            // Ring slots allocated; exited threads' slots are reused
+} log_stats_t;
+
+// Start the background writer (output NULL means stdout)
+int log_start(FILE* output);
+
+// Drain all rings and stop the background writer
+void log_stop(void);
+
+// Snapshot of logging counters
+void log_get_stats(log_stats_t* stats);
+
+// Capture a record; use the LOG_* macros instead of calling this directly
+void log_write(int level, const char* format, int arg_count, const log_arg_t* args);
+
+log_arg_t log_arg_int(long long value);
+log_arg_t log_arg_uint(unsigned long long value);
+log_arg_t log_arg_double(double value);
+log_arg_t log_arg_pointer(const void* value);
+log_arg_t log_arg_string(const char* value);
+
+#define LOG_ARG(x) _Generic((x), \
+    char: log_arg_int, signed char: log_arg_int, short: log_arg_int, int: log_arg_int, \
+    long: log_arg_int, long long: log_arg_int, \
+    unsigned char: log_arg_uint, unsigned short: log_arg_uint, unsigned int: log_arg_uint, \
+    unsigned long: log_arg_uint, unsigned long long: log_arg_uint, \
+    float: log_arg_double, double: log_arg_double, \
+    char*: log_arg_string, const char*: log_arg_string, \
+    default: log_arg_pointer)(x)
+
+#define LOG_CONCAT_(a, b) a##b
+#define LOG_CONCAT(a, b) LOG_CONCAT_(a, b)
+#define LOG_COUNT_(_1, _2, _3, _4, _5, _6, _7, n, ...) n
+#define LOG_COUNT(...) LOG_COUNT_(__VA_ARGS__, 7, 6, 5, 4, 3, 2, 1, 0)
+
+#define LOG_CAPTURE_1(level, fmt) log_write(level, fmt, 0, NULL)
+#define LOG_CAPTURE_2(level, fmt, a) \
+    log_write(level, fmt, 1, (const log_arg_t[]){ LOG_ARG(a) })
+#define LOG_CAPTURE_3(level, fmt, a, b) \
+    log_write(level, fmt, 2, (const log_arg_t[]){ LOG_ARG(a), LOG_ARG(b) })
+#define LOG_CAPTURE_4(level, fmt, a, b, c) \
+    log_write(level, fmt, 3, (const log_arg_t[]){ LOG_ARG(a), LOG_ARG(b), LOG_ARG(c) })
+#define LOG_CAPTURE_5(level, fmt, a, b, c, d) \
+    log_write(level, fmt, 4, (const log_arg_t[]){ LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), \
+                                                  LOG_ARG(d) })
+#define LOG_CAPTURE_6(level, fmt, a, b, c, d, e) \
+    log_write(level, fmt, 5, (const log_arg_t[]){ LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), \
+                                                  LOG_ARG(d), LOG_ARG(e) })
+#define LOG_CAPTURE_7(level, fmt, a, b, c, d, e, f) \
+    log_write(level, fmt, 6, (const log_arg_t[]){ LOG_ARG(a), LOG_ARG(b), LOG_ARG(c), \
+                                                  LOG_ARG(d), LOG_ARG(e), LOG_ARG(f) })
+
+#define LOG_CAPTURE(level, ...) \
+    LOG_CONCAT(LOG_CAPTURE_, LOG_COUNT(__VA_ARGS__))(level, __VA_ARGS__)
+
+#if LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_CAPTURE(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_CAPTURE(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_CAPTURE(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
+
+#if LOG_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_CAPTURE(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#endif
+
+#endif
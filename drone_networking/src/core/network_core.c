@@ -1,7 +1,24 @@
 // src/core/network_core.c
 #include "network_core.h"
+#include "buffer_pool.h"
+#include "log.h"
+#include "uring_backend.h"
 #include <fcntl.h>
 
+uint64_t network_monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void counter_add(unsigned long* counter, unsigned long value) {
+    __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+}
+
+static unsigned long counter_read(const unsigned long* counter) {
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
 network_config_t* network_init(const char* server_ip, int port, network_mode_t mode) {
     network_config_t* config = (network_config_t*)malloc(sizeof(network_config_t));
     if (!config) {
@@ -51,6 +68,15 @@ network_result_t network_connect(network_config_t* config) {
     
     // Bind socket for server mode or set up for client
     if (config->mode == NETWORK_MODE_SERVER) {
+        if (config->reuse_port) {
+            int reuse = 1;
+            if (setsockopt(config->socket_fd, SOL_SOCKET, SO_REUSEPORT,
+                           &reuse, sizeof(reuse)) < 0) {
+                perror("Set SO_REUSEPORT failed");
+                close(config->socket_fd);
+                return NET_ERROR;
+            }
+        }
         if (bind(config->socket_fd, (struct sockaddr*)&config->local_addr, 
                  sizeof(config->local_addr)) < 0) {
             perror("Bind failed");
@@ -68,6 +94,10 @@ network_result_t network_connect(network_config_t* config) {
 network_result_t network_disconnect(network_config_t* config) {
     if (!config || config->socket_fd < 0) return NET_ERROR;
     
+    // The ring holds sends referencing this socket; drain it first
+    uring_backend_destroy(config->uring);
+    config->uring = NULL;
+    
     close(config->socket_fd);
     config->socket_fd = -1;
     config->is_connected = 0;
@@ -75,41 +105,180 @@ network_result_t network_disconnect(network_config_t* config) {
     return NET_SUCCESS;
 }
 
+// Count sends the kernel failed asynchronously. Without batching these are
+// almost always the datagram just submitted.
+static unsigned long take_uring_send_errors(network_config_t* config) {
+    unsigned long errors = uring_backend_take_send_errors(config->uring);
+    if (errors > 0) {
+        counter_add(&config->counters.send_errors, errors);
+        LOG_WARN("io_uring: %lu sends failed", errors);
+    }
+    return errors;
+}
+
 network_result_t network_send_data(network_config_t* config, const void* data, size_t length) {
-    if (!config || !data || !config->is_connected) return NET_ERROR;
+    if (!config) return NET_ERROR;
     
+    return network_send_data_to(config, data, length, &config->server_addr);
+}
+
+network_result_t network_send_data_to(network_config_t* config, const void* data, size_t length,
+                                      const struct sockaddr_in* destination) {
+    if (!config || !data || !destination || !config->is_connected) return NET_ERROR;
+    
+    if (config->uring && length <= MAX_BUFFER_SIZE) {
+        uint64_t queued = network_monotonic_ns();
+        network_result_t result = uring_backend_send(config->uring, data, length, destination);
+        latency_histogram_record(&config->counters.send_queue, network_monotonic_ns() - queued);
+        if (result != NET_SUCCESS) {
+            counter_add(&config->counters.send_errors, 1);
+            LOG_WARN("io_uring send failed");
+            return result;
+        }
+        if (take_uring_send_errors(config) > 0) return NET_ERROR;
+        counter_add(&config->counters.bytes_sent, (unsigned long)length);
+        counter_add(&config->counters.messages_sent, 1);
+        __atomic_store_n(&config->counters.last_activity, time(NULL), __ATOMIC_RELAXED);
+        return NET_SUCCESS;
+    }
+    
+    uint64_t started = network_monotonic_ns();
     ssize_t bytes_sent = sendto(config->socket_fd, data, length, 0,
-                               (struct sockaddr*)&config->server_addr,
-                               sizeof(config->server_addr));
+                               (const struct sockaddr*)destination,
+                               sizeof(*destination));
+    latency_histogram_record(&config->counters.send_latency, network_monotonic_ns() - started);
     
     if (bytes_sent < 0) {
-        perror("Send failed");
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+            counter_add(&config->counters.drops, 1);
+        } else {
+            counter_add(&config->counters.send_errors, 1);
+        }
+        LOG_WARN("Send failed: %s", strerror(errno));
         return NET_ERROR;
     }
     
-    printf("Sent %zd bytes of data\n", bytes_sent);
+    counter_add(&config->counters.bytes_sent, (unsigned long)bytes_sent);
+    counter_add(&config->counters.messages_sent, 1);
+    __atomic_store_n(&config->counters.last_activity, time(NULL), __ATOMIC_RELAXED);
+    
+    LOG_DEBUG("Sent %zd bytes of data", bytes_sent);
     return NET_SUCCESS;
 }
 
 network_result_t network_receive_data(network_config_t* config, void* buffer, size_t max_length) {
+    if (!config) return NET_ERROR;
+    
+    return network_receive_data_from(config, buffer, max_length, NULL, &config->server_addr);
+}
+
+network_result_t network_receive_data_from(network_config_t* config, void* buffer, size_t max_length,
+                                           size_t* received, struct sockaddr_in* source) {
     if (!config || !buffer || !config->is_connected) return NET_ERROR;
     
+    if (config->uring && !uring_backend_receive_unsupported(config->uring)) {
+        size_t length = 0;
+        network_result_t result = uring_backend_receive(config->uring, buffer, max_length,
+                                                        &length, source,
+                                                        config->uring_timeout_ms);
+        if (result == NET_SUCCESS) {
+            counter_add(&config->counters.bytes_received, (unsigned long)length);
+            counter_add(&config->counters.messages_received, 1);
+            __atomic_store_n(&config->counters.last_activity, time(NULL), __ATOMIC_RELAXED);
+            if (received) {
+                *received = length;
+            }
+            return NET_SUCCESS;
+        }
+        if (result == NET_TIMEOUT) return NET_TIMEOUT;
+        if (!uring_backend_receive_unsupported(config->uring)) {
+            counter_add(&config->counters.receive_errors, 1);
+            LOG_WARN("io_uring receive failed");
+            return NET_ERROR;
+        }
+        LOG_INFO("Multishot receive unsupported, falling back to recvfrom");
+    }
+    
+    struct sockaddr_in sender;
     socklen_t addr_len = sizeof(struct sockaddr_in);
     ssize_t bytes_received = recvfrom(config->socket_fd, buffer, max_length, 0,
-                                     (struct sockaddr*)&config->server_addr, &addr_len);
+                                     (struct sockaddr*)&sender, &addr_len);
     
     if (bytes_received < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
             return NET_TIMEOUT;
         }
-        perror("Receive failed");
+        counter_add(&config->counters.receive_errors, 1);
+        LOG_WARN("Receive failed: %s", strerror(errno));
+        return NET_ERROR;
+    }
+    
+    counter_add(&config->counters.bytes_received, (unsigned long)bytes_received);
+    counter_add(&config->counters.messages_received, 1);
+    __atomic_store_n(&config->counters.last_activity, time(NULL), __ATOMIC_RELAXED);
+    
+    if (source) {
+        *source = sender;
+    }
+    if (received) {
+        *received = (size_t)bytes_received;
+    }
+    
+    LOG_DEBUG("Received %zd bytes of data", bytes_received);
+    return NET_SUCCESS;
+}
+
+network_result_t network_enable_uring(network_config_t* config, unsigned int submit_batch) {
+    if (!config || !config->is_connected || config->socket_fd < 0) return NET_ERROR;
+    if (config->uring) return NET_SUCCESS;
+    
+    // Receives block in io_uring_enter, so mirror the socket's own timeout
+    struct timeval timeout;
+    socklen_t timeout_len = sizeof(timeout);
+    int flags = fcntl(config->socket_fd, F_GETFL, 0);
+    if (flags >= 0 && (flags & O_NONBLOCK)) {
+        config->uring_timeout_ms = 0;
+    } else if (getsockopt(config->socket_fd, SOL_SOCKET, SO_RCVTIMEO,
+                          &timeout, &timeout_len) == 0 &&
+               (timeout.tv_sec > 0 || timeout.tv_usec > 0)) {
+        config->uring_timeout_ms = (int)(timeout.tv_sec * 1000 + timeout.tv_usec / 1000);
+    } else {
+        config->uring_timeout_ms = -1;
+    }
+    
+    config->uring = uring_backend_create(config->socket_fd, submit_batch);
+    if (!config->uring) {
+        LOG_INFO("io_uring unavailable, using sendto/recvfrom");
         return NET_ERROR;
     }
     
-    printf("Received %zd bytes of data\n", bytes_received);
+    LOG_INFO("io_uring data path enabled (batch %u)", submit_batch ? submit_batch : 1);
     return NET_SUCCESS;
 }
 
+network_result_t network_set_receive_timeout(network_config_t* config, int timeout_ms) {
+    if (!config || config->socket_fd < 0 || timeout_ms < 0) return NET_ERROR;
+    
+    struct timeval timeout = { (time_t)(timeout_ms / 1000), (suseconds_t)((timeout_ms % 1000) * 1000) };
+    if (setsockopt(config->socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0) {
+        return NET_ERROR;
+    }
+    // An io_uring path enabled earlier captured the old timeout
+    if (config->uring) {
+        config->uring_timeout_ms = timeout_ms ? timeout_ms : -1;
+    }
+    return NET_SUCCESS;
+}
+
+network_result_t network_flush(network_config_t* config) {
+    if (!config) return NET_ERROR;
+    if (!config->uring) return NET_SUCCESS;
+    
+    network_result_t result = uring_backend_flush(config->uring);
+    if (take_uring_send_errors(config) > 0) return NET_ERROR;
+    return result;
+}
+
 void network_cleanup(network_config_t* config) {
     if (config) {
         if (config->is_connected) {
@@ -122,13 +291,34 @@ void network_cleanup(network_config_t* config) {
 void network_get_stats(network_config_t* config, network_stats_t* stats) {
     if (!config || !stats) return;
     
-    // This would be populated in a real implementation
-    stats->bytes_sent = 0;
-    stats->bytes_received = 0;
-    stats->messages_sent = 0;
-    stats->messages_received = 0;
-    stats->errors = 0;
-    stats->last_activity = time(NULL);
+    const network_counters_t* counters = &config->counters;
+    stats->bytes_sent = counter_read(&counters->bytes_sent);
+    stats->bytes_received = counter_read(&counters->bytes_received);
+    stats->messages_sent = counter_read(&counters->messages_sent);
+    stats->messages_received = counter_read(&counters->messages_received);
+    stats->errors = counter_read(&counters->send_errors) +
+                    counter_read(&counters->receive_errors);
+    stats->drops = counter_read(&counters->drops);
+    stats->checksum_failures = counter_read(&counters->checksum_failures);
+    stats->last_activity = __atomic_load_n(&counters->last_activity, __ATOMIC_RELAXED);
+    stats->send_latency_p50_ns = latency_histogram_percentile(&counters->send_latency, 50.0);
+    stats->send_latency_p99_ns = latency_histogram_percentile(&counters->send_latency, 99.0);
+    stats->send_queue_p50_ns = latency_histogram_percentile(&counters->send_queue, 50.0);
+    stats->send_queue_p99_ns = latency_histogram_percentile(&counters->send_queue, 99.0);
+    stats->round_trip_p50_ns = latency_histogram_percentile(&counters->round_trip, 50.0);
+    stats->round_trip_p99_ns = latency_histogram_percentile(&counters->round_trip, 99.0);
+}
+
+void network_record_checksum_failure(network_config_t* config) {
+    if (config) {
+        counter_add(&config->counters.checksum_failures, 1);
+    }
+}
+
+void network_record_round_trip(network_config_t* config, uint64_t round_trip_ns) {
+    if (config) {
+        latency_histogram_record(&config->counters.round_trip, round_trip_ns);
+    }
 }
 
 void network_print_stats(network_config_t* config) {
@@ -141,5 +331,19 @@ void network_print_stats(network_config_t* config) {
     printf("Messages Sent: %lu\n", stats.messages_sent);
     printf("Messages Received: %lu\n", stats.messages_received);
     printf("Errors: %lu\n", stats.errors);
+    printf("Drops: %lu\n", stats.drops);
+    printf("Checksum Failures: %lu\n", stats.checksum_failures);
     printf("Last Activity: %s", ctime(&stats.last_activity));
+    latency_histogram_print(&config->counters.send_latency, "Send Latency");
+    if (config->uring) latency_histogram_print(&config->counters.send_queue, "io_uring Send Queue");
+    latency_histogram_print(&config->counters.round_trip, "Round Trip");
+    if (config->uring) {
+        uring_stats_t uring;
+        uring_backend_get_stats(config->uring, &uring);
+        printf("io_uring: %lu enters, %lu sends queued, %lu completed, %lu errors, "
+               "%lu receives, %lu rearms\n",
+               uring.enter_calls, uring.sends_queued, uring.sends_completed,
+               uring.send_errors, uring.receives, uring.receive_rearms);
+    }
+    buffer_pool_print_stats();
 }
\ No newline at end of file
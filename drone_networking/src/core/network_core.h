@@ -4,6 +4,26 @@
 
 #include "common.h"
 #include "../../include/common.h"
+#include "latency_histogram.h"
+
+// Live per-socket counters. Updated with relaxed atomics on the data path,
+// read without locks by network_get_stats.
+typedef struct {
+    unsigned long bytes_sent;
+    unsigned long bytes_received;
+    unsigned long messages_sent;
+    unsigned long messages_received;
+    unsigned long send_errors;
+    unsigned long receive_errors;
+    unsigned long drops;                // Sends refused for lack of buffer space
+    unsigned long checksum_failures;    // Received messages failing validation
+    time_t last_activity;
+    latency_histogram_t send_latency;   // Time spent in sendto (plain socket path)
+    latency_histogram_t send_queue;     // Time to queue a send on io_uring, slot waits included
+    latency_histogram_t round_trip;     // Acknowledged message round trips
+} network_counters_t;
+
+struct uring_backend;
 
 // Network configuration structure
 typedef struct {
@@ -18,6 +38,10 @@ typedef struct {
     int is_connected;
     int max_retries;
     int retry_delay;
+    int reuse_port;             // Set SO_REUSEPORT before binding (sharded servers)
+    network_counters_t counters;
+    struct uring_backend* uring;    // Optional io_uring data path, NULL for sendto/recvfrom
+    int uring_timeout_ms;           // Receive timeout for the io_uring path, -1 blocks
 } network_config_t;
 
 // Network statistics
@@ -27,9 +51,20 @@ typedef struct {
     unsigned long messages_sent;
     unsigned long messages_received;
     unsigned long errors;
+    unsigned long drops;
+    unsigned long checksum_failures;
     time_t last_activity;
+    uint64_t send_latency_p50_ns;       // sendto only
+    uint64_t send_latency_p99_ns;
+    uint64_t send_queue_p50_ns;         // io_uring only; completion is not timed
+    uint64_t send_queue_p99_ns;
+    uint64_t round_trip_p50_ns;
+    uint64_t round_trip_p99_ns;
 } network_stats_t;
 
+// CLOCK_MONOTONIC in ns, for intervals and deadlines
+uint64_t network_monotonic_ns(void);
+
 // Function prototypes
 network_config_t* network_init(const char* server_ip, int port, network_mode_t mode);
 void network_cleanup(network_config_t* config);
@@ -37,7 +72,22 @@ network_result_t network_connect(network_config_t* config);
 network_result_t network_disconnect(network_config_t* config);
 network_result_t network_send_data(network_config_t* config, const void* data, size_t length);
 network_result_t network_receive_data(network_config_t* config, void* buffer, size_t max_length);
+network_result_t network_send_data_to(network_config_t* config, const void* data, size_t length,
+                                      const struct sockaddr_in* destination);
+network_result_t network_receive_data_from(network_config_t* config, void* buffer, size_t max_length,
+                                           size_t* received, struct sockaddr_in* source);
+// submit_batch 0 or 1 sends each datagram at once; larger values queue
+// sends and require network_flush after each burst
+network_result_t network_enable_uring(network_config_t* config, unsigned int submit_batch);
+// Receive timeout in ms (0 blocks), honoured whether or not io_uring is
+// enabled and in either order
+network_result_t network_set_receive_timeout(network_config_t* config, int timeout_ms);
+network_result_t network_flush(network_config_t* config);
+// Snapshot the counters. sendto calls are timed into send_latency and
+// io_uring sends into send_queue, which ends once the send is queued.
 void network_get_stats(network_config_t* config, network_stats_t* stats);
+void network_record_checksum_failure(network_config_t* config);
+void network_record_round_trip(network_config_t* config, uint64_t round_trip_ns);
 void network_print_stats(network_config_t* config);
 
 #endif
\ No newline at end of file
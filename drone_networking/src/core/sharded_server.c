@@ -0,0 +1,194 @@
+// src/core/sharded_server.c
+#include "sharded_server.h"
+#include "buffer_pool.h"
+#include "log.h"
+#include <sched.h>
+#include <sys/time.h>
+
+sharded_server_t* sharded_server_init(int port, int shard_count, int pin_cpus,
+                                      shard_handler_t handler, void* user_data) {
+    if (!handler) return NULL;
+    
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1) cpus = 1;
+    if (shard_count <= 0) shard_count = (int)cpus;
+    if (shard_count > SHARDED_SERVER_MAX_SHARDS) shard_count = SHARDED_SERVER_MAX_SHARDS;
+    
+    sharded_server_t* server = (sharded_server_t*)malloc(sizeof(sharded_server_t));
+    if (!server) return NULL;
+    
+    memset(server, 0, sizeof(sharded_server_t));
+    server->port = port;
+    server->shard_count = shard_count;
+    server->handler = handler;
+    server->user_data = user_data;
+    
+    for (int i = 0; i < shard_count; i++) {
+        server_shard_t* shard = &server->shards[i];
+        shard->shard_id = i;
+        shard->cpu = pin_cpus ? (int)(i % cpus) : -1;
+        shard->server = server;
+        
+        shard->net_config = network_init("0.0.0.0", port, NETWORK_MODE_SERVER);
+        if (!shard->net_config) {
+            sharded_server_cleanup(server);
+            return NULL;
+        }
+        shard->net_config->local_port = port;
+        shard->net_config->local_addr.sin_port = htons(port);
+        shard->net_config->reuse_port = 1;
+    }
+    
+    return server;
+}
+
+static void* shard_thread(void* arg) {
+    server_shard_t* shard = (server_shard_t*)arg;
+    sharded_server_t* server = shard->server;
+    
+    if (shard->cpu >= 0) {
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(shard->cpu, &cpu_set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) != 0) {
+            LOG_WARN("Shard %d could not be pinned to CPU %d", shard->shard_id, shard->cpu);
+        }
+    }
+    
+    void* buffer = buffer_pool_acquire();
+    if (!buffer) return NULL;
+    
+    int errors = 0;
+    while (__atomic_load_n(&server->running, __ATOMIC_ACQUIRE)) {
+        size_t length;
+        struct sockaddr_in source;
+        network_result_t result = network_receive_data_from(shard->net_config, buffer,
+                                                            MAX_BUFFER_SIZE, &length, &source);
+        if (result == NET_SUCCESS) {
+            server->handler(shard->shard_id, shard->net_config, buffer, length,
+                            &source, server->user_data);
+        }
+        if (result != NET_ERROR) {
+            errors = 0;
+            continue;
+        }
+        
+        // A broken socket fails at once every time; don't spin on it
+        if (++errors >= SHARDED_SERVER_MAX_ERRORS) {
+            LOG_ERROR("Shard %d stopping after %d receive errors in a row", shard->shard_id, errors);
+            __atomic_store_n(&shard->failed, 1, __ATOMIC_RELEASE);
+            break;
+        }
+        long pause_ms = 1L << (errors - 1);
+        if (pause_ms > SHARDED_SERVER_POLL_MS) pause_ms = SHARDED_SERVER_POLL_MS;
+        struct timespec pause = { 0, pause_ms * 1000000L };
+        nanosleep(&pause, NULL);
+    }
+    
+    buffer_pool_release(buffer);
+    return NULL;
+}
+
+network_result_t sharded_server_start(sharded_server_t* server) {
+    if (!server || server->running) return NET_ERROR;
+    
+    // Open every socket before any thread starts so the kernel's
+    // reuseport group is complete from the first packet
+    for (int i = 0; i < server->shard_count; i++) {
+        network_config_t* config = server->shards[i].net_config;
+        if (network_connect(config) != NET_SUCCESS) {
+            sharded_server_stop(server);
+            return NET_ERROR;
+        }
+        
+        // Wake periodically to notice shutdown
+        struct timeval timeout = { 0, SHARDED_SERVER_POLL_MS * 1000 };
+        setsockopt(config->socket_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+    
+    __atomic_store_n(&server->running, 1, __ATOMIC_RELEASE);
+    
+    for (int i = 0; i < server->shard_count; i++) {
+        server_shard_t* shard = &server->shards[i];
+        shard->failed = 0;
+        if (pthread_create(&shard->thread, NULL, shard_thread, shard) != 0) {
+            perror("Shard thread creation failed");
+            sharded_server_stop(server);
+            return NET_ERROR;
+        }
+        shard->thread_started = 1;
+    }
+    
+    printf("Sharded server on port %d with %d shards\n", server->port, server->shard_count);
+    return NET_SUCCESS;
+}
+
+void sharded_server_stop(sharded_server_t* server) {
+    if (!server) return;
+    
+    __atomic_store_n(&server->running, 0, __ATOMIC_RELEASE);
+    
+    for (int i = 0; i < server->shard_count; i++) {
+        server_shard_t* shard = &server->shards[i];
+        if (shard->thread_started) {
+            pthread_join(shard->thread, NULL);
+            shard->thread_started = 0;
+        }
+        if (shard->net_config && shard->net_config->is_connected) {
+            network_disconnect(shard->net_config);
+        }
+    }
+}
+
+void sharded_server_get_stats(sharded_server_t* server, network_stats_t* stats) {
+    if (!server || !stats) return;
+    
+    memset(stats, 0, sizeof(network_stats_t));
+    
+    for (int i = 0; i < server->shard_count; i++) {
+        network_stats_t shard_stats;
+        network_get_stats(server->shards[i].net_config, &shard_stats);
+        
+        stats->bytes_sent += shard_stats.bytes_sent;
+        stats->bytes_received += shard_stats.bytes_received;
+        stats->messages_sent += shard_stats.messages_sent;
+        stats->messages_received += shard_stats.messages_received;
+        stats->errors += shard_stats.errors;
+        stats->drops += shard_stats.drops;
+        stats->checksum_failures += shard_stats.checksum_failures;
+        if (shard_stats.last_activity > stats->last_activity) {
+            stats->last_activity = shard_stats.last_activity;
+        }
+        // Percentiles don't sum; report the worst shard
+        if (shard_stats.send_latency_p50_ns > stats->send_latency_p50_ns) {
+            stats->send_latency_p50_ns = shard_stats.send_latency_p50_ns;
+        }
+        if (shard_stats.send_latency_p99_ns > stats->send_latency_p99_ns) {
+            stats->send_latency_p99_ns = shard_stats.send_latency_p99_ns;
+        }
+        if (shard_stats.send_queue_p50_ns > stats->send_queue_p50_ns) {
+            stats->send_queue_p50_ns = shard_stats.send_queue_p50_ns;
+        }
+        if (shard_stats.send_queue_p99_ns > stats->send_queue_p99_ns) {
+            stats->send_queue_p99_ns = shard_stats.send_queue_p99_ns;
+        }
+        if (shard_stats.round_trip_p50_ns > stats->round_trip_p50_ns) {
+            stats->round_trip_p50_ns = shard_stats.round_trip_p50_ns;
+        }
+        if (shard_stats.round_trip_p99_ns > stats->round_trip_p99_ns) {
+            stats->round_trip_p99_ns = shard_stats.round_trip_p99_ns;
+        }
+    }
+}
+
+void sharded_server_cleanup(sharded_server_t* server) {
+    if (server) {
+        sharded_server_stop(server);
+        for (int i = 0; i < server->shard_count; i++) {
+            if (server->shards[i].net_config) {
+                network_cleanup(server->shards[i].net_config);
+            }
+        }
+        free(server);
+    }
+}
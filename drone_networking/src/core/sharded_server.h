@@ -0,0 +1,69 @@
+// src/core/sharded_server.h
+#ifndef SHARDED_SERVER_H
+#define SHARDED_SERVER_H
+
+#include "common.h"
+#include "network_core.h"
+
+// Multi-core ground station receive path.
+//
+// Opens one SO_REUSEPORT UDP socket per shard on the same port; the kernel
+// spreads incoming flows across them by source address hash, so each drone
+// consistently lands on one shard. Every shard has its own receive thread,
+// its own network_config_t (and therefore its own counters) and calls the
+// handler from that thread only, so handlers can keep per-shard state
+// without locking.
+//
+// A receive error other than a timeout makes the shard back off, doubling
+// the pause up to SHARDED_SERVER_POLL_MS; after SHARDED_SERVER_MAX_ERRORS
+// in a row the shard logs an error and its thread exits with failed set.
+// The other shards keep running.
+
+#define SHARDED_SERVER_MAX_SHARDS 64
+#define SHARDED_SERVER_POLL_MS 100  // How often idle shards check for shutdown
+#define SHARDED_SERVER_MAX_ERRORS 10    // Consecutive receive errors before a shard gives up
+
+// Called on the shard's thread for each received datagram. Replies can be
+// sent with network_send_data_to(shard_config, ..., source).
+typedef void (*shard_handler_t)(int shard_id, network_config_t* shard_config,
+                                const void* data, size_t length,
+                                const struct sockaddr_in* source, void* user_data);
+
+struct sharded_server;
+
+typedef struct {
+    int shard_id;
+    int cpu;                        // CPU to pin to, -1 for none
+    network_config_t* net_config;
+    pthread_t thread;
+    int thread_started;
+    int failed;                     // Receive thread gave up on its socket
+    struct sharded_server* server;
+} server_shard_t;
+
+typedef struct sharded_server {
+    int port;
+    int shard_count;
+    int running;
+    shard_handler_t handler;
+    void* user_data;
+    server_shard_t shards[SHARDED_SERVER_MAX_SHARDS];
+} sharded_server_t;
+
+// Create a server; shard_count 0 means one shard per online CPU
+sharded_server_t* sharded_server_init(int port, int shard_count, int pin_cpus,
+                                      shard_handler_t handler, void* user_data);
+
+// Open the sockets and start the receive threads
+network_result_t sharded_server_start(sharded_server_t* server);
+
+// Stop receive threads and close sockets
+void sharded_server_stop(sharded_server_t* server);
+
+// Sum of all shard statistics
+void sharded_server_get_stats(sharded_server_t* server, network_stats_t* stats);
+
+// Stop if running and free the server
+void sharded_server_cleanup(sharded_server_t* server);
+
+#endif
@@ -0,0 +1,606 @@
+// src/core/uring_backend.c
+#include "uring_backend.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <stdint.h>
+#include <pthread.h>
+#if defined(IORING_RECV_MULTISHOT) && defined(IORING_CQE_F_NOTIF)
+#define URING_AVAILABLE 1
+#endif
+#endif
+#endif
+
+#ifdef URING_AVAILABLE
+
+#define URING_BUFFER_GROUP 1
+#define URING_TAG_RECEIVE 1ULL
+#define URING_TAG_SEND 2ULL
+#define URING_RECEIVE_BUFFER_SIZE \
+    (sizeof(struct io_uring_recvmsg_out) + sizeof(struct sockaddr_in) + MAX_BUFFER_SIZE)
+
+typedef struct {
+    uint16_t buffer_id;
+    int32_t length;
+} uring_ready_t;
+
+struct uring_backend {
+    int ring_fd;
+    int socket_fd;
+    unsigned int submit_batch;
+    
+    // Guards everything below. A receiver waiting in io_uring_enter drops
+    // it and sets receiver_waiting; until it returns it alone reaps the
+    // completion queue (so its wakeup cannot be consumed by another thread)
+    // and broadcasts `reaped` afterwards.
+    pthread_mutex_t lock;
+    pthread_cond_t reaped;
+    int receiver_waiting;
+    unsigned long send_errors_reported;
+    
+    // Submission queue
+    void* sq_ring;
+    size_t sq_ring_size;
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    struct io_uring_sqe* sqes;
+    size_t sqes_size;
+    unsigned pending;                   // Queued but not yet submitted
+    
+    // Completion queue
+    void* cq_ring;
+    size_t cq_ring_size;
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned cq_mask;
+    struct io_uring_cqe* cqes;
+    
+    // Receive side: provided buffer ring feeding one multishot RECVMSG
+    struct io_uring_buf_ring* buffer_ring;
+    size_t buffer_ring_size;
+    unsigned char* receive_buffers;
+    uint16_t buffer_ring_tail;
+    struct msghdr receive_msg;
+    int receive_armed;
+    int receive_unsupported;
+    uring_ready_t ready[URING_RECEIVE_BUFFERS];
+    unsigned ready_head;
+    unsigned ready_tail;
+    
+    // Send side: registered slab split into fixed slots
+    unsigned char* send_slab;
+    int send_slab_registered;
+    int zerocopy_supported;
+    struct iovec send_iov[URING_SEND_SLOTS];
+    struct msghdr send_msg[URING_SEND_SLOTS];
+    struct sockaddr_in send_addr[URING_SEND_SLOTS];
+    uint16_t free_slots[URING_SEND_SLOTS];
+    unsigned free_count;
+    
+    uring_stats_t stats;
+};
+
+static int ring_enter(uring_backend_t* backend, unsigned to_submit, unsigned min_complete,
+                      unsigned flags, const void* arg, size_t arg_size) {
+    int result;
+    do {
+        result = (int)syscall(__NR_io_uring_enter, backend->ring_fd, to_submit, min_complete,
+                              flags, arg, arg_size);
+        backend->stats.enter_calls++;
+    } while (result < 0 && errno == EINTR);
+    
+    if (result > 0) {
+        backend->pending -= (unsigned)result < backend->pending ? (unsigned)result
+                                                                 : backend->pending;
+    }
+    return result;
+}
+
+static int submit_pending(uring_backend_t* backend) {
+    if (backend->pending == 0) return 0;
+    return ring_enter(backend, backend->pending, 0, 0, NULL, 0);
+}
+
+// Reserve the next SQE; the caller fills it and calls queue_sqe
+static struct io_uring_sqe* reserve_sqe(uring_backend_t* backend) {
+    unsigned tail = *backend->sq_tail;
+    unsigned head = __atomic_load_n(backend->sq_head, __ATOMIC_ACQUIRE);
+    
+    if (tail - head >= backend->sq_entries) {
+        if (submit_pending(backend) < 0) return NULL;
+        head = __atomic_load_n(backend->sq_head, __ATOMIC_ACQUIRE);
+        if (tail - head >= backend->sq_entries) return NULL;
+    }
+    
+    struct io_uring_sqe* sqe = &backend->sqes[tail & backend->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+static void queue_sqe(uring_backend_t* backend) {
+    unsigned tail = *backend->sq_tail;
+    backend->sq_array[tail & backend->sq_mask] = tail & backend->sq_mask;
+    __atomic_store_n(backend->sq_tail, tail + 1, __ATOMIC_RELEASE);
+    backend->pending++;
+}
+
+static void recycle_receive_buffer(uring_backend_t* backend, uint16_t buffer_id) {
+    struct io_uring_buf* buf =
+        &backend->buffer_ring->bufs[backend->buffer_ring_tail & (URING_RECEIVE_BUFFERS - 1)];
+    buf->addr = (uint64_t)(uintptr_t)(backend->receive_buffers +
+                                      (size_t)buffer_id * URING_RECEIVE_BUFFER_SIZE);
+    buf->len = (uint32_t)URING_RECEIVE_BUFFER_SIZE;
+    buf->bid = buffer_id;
+    backend->buffer_ring_tail++;
+    __atomic_store_n(&backend->buffer_ring->tail, backend->buffer_ring_tail, __ATOMIC_RELEASE);
+}
+
+static int arm_receive(uring_backend_t* backend) {
+    struct io_uring_sqe* sqe = reserve_sqe(backend);
+    if (!sqe) return -1;
+    
+    sqe->opcode = IORING_OP_RECVMSG;
+    sqe->fd = backend->socket_fd;
+    sqe->addr = (uint64_t)(uintptr_t)&backend->receive_msg;
+    sqe->len = 1;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = URING_TAG_RECEIVE << 32;
+    queue_sqe(backend);
+    
+    backend->receive_armed = 1;
+    return 0;
+}
+
+static void release_send_slot(uring_backend_t* backend, uint16_t slot) {
+    backend->free_slots[backend->free_count++] = slot;
+}
+
+// Drain the completion queue without a syscall
+static void reap_completions(uring_backend_t* backend) {
+    unsigned head = *backend->cq_head;
+    unsigned tail = __atomic_load_n(backend->cq_tail, __ATOMIC_ACQUIRE);
+    
+    while (head != tail) {
+        const struct io_uring_cqe* cqe = &backend->cqes[head & backend->cq_mask];
+        uint64_t tag = cqe->user_data >> 32;
+        uint16_t index = (uint16_t)(cqe->user_data & 0xFFFF);
+        
+        if (tag == URING_TAG_RECEIVE) {
+            if (!(cqe->flags & IORING_CQE_F_MORE)) {
+                backend->receive_armed = 0;
+            }
+            if (cqe->res >= 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+                uring_ready_t* ready = &backend->ready[backend->ready_tail % URING_RECEIVE_BUFFERS];
+                ready->buffer_id = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+                ready->length = cqe->res;
+                backend->ready_tail++;
+            } else if ((cqe->res == -EINVAL || cqe->res == -EOPNOTSUPP) &&
+                       backend->stats.receives == 0) {
+                __atomic_store_n(&backend->receive_unsupported, 1, __ATOMIC_RELAXED);
+            }
+        } else if (tag == URING_TAG_SEND) {
+            if (cqe->flags & IORING_CQE_F_NOTIF) {
+                release_send_slot(backend, index); // Zero-copy buffer handed back
+            } else {
+                if (cqe->res < 0) {
+                    backend->stats.send_errors++;
+                } else {
+                    backend->stats.sends_completed++;
+                }
+                if (!(cqe->flags & IORING_CQE_F_MORE)) {
+                    release_send_slot(backend, index);
+                }
+            }
+        }
+        head++;
+    }
+    
+    __atomic_store_n(backend->cq_head, head, __ATOMIC_RELEASE);
+}
+
+static int probe_zerocopy(uring_backend_t* backend) {
+    size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe* probe = (struct io_uring_probe*)calloc(1, probe_size);
+    if (!probe) return 0;
+    
+    int supported = 0;
+    if (syscall(__NR_io_uring_register, backend->ring_fd, IORING_REGISTER_PROBE, probe, 256) == 0 &&
+        probe->last_op >= IORING_OP_SEND_ZC) {
+        supported = (probe->ops[IORING_OP_SEND_ZC].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+    free(probe);
+    return supported;
+}
+
+static int map_rings(uring_backend_t* backend, const struct io_uring_params* params) {
+    backend->sq_ring_size = params->sq_off.array + params->sq_entries * sizeof(unsigned);
+    backend->cq_ring_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+    backend->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+    
+    backend->sq_ring = mmap(NULL, backend->sq_ring_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, backend->ring_fd, IORING_OFF_SQ_RING);
+    backend->cq_ring = mmap(NULL, backend->cq_ring_size, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, backend->ring_fd, IORING_OFF_CQ_RING);
+    backend->sqes = (struct io_uring_sqe*)mmap(NULL, backend->sqes_size, PROT_READ | PROT_WRITE,
+                                               MAP_SHARED | MAP_POPULATE, backend->ring_fd,
+                                               IORING_OFF_SQES);
+    if (backend->sq_ring == MAP_FAILED || backend->cq_ring == MAP_FAILED ||
+        backend->sqes == MAP_FAILED) {
+        return -1;
+    }
+    
+    unsigned char* sq = (unsigned char*)backend->sq_ring;
+    backend->sq_head = (unsigned*)(sq + params->sq_off.head);
+    backend->sq_tail = (unsigned*)(sq + params->sq_off.tail);
+    backend->sq_mask = *(unsigned*)(sq + params->sq_off.ring_mask);
+    backend->sq_entries = *(unsigned*)(sq + params->sq_off.ring_entries);
+    backend->sq_array = (unsigned*)(sq + params->sq_off.array);
+    
+    unsigned char* cq = (unsigned char*)backend->cq_ring;
+    backend->cq_head = (unsigned*)(cq + params->cq_off.head);
+    backend->cq_tail = (unsigned*)(cq + params->cq_off.tail);
+    backend->cq_mask = *(unsigned*)(cq + params->cq_off.ring_mask);
+    backend->cqes = (struct io_uring_cqe*)(cq + params->cq_off.cqes);
+    return 0;
+}
+
+static int setup_receive_buffers(uring_backend_t* backend) {
+    backend->buffer_ring_size = URING_RECEIVE_BUFFERS * sizeof(struct io_uring_buf);
+    backend->buffer_ring = (struct io_uring_buf_ring*)mmap(NULL, backend->buffer_ring_size,
+                                                           PROT_READ | PROT_WRITE,
+                                                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (backend->buffer_ring == MAP_FAILED) {
+        backend->buffer_ring = NULL;
+        return -1;
+    }
+    
+    backend->receive_buffers = (unsigned char*)malloc((size_t)URING_RECEIVE_BUFFERS *
+                                                      URING_RECEIVE_BUFFER_SIZE);
+    if (!backend->receive_buffers) return -1;
+    
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)backend->buffer_ring;
+    reg.ring_entries = URING_RECEIVE_BUFFERS;
+    reg.bgid = URING_BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, backend->ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        return -1;
+    }
+    
+    for (uint16_t i = 0; i < URING_RECEIVE_BUFFERS; i++) {
+        recycle_receive_buffer(backend, i);
+    }
+    
+    backend->receive_msg.msg_namelen = sizeof(struct sockaddr_in);
+    return 0;
+}
+
+static int setup_send_slots(uring_backend_t* backend) {
+    size_t slab_size = (size_t)URING_SEND_SLOTS * MAX_BUFFER_SIZE;
+    if (posix_memalign((void**)&backend->send_slab, 4096, slab_size) != 0) {
+        backend->send_slab = NULL;
+        return -1;
+    }
+    
+    // Pin the slab once instead of per operation; zero-copy sends need it
+    struct iovec region = { backend->send_slab, slab_size };
+    backend->send_slab_registered =
+        syscall(__NR_io_uring_register, backend->ring_fd, IORING_REGISTER_BUFFERS, &region, 1) == 0;
+    backend->zerocopy_supported = backend->send_slab_registered && probe_zerocopy(backend);
+    
+    for (unsigned i = 0; i < URING_SEND_SLOTS; i++) {
+        backend->send_iov[i].iov_base = backend->send_slab + (size_t)i * MAX_BUFFER_SIZE;
+        backend->send_msg[i].msg_name = &backend->send_addr[i];
+        backend->send_msg[i].msg_namelen = sizeof(struct sockaddr_in);
+        backend->send_msg[i].msg_iov = &backend->send_iov[i];
+        backend->send_msg[i].msg_iovlen = 1;
+        backend->free_slots[i] = (uint16_t)(URING_SEND_SLOTS - 1 - i);
+    }
+    backend->free_count = URING_SEND_SLOTS;
+    return 0;
+}
+
+uring_backend_t* uring_backend_create(int socket_fd, unsigned int submit_batch) {
+    if (socket_fd < 0) return NULL;
+    
+    uring_backend_t* backend = (uring_backend_t*)calloc(1, sizeof(uring_backend_t));
+    if (!backend) return NULL;
+    
+    backend->socket_fd = socket_fd;
+    backend->submit_batch = submit_batch ? submit_batch : 1;
+    
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    backend->ring_fd = (int)syscall(__NR_io_uring_setup, URING_QUEUE_DEPTH, &params);
+    if (backend->ring_fd < 0) {
+        free(backend);
+        return NULL; // Kernel without io_uring, or disabled by policy
+    }
+    pthread_mutex_init(&backend->lock, NULL);
+    pthread_cond_init(&backend->reaped, NULL);
+    
+    if (!(params.features & IORING_FEAT_EXT_ARG) ||
+        map_rings(backend, &params) != 0 ||
+        setup_receive_buffers(backend) != 0 ||
+        setup_send_slots(backend) != 0) {
+        uring_backend_destroy(backend);
+        return NULL;
+    }
+    
+    return backend;
+}
+
+void uring_backend_destroy(uring_backend_t* backend) {
+    if (!backend) return;
+    
+    // Let queued sends finish before their slots go away
+    if (backend->ring_fd >= 0 && backend->cqes) {
+        submit_pending(backend);
+        reap_completions(backend);
+        while (backend->free_count < URING_SEND_SLOTS && backend->send_slab) {
+            if (ring_enter(backend, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0) break;
+            reap_completions(backend);
+        }
+    }
+    
+    if (backend->sq_ring && backend->sq_ring != MAP_FAILED) munmap(backend->sq_ring, backend->sq_ring_size);
+    if (backend->cq_ring && backend->cq_ring != MAP_FAILED) munmap(backend->cq_ring, backend->cq_ring_size);
+    if (backend->sqes && (void*)backend->sqes != MAP_FAILED) munmap(backend->sqes, backend->sqes_size);
+    if (backend->ring_fd >= 0) close(backend->ring_fd);
+    if (backend->buffer_ring) munmap(backend->buffer_ring, backend->buffer_ring_size);
+    free(backend->receive_buffers);
+    free(backend->send_slab);
+    pthread_cond_destroy(&backend->reaped);
+    pthread_mutex_destroy(&backend->lock);
+    free(backend);
+}
+
+network_result_t uring_backend_send(uring_backend_t* backend, const void* data, size_t length,
+                                    const struct sockaddr_in* destination) {
+    if (!backend || !data || !destination || length > MAX_BUFFER_SIZE) return NET_ERROR;
+    
+    pthread_mutex_lock(&backend->lock);
+    
+    // Wait for a slot only when every one is in flight
+    if (!backend->receiver_waiting) reap_completions(backend);
+    while (backend->free_count == 0) {
+        if (backend->receiver_waiting) {
+            // The receiver's wait ends on our completions and it reaps them
+            if (submit_pending(backend) < 0) break;
+            pthread_cond_wait(&backend->reaped, &backend->lock);
+            continue;
+        }
+        if (ring_enter(backend, backend->pending, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0) break;
+        reap_completions(backend);
+    }
+    
+    struct io_uring_sqe* sqe = backend->free_count ? reserve_sqe(backend) : NULL;
+    if (!sqe) {
+        pthread_mutex_unlock(&backend->lock);
+        return NET_ERROR;
+    }
+    
+    uint16_t slot = backend->free_slots[--backend->free_count];
+    memcpy(backend->send_iov[slot].iov_base, data, length);
+    backend->send_iov[slot].iov_len = length;
+    backend->send_addr[slot] = *destination;
+    
+    if (backend->zerocopy_supported && length >= URING_ZEROCOPY_MIN) {
+        sqe->opcode = IORING_OP_SEND_ZC;
+        sqe->fd = backend->socket_fd;
+        sqe->addr = (uint64_t)(uintptr_t)backend->send_iov[slot].iov_base;
+        sqe->len = (uint32_t)length;
+        sqe->ioprio = IORING_RECVSEND_FIXED_BUF;
+        sqe->buf_index = 0;
+        sqe->addr2 = (uint64_t)(uintptr_t)&backend->send_addr[slot];
+        sqe->addr_len = sizeof(struct sockaddr_in);
+    } else {
+        sqe->opcode = IORING_OP_SENDMSG;
+        sqe->fd = backend->socket_fd;
+        sqe->addr = (uint64_t)(uintptr_t)&backend->send_msg[slot];
+        sqe->len = 1;
+    }
+    sqe->user_data = (URING_TAG_SEND << 32) | slot;
+    queue_sqe(backend);
+    backend->stats.sends_queued++;
+    
+    network_result_t result = NET_SUCCESS;
+    if (backend->pending >= backend->submit_batch) {
+        // UDP sends normally complete inline, so their result is usually
+        // in the completion queue by the time this returns
+        if (submit_pending(backend) < 0) result = NET_ERROR;
+        if (!backend->receiver_waiting) reap_completions(backend);
+    }
+    
+    pthread_mutex_unlock(&backend->lock);
+    return result;
+}
+
+network_result_t uring_backend_receive(uring_backend_t* backend, void* buffer, size_t max_length,
+                                       size_t* received, struct sockaddr_in* source,
+                                       int timeout_ms) {
+    if (!backend || !buffer) return NET_ERROR;
+    
+    pthread_mutex_lock(&backend->lock);
+    
+    // One receiving thread at a time
+    while (backend->receiver_waiting) {
+        pthread_cond_wait(&backend->reaped, &backend->lock);
+    }
+    reap_completions(backend);
+    
+    network_result_t result = NET_SUCCESS;
+    while (backend->ready_head == backend->ready_tail) {
+        if (backend->receive_unsupported) {
+            result = NET_ERROR;
+            break;
+        }
+        if (!backend->receive_armed) {
+            if (arm_receive(backend) != 0) {
+                result = NET_ERROR;
+                break;
+            }
+            if (backend->stats.receives > 0) backend->stats.receive_rearms++;
+        }
+        if (submit_pending(backend) < 0) {
+            result = NET_ERROR;
+            break;
+        }
+        
+        struct io_uring_getevents_arg arg;
+        struct __kernel_timespec timeout;
+        memset(&arg, 0, sizeof(arg));
+        if (timeout_ms >= 0) {
+            timeout.tv_sec = timeout_ms / 1000;
+            timeout.tv_nsec = (long long)(timeout_ms % 1000) * 1000000LL;
+            arg.ts = (uint64_t)(uintptr_t)&timeout;
+        }
+        
+        // Wait without the lock so other threads can keep sending
+        backend->receiver_waiting = 1;
+        pthread_mutex_unlock(&backend->lock);
+        int waited;
+        do {
+            waited = (int)syscall(__NR_io_uring_enter, backend->ring_fd, 0, 1,
+                                  IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                                  &arg, sizeof(arg));
+        } while (waited < 0 && errno == EINTR);
+        int wait_errno = errno;
+        pthread_mutex_lock(&backend->lock);
+        backend->receiver_waiting = 0;
+        backend->stats.enter_calls++;
+        reap_completions(backend);
+        pthread_cond_broadcast(&backend->reaped);
+        
+        if (waited < 0 && wait_errno == ETIME) {
+            if (backend->ready_head == backend->ready_tail) result = NET_TIMEOUT;
+            break;
+        }
+        if (waited < 0) {
+            result = NET_ERROR;
+            break;
+        }
+    }
+    
+    if (result != NET_SUCCESS) {
+        pthread_mutex_unlock(&backend->lock);
+        return result;
+    }
+    
+    uring_ready_t ready = backend->ready[backend->ready_head % URING_RECEIVE_BUFFERS];
+    backend->ready_head++;
+    
+    const unsigned char* raw = backend->receive_buffers +
+                               (size_t)ready.buffer_id * URING_RECEIVE_BUFFER_SIZE;
+    const struct io_uring_recvmsg_out* out = (const struct io_uring_recvmsg_out*)raw;
+    const unsigned char* name = raw + sizeof(struct io_uring_recvmsg_out);
+    const unsigned char* payload = name + backend->receive_msg.msg_namelen +
+                                   backend->receive_msg.msg_controllen;
+    
+    size_t available = (size_t)ready.length - (size_t)(payload - raw);
+    size_t length = out->payloadlen < available ? out->payloadlen : available;
+    if (length > max_length) length = max_length;
+    
+    memcpy(buffer, payload, length);
+    if (source && out->namelen >= sizeof(struct sockaddr_in)) {
+        memcpy(source, name, sizeof(struct sockaddr_in));
+    }
+    if (received) {
+        *received = length;
+    }
+    
+    recycle_receive_buffer(backend, ready.buffer_id);
+    backend->stats.receives++;
+    pthread_mutex_unlock(&backend->lock);
+    return NET_SUCCESS;
+}
+
+network_result_t uring_backend_flush(uring_backend_t* backend) {
+    if (!backend) return NET_ERROR;
+    
+    pthread_mutex_lock(&backend->lock);
+    if (!backend->receiver_waiting) reap_completions(backend);
+    int submitted = submit_pending(backend);
+    if (!backend->receiver_waiting) reap_completions(backend);
+    pthread_mutex_unlock(&backend->lock);
+    
+    return submitted < 0 ? NET_ERROR : NET_SUCCESS;
+}
+
+unsigned long uring_backend_take_send_errors(uring_backend_t* backend) {
+    if (!backend) return 0;
+    
+    pthread_mutex_lock(&backend->lock);
+    unsigned long errors = backend->stats.send_errors - backend->send_errors_reported;
+    backend->send_errors_reported = backend->stats.send_errors;
+    pthread_mutex_unlock(&backend->lock);
+    return errors;
+}
+
+int uring_backend_receive_unsupported(const uring_backend_t* backend) {
+    return backend ? __atomic_load_n(&backend->receive_unsupported, __ATOMIC_RELAXED) : 1;
+}
+
+void uring_backend_get_stats(uring_backend_t* backend, uring_stats_t* stats) {
+    if (backend && stats) {
+        pthread_mutex_lock(&backend->lock);
+        *stats = backend->stats;
+        pthread_mutex_unlock(&backend->lock);
+    }
+}
+
+#else // !URING_AVAILABLE
+
+uring_backend_t* uring_backend_create(int socket_fd, unsigned int submit_batch) {
+    (void)socket_fd;
+    (void)submit_batch;
+    return NULL;
+}
+
+void uring_backend_destroy(uring_backend_t* backend) {
+    (void)backend;
+}
+
+network_result_t uring_backend_send(uring_backend_t* backend, const void* data, size_t length,
+                                    const struct sockaddr_in* destination) {
+    (void)backend; (void)data; (void)length; (void)destination;
+    return NET_ERROR;
+}
+
+network_result_t uring_backend_receive(uring_backend_t* backend, void* buffer, size_t max_length,
+                                       size_t* received, struct sockaddr_in* source,
+                                       int timeout_ms) {
+    (void)backend; (void)buffer; (void)max_length; (void)received; (void)source; (void)timeout_ms;
+    return NET_ERROR;
+}
+
+network_result_t uring_backend_flush(uring_backend_t* backend) {
+    (void)backend;
+    return NET_ERROR;
+}
+
+unsigned long uring_backend_take_send_errors(uring_backend_t* backend) {
+    (void)backend;
+    return 0;
+}
+
+int uring_backend_receive_unsupported(const uring_backend_t* backend) {
+    (void)backend;
+    return 1;
+}
+
+void uring_backend_get_stats(uring_backend_t* backend, uring_stats_t* stats) {
+    (void)backend;
+    if (stats) memset(stats, 0, sizeof(uring_stats_t));
+}
+
+#endif
@@ -0,0 +1,73 @@
+// src/core/uring_backend.h
+#ifndef URING_BACKEND_H
+#define URING_BACKEND_H
+
+#include "common.h"
+
+// Optional io_uring data path for network_core (Linux 6.0+).
+//
+// Receives use one multishot RECVMSG request fed from a provided-buffer
+// ring, so the kernel keeps delivering datagrams without a new submission
+// per packet. Sends are copied into a registered (pinned) slab and
+// submitted at once, the same as sendto. A caller that opts into batching
+// (submit_batch > 1) has sends queued until that many are pending or the
+// next flush or receive, and must call uring_backend_flush after each
+// burst. Completions are reaped from shared memory. Large sends use
+// zero-copy SEND_ZC on the registered buffers when the kernel supports it.
+//
+// The ring is locked, so one thread may receive while others send on the
+// same backend. The receiver waits in io_uring_enter without the lock.
+//
+// network_core owns the backend through network_enable_uring(); when any
+// part of the setup is unsupported it returns NULL and the caller stays on
+// plain sendto/recvfrom.
+
+#define URING_QUEUE_DEPTH 256
+#define URING_RECEIVE_BUFFERS 256       // Power of two
+#define URING_SEND_SLOTS 128
+#define URING_SUGGESTED_SUBMIT_BATCH 16  // For callers that flush after each burst
+#define URING_ZEROCOPY_MIN 4096         // Smaller sends are cheaper to copy
+
+struct uring_backend;
+typedef struct uring_backend uring_backend_t;
+
+// Backend counters
+typedef struct {
+    unsigned long enter_calls;          // io_uring_enter syscalls
+    unsigned long sends_queued;
+    unsigned long sends_completed;
+    unsigned long send_errors;
+    unsigned long receives;
+    unsigned long receive_rearms;       // Multishot request had to be resubmitted
+} uring_stats_t;
+
+// Set up a ring for a socket; NULL if io_uring is unavailable. submit_batch
+// 0 or 1 submits every send at once.
+uring_backend_t* uring_backend_create(int socket_fd, unsigned int submit_batch);
+
+// Tear down the ring (waits for in-flight sends)
+void uring_backend_destroy(uring_backend_t* backend);
+
+// Send a datagram (queue it, when batching); the data is copied, so the
+// caller may reuse it at once
+network_result_t uring_backend_send(uring_backend_t* backend, const void* data, size_t length,
+                                    const struct sockaddr_in* destination);
+
+// Receive one datagram. timeout_ms < 0 blocks. NET_TIMEOUT when nothing arrived.
+network_result_t uring_backend_receive(uring_backend_t* backend, void* buffer, size_t max_length,
+                                       size_t* received, struct sockaddr_in* source,
+                                       int timeout_ms);
+
+// Submit queued sends now
+network_result_t uring_backend_flush(uring_backend_t* backend);
+
+// Sends that completed with an error since the last call
+unsigned long uring_backend_take_send_errors(uring_backend_t* backend);
+
+// Multishot receive was rejected by the kernel; use recvfrom instead
+int uring_backend_receive_unsupported(const uring_backend_t* backend);
+
+// Snapshot of backend counters
+void uring_backend_get_stats(uring_backend_t* backend, uring_stats_t* stats);
+
+#endif
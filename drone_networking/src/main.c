@@ -8,8 +8,15 @@
 void demonstrate_secure_networking() {
     printf("=== Secure Drone Networking Demonstration ===\n");
     
-    // Initialize security context
-    security_context_t* security = security_init("MY_SECURE_DRONE_KEY_32_CHARS", "MY_IV_16_CHARS");
+    // Initialize security context with the fleet key from the environment
+    unsigned char key[AEAD_KEY_SIZE];
+    if (security_parse_key(getenv("DRONE_NETWORK_KEY"), key) != 0) {
+        fprintf(stderr, "Set DRONE_NETWORK_KEY to the fleet key as %d hex digits\n",
+                2 * AEAD_KEY_SIZE);
+        return;
+    }
+    security_context_t* security = security_init(key, "MY_IV_16_CHARS");
+    memset(key, 0, sizeof(key));
     if (!security) {
         fprintf(stderr, "Failed to initialize security\n");
         return;
@@ -0,0 +1,144 @@
+// src/protocols/checksum.c
+#include "checksum.h"
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define CRC32C_HAVE_SSE42 1
+#endif
+
+#define CRC32C_POLYNOMIAL 0x82F63B78 // Reflected Castagnoli polynomial
+
+typedef uint32_t (*crc32c_update_fn)(uint32_t crc, const unsigned char* data, size_t length);
+
+static uint32_t crc32c_table[8][256];
+static crc32c_update_fn crc32c_impl = NULL;
+static const char* crc32c_impl_name = "none";
+static pthread_once_t crc32c_once = PTHREAD_ONCE_INIT;
+
+static uint32_t crc32c_slicing8(uint32_t crc, const unsigned char* p, size_t length) {
+    // Byte steps until 8-byte aligned
+    while (length > 0 && ((uintptr_t)p & 7) != 0) {
+        crc = crc32c_table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+        length--;
+    }
+    
+    while (length >= 8) {
+        uint32_t low, high;
+        memcpy(&low, p, sizeof(low));
+        memcpy(&high, p + 4, sizeof(high));
+        low ^= crc;
+        crc = crc32c_table[7][low & 0xFF] ^
+              crc32c_table[6][(low >> 8) & 0xFF] ^
+              crc32c_table[5][(low >> 16) & 0xFF] ^
+              crc32c_table[4][low >> 24] ^
+              crc32c_table[3][high & 0xFF] ^
+              crc32c_table[2][(high >> 8) & 0xFF] ^
+              crc32c_table[1][(high >> 16) & 0xFF] ^
+              crc32c_table[0][high >> 24];
+        p += 8;
+        length -= 8;
+    }
+    
+    while (length > 0) {
+        crc = crc32c_table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+        length--;
+    }
+    
+    return crc;
+}
+
+#ifdef CRC32C_HAVE_SSE42
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_update_sse42(uint32_t crc, const unsigned char* p, size_t length) {
+    while (length > 0 && ((uintptr_t)p & 7) != 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+        length--;
+    }
+
+#ifdef __x86_64__
+    uint64_t crc64 = crc;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        p += 8;
+        length -= 8;
+    }
+    crc = (uint32_t)crc64;
+#endif
+    
+    while (length >= 4) {
+        uint32_t word;
+        memcpy(&word, p, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+        p += 4;
+        length -= 4;
+    }
+    
+    while (length > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+        length--;
+    }
+    
+    return crc;
+}
+#endif
+
+static void crc32c_setup(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLYNOMIAL : 0);
+        }
+        crc32c_table[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (int slice = 1; slice < 8; slice++) {
+            uint32_t previous = crc32c_table[slice - 1][i];
+            crc32c_table[slice][i] = crc32c_table[0][previous & 0xFF] ^ (previous >> 8);
+        }
+    }
+    
+    crc32c_impl = crc32c_slicing8;
+    crc32c_impl_name = "slicing-by-8";
+
+#ifdef CRC32C_HAVE_SSE42
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) {
+        crc32c_impl = crc32c_update_sse42;
+        crc32c_impl_name = "sse4.2";
+    }
+#endif
+}
+
+uint32_t crc32c_init(void) {
+    return 0xFFFFFFFF;
+}
+
+uint32_t crc32c_update(uint32_t crc, const void* data, size_t length) {
+    if (!data || length == 0) return crc;
+    
+    pthread_once(&crc32c_once, crc32c_setup);
+    return crc32c_impl(crc, (const unsigned char*)data, length);
+}
+
+uint32_t crc32c_update_slicing8(uint32_t crc, const void* data, size_t length) {
+    if (!data || length == 0) return crc;
+    
+    pthread_once(&crc32c_once, crc32c_setup);
+    return crc32c_slicing8(crc, (const unsigned char*)data, length);
+}
+
+uint32_t crc32c_final(uint32_t crc) {
+    return crc ^ 0xFFFFFFFF;
+}
+
+uint32_t crc32c(const void* data, size_t length) {
+    return crc32c_final(crc32c_update(crc32c_init(), data, length));
+}
+
+const char* crc32c_backend(void) {
+    pthread_once(&crc32c_once, crc32c_setup);
+    return crc32c_impl_name;
+}
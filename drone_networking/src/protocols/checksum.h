@@ -0,0 +1,35 @@
+// src/protocols/checksum.h
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include "common.h"
+
+// CRC32C (Castagnoli) checksum engine. Uses the SSE4.2 crc32 instruction when
+// the CPU supports it and a slicing-by-8 table implementation otherwise.
+//
+// Incremental use:
+//     uint32_t crc = crc32c_init();
+//     crc = crc32c_update(crc, part1, len1);
+//     crc = crc32c_update(crc, part2, len2);
+//     uint32_t checksum = crc32c_final(crc);
+
+// Start a new checksum
+uint32_t crc32c_init(void);
+
+// Feed more data into a running checksum
+uint32_t crc32c_update(uint32_t crc, const void* data, size_t length);
+
+// crc32c_update with the slicing-by-8 tables whatever the CPU supports,
+// so tests can check the fallback on hardware that never selects it
+uint32_t crc32c_update_slicing8(uint32_t crc, const void* data, size_t length);
+
+// Finish a running checksum
+uint32_t crc32c_final(uint32_t crc);
+
+// One-shot checksum of a buffer
+uint32_t crc32c(const void* data, size_t length);
+
+// Name of the backend in use ("sse4.2" or "slicing-by-8")
+const char* crc32c_backend(void);
+
+#endif
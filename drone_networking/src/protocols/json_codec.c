@@ -0,0 +1,636 @@
+// src/protocols/json_codec.c
+#include "json_codec.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define JSON_HAVE_SSE2 1
+#endif
+
+// Exactly representable powers of ten, for the fast number paths
+static const double power_of_ten[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define JSON_MAX_EXACT_POWER 22
+#define JSON_MAX_EXACT_INTEGER 9007199254740992.0  // 2^53
+
+static int needs_escape(unsigned char c) {
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
+// Offset of the first quote, backslash or control byte in data[position,
+// length), or length if there is none. Strings are scanned 16 bytes at a
+// time where SSE2 is available.
+static size_t scan_string(const char* data, size_t position, size_t length) {
+#ifdef JSON_HAVE_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1f);
+    while (length - position >= 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(data + position));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                       _mm_cmpeq_epi8(chunk, backslash));
+        // Unsigned c <= 0x1f, as max(c, 0x1f) == 0x1f
+        special = _mm_or_si128(special, _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+        int mask = _mm_movemask_epi8(special);
+        if (mask) return position + (size_t)__builtin_ctz((unsigned)mask);
+        position += 16;
+    }
+#endif
+    while (position < length && !needs_escape((unsigned char)data[position])) {
+        position++;
+    }
+    return position;
+}
+
+// Writer
+
+void json_writer_init(json_writer_t* writer, char* out, size_t capacity) {
+    writer->out = out;
+    writer->capacity = capacity;
+    writer->length = 0;
+    writer->overflow = 0;
+}
+
+void json_write_raw(json_writer_t* writer, const char* text, size_t length) {
+    if (writer->overflow || writer->capacity - writer->length < length) {
+        writer->overflow = 1;
+        return;
+    }
+    memcpy(writer->out + writer->length, text, length);
+    writer->length += length;
+}
+
+static void write_byte(json_writer_t* writer, char c) {
+    if (writer->overflow || writer->length >= writer->capacity) {
+        writer->overflow = 1;
+        return;
+    }
+    writer->out[writer->length++] = c;
+}
+
+void json_write_string(json_writer_t* writer, const char* value, size_t max_length) {
+    static const char hex[] = "0123456789abcdef";
+    size_t length = strnlen(value, max_length);
+    
+    write_byte(writer, '"');
+    size_t position = 0;
+    while (position < length) {
+        // Copy the run that needs no escaping in one go
+        size_t special = scan_string(value, position, length);
+        json_write_raw(writer, value + position, special - position);
+        if (special == length) break;
+        
+        unsigned char c = (unsigned char)value[special];
+        if (c == '"' || c == '\\') {
+            write_byte(writer, '\\');
+            write_byte(writer, (char)c);
+        } else if (c == '\n') {
+            json_write_raw(writer, "\\n", 2);
+        } else if (c == '\r') {
+            json_write_raw(writer, "\\r", 2);
+        } else if (c == '\t') {
+            json_write_raw(writer, "\\t", 2);
+        } else {
+            char escape[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 15] };
+            json_write_raw(writer, escape, sizeof(escape));
+        }
+        position = special + 1;
+    }
+    write_byte(writer, '"');
+}
+
+// Decimal digits of value, most significant first; returns the count
+static size_t format_unsigned(uint64_t value, char out[20]) {
+    char reversed[20];
+    size_t count = 0;
+    do {
+        reversed[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    for (size_t i = 0; i < count; i++) {
+        out[i] = reversed[count - 1 - i];
+    }
+    return count;
+}
+
+// Write value as mantissa / 10^scale in plain decimal notation
+static size_t format_fixed(int64_t mantissa, int scale, char* out) {
+    size_t length = 0;
+    uint64_t magnitude = (uint64_t)mantissa;
+    if (mantissa < 0) {
+        out[length++] = '-';
+        magnitude = 0 - magnitude;
+    }
+    
+    char digits[20];
+    size_t count = format_unsigned(magnitude, digits);
+    if (scale == 0) {
+        memcpy(out + length, digits, count);
+        return length + count;
+    }
+    
+    size_t fraction = (size_t)scale;
+    if (count <= fraction) {
+        out[length++] = '0';
+        out[length++] = '.';
+        memset(out + length, '0', fraction - count);
+        length += fraction - count;
+        memcpy(out + length, digits, count);
+        return length + count;
+    }
+    memcpy(out + length, digits, count - fraction);
+    length += count - fraction;
+    out[length++] = '.';
+    memcpy(out + length, digits + count - fraction, fraction);
+    return length + fraction;
+}
+
+void json_write_double(json_writer_t* writer, double value) {
+    if (!isfinite(value)) {
+        json_write_raw(writer, "null", 4);
+        return;
+    }
+    
+    if (value == 0) {
+        json_write_raw(writer, signbit(value) ? "-0" : "0", signbit(value) ? 2 : 1);
+        return;
+    }
+    
+    // Telemetry values mostly have a few decimals. Find the smallest scale
+    // where value is an exact decimal m / 10^scale: m and 10^scale are both
+    // exact doubles, so the division is correctly rounded just like the
+    // reader's, and the text reads back to the same bits.
+    char text[40];
+    double magnitude = value < 0 ? -value : value;
+    for (int scale = 0; scale <= 15; scale++) {
+        double scaled = magnitude * power_of_ten[scale];
+        if (scaled >= JSON_MAX_EXACT_INTEGER) break;
+        
+        int64_t mantissa = (int64_t)(scaled + 0.5);
+        if ((double)mantissa / power_of_ten[scale] == magnitude) {
+            size_t length = format_fixed(value < 0 ? -mantissa : mantissa, scale, text);
+            json_write_raw(writer, text, length);
+            return;
+        }
+    }
+    
+    // Shortest of %.15g and %.17g that reads back exactly
+    int length = snprintf(text, sizeof(text), "%.15g", value);
+    if (strtod(text, NULL) != value) {
+        length = snprintf(text, sizeof(text), "%.17g", value);
+    }
+    json_write_raw(writer, text, (size_t)length);
+}
+
+void json_write_int64(json_writer_t* writer, int64_t value) {
+    char text[24];
+    size_t length = 0;
+    uint64_t magnitude = (uint64_t)value;
+    if (value < 0) {
+        text[length++] = '-';
+        magnitude = 0 - magnitude;
+    }
+    length += format_unsigned(magnitude, text + length);
+    json_write_raw(writer, text, length);
+}
+
+int json_writer_finish(const json_writer_t* writer) {
+    return writer->overflow ? -1 : (int)writer->length;
+}
+
+// Reader
+
+void json_reader_init(json_reader_t* reader, const char* data, size_t length) {
+    reader->data = data;
+    reader->length = length;
+    reader->position = 0;
+}
+
+static int is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static void skip_whitespace(json_reader_t* reader) {
+    while (reader->position < reader->length && is_space(reader->data[reader->position])) {
+        reader->position++;
+    }
+}
+
+static int peek(json_reader_t* reader) {
+    skip_whitespace(reader);
+    return reader->position < reader->length ? (unsigned char)reader->data[reader->position] : -1;
+}
+
+static int consume(json_reader_t* reader, char expected) {
+    if (peek(reader) != (unsigned char)expected) return -1;
+    reader->position++;
+    return 0;
+}
+
+static int consume_literal(json_reader_t* reader, const char* literal, size_t length) {
+    if (reader->length - reader->position < length ||
+        memcmp(reader->data + reader->position, literal, length) != 0) {
+        return -1;
+    }
+    reader->position += length;
+    return 0;
+}
+
+static int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static int read_hex4(json_reader_t* reader, uint32_t* value) {
+    if (reader->length - reader->position < 4) return -1;
+    *value = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = hex_value(reader->data[reader->position++]);
+        if (digit < 0) return -1;
+        *value = (*value << 4) | (uint32_t)digit;
+    }
+    return 0;
+}
+
+// Decode the escape after a backslash into a code point. Unknown escapes
+// and surrogates that are not a high-low pair are malformed.
+static int read_escape(json_reader_t* reader, uint32_t* code) {
+    if (reader->position >= reader->length) return -1;
+    
+    char escape = reader->data[reader->position++];
+    switch (escape) {
+        case '"': case '\\': case '/': *code = (uint32_t)escape; return 0;
+        case 'b': *code = '\b'; return 0;
+        case 'f': *code = '\f'; return 0;
+        case 'n': *code = '\n'; return 0;
+        case 'r': *code = '\r'; return 0;
+        case 't': *code = '\t'; return 0;
+        case 'u': break;
+        default: return -1;
+    }
+    
+    if (read_hex4(reader, code) != 0 || (*code >= 0xdc00 && *code < 0xe000)) return -1;
+    if (*code >= 0xd800 && *code < 0xdc00) {
+        uint32_t low;
+        if (consume_literal(reader, "\\u", 2) != 0 || read_hex4(reader, &low) != 0 ||
+            low < 0xdc00 || low >= 0xe000) {
+            return -1;
+        }
+        *code = 0x10000 + ((*code - 0xd800) << 10) + (low - 0xdc00);
+    }
+    return 0;
+}
+
+// Past the closing quote of the string starting at the cursor
+static int skip_string(json_reader_t* reader) {
+    if (consume(reader, '"') != 0) return -1;
+    for (;;) {
+        size_t special = scan_string(reader->data, reader->position, reader->length);
+        if (special >= reader->length) return -1;
+        
+        char c = reader->data[special];
+        reader->position = special + 1;
+        if (c == '"') return 0;
+        
+        uint32_t code;
+        if (c != '\\' || read_escape(reader, &code) != 0) return -1;
+    }
+}
+
+int json_object_begin(json_reader_t* reader) {
+    return consume(reader, '{');
+}
+
+int json_object_next(json_reader_t* reader, const char** key, size_t* key_length) {
+    int c = peek(reader);
+    if (c == '}') {
+        reader->position++;
+        return 0;
+    }
+    
+    // A member follows '{' directly or follows a comma after a value
+    size_t back = reader->position;
+    while (back > 0 && is_space(reader->data[back - 1])) back--;
+    char previous = back > 0 ? reader->data[back - 1] : '\0';
+    if (c == ',') {
+        if (previous == '{') return -1;
+        reader->position++;
+        c = peek(reader);
+    } else if (previous != '{') {
+        return -1;
+    }
+    if (c != '"') return -1;
+    
+    size_t start = reader->position + 1;
+    if (skip_string(reader) != 0) return -1;
+    *key = reader->data + start;
+    *key_length = reader->position - 1 - start;
+    
+    return consume(reader, ':') == 0 ? 1 : -1;
+}
+
+static size_t encode_utf8(uint32_t code, char out[4]) {
+    if (code < 0x80) {
+        out[0] = (char)code;
+        return 1;
+    }
+    if (code < 0x800) {
+        out[0] = (char)(0xc0 | (code >> 6));
+        out[1] = (char)(0x80 | (code & 0x3f));
+        return 2;
+    }
+    if (code < 0x10000) {
+        out[0] = (char)(0xe0 | (code >> 12));
+        out[1] = (char)(0x80 | ((code >> 6) & 0x3f));
+        out[2] = (char)(0x80 | (code & 0x3f));
+        return 3;
+    }
+    out[0] = (char)(0xf0 | (code >> 18));
+    out[1] = (char)(0x80 | ((code >> 12) & 0x3f));
+    out[2] = (char)(0x80 | ((code >> 6) & 0x3f));
+    out[3] = (char)(0x80 | (code & 0x3f));
+    return 4;
+}
+
+int json_read_string(json_reader_t* reader, char* out, size_t capacity) {
+    if (capacity == 0 || consume(reader, '"') != 0) return -1;
+    
+    size_t written = 0;
+    for (;;) {
+        // Copy the plain run up to the next quote, escape or control byte
+        size_t special = scan_string(reader->data, reader->position, reader->length);
+        size_t run = special - reader->position;
+        if (special >= reader->length || written + run >= capacity) return -1;
+        memcpy(out + written, reader->data + reader->position, run);
+        written += run;
+        reader->position = special + 1;
+        
+        char c = reader->data[special];
+        if (c == '"') {
+            out[written] = '\0';
+            return 0;
+        }
+        
+        uint32_t code;
+        if (c != '\\' || read_escape(reader, &code) != 0) return -1;
+        char decoded[4];
+        size_t decoded_length = encode_utf8(code, decoded);
+        if (written + decoded_length >= capacity) return -1;
+        memcpy(out + written, decoded, decoded_length);
+        written += decoded_length;
+    }
+}
+
+int json_match_string(json_reader_t* reader, const char* expected, size_t expected_length) {
+    skip_whitespace(reader);
+    size_t start = reader->position + 1;
+    if (skip_string(reader) != 0) return -1;
+    
+    size_t length = reader->position - 1 - start;
+    return length == expected_length && memcmp(reader->data + start, expected, length) == 0;
+}
+
+// A number as parsed in place: value = mantissa * 10^exponent
+typedef struct {
+    uint64_t mantissa;
+    int exponent;
+    int negative;
+    int exact;          // All significant digits fit in mantissa
+    int integral;       // No fraction or exponent part
+    size_t start;
+    size_t end;
+} json_number_t;
+
+static int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// Parse the number at the cursor per the JSON grammar, without copying it
+static int scan_number(json_reader_t* reader, json_number_t* number) {
+    skip_whitespace(reader);
+    const char* data = reader->data;
+    size_t length = reader->length;
+    size_t position = reader->position;
+    int digits = 0;
+    
+    memset(number, 0, sizeof(*number));
+    number->start = position;
+    number->exact = 1;
+    number->integral = 1;
+    if (position < length && data[position] == '-') {
+        number->negative = 1;
+        position++;
+    }
+    
+    // Integer part: one zero or a run without leading zeros
+    if (position >= length || !is_digit(data[position])) return -1;
+    if (data[position] == '0') {
+        position++;
+    } else {
+        while (position < length && is_digit(data[position])) {
+            if (digits < 19) {
+                number->mantissa = number->mantissa * 10 + (uint64_t)(data[position] - '0');
+                digits++;
+            } else {
+                number->exponent++;
+                number->exact = 0;
+            }
+            position++;
+        }
+    }
+    
+    if (position < length && data[position] == '.') {
+        number->integral = 0;
+        position++;
+        if (position >= length || !is_digit(data[position])) return -1;
+        while (position < length && is_digit(data[position])) {
+            if (digits < 19) {
+                number->mantissa = number->mantissa * 10 + (uint64_t)(data[position] - '0');
+                number->exponent--;
+                if (number->mantissa != 0) digits++;
+            } else if (data[position] != '0') {
+                number->exact = 0;
+            }
+            position++;
+        }
+    }
+    
+    if (position < length && (data[position] == 'e' || data[position] == 'E')) {
+        number->integral = 0;
+        position++;
+        int exponent_negative = 0;
+        if (position < length && (data[position] == '+' || data[position] == '-')) {
+            exponent_negative = data[position] == '-';
+            position++;
+        }
+        if (position >= length || !is_digit(data[position])) return -1;
+        int exponent = 0;
+        while (position < length && is_digit(data[position])) {
+            if (exponent < 100000) exponent = exponent * 10 + (data[position] - '0');
+            position++;
+        }
+        number->exponent += exponent_negative ? -exponent : exponent;
+    }
+    
+    number->end = position;
+    reader->position = position;
+    return 0;
+}
+
+// Slow path: hand the text to strtod
+static int number_to_double_slow(const json_reader_t* reader, const json_number_t* number,
+                                 double* value) {
+    char text[64];
+    size_t length = number->end - number->start;
+    if (length >= sizeof(text)) return -1;
+    memcpy(text, reader->data + number->start, length);
+    text[length] = '\0';
+    *value = strtod(text, NULL);
+    return 0;
+}
+
+static int number_to_double(const json_reader_t* reader, const json_number_t* number,
+                            double* value) {
+    // Clinger's fast path: an exact mantissa and power of ten give a
+    // correctly rounded result with a single multiply or divide
+    if (number->exact && (double)number->mantissa <= JSON_MAX_EXACT_INTEGER &&
+        number->exponent >= -JSON_MAX_EXACT_POWER && number->exponent <= JSON_MAX_EXACT_POWER) {
+        double result = (double)number->mantissa;
+        if (number->exponent < 0) {
+            result /= power_of_ten[-number->exponent];
+        } else {
+            result *= power_of_ten[number->exponent];
+        }
+        *value = number->negative ? -result : result;
+        return 0;
+    }
+    return number_to_double_slow(reader, number, value);
+}
+
+int json_read_double(json_reader_t* reader, double* value) {
+    if (peek(reader) == 'n') {
+        *value = 0;
+        return consume_literal(reader, "null", 4);
+    }
+    
+    json_number_t number;
+    if (scan_number(reader, &number) != 0) return -1;
+    return number_to_double(reader, &number, value);
+}
+
+int json_read_int64(json_reader_t* reader, int64_t* value) {
+    if (peek(reader) == 'n') {
+        *value = 0;
+        return consume_literal(reader, "null", 4);
+    }
+    
+    json_number_t number;
+    if (scan_number(reader, &number) != 0) return -1;
+    if (number.integral && number.exact) {
+        uint64_t limit = number.negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+        if (number.mantissa > limit) return -1;
+        *value = number.negative ? (int64_t)(0 - number.mantissa) : (int64_t)number.mantissa;
+        return 0;
+    }
+    
+    // Accept integral values written as floating point (1.7e9)
+    double real;
+    if (number_to_double(reader, &number, &real) != 0) return -1;
+    if (!(real >= -9223372036854775808.0 && real < 9223372036854775808.0) ||
+        real != (double)(long long)real) {
+        return -1;
+    }
+    *value = (int64_t)real;
+    return 0;
+}
+
+// A scalar: string, number or literal
+static int skip_scalar(json_reader_t* reader) {
+    switch (peek(reader)) {
+        case '"': return skip_string(reader);
+        case 't': return consume_literal(reader, "true", 4);
+        case 'f': return consume_literal(reader, "false", 5);
+        case 'n': return consume_literal(reader, "null", 4);
+        default: {
+            json_number_t number;
+            return scan_number(reader, &number);
+        }
+    }
+}
+
+// An object member's key and the colon after it
+static int skip_key(json_reader_t* reader) {
+    if (peek(reader) != '"' || skip_string(reader) != 0) return -1;
+    return consume(reader, ':');
+}
+
+// Values are checked against the grammar, not just balanced: members need
+// string keys and colons, and elements are separated by single commas.
+// Bit d of objects tells whether nesting level d is an object.
+_Static_assert(JSON_MAX_DEPTH <= 64, "one bit of objects per nesting level");
+
+int json_skip_value(json_reader_t* reader) {
+    uint64_t objects = 0;
+    int depth = 0;
+    for (;;) {
+        int c = peek(reader);
+        if (c == '{' || c == '[') {
+            if (depth == JSON_MAX_DEPTH) return -1;
+            reader->position++;
+            if (c == '{') {
+                objects |= 1ULL << depth;
+            } else {
+                objects &= ~(1ULL << depth);
+            }
+            depth++;
+            if (peek(reader) != (c == '{' ? '}' : ']')) {
+                if (c == '{' && skip_key(reader) != 0) return -1;
+                continue;   // The first value inside
+            }
+            reader->position++;
+            depth--;
+        } else if (skip_scalar(reader) != 0) {
+            return -1;
+        }
+        
+        // After a value: a comma and the next one, or the end of its container
+        for (;;) {
+            if (depth == 0) return 0;
+            int in_object = (int)(objects >> (depth - 1)) & 1;
+            c = peek(reader);
+            if (c == ',') {
+                reader->position++;
+                if (in_object && skip_key(reader) != 0) return -1;
+                break;
+            }
+            if (c != (in_object ? '}' : ']')) return -1;
+            reader->position++;
+            depth--;
+        }
+    }
+}
+
+int json_read_raw(json_reader_t* reader, char* out, size_t capacity) {
+    skip_whitespace(reader);
+    size_t start = reader->position;
+    if (json_skip_value(reader) != 0) return -1;
+    
+    size_t length = reader->position - start;
+    if (length >= capacity) return -1;
+    memcpy(out, reader->data + start, length);
+    out[length] = '\0';
+    return 0;
+}
+
+int json_reader_finish(json_reader_t* reader) {
+    skip_whitespace(reader);
+    return reader->position == reader->length ? 0 : -1;
+}
@@ -0,0 +1,86 @@
+// src/protocols/json_codec.h
+#ifndef JSON_CODEC_H
+#define JSON_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Minimal JSON writer and pull reader for the command-center formats.
+//
+// Neither side allocates. The writer appends into a caller buffer and
+// remembers overflow instead of failing each call, so generated encoders
+// are a straight run of writes with one check at the end. The reader is a
+// cursor over the caller's buffer: objects are walked member by member,
+// keys are returned as pointers into the buffer, and values are read
+// into typed fields or skipped.
+//
+// Both sides are built for gateway rates. Strings are scanned for quotes,
+// escapes and control bytes 16 at a time with SSE2 and copied in runs.
+// Numbers are parsed where they lie, and those with at most 19
+// significant digits and a small exponent are converted with one exact
+// multiply or divide (Clinger's fast path) instead of strtod. Doubles are
+// written as the shortest exact fixed-point decimal when one exists,
+// falling back to printf only for values such as 1e300.
+
+#define JSON_MAX_DEPTH 32
+
+typedef struct {
+    char* out;
+    size_t capacity;
+    size_t length;
+    int overflow;
+} json_writer_t;
+
+typedef struct {
+    const char* data;
+    size_t length;
+    size_t position;
+} json_reader_t;
+
+// Start writing into out
+void json_writer_init(json_writer_t* writer, char* out, size_t capacity);
+
+// Append text verbatim
+void json_write_raw(json_writer_t* writer, const char* text, size_t length);
+
+// Append a quoted, escaped string of at most max_length bytes
+void json_write_string(json_writer_t* writer, const char* value, size_t max_length);
+
+// Append a number; non-finite values are written as null
+void json_write_double(json_writer_t* writer, double value);
+void json_write_int64(json_writer_t* writer, int64_t value);
+
+// Bytes written, or -1 if anything did not fit
+int json_writer_finish(const json_writer_t* writer);
+
+// Start reading length bytes of data
+void json_reader_init(json_reader_t* reader, const char* data, size_t length);
+
+// Consume the '{' opening an object, 0 or -1
+int json_object_begin(json_reader_t* reader);
+
+// Advance to the next member of the current object. Returns 1 with the key
+// (unescaped keys only) and the cursor on its value, 0 after the closing
+// '}', -1 on malformed input.
+int json_object_next(json_reader_t* reader, const char** key, size_t* key_length);
+
+// Read a string value into out, NUL-terminated; -1 if it does not fit
+int json_read_string(json_reader_t* reader, char* out, size_t capacity);
+
+// Read a string value and compare it: 1 if equal, 0 if not, -1 if malformed
+int json_match_string(json_reader_t* reader, const char* expected, size_t expected_length);
+
+// Read a number; null reads as 0
+int json_read_double(json_reader_t* reader, double* value);
+int json_read_int64(json_reader_t* reader, int64_t* value);
+
+// Copy any well-formed value's text verbatim into out, NUL-terminated
+int json_read_raw(json_reader_t* reader, char* out, size_t capacity);
+
+// Skip over any value, -1 unless it is well-formed JSON
+int json_skip_value(json_reader_t* reader);
+
+// 0 if only whitespace remains
+int json_reader_finish(json_reader_t* reader);
+
+#endif
@@ -0,0 +1,314 @@
+// src/protocols/message_formats.c
+// Generated by scripts/generate_message_formats.rb from shared/message_formats.json.
+// Do not edit: change the schema and run `make generate`.
+#include "message_formats.h"
+#include "json_codec.h"
+#include "message_protocol.h"
+#include <string.h>
+
+// Protocol structs that carry these formats on the drone link (x-c-wire)
+// must keep a member of a compatible size for every schema field.
+_Static_assert(sizeof(((status_update_message_t*)0)->header.drone_id[0]) == 1 &&
+               sizeof(((status_update_message_t*)0)->header.drone_id) <= STATUS_UPDATE_DRONE_ID_SIZE,
+               "status_update.drone_id: status_update_message_t.header.drone_id is not text that fits");
+_Static_assert(sizeof(((status_update_message_t*)0)->x) == 8,
+               "status_update.position.x: status_update_message_t.x is not 8 bytes");
+_Static_assert(sizeof(((status_update_message_t*)0)->y) == 8,
+               "status_update.position.y: status_update_message_t.y is not 8 bytes");
+_Static_assert(sizeof(((status_update_message_t*)0)->z) == 8,
+               "status_update.position.z: status_update_message_t.z is not 8 bytes");
+_Static_assert(sizeof(((status_update_message_t*)0)->battery_level) == 8,
+               "status_update.battery_level: status_update_message_t.battery_level is not 8 bytes");
+_Static_assert(sizeof(((status_update_message_t*)0)->state) == sizeof(int),
+               "status_update.state: status_update_message_t.state is not an enum");
+_Static_assert(sizeof(((status_update_message_t*)0)->header.timestamp) == 8,
+               "status_update.timestamp: status_update_message_t.header.timestamp is not 8 bytes");
+
+static unsigned char* put_u64(unsigned char* out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out[i] = (unsigned char)(value >> (8 * i));
+    }
+    return out + 8;
+}
+
+static unsigned char* put_double(unsigned char* out, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return put_u64(out, bits);
+}
+
+static unsigned char* put_string(unsigned char* out, const char* value, size_t size) {
+    size_t length = strnlen(value, size - 1);
+    *out++ = (unsigned char)length;
+    memcpy(out, value, length);
+    return out + length;
+}
+
+static unsigned char* put_raw(unsigned char* out, const char* value, size_t size) {
+    size_t length = strnlen(value, size - 1);
+    out[0] = (unsigned char)length;
+    out[1] = (unsigned char)(length >> 8);
+    memcpy(out + 2, value, length);
+    return out + 2 + length;
+}
+
+static int get_u64(const unsigned char** in, const unsigned char* end, uint64_t* value) {
+    if (end - *in < 8) return -1;
+    uint64_t result = 0;
+    for (int i = 7; i >= 0; i--) {
+        result = (result << 8) | (*in)[i];
+    }
+    *value = result;
+    *in += 8;
+    return 0;
+}
+
+static int get_double(const unsigned char** in, const unsigned char* end, double* value) {
+    uint64_t bits;
+    if (get_u64(in, end, &bits) != 0) return -1;
+    memcpy(value, &bits, sizeof(bits));
+    return 0;
+}
+
+static int get_string(const unsigned char** in, const unsigned char* end, char* value, size_t size) {
+    if (*in >= end) return -1;
+    size_t length = *(*in)++;
+    if (length >= size || (size_t)(end - *in) < length) return -1;
+    memcpy(value, *in, length);
+    value[length] = '\0';
+    *in += length;
+    return 0;
+}
+
+static int get_raw(const unsigned char** in, const unsigned char* end, char* value, size_t size) {
+    if (end - *in < 2) return -1;
+    size_t length = (size_t)(*in)[0] | ((size_t)(*in)[1] << 8);
+    *in += 2;
+    if (length >= size || (size_t)(end - *in) < length) return -1;
+    memcpy(value, *in, length);
+    value[length] = '\0';
+    *in += length;
+    return 0;
+}
+
+static int decode_status_update_position_json(json_reader_t* reader, status_update_position_t* value) {
+    const char* key;
+    size_t key_length;
+    int member;
+    if (json_object_begin(reader) != 0) return -1;
+    while ((member = json_object_next(reader, &key, &key_length)) > 0) {
+        if (key_length == 1 && memcmp(key, "x", 1) == 0) {
+            if (json_read_double(reader, &value->x) != 0) return -1;
+        } else if (key_length == 1 && memcmp(key, "y", 1) == 0) {
+            if (json_read_double(reader, &value->y) != 0) return -1;
+        } else if (key_length == 1 && memcmp(key, "z", 1) == 0) {
+            if (json_read_double(reader, &value->z) != 0) return -1;
+        } else if (json_skip_value(reader) != 0) {
+            return -1;
+        }
+    }
+    return member == 0 ? 0 : -1;
+}
+
+static int decode_status_update_members(json_reader_t* reader, status_update_format_t* message) {
+    const char* key;
+    size_t key_length;
+    int member;
+    int seen_discriminator = 0;
+    if (json_object_begin(reader) != 0) return -1;
+    while ((member = json_object_next(reader, &key, &key_length)) > 0) {
+        if (key_length == 12 && memcmp(key, "message_type", 12) == 0) {
+            if (json_match_string(reader, "status_update", 13) != 1) return -1;
+            seen_discriminator = 1;
+        } else if (key_length == 8 && memcmp(key, "drone_id", 8) == 0) {
+            if (json_read_string(reader, message->drone_id, sizeof(message->drone_id)) != 0) return -1;
+        } else if (key_length == 8 && memcmp(key, "position", 8) == 0) {
+            if (decode_status_update_position_json(reader, &message->position) != 0) return -1;
+        } else if (key_length == 13 && memcmp(key, "battery_level", 13) == 0) {
+            if (json_read_double(reader, &message->battery_level) != 0) return -1;
+        } else if (key_length == 5 && memcmp(key, "state", 5) == 0) {
+            if (json_read_string(reader, message->state, sizeof(message->state)) != 0) return -1;
+        } else if (key_length == 9 && memcmp(key, "timestamp", 9) == 0) {
+            if (json_read_int64(reader, &message->timestamp) != 0) return -1;
+        } else if (json_skip_value(reader) != 0) {
+            return -1;
+        }
+    }
+    return member == 0 && seen_discriminator ? 0 : -1;
+}
+
+int status_update_format_encode_json(const status_update_format_t* message, char* out, size_t capacity) {
+    if (!message || !out) return -1;
+    
+    json_writer_t writer;
+    json_writer_init(&writer, out, capacity);
+    json_write_raw(&writer, "{\"message_type\":\"status_update\",\"drone_id\":", 43);
+    json_write_string(&writer, message->drone_id, sizeof(message->drone_id));
+    json_write_raw(&writer, ",\"position\":{\"x\":", 17);
+    json_write_double(&writer, message->position.x);
+    json_write_raw(&writer, ",\"y\":", 5);
+    json_write_double(&writer, message->position.y);
+    json_write_raw(&writer, ",\"z\":", 5);
+    json_write_double(&writer, message->position.z);
+    json_write_raw(&writer, "},\"battery_level\":", 18);
+    json_write_double(&writer, message->battery_level);
+    json_write_raw(&writer, ",\"state\":", 9);
+    json_write_string(&writer, message->state, sizeof(message->state));
+    json_write_raw(&writer, ",\"timestamp\":", 13);
+    json_write_int64(&writer, message->timestamp);
+    json_write_raw(&writer, "}", 1);
+    return json_writer_finish(&writer);
+}
+
+int status_update_format_decode_json(status_update_format_t* message, const char* json, size_t length) {
+    if (!message || !json) return -1;
+    
+    json_reader_t reader;
+    json_reader_init(&reader, json, length);
+    memset(message, 0, sizeof(*message));
+    if (decode_status_update_members(&reader, message) != 0) return -1;
+    return json_reader_finish(&reader);
+}
+
+int status_update_format_encode_binary(const status_update_format_t* message, unsigned char* out, size_t capacity) {
+    if (!message || !out || capacity < STATUS_UPDATE_BINARY_MAX_SIZE) return -1;
+    
+    unsigned char* start = out;
+    *out++ = MESSAGE_FORMAT_STATUS_UPDATE;
+    out = put_string(out, message->drone_id, sizeof(message->drone_id));
+    out = put_double(out, message->position.x);
+    out = put_double(out, message->position.y);
+    out = put_double(out, message->position.z);
+    out = put_double(out, message->battery_level);
+    out = put_string(out, message->state, sizeof(message->state));
+    out = put_u64(out, (uint64_t)message->timestamp);
+    return (int)(out - start);
+}
+
+int status_update_format_decode_binary(status_update_format_t* message, const unsigned char* data, size_t length) {
+    if (!message || !data || length == 0 || data[0] != MESSAGE_FORMAT_STATUS_UPDATE) return -1;
+    
+    const unsigned char* in = data + 1;
+    const unsigned char* end = data + length;
+    memset(message, 0, sizeof(*message));
+    if (get_string(&in, end, message->drone_id, sizeof(message->drone_id)) != 0) return -1;
+    if (get_double(&in, end, &message->position.x) != 0) return -1;
+    if (get_double(&in, end, &message->position.y) != 0) return -1;
+    if (get_double(&in, end, &message->position.z) != 0) return -1;
+    if (get_double(&in, end, &message->battery_level) != 0) return -1;
+    if (get_string(&in, end, message->state, sizeof(message->state)) != 0) return -1;
+    if (get_u64(&in, end, (uint64_t*)&message->timestamp) != 0) return -1;
+    return in == end ? 0 : -1;
+}
+
+static int decode_command_members(json_reader_t* reader, command_format_t* message) {
+    const char* key;
+    size_t key_length;
+    int member;
+    int seen_discriminator = 0;
+    if (json_object_begin(reader) != 0) return -1;
+    while ((member = json_object_next(reader, &key, &key_length)) > 0) {
+        if (key_length == 12 && memcmp(key, "message_type", 12) == 0) {
+            if (json_match_string(reader, "command", 7) != 1) return -1;
+            seen_discriminator = 1;
+        } else if (key_length == 8 && memcmp(key, "drone_id", 8) == 0) {
+            if (json_read_string(reader, message->drone_id, sizeof(message->drone_id)) != 0) return -1;
+        } else if (key_length == 7 && memcmp(key, "command", 7) == 0) {
+            if (json_read_string(reader, message->command, sizeof(message->command)) != 0) return -1;
+        } else if (key_length == 6 && memcmp(key, "params", 6) == 0) {
+            if (json_read_raw(reader, message->params, sizeof(message->params)) != 0) return -1;
+        } else if (key_length == 9 && memcmp(key, "timestamp", 9) == 0) {
+            if (json_read_int64(reader, &message->timestamp) != 0) return -1;
+        } else if (json_skip_value(reader) != 0) {
+            return -1;
+        }
+    }
+    return member == 0 && seen_discriminator ? 0 : -1;
+}
+
+int command_format_encode_json(const command_format_t* message, char* out, size_t capacity) {
+    if (!message || !out) return -1;
+    
+    json_writer_t writer;
+    json_writer_init(&writer, out, capacity);
+    json_write_raw(&writer, "{\"message_type\":\"command\",\"drone_id\":", 37);
+    json_write_string(&writer, message->drone_id, sizeof(message->drone_id));
+    json_write_raw(&writer, ",\"command\":", 11);
+    json_write_string(&writer, message->command, sizeof(message->command));
+    json_write_raw(&writer, ",\"params\":", 10);
+    if (message->params[0]) {
+        json_write_raw(&writer, message->params, strnlen(message->params, sizeof(message->params)));
+    } else {
+        json_write_raw(&writer, "{}", 2);
+    }
+    json_write_raw(&writer, ",\"timestamp\":", 13);
+    json_write_int64(&writer, message->timestamp);
+    json_write_raw(&writer, "}", 1);
+    return json_writer_finish(&writer);
+}
+
+int command_format_decode_json(command_format_t* message, const char* json, size_t length) {
+    if (!message || !json) return -1;
+    
+    json_reader_t reader;
+    json_reader_init(&reader, json, length);
+    memset(message, 0, sizeof(*message));
+    if (decode_command_members(&reader, message) != 0) return -1;
+    return json_reader_finish(&reader);
+}
+
+int command_format_encode_binary(const command_format_t* message, unsigned char* out, size_t capacity) {
+    if (!message || !out || capacity < COMMAND_BINARY_MAX_SIZE) return -1;
+    
+    unsigned char* start = out;
+    *out++ = MESSAGE_FORMAT_COMMAND;
+    out = put_string(out, message->drone_id, sizeof(message->drone_id));
+    out = put_string(out, message->command, sizeof(message->command));
+    out = put_raw(out, message->params, sizeof(message->params));
+    out = put_u64(out, (uint64_t)message->timestamp);
+    return (int)(out - start);
+}
+
+int command_format_decode_binary(command_format_t* message, const unsigned char* data, size_t length) {
+    if (!message || !data || length == 0 || data[0] != MESSAGE_FORMAT_COMMAND) return -1;
+    
+    const unsigned char* in = data + 1;
+    const unsigned char* end = data + length;
+    memset(message, 0, sizeof(*message));
+    if (get_string(&in, end, message->drone_id, sizeof(message->drone_id)) != 0) return -1;
+    if (get_string(&in, end, message->command, sizeof(message->command)) != 0) return -1;
+    if (get_raw(&in, end, message->params, sizeof(message->params)) != 0) return -1;
+    if (get_u64(&in, end, (uint64_t*)&message->timestamp) != 0) return -1;
+    return in == end ? 0 : -1;
+}
+
+message_format_t message_format_detect_json(const char* json, size_t length) {
+    if (!json) return MESSAGE_FORMAT_UNKNOWN;
+    
+    json_reader_t reader;
+    json_reader_init(&reader, json, length);
+    if (json_object_begin(&reader) != 0) return MESSAGE_FORMAT_UNKNOWN;
+    
+    const char* key;
+    size_t key_length;
+    while (json_object_next(&reader, &key, &key_length) > 0) {
+        if (key_length == 12 && memcmp(key, "message_type", 12) == 0) {
+            json_reader_t value = reader;
+            if (json_match_string(&value, "status_update", 13) == 1) return MESSAGE_FORMAT_STATUS_UPDATE;
+            value = reader;
+            if (json_match_string(&value, "command", 7) == 1) return MESSAGE_FORMAT_COMMAND;
+        }
+        if (json_skip_value(&reader) != 0) break;
+    }
+    return MESSAGE_FORMAT_UNKNOWN;
+}
+
+message_format_t message_format_detect_binary(const unsigned char* data, size_t length) {
+    if (!data || length == 0) return MESSAGE_FORMAT_UNKNOWN;
+    
+    switch (data[0]) {
+        case MESSAGE_FORMAT_STATUS_UPDATE: return MESSAGE_FORMAT_STATUS_UPDATE;
+        case MESSAGE_FORMAT_COMMAND: return MESSAGE_FORMAT_COMMAND;
+    }
+    return MESSAGE_FORMAT_UNKNOWN;
+}
@@ -0,0 +1,82 @@
+// src/protocols/message_formats.h
+// Generated by scripts/generate_message_formats.rb from shared/message_formats.json.
+// Do not edit: change the schema and run `make generate`.
+#ifndef MESSAGE_FORMATS_H
+#define MESSAGE_FORMATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Command-center message formats. Each has a struct with fixed field
+// sizes and four codecs: JSON as the Ruby side speaks it, and a compact
+// little-endian binary form led by the format's tag byte.
+
+typedef enum {
+    MESSAGE_FORMAT_UNKNOWN = 0,
+    MESSAGE_FORMAT_STATUS_UPDATE = 1,
+    MESSAGE_FORMAT_COMMAND = 2
+} message_format_t;
+
+// status_update
+#define STATUS_UPDATE_DRONE_ID_SIZE 32
+#define STATUS_UPDATE_STATE_SIZE 24
+#define STATUS_UPDATE_BINARY_MAX_SIZE 97
+
+typedef struct {
+    double x;
+    double y;
+    double z;
+} status_update_position_t;
+
+typedef struct {
+    char drone_id[STATUS_UPDATE_DRONE_ID_SIZE];
+    status_update_position_t position;
+    double battery_level;
+    char state[STATUS_UPDATE_STATE_SIZE];
+    int64_t timestamp;
+} status_update_format_t;
+
+// Encode as JSON; returns bytes written (no terminator) or -1 if out is too small
+int status_update_format_encode_json(const status_update_format_t* message, char* out, size_t capacity);
+
+// Decode JSON; 0 on success, -1 if malformed or not a status_update
+int status_update_format_decode_json(status_update_format_t* message, const char* json, size_t length);
+
+// Encode in binary; capacity must be at least STATUS_UPDATE_BINARY_MAX_SIZE
+int status_update_format_encode_binary(const status_update_format_t* message, unsigned char* out, size_t capacity);
+
+// Decode binary; 0 on success, -1 if truncated or of another format
+int status_update_format_decode_binary(status_update_format_t* message, const unsigned char* data, size_t length);
+
+// command
+#define COMMAND_DRONE_ID_SIZE 32
+#define COMMAND_COMMAND_SIZE 32
+#define COMMAND_PARAMS_SIZE 256
+#define COMMAND_BINARY_MAX_SIZE 330
+
+typedef struct {
+    char drone_id[COMMAND_DRONE_ID_SIZE];
+    char command[COMMAND_COMMAND_SIZE];
+    char params[COMMAND_PARAMS_SIZE];
+    int64_t timestamp;
+} command_format_t;
+
+// Encode as JSON; returns bytes written (no terminator) or -1 if out is too small
+int command_format_encode_json(const command_format_t* message, char* out, size_t capacity);
+
+// Decode JSON; 0 on success, -1 if malformed or not a command
+int command_format_decode_json(command_format_t* message, const char* json, size_t length);
+
+// Encode in binary; capacity must be at least COMMAND_BINARY_MAX_SIZE
+int command_format_encode_binary(const command_format_t* message, unsigned char* out, size_t capacity);
+
+// Decode binary; 0 on success, -1 if truncated or of another format
+int command_format_decode_binary(command_format_t* message, const unsigned char* data, size_t length);
+
+// Which format a JSON document holds, from its discriminator member
+message_format_t message_format_detect_json(const char* json, size_t length);
+
+// Which format a binary frame holds, from its tag byte
+message_format_t message_format_detect_binary(const unsigned char* data, size_t length);
+
+#endif
@@ -1,8 +1,23 @@
 // src/protocols/message_protocol.c
 #include "message_protocol.h"
+#include "checksum.h"
+#include "../core/log.h"
+#include <stddef.h>
+#include <stdint.h>
 #include <time.h>
 
-#define MESSAGE_MAGIC_NUMBER 0xDEADBEEF
+static uint16_t next_message_id = 0;
+static pthread_once_t message_id_once = PTHREAD_ONCE_INIT;
+
+static void seed_message_id(void) {
+    next_message_id = (uint16_t)(time(NULL) ^ getpid());
+}
+
+uint64_t message_timestamp_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
 
 void init_message_header(message_header_t* header, message_type_t type, 
                         const char* drone_id) {
@@ -10,23 +25,34 @@ void init_message_header(message_header_t* header, message_type_t type,
     
     header->magic_number = MESSAGE_MAGIC_NUMBER;
     header->message_type = (uint16_t)type;
-    header->message_id = (uint16_t)(time(NULL) & 0xFFFF); // Simple ID generation
+    // Process-wide counter, so messages sent within the same second differ
+    pthread_once(&message_id_once, seed_message_id);
+    header->message_id = __atomic_fetch_add(&next_message_id, 1, __ATOMIC_RELAXED);
     header->payload_length = 0;
     header->checksum = 0;
     strncpy(header->drone_id, drone_id, MAX_DRONE_ID - 1);
     header->drone_id[MAX_DRONE_ID - 1] = '\0';
-    header->timestamp = (uint64_t)time(NULL);
+    header->timestamp = message_timestamp_ns();
 }
 
 uint32_t calculate_checksum(const void* data, size_t length) {
-    const unsigned char* bytes = (const unsigned char*)data;
-    uint32_t checksum = 0;
+    return crc32c(data, length);
+}
+
+uint32_t calculate_message_checksum(const void* message, size_t length) {
+    const unsigned char* bytes = (const unsigned char*)message;
+    const size_t checksum_offset = offsetof(message_header_t, checksum);
+    const uint32_t zero = 0;
     
-    for (size_t i = 0; i < length; i++) {
-        checksum += bytes[i];
-    }
+    if (!message || length < sizeof(message_header_t)) return 0;
     
-    return checksum;
+    // Checksum field counts as zero so the sender can fill it in afterwards
+    uint32_t crc = crc32c_init();
+    crc = crc32c_update(crc, bytes, checksum_offset);
+    crc = crc32c_update(crc, &zero, sizeof(zero));
+    crc = crc32c_update(crc, bytes + checksum_offset + sizeof(zero),
+                        length - checksum_offset - sizeof(zero));
+    return crc32c_final(crc);
 }
 
 int validate_message(const void* message, size_t length) {
@@ -38,14 +64,21 @@ int validate_message(const void* message, size_t length) {
     
     // Check magic number
     if (header->magic_number != MESSAGE_MAGIC_NUMBER) {
-        printf("Invalid magic number\n");
+        LOG_DEBUG("Invalid magic number");
+        return 0;
+    }
+    
+    // Check the declared length against what was actually received
+    if (header->payload_length > length - sizeof(message_header_t)) {
+        LOG_DEBUG("Truncated message");
         return 0;
     }
     
-    // Check checksum
-    uint32_t calculated_checksum = calculate_checksum(message, length);
+    // Check checksum over the message itself, not the whole receive buffer
+    size_t message_size = sizeof(message_header_t) + header->payload_length;
+    uint32_t calculated_checksum = calculate_message_checksum(message, message_size);
     if (calculated_checksum != header->checksum) {
-        printf("Checksum mismatch\n");
+        LOG_DEBUG("Checksum mismatch");
         return 0;
     }
     
@@ -68,7 +101,7 @@ int serialize_message(const void* message, void* buffer, size_t buffer_size) {
     
     // Update checksum
     message_header_t* buf_header = (message_header_t*)buffer;
-    buf_header->checksum = calculate_checksum(buffer, message_size);
+    buf_header->checksum = calculate_message_checksum(buffer, message_size);
     
     return (int)message_size;
 }
@@ -87,4 +120,455 @@ int deserialize_message(const void* buffer, size_t length, void* message) {
     
     memcpy(message, buffer, copy_size);
     return (int)copy_size;
-}
\ No newline at end of file
+}
+
+// Smallest valid message of each type; 0 marks a type with no body layout
+static size_t message_minimum_size(message_type_t type) {
+    switch (type) {
+        case MSG_STATUS_UPDATE:  return sizeof(status_update_message_t);
+        case MSG_COMMAND:        return offsetof(command_message_t, payload);
+        case MSG_BUILDING_PLAN:  return sizeof(building_plan_message_t);
+        case MSG_HEARTBEAT:      return sizeof(heartbeat_message_t);
+        case MSG_ERROR:          return sizeof(message_header_t);
+        case MSG_ACKNOWLEDGMENT: return sizeof(acknowledgment_message_t);
+        case MSG_PLAN_CHUNK:     return offsetof(plan_chunk_message_t, components);
+        case MSG_PLAN_ACK:       return sizeof(plan_ack_message_t);
+        case MSG_CLOCK_SYNC:     return sizeof(clock_sync_message_t);
+        case MSG_SESSION_HELLO:  return sizeof(session_hello_message_t);
+    }
+    return 0;
+}
+
+int message_view_init(message_view_t* view, const void* buffer, size_t length) {
+    if (!view || !buffer) return -1;
+    
+    // Typed pointers into the buffer need the structs' natural alignment
+    if ((uintptr_t)buffer % __alignof__(status_update_message_t) != 0) {
+        LOG_DEBUG("Misaligned message buffer");
+        return -1;
+    }
+    
+    if (!validate_message(buffer, length)) {
+        return -1;
+    }
+    
+    const message_header_t* header = (const message_header_t*)buffer;
+    size_t message_size = sizeof(message_header_t) + header->payload_length;
+    size_t minimum = message_minimum_size((message_type_t)header->message_type);
+    if (minimum == 0 || message_size < minimum) {
+        LOG_DEBUG("Message too short for type %d", (int)header->message_type);
+        return -1;
+    }
+    
+    if (header->message_type == MSG_PLAN_CHUNK) {
+        const plan_chunk_message_t* chunk = (const plan_chunk_message_t*)buffer;
+        if (chunk->component_count > PLAN_COMPONENTS_PER_CHUNK ||
+            minimum + chunk->component_count * sizeof(plan_component_t) > message_size) {
+            LOG_DEBUG("Plan chunk component count exceeds payload");
+            return -1;
+        }
+    }
+    
+    view->type = (message_type_t)header->message_type;
+    view->length = message_size;
+    view->as.header = header;
+    return 0;
+}
+
+void message_dispatcher_init(message_dispatcher_t* dispatcher) {
+    if (dispatcher) {
+        memset(dispatcher, 0, offsetof(message_dispatcher_t, scratch));
+    }
+}
+
+int message_dispatcher_register(message_dispatcher_t* dispatcher, message_type_t type,
+                                message_handler_t handler, void* user_data) {
+    if (!dispatcher || (unsigned)type >= MESSAGE_DISPATCH_MAX_TYPES) return -1;
+    
+    dispatcher->handlers[type] = handler;
+    dispatcher->user_data[type] = user_data;
+    return 0;
+}
+
+void message_dispatcher_set_fallback(message_dispatcher_t* dispatcher,
+                                     message_handler_t handler, void* user_data) {
+    if (dispatcher) {
+        dispatcher->fallback = handler;
+        dispatcher->fallback_data = user_data;
+    }
+}
+
+void message_dispatcher_set_delta_handler(message_dispatcher_t* dispatcher,
+                                          status_delta_handler_t handler, void* user_data) {
+    if (dispatcher) {
+        dispatcher->delta_handler = handler;
+        dispatcher->delta_data = user_data;
+    }
+}
+
+int message_dispatch(message_dispatcher_t* dispatcher, const void* buffer, size_t length) {
+    if (!dispatcher || !buffer) return -1;
+    
+    // Delta frames carry no message header; their decoder reads them
+    // byte-wise, so they need no realignment either
+    if (is_status_delta_frame(buffer, length)) {
+        if (!dispatcher->delta_handler) {
+            dispatcher->unhandled++;
+            return 0;
+        }
+        dispatcher->delta_handler(buffer, length, dispatcher->delta_data);
+        dispatcher->dispatched++;
+        return 1;
+    }
+    
+    // Coalesced records are padded to stay aligned (udp_comm.h); input from
+    // anywhere else is copied once into aligned scratch rather than read
+    // through a bad pointer
+    if ((uintptr_t)buffer % __alignof__(status_update_message_t) != 0) {
+        if (length > sizeof(dispatcher->scratch.bytes)) {
+            dispatcher->rejected++;
+            return -1;
+        }
+        memcpy(dispatcher->scratch.bytes, buffer, length);
+        buffer = dispatcher->scratch.bytes;
+        dispatcher->realigned++;
+    }
+    
+    message_view_t view;
+    if (message_view_init(&view, buffer, length) != 0) {
+        dispatcher->rejected++;
+        return -1;
+    }
+    
+    message_handler_t handler = NULL;
+    void* user_data = NULL;
+    if ((unsigned)view.type < MESSAGE_DISPATCH_MAX_TYPES) {
+        handler = dispatcher->handlers[view.type];
+        user_data = dispatcher->user_data[view.type];
+    }
+    if (!handler) {
+        handler = dispatcher->fallback;
+        user_data = dispatcher->fallback_data;
+    }
+    if (!handler) {
+        dispatcher->unhandled++;
+        return 0;
+    }
+    
+    handler(&view, user_data);
+    dispatcher->dispatched++;
+    return 1;
+}
+
+// Delta-compressed telemetry
+//
+// Keyframes carry a full status_update_message_t. Delta frames carry only the
+// fields whose value differs from the prediction made from the last
+// acknowledged keyframe: positions are dead-reckoned from the keyframe
+// velocity, everything else is held constant. Floating-point fields are sent
+// as float32 residuals against the prediction, integers as int32, and the
+// time since the keyframe as int32 microseconds.
+
+static void write_u16(unsigned char* p, uint16_t value) {
+    memcpy(p, &value, sizeof(value));
+}
+
+static uint16_t read_u16(const unsigned char* p) {
+    uint16_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+size_t write_status_delta_header(void* buffer, const status_delta_header_t* header) {
+    unsigned char* out = (unsigned char*)buffer;
+    out[0] = header->magic;
+    out[1] = header->flags;
+    write_u16(out + 2, header->stream_id);
+    write_u16(out + 4, header->sequence);
+    write_u16(out + 6, header->base_sequence);
+    write_u16(out + 8, header->field_mask);
+    return STATUS_DELTA_HEADER_SIZE;
+}
+
+int read_status_delta_header(const void* buffer, size_t length, status_delta_header_t* header) {
+    if (!header || !is_status_delta_frame(buffer, length)) return -1;
+    
+    const unsigned char* in = (const unsigned char*)buffer;
+    header->magic = in[0];
+    header->flags = in[1];
+    header->stream_id = read_u16(in + 2);
+    header->sequence = read_u16(in + 4);
+    header->base_sequence = read_u16(in + 6);
+    header->field_mask = read_u16(in + 8);
+    return 0;
+}
+
+static void predict_status(const status_update_message_t* reference, uint64_t timestamp,
+                           status_update_message_t* predicted) {
+    double dt = (double)(int64_t)(timestamp - reference->header.timestamp) / 1e9;
+    
+    *predicted = *reference;
+    predicted->header.timestamp = timestamp;
+    predicted->x = reference->x + reference->vx * dt;
+    predicted->y = reference->y + reference->vy * dt;
+    predicted->z = reference->z + reference->vz * dt;
+}
+
+void status_delta_encoder_init(status_delta_encoder_t* encoder, uint16_t stream_id,
+                               uint16_t keyframe_interval) {
+    if (!encoder) return;
+    
+    memset(encoder, 0, sizeof(status_delta_encoder_t));
+    encoder->stream_id = stream_id;
+    encoder->keyframe_interval = keyframe_interval ? keyframe_interval
+                                                   : STATUS_DELTA_KEYFRAME_INTERVAL;
+    encoder->position_epsilon = 0.01;
+    encoder->velocity_epsilon = 0.01;
+    encoder->battery_epsilon = 0.1;
+}
+
+static int encode_status_keyframe(status_delta_encoder_t* encoder,
+                                  const status_update_message_t* status,
+                                  unsigned char* out, size_t buffer_size) {
+    size_t frame_size = STATUS_DELTA_HEADER_SIZE + sizeof(status_update_message_t);
+    if (buffer_size < frame_size) return -1;
+    
+    uint16_t sequence = encoder->next_sequence++;
+    
+    status_delta_header_t header = { STATUS_DELTA_MAGIC, 0, encoder->stream_id,
+                                     sequence, sequence, STATUS_FIELD_KEYFRAME };
+    write_status_delta_header(out, &header);
+    memcpy(out + STATUS_DELTA_HEADER_SIZE, status, sizeof(status_update_message_t));
+    
+    encoder->frames_since_keyframe = 0;
+    if (encoder->auto_acknowledge) {
+        encoder->reference = *status;
+        encoder->reference_sequence = sequence;
+        encoder->has_reference = 1;
+        encoder->has_pending = 0;
+    } else {
+        encoder->pending = *status;
+        encoder->pending_sequence = sequence;
+        encoder->has_pending = 1;
+    }
+    
+    return (int)frame_size;
+}
+
+static unsigned char* put_residual(unsigned char* p, double actual, double predicted) {
+    float residual = (float)(actual - predicted);
+    memcpy(p, &residual, sizeof(residual));
+    return p + sizeof(residual);
+}
+
+int encode_status_delta(status_delta_encoder_t* encoder,
+                        const status_update_message_t* status,
+                        void* buffer, size_t buffer_size) {
+    if (!encoder || !status || !buffer) return -1;
+    
+    unsigned char* out = (unsigned char*)buffer;
+    
+    // Keyframe until the receiver has acknowledged one, then periodically
+    int keyframe_due = encoder->frames_since_keyframe + 1 >= encoder->keyframe_interval;
+    if (!encoder->has_reference || keyframe_due) {
+        return encode_status_keyframe(encoder, status, out, buffer_size);
+    }
+    
+    // Elapsed time travels in STATUS_DELTA_TIME_UNIT_NS steps; predict from
+    // the quantized time so encoder and decoder agree exactly
+    int64_t elapsed_ns = (int64_t)(status->header.timestamp - encoder->reference.header.timestamp);
+    int64_t elapsed_units = (elapsed_ns + (elapsed_ns >= 0 ? 1 : -1) * STATUS_DELTA_TIME_UNIT_NS / 2) /
+                            STATUS_DELTA_TIME_UNIT_NS;
+    if (elapsed_units > INT32_MAX || elapsed_units < INT32_MIN) {
+        return encode_status_keyframe(encoder, status, out, buffer_size);
+    }
+    uint64_t predicted_timestamp = encoder->reference.header.timestamp +
+                                   (uint64_t)(elapsed_units * STATUS_DELTA_TIME_UNIT_NS);
+    
+    // Worst case: header + 7 residuals + 3 int32 fields
+    if (buffer_size < STATUS_DELTA_HEADER_SIZE + 7 * sizeof(float) + 3 * sizeof(int32_t)) {
+        return -1;
+    }
+    
+    status_update_message_t predicted;
+    predict_status(&encoder->reference, predicted_timestamp, &predicted);
+    
+    const double actual[7] = { status->x, status->y, status->z,
+                               status->vx, status->vy, status->vz,
+                               status->battery_level };
+    const double expected[7] = { predicted.x, predicted.y, predicted.z,
+                                 predicted.vx, predicted.vy, predicted.vz,
+                                 predicted.battery_level };
+    const double epsilon[7] = { encoder->position_epsilon, encoder->position_epsilon,
+                                encoder->position_epsilon, encoder->velocity_epsilon,
+                                encoder->velocity_epsilon, encoder->velocity_epsilon,
+                                encoder->battery_epsilon };
+    
+    uint16_t field_mask = 0;
+    unsigned char* p = out + STATUS_DELTA_HEADER_SIZE;
+    
+    if (elapsed_units != 0) {
+        int32_t elapsed = (int32_t)elapsed_units;
+        memcpy(p, &elapsed, sizeof(elapsed));
+        p += sizeof(elapsed);
+        field_mask |= STATUS_FIELD_TIMESTAMP;
+    }
+    
+    for (int i = 0; i < 7; i++) {
+        double error = actual[i] - expected[i];
+        if (error > epsilon[i] || error < -epsilon[i]) {
+            p = put_residual(p, actual[i], expected[i]);
+            field_mask |= (uint16_t)(STATUS_FIELD_X << i);
+        }
+    }
+    
+    if (status->state != predicted.state) {
+        int32_t value = status->state;
+        memcpy(p, &value, sizeof(value));
+        p += sizeof(value);
+        field_mask |= STATUS_FIELD_STATE;
+    }
+    
+    if (status->construction_progress != predicted.construction_progress) {
+        int32_t value = status->construction_progress;
+        memcpy(p, &value, sizeof(value));
+        p += sizeof(value);
+        field_mask |= STATUS_FIELD_PROGRESS;
+    }
+    
+    status_delta_header_t header = { STATUS_DELTA_MAGIC, 0, encoder->stream_id,
+                                     encoder->next_sequence++, encoder->reference_sequence,
+                                     field_mask };
+    write_status_delta_header(out, &header);
+    
+    encoder->frames_since_keyframe++;
+    return (int)(p - out);
+}
+
+void status_delta_acknowledge(status_delta_encoder_t* encoder, uint16_t keyframe_sequence) {
+    if (!encoder || !encoder->has_pending) return;
+    
+    // Only the most recent keyframe can become the new reference
+    if (keyframe_sequence == encoder->pending_sequence) {
+        encoder->reference = encoder->pending;
+        encoder->reference_sequence = encoder->pending_sequence;
+        encoder->has_reference = 1;
+        encoder->has_pending = 0;
+    }
+}
+
+void status_delta_force_keyframe(status_delta_encoder_t* encoder) {
+    if (!encoder) return;
+    
+    encoder->frames_since_keyframe = encoder->keyframe_interval;
+}
+
+void status_delta_decoder_init(status_delta_decoder_t* decoder) {
+    if (decoder) {
+        memset(decoder, 0, sizeof(status_delta_decoder_t));
+    }
+}
+
+int is_status_delta_frame(const void* buffer, size_t length) {
+    return buffer && length >= STATUS_DELTA_HEADER_SIZE &&
+           ((const unsigned char*)buffer)[0] == STATUS_DELTA_MAGIC;
+}
+
+static const status_update_message_t* find_keyframe(const status_delta_decoder_t* decoder,
+                                                    uint16_t sequence) {
+    for (int i = 0; i < STATUS_DELTA_KEYFRAME_HISTORY; i++) {
+        if (decoder->valid[i] && decoder->sequence[i] == sequence) {
+            return &decoder->keyframes[i];
+        }
+    }
+    return NULL;
+}
+
+int decode_status_delta(status_delta_decoder_t* decoder, const void* buffer,
+                        size_t length, status_update_message_t* status) {
+    status_delta_header_t header;
+    if (!decoder || !status || read_status_delta_header(buffer, length, &header) != 0) return -1;
+    
+    // Keyframes of another stream would poison this one's history
+    if (decoder->bound && header.stream_id != decoder->stream_id) return -1;
+    
+    const unsigned char* in = (const unsigned char*)buffer;
+    const unsigned char* end = in + length;
+    uint16_t sequence = header.sequence;
+    uint16_t base_sequence = header.base_sequence;
+    uint16_t field_mask = header.field_mask;
+    const unsigned char* p = in + STATUS_DELTA_HEADER_SIZE;
+    
+    if (field_mask & STATUS_FIELD_KEYFRAME) {
+        if ((size_t)(end - p) < sizeof(status_update_message_t)) return -1;
+        
+        memcpy(status, p, sizeof(status_update_message_t));
+        decoder->bound = 1;
+        decoder->stream_id = header.stream_id;
+        status->header.message_id = sequence;
+        
+        // Replace an existing copy of this keyframe, otherwise the oldest slot
+        int slot = -1;
+        for (int i = 0; i < STATUS_DELTA_KEYFRAME_HISTORY; i++) {
+            if (decoder->valid[i] && decoder->sequence[i] == sequence) {
+                slot = i;
+            }
+        }
+        if (slot < 0) {
+            slot = decoder->next_slot;
+            decoder->next_slot = (uint16_t)((decoder->next_slot + 1) % STATUS_DELTA_KEYFRAME_HISTORY);
+        }
+        decoder->keyframes[slot] = *status;
+        decoder->sequence[slot] = sequence;
+        decoder->valid[slot] = 1;
+        return 1;
+    }
+    
+    const status_update_message_t* reference = find_keyframe(decoder, base_sequence);
+    if (!reference) {
+        return -1; // Base keyframe lost or evicted, sender must resend one
+    }
+    
+    uint64_t timestamp = reference->header.timestamp;
+    if (field_mask & STATUS_FIELD_TIMESTAMP) {
+        int32_t elapsed;
+        if ((size_t)(end - p) < sizeof(elapsed)) return -1;
+        memcpy(&elapsed, p, sizeof(elapsed));
+        p += sizeof(elapsed);
+        timestamp += (uint64_t)((int64_t)elapsed * STATUS_DELTA_TIME_UNIT_NS);
+    }
+    
+    predict_status(reference, timestamp, status);
+    
+    double* fields[7] = { &status->x, &status->y, &status->z,
+                          &status->vx, &status->vy, &status->vz,
+                          &status->battery_level };
+    for (int i = 0; i < 7; i++) {
+        if (field_mask & (STATUS_FIELD_X << i)) {
+            float residual;
+            if ((size_t)(end - p) < sizeof(residual)) return -1;
+            memcpy(&residual, p, sizeof(residual));
+            p += sizeof(residual);
+            *fields[i] += (double)residual;
+        }
+    }
+    
+    if (field_mask & STATUS_FIELD_STATE) {
+        int32_t value;
+        if ((size_t)(end - p) < sizeof(value)) return -1;
+        memcpy(&value, p, sizeof(value));
+        p += sizeof(value);
+        status->state = value;
+    }
+    
+    if (field_mask & STATUS_FIELD_PROGRESS) {
+        int32_t value;
+        if ((size_t)(end - p) < sizeof(value)) return -1;
+        memcpy(&value, p, sizeof(value));
+        p += sizeof(value);
+        status->construction_progress = value;
+    }
+    
+    status->header.message_id = sequence;
+    return 0;
+}
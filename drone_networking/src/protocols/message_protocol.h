@@ -4,6 +4,8 @@
 
 #include "common.h"
 
+#define MESSAGE_MAGIC_NUMBER 0xDEADBEEF
+
 // Message header structure
 typedef struct {
     uint32_t magic_number;      // Magic number for validation
@@ -12,7 +14,7 @@ typedef struct {
     uint32_t payload_length;    // Length of payload data
     uint32_t checksum;          // Message checksum
     char drone_id[MAX_DRONE_ID]; // Source drone ID
-    uint64_t timestamp;         // Message timestamp
+    uint64_t timestamp;         // Send time, ns since the epoch (CLOCK_REALTIME)
 } message_header_t;
 
 // Status update message
@@ -25,12 +27,20 @@ typedef struct {
     int construction_progress;  // Construction progress percentage
 } status_update_message_t;
 
+// command_message_t.priority levels. Emergency commands (landing, abort)
+// jump every outbound queue (priority_queue.h).
+#define COMMAND_PRIORITY_NORMAL 0
+#define COMMAND_PRIORITY_EMERGENCY 100      // This and above
+
 // Command message
 typedef struct {
     message_header_t header;
     int command_type;           // Type of command
     double target_x, target_y, target_z; // Target coordinates
-    int priority;               // Command priority
+    int priority;               // COMMAND_PRIORITY_*
+    uint32_t sender_epoch;      // Reliable delivery: sender's per-run nonce
+    uint16_t window_base;       // Reliable delivery: oldest unacknowledged sequence
+    uint16_t reserved;
     char payload[1024];         // Additional command data
 } command_message_t;
 
@@ -41,16 +51,213 @@ typedef struct {
     int completed_components;   // Completed components
     int building_type;          // Type of building
     char building_name[64];     // Building name
-    // Components would be stored separately
+    // Components are streamed as MSG_PLAN_CHUNK messages (plan_stream.h)
 } building_plan_message_t;
 
+// Building plan streaming. A full chunk (144-byte header plus 11 112-byte
+// components) fits one 1400-byte datagram, so chunks never fragment.
+#define PLAN_COMPONENTS_PER_CHUNK 11
+
+// Wire format of one building component
+typedef struct {
+    char component_id[32];
+    double x, y, z;             // Position
+    double pitch, yaw, roll;    // Orientation
+    char material_type[32];
+} plan_component_t;
+
+// One fragment of a building plan (MSG_PLAN_CHUNK). Only component_count
+// entries of components are sent; payload_length is trimmed to match.
+typedef struct {
+    message_header_t header;
+    uint32_t plan_id;           // Transfer identifier
+    uint32_t chunk_index;       // Position of this chunk in the plan
+    uint32_t total_chunks;
+    uint32_t total_components;
+    uint16_t component_count;   // Components in this chunk
+    uint16_t reserved;
+    int32_t building_type;
+    char building_name[64];
+    plan_component_t components[PLAN_COMPONENTS_PER_CHUNK];
+} plan_chunk_message_t;
+
+// Receiver progress report (MSG_PLAN_ACK)
+typedef struct {
+    message_header_t header;
+    uint32_t plan_id;
+    uint32_t contiguous_chunks; // Every chunk below this index has arrived
+    uint64_t chunk_bitmap;      // Bit i set: chunk contiguous_chunks + 1 + i arrived
+} plan_ack_message_t;
+
+// Liveness beacon (MSG_HEARTBEAT)
+typedef struct {
+    message_header_t header;
+    uint32_t sequence;          // Increments per heartbeat; gaps reveal loss
+    uint32_t interval_ms;       // Sender's heartbeat period
+    int32_t state;              // drone_state_t of the sender
+    float battery_level;
+} heartbeat_message_t;
+
+// NTP-style clock probe (MSG_CLOCK_SYNC). The requester fills
+// origin_ns; the responder echoes it with its receive and transmit times.
+typedef struct {
+    message_header_t header;
+    uint32_t is_response;
+    uint32_t probe_id;
+    uint64_t origin_ns;         // t1: request sent (requester clock)
+    uint64_t receive_ns;        // t2: request received (responder clock)
+    uint64_t transmit_ns;       // t3: response sent (responder clock)
+} clock_sync_message_t;
+
+// Session handshake (MSG_SESSION_HELLO). Each side contributes a fresh
+// random value; the tag proves knowledge of the fleet key (session.h).
+#define SESSION_RANDOM_SIZE 32
+#define SESSION_HELLO_TAG_SIZE 16
+
+typedef struct {
+    message_header_t header;
+    uint32_t is_response;
+    uint32_t session_id;        // Chosen by the initiator, echoed in the response
+    unsigned char random[SESSION_RANDOM_SIZE];
+    unsigned char tag[SESSION_HELLO_TAG_SIZE];
+} session_hello_message_t;
+
+// Acknowledgment message (selective ACK for reliable commands)
+typedef struct {
+    message_header_t header;
+    uint16_t cumulative_ack;    // Next sequence expected in order
+    uint16_t group_tag;         // Non-zero: acknowledges a group's sequence space
+    uint32_t sender_epoch;      // Echoes the acknowledged commands' sender_epoch
+    uint64_t sack_bitmap;       // Bit i set: cumulative_ack + 1 + i was received
+} acknowledgment_message_t;
+
+// Zero-copy receive path
+//
+// A message view is a validated, read-only window onto a message that is
+// still in the receive buffer. Magic, length, checksum, per-type minimum
+// size and alignment are checked once in message_view_init; handlers then
+// read the typed pointer directly. Views are only valid while the buffer is.
+#define MESSAGE_DISPATCH_MAX_TYPES 16
+
+typedef struct {
+    message_type_t type;
+    size_t length;                  // Header plus declared payload
+    union {
+        const message_header_t* header;
+        const status_update_message_t* status;
+        const command_message_t* command;   // payload holds length - offsetof(payload) bytes
+        const building_plan_message_t* building_plan;
+        const plan_chunk_message_t* plan_chunk;
+        const plan_ack_message_t* plan_ack;
+        const heartbeat_message_t* heartbeat;
+        const clock_sync_message_t* clock_sync;
+        const session_hello_message_t* session_hello;
+        const acknowledgment_message_t* acknowledgment;
+    } as;
+} message_view_t;
+
+typedef void (*message_handler_t)(const message_view_t* view, void* user_data);
+
+// Receives delta telemetry frames (is_status_delta_frame) as they arrived,
+// possibly unaligned; decode them with the stream's status_delta_decoder_t
+typedef void (*status_delta_handler_t)(const void* frame, size_t length, void* user_data);
+
+// Handler table keyed by message_type_t
+typedef struct {
+    message_handler_t handlers[MESSAGE_DISPATCH_MAX_TYPES];
+    void* user_data[MESSAGE_DISPATCH_MAX_TYPES];
+    message_handler_t fallback;     // Types without a handler, may be NULL
+    void* fallback_data;
+    status_delta_handler_t delta_handler;   // Delta telemetry frames, may be NULL
+    void* delta_data;
+    unsigned long dispatched;
+    unsigned long unhandled;
+    unsigned long rejected;         // Failed validation
+    unsigned long realigned;        // Misaligned input copied to scratch
+    union {
+        uint64_t align;
+        unsigned char bytes[MAX_BUFFER_SIZE];
+    } scratch;
+} message_dispatcher_t;
+
+// Delta-compressed telemetry
+#define STATUS_DELTA_MAGIC 0xD7
+#define STATUS_DELTA_KEYFRAME_INTERVAL 32
+#define STATUS_DELTA_KEYFRAME_HISTORY 4
+// Delta frames carry the time since their keyframe in these units, so a
+// decoded delta's header.timestamp is within STATUS_DELTA_TIME_UNIT_NS / 2
+// of the sender's (keyframes carry it exactly)
+#define STATUS_DELTA_TIME_UNIT_NS 1000
+
+// Field mask bits for delta frames
+#define STATUS_FIELD_X          (1u << 0)
+#define STATUS_FIELD_Y          (1u << 1)
+#define STATUS_FIELD_Z          (1u << 2)
+#define STATUS_FIELD_VX         (1u << 3)
+#define STATUS_FIELD_VY         (1u << 4)
+#define STATUS_FIELD_VZ         (1u << 5)
+#define STATUS_FIELD_BATTERY    (1u << 6)
+#define STATUS_FIELD_STATE      (1u << 7)
+#define STATUS_FIELD_PROGRESS   (1u << 8)
+#define STATUS_FIELD_TIMESTAMP  (1u << 9)
+#define STATUS_FIELD_KEYFRAME   (1u << 15)
+
+// Compact frame header used instead of message_header_t for delta frames.
+// Serialized field by field (10 bytes on the wire, no padding) by
+// write_status_delta_header / read_status_delta_header.
+typedef struct {
+    uint8_t magic;              // STATUS_DELTA_MAGIC
+    uint8_t flags;              // Reserved
+    uint16_t stream_id;         // Sender-assigned stream (e.g. drone slot)
+    uint16_t sequence;          // Frame sequence number
+    uint16_t base_sequence;     // Keyframe this delta is relative to
+    uint16_t field_mask;        // STATUS_FIELD_* bits present in the frame
+} status_delta_header_t;
+
+#define STATUS_DELTA_HEADER_SIZE 10
+
+// Sender side of a delta telemetry stream
+typedef struct {
+    uint16_t stream_id;
+    uint16_t next_sequence;
+    uint16_t keyframe_interval;     // Frames between keyframes
+    uint16_t frames_since_keyframe;
+    int auto_acknowledge;           // Treat keyframes as acknowledged on send
+    int has_reference;
+    uint16_t reference_sequence;    // Last acknowledged keyframe
+    status_update_message_t reference;
+    int has_pending;
+    uint16_t pending_sequence;      // Keyframe sent but not yet acknowledged
+    status_update_message_t pending;
+    double position_epsilon;        // Tolerated reconstruction error (m)
+    double velocity_epsilon;        // Tolerated reconstruction error (m/s)
+    double battery_epsilon;         // Tolerated reconstruction error (%)
+} status_delta_encoder_t;
+
+// Receiver side of one delta telemetry stream. The decoder binds to the
+// stream_id of the first keyframe it accepts and rejects other streams.
+typedef struct {
+    int bound;
+    uint16_t stream_id;
+    int valid[STATUS_DELTA_KEYFRAME_HISTORY];
+    uint16_t sequence[STATUS_DELTA_KEYFRAME_HISTORY];
+    status_update_message_t keyframes[STATUS_DELTA_KEYFRAME_HISTORY];
+    uint16_t next_slot;
+} status_delta_decoder_t;
+
+// Current wall-clock time in ns, as stamped into message headers
+uint64_t message_timestamp_ns(void);
+
 // Initialize message header
 void init_message_header(message_header_t* header, message_type_t type, 
                         const char* drone_id);
 
-// Calculate message checksum
+// Calculate CRC32C checksum of a buffer
 uint32_t calculate_checksum(const void* data, size_t length);
 
+// Calculate the checksum of a serialized message (checksum field taken as zero)
+uint32_t calculate_message_checksum(const void* message, size_t length);
+
 // Validate message integrity
 int validate_message(const void* message, size_t length);
 
@@ -60,4 +267,62 @@ int serialize_message(const void* message, void* buffer, size_t buffer_size);
 // Deserialize message from buffer
 int deserialize_message(const void* buffer, size_t length, void* message);
 
+// Validate a received message and point a typed view at it, 0 or -1.
+// The buffer must be 8-byte aligned (see message_dispatch for other input).
+int message_view_init(message_view_t* view, const void* buffer, size_t length);
+
+// Initialize a dispatcher with no handlers
+void message_dispatcher_init(message_dispatcher_t* dispatcher);
+
+// Register the handler for one message type, replacing any previous one
+int message_dispatcher_register(message_dispatcher_t* dispatcher, message_type_t type,
+                                message_handler_t handler, void* user_data);
+
+// Handler for types without their own
+void message_dispatcher_set_fallback(message_dispatcher_t* dispatcher,
+                                     message_handler_t handler, void* user_data);
+
+// Handler for delta telemetry frames
+void message_dispatcher_set_delta_handler(message_dispatcher_t* dispatcher,
+                                          status_delta_handler_t handler, void* user_data);
+
+// Validate and hand a message (or delta telemetry frame) to its handler.
+// Returns 1 if handled, 0 if no handler was registered, -1 if the message
+// was rejected
+int message_dispatch(message_dispatcher_t* dispatcher, const void* buffer, size_t length);
+
+// Initialize delta encoder (keyframe_interval 0 selects the default)
+void status_delta_encoder_init(status_delta_encoder_t* encoder, uint16_t stream_id,
+                               uint16_t keyframe_interval);
+
+// Encode a status update as a keyframe or delta frame, returns bytes written or -1
+int encode_status_delta(status_delta_encoder_t* encoder,
+                        const status_update_message_t* status,
+                        void* buffer, size_t buffer_size);
+
+// Record receiver acknowledgment of a keyframe
+void status_delta_acknowledge(status_delta_encoder_t* encoder, uint16_t keyframe_sequence);
+
+// Make the next encoded frame a keyframe (e.g. after a receiver reported loss)
+void status_delta_force_keyframe(status_delta_encoder_t* encoder);
+
+// Initialize delta decoder
+void status_delta_decoder_init(status_delta_decoder_t* decoder);
+
+// Decode a delta frame. Returns 1 for a keyframe (acknowledge
+// status->header.message_id), 0 for a delta frame, -1 on error, unknown
+// base keyframe or a frame of another stream. Fields come back within the
+// encoder's epsilons and the timestamp within STATUS_DELTA_TIME_UNIT_NS / 2.
+int decode_status_delta(status_delta_decoder_t* decoder, const void* buffer,
+                        size_t length, status_update_message_t* status);
+
+// Check whether a received datagram is a delta frame
+int is_status_delta_frame(const void* buffer, size_t length);
+
+// Write a delta frame header, returns STATUS_DELTA_HEADER_SIZE
+size_t write_status_delta_header(void* buffer, const status_delta_header_t* header);
+
+// Read a delta frame header (e.g. to pick the stream's decoder), 0 or -1
+int read_status_delta_header(const void* buffer, size_t length, status_delta_header_t* header);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,460 @@
+// src/security/aead.c
+#include "aead.h"
+#include <string.h>
+
+static uint32_t load32_le(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void store32_le(unsigned char* p, uint32_t value) {
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+static void store64_le(unsigned char* p, uint64_t value) {
+    store32_le(p, (uint32_t)value);
+    store32_le(p + 4, (uint32_t)(value >> 32));
+}
+
+// ChaCha20
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define QUARTER_ROUND(a, b, c, d) \
+    a += b; d ^= a; d = ROTL32(d, 16); \
+    c += d; b ^= c; b = ROTL32(b, 12); \
+    a += b; d ^= a; d = ROTL32(d, 8);  \
+    c += d; b ^= c; b = ROTL32(b, 7)
+
+void aead_key_init(aead_key_t* schedule, const unsigned char key[AEAD_KEY_SIZE]) {
+    schedule->words[0] = 0x61707865;
+    schedule->words[1] = 0x3320646e;
+    schedule->words[2] = 0x79622d32;
+    schedule->words[3] = 0x6b206574;
+    for (int i = 0; i < 8; i++) {
+        schedule->words[4 + i] = load32_le(key + 4 * i);
+    }
+}
+
+void aead_key_wipe(aead_key_t* schedule) {
+    volatile uint32_t* words = schedule->words;
+    for (int i = 0; i < 12; i++) {
+        words[i] = 0;
+    }
+}
+
+static void chacha20_rounds(uint32_t x[16]) {
+    for (int round = 0; round < 10; round++) {
+        QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+}
+
+void chacha20_block(const aead_key_t* key, uint32_t counter,
+                    const unsigned char nonce[AEAD_NONCE_SIZE], unsigned char out[64]) {
+    uint32_t input[16];
+    memcpy(input, key->words, sizeof(key->words));
+    input[12] = counter;
+    input[13] = load32_le(nonce);
+    input[14] = load32_le(nonce + 4);
+    input[15] = load32_le(nonce + 8);
+    
+    uint32_t x[16];
+    memcpy(x, input, sizeof(x));
+    chacha20_rounds(x);
+    
+    for (int i = 0; i < 16; i++) {
+        store32_le(out + 4 * i, x[i] + input[i]);
+    }
+}
+
+// Output words 0-3 and 12-15 of the permutation, without the final addition
+void hchacha20(const unsigned char key[AEAD_KEY_SIZE], const unsigned char input[16],
+               unsigned char out[AEAD_KEY_SIZE]) {
+    aead_key_t schedule;
+    aead_key_init(&schedule, key);
+    
+    uint32_t x[16];
+    memcpy(x, schedule.words, sizeof(schedule.words));
+    for (int i = 0; i < 4; i++) {
+        x[12 + i] = load32_le(input + 4 * i);
+    }
+    chacha20_rounds(x);
+    
+    for (int i = 0; i < 4; i++) {
+        store32_le(out + 4 * i, x[i]);
+        store32_le(out + 16 + 4 * i, x[12 + i]);
+    }
+    aead_key_wipe(&schedule);
+    memset(x, 0, sizeof(x));
+}
+
+// Lane-major state so each round step is one operation across all lanes
+#define QUARTER_ROUND_LANES(x, a, b, c, d) \
+    for (int l = 0; l < AEAD_BATCH_LANES; l++) { \
+        x[a][l] += x[b][l]; x[d][l] ^= x[a][l]; x[d][l] = ROTL32(x[d][l], 16); \
+        x[c][l] += x[d][l]; x[b][l] ^= x[c][l]; x[b][l] = ROTL32(x[b][l], 12); \
+        x[a][l] += x[b][l]; x[d][l] ^= x[a][l]; x[d][l] = ROTL32(x[d][l], 8);  \
+        x[c][l] += x[d][l]; x[b][l] ^= x[c][l]; x[b][l] = ROTL32(x[b][l], 7);  \
+    }
+
+void chacha20_block_lanes(const aead_key_t* key,
+                          const uint32_t counters[AEAD_BATCH_LANES],
+                          const unsigned char* const nonces[AEAD_BATCH_LANES],
+                          unsigned char out[AEAD_BATCH_LANES][64]) {
+    uint32_t input[16][AEAD_BATCH_LANES];
+    for (int l = 0; l < AEAD_BATCH_LANES; l++) {
+        for (int i = 0; i < 12; i++) {
+            input[i][l] = key->words[i];
+        }
+        input[12][l] = counters[l];
+        input[13][l] = load32_le(nonces[l]);
+        input[14][l] = load32_le(nonces[l] + 4);
+        input[15][l] = load32_le(nonces[l] + 8);
+    }
+    
+    uint32_t x[16][AEAD_BATCH_LANES];
+    memcpy(x, input, sizeof(x));
+    for (int round = 0; round < 10; round++) {
+        QUARTER_ROUND_LANES(x, 0, 4, 8, 12);
+        QUARTER_ROUND_LANES(x, 1, 5, 9, 13);
+        QUARTER_ROUND_LANES(x, 2, 6, 10, 14);
+        QUARTER_ROUND_LANES(x, 3, 7, 11, 15);
+        QUARTER_ROUND_LANES(x, 0, 5, 10, 15);
+        QUARTER_ROUND_LANES(x, 1, 6, 11, 12);
+        QUARTER_ROUND_LANES(x, 2, 7, 8, 13);
+        QUARTER_ROUND_LANES(x, 3, 4, 9, 14);
+    }
+    
+    for (int l = 0; l < AEAD_BATCH_LANES; l++) {
+        for (int i = 0; i < 16; i++) {
+            store32_le(out[l] + 4 * i, x[i][l] + input[i][l]);
+        }
+    }
+}
+
+// Poly1305, 26-bit limbs
+
+static void poly1305_blocks(poly1305_state_t* state, const unsigned char* m, size_t bytes,
+                            uint32_t hibit) {
+    const uint32_t r0 = state->r[0], r1 = state->r[1], r2 = state->r[2];
+    const uint32_t r3 = state->r[3], r4 = state->r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+    uint32_t h0 = state->h[0], h1 = state->h[1], h2 = state->h[2];
+    uint32_t h3 = state->h[3], h4 = state->h[4];
+    
+    while (bytes >= 16) {
+        h0 += load32_le(m) & 0x3ffffff;
+        h1 += (load32_le(m + 3) >> 2) & 0x3ffffff;
+        h2 += (load32_le(m + 6) >> 4) & 0x3ffffff;
+        h3 += (load32_le(m + 9) >> 6) & 0x3ffffff;
+        h4 += (load32_le(m + 12) >> 8) | hibit;
+        
+        uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 +
+                      (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+        uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 +
+                      (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+        uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 +
+                      (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+        uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 +
+                      (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+        uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 +
+                      (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+        
+        uint32_t c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & 0x3ffffff;
+        d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & 0x3ffffff;
+        d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & 0x3ffffff;
+        d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & 0x3ffffff;
+        d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & 0x3ffffff;
+        h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+        h1 += c;
+        
+        m += 16;
+        bytes -= 16;
+    }
+    
+    state->h[0] = h0; state->h[1] = h1; state->h[2] = h2;
+    state->h[3] = h3; state->h[4] = h4;
+}
+
+void poly1305_init(poly1305_state_t* state, const unsigned char key[32]) {
+    state->r[0] = load32_le(key) & 0x3ffffff;
+    state->r[1] = (load32_le(key + 3) >> 2) & 0x3ffff03;
+    state->r[2] = (load32_le(key + 6) >> 4) & 0x3ffc0ff;
+    state->r[3] = (load32_le(key + 9) >> 6) & 0x3f03fff;
+    state->r[4] = (load32_le(key + 12) >> 8) & 0x00fffff;
+    memset(state->h, 0, sizeof(state->h));
+    for (int i = 0; i < 4; i++) {
+        state->pad[i] = load32_le(key + 16 + 4 * i);
+    }
+    state->leftover = 0;
+}
+
+void poly1305_update(poly1305_state_t* state, const unsigned char* data, size_t length) {
+    if (state->leftover) {
+        size_t want = 16 - state->leftover;
+        if (want > length) want = length;
+        memcpy(state->buffer + state->leftover, data, want);
+        state->leftover += want;
+        data += want;
+        length -= want;
+        if (state->leftover < 16) return;
+        poly1305_blocks(state, state->buffer, 16, 1u << 24);
+        state->leftover = 0;
+    }
+    
+    size_t whole = length & ~(size_t)15;
+    if (whole) {
+        poly1305_blocks(state, data, whole, 1u << 24);
+        data += whole;
+        length -= whole;
+    }
+    
+    if (length) {
+        memcpy(state->buffer, data, length);
+        state->leftover = length;
+    }
+}
+
+void poly1305_finish(poly1305_state_t* state, unsigned char tag[16]) {
+    if (state->leftover) {
+        size_t i = state->leftover;
+        state->buffer[i++] = 1;
+        memset(state->buffer + i, 0, 16 - i);
+        poly1305_blocks(state, state->buffer, 16, 0);
+    }
+    
+    uint32_t h0 = state->h[0], h1 = state->h[1], h2 = state->h[2];
+    uint32_t h3 = state->h[3], h4 = state->h[4];
+    uint32_t c;
+    
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+    
+    // Compute h - p and keep it if non-negative, in constant time
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    uint32_t g4 = h4 + c - (1u << 26);
+    
+    uint32_t mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+    
+    h0 = h0 | (h1 << 26);
+    h1 = (h1 >> 6) | (h2 << 20);
+    h2 = (h2 >> 12) | (h3 << 14);
+    h3 = (h3 >> 18) | (h4 << 8);
+    
+    uint64_t f;
+    f = (uint64_t)h0 + state->pad[0];             h0 = (uint32_t)f;
+    f = (uint64_t)h1 + state->pad[1] + (f >> 32); h1 = (uint32_t)f;
+    f = (uint64_t)h2 + state->pad[2] + (f >> 32); h2 = (uint32_t)f;
+    f = (uint64_t)h3 + state->pad[3] + (f >> 32); h3 = (uint32_t)f;
+    
+    store32_le(tag, h0);
+    store32_le(tag + 4, h1);
+    store32_le(tag + 8, h2);
+    store32_le(tag + 12, h3);
+    
+    memset(state, 0, sizeof(*state));
+}
+
+// AEAD construction
+
+static const unsigned char zero_padding[16];
+
+static void mac_pad(poly1305_state_t* poly, size_t length) {
+    if (length % 16) {
+        poly1305_update(poly, zero_padding, 16 - length % 16);
+    }
+}
+
+static void mac_lengths(poly1305_state_t* poly, size_t aad_length, size_t length) {
+    unsigned char lengths[16];
+    store64_le(lengths, (uint64_t)aad_length);
+    store64_le(lengths + 8, (uint64_t)length);
+    poly1305_update(poly, lengths, sizeof(lengths));
+}
+
+// Block 0 of the keystream keys Poly1305; the message starts at block 1
+static void aead_begin(poly1305_state_t* poly, const aead_key_t* key,
+                       const unsigned char* nonce, const void* aad, size_t aad_length) {
+    unsigned char block[64];
+    chacha20_block(key, 0, nonce, block);
+    poly1305_init(poly, block);
+    memset(block, 0, sizeof(block));
+    
+    if (aad_length) {
+        poly1305_update(poly, (const unsigned char*)aad, aad_length);
+        mac_pad(poly, aad_length);
+    }
+}
+
+void aead_seal(const aead_key_t* key, const unsigned char nonce[AEAD_NONCE_SIZE],
+               const void* aad, size_t aad_length,
+               const void* source, void* destination, size_t length,
+               unsigned char tag[AEAD_TAG_SIZE]) {
+    poly1305_state_t poly;
+    aead_begin(&poly, key, nonce, aad, aad_length);
+    
+    const unsigned char* in = (const unsigned char*)source;
+    unsigned char* out = (unsigned char*)destination;
+    unsigned char keystream[64];
+    uint32_t counter = 1;
+    
+    for (size_t offset = 0; offset < length; offset += 64) {
+        size_t block = length - offset < 64 ? length - offset : 64;
+        chacha20_block(key, counter++, nonce, keystream);
+        for (size_t i = 0; i < block; i++) {
+            out[offset + i] = in[offset + i] ^ keystream[i];
+        }
+        poly1305_update(&poly, out + offset, block);
+    }
+    
+    mac_pad(&poly, length);
+    mac_lengths(&poly, aad_length, length);
+    poly1305_finish(&poly, tag);
+    memset(keystream, 0, sizeof(keystream));
+}
+
+void aead_seal_in_place(const aead_key_t* key,
+                        const unsigned char nonce[AEAD_NONCE_SIZE],
+                        const void* aad, size_t aad_length,
+                        void* data, size_t length, unsigned char tag[AEAD_TAG_SIZE]) {
+    aead_seal(key, nonce, aad, aad_length, data, data, length, tag);
+}
+
+typedef struct {
+    aead_batch_item_t* item;
+    size_t offset;
+    uint32_t counter;       // 0 while the lane still needs its Poly1305 key
+    poly1305_state_t poly;
+} batch_lane_t;
+
+static void batch_lane_finish(batch_lane_t* lane) {
+    mac_pad(&lane->poly, lane->item->length);
+    mac_lengths(&lane->poly, lane->item->aad_length, lane->item->length);
+    poly1305_finish(&lane->poly, lane->item->tag);
+    lane->item = NULL;
+}
+
+void aead_seal_batch(const aead_key_t* key, aead_batch_item_t* items, size_t count) {
+    if (!items || count == 0) return;
+    
+    batch_lane_t lanes[AEAD_BATCH_LANES];
+    memset(lanes, 0, sizeof(lanes));
+    unsigned char keystream[AEAD_BATCH_LANES][64];
+    uint32_t counters[AEAD_BATCH_LANES];
+    const unsigned char* nonces[AEAD_BATCH_LANES];
+    size_t next = 0;
+    
+    for (;;) {
+        int active = 0;
+        for (int l = 0; l < AEAD_BATCH_LANES; l++) {
+            if (!lanes[l].item && next < count) {
+                lanes[l].item = &items[next++];
+                lanes[l].offset = 0;
+                lanes[l].counter = 0;
+            }
+            if (lanes[l].item) active++;
+        }
+        if (active == 0) break;
+        
+        // Idle lanes borrow an active lane's inputs; their output is ignored
+        const batch_lane_t* filler = NULL;
+        for (int l = 0; l < AEAD_BATCH_LANES && !filler; l++) {
+            if (lanes[l].item) filler = &lanes[l];
+        }
+        for (int l = 0; l < AEAD_BATCH_LANES; l++) {
+            const batch_lane_t* source = lanes[l].item ? &lanes[l] : filler;
+            counters[l] = source->counter;
+            nonces[l] = source->item->nonce;
+        }
+        chacha20_block_lanes(key, counters, nonces, keystream);
+        
+        for (int l = 0; l < AEAD_BATCH_LANES; l++) {
+            batch_lane_t* lane = &lanes[l];
+            aead_batch_item_t* item = lane->item;
+            if (!item) continue;
+            
+            if (lane->counter == 0) {
+                poly1305_init(&lane->poly, keystream[l]);
+                if (item->aad_length) {
+                    poly1305_update(&lane->poly, (const unsigned char*)item->aad, item->aad_length);
+                    mac_pad(&lane->poly, item->aad_length);
+                }
+                lane->counter = 1;
+                if (item->length == 0) batch_lane_finish(lane);
+                continue;
+            }
+            
+            unsigned char* bytes = (unsigned char*)item->data + lane->offset;
+            size_t block = item->length - lane->offset < 64 ? item->length - lane->offset : 64;
+            for (size_t i = 0; i < block; i++) {
+                bytes[i] ^= keystream[l][i];
+            }
+            poly1305_update(&lane->poly, bytes, block);
+            lane->offset += block;
+            lane->counter++;
+            if (lane->offset == item->length) batch_lane_finish(lane);
+        }
+    }
+    
+    memset(keystream, 0, sizeof(keystream));
+}
+
+int aead_open_in_place(const aead_key_t* key,
+                       const unsigned char nonce[AEAD_NONCE_SIZE],
+                       const void* aad, size_t aad_length,
+                       void* data, size_t length, const unsigned char tag[AEAD_TAG_SIZE]) {
+    poly1305_state_t poly;
+    aead_begin(&poly, key, nonce, aad, aad_length);
+    
+    unsigned char* bytes = (unsigned char*)data;
+    unsigned char keystream[64];
+    uint32_t counter = 1;
+    
+    // Authenticate each ciphertext block, then decrypt it while it is hot
+    for (size_t offset = 0; offset < length; offset += 64) {
+        size_t block = length - offset < 64 ? length - offset : 64;
+        poly1305_update(&poly, bytes + offset, block);
+        chacha20_block(key, counter++, nonce, keystream);
+        for (size_t i = 0; i < block; i++) {
+            bytes[offset + i] ^= keystream[i];
+        }
+    }
+    memset(keystream, 0, sizeof(keystream));
+    
+    unsigned char computed[AEAD_TAG_SIZE];
+    mac_pad(&poly, length);
+    mac_lengths(&poly, aad_length, length);
+    poly1305_finish(&poly, computed);
+    
+    unsigned char difference = 0;
+    for (int i = 0; i < AEAD_TAG_SIZE; i++) {
+        difference |= (unsigned char)(computed[i] ^ tag[i]);
+    }
+    if (difference != 0) {
+        memset(data, 0, length);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,98 @@
+// src/security/aead.h
+#ifndef AEAD_H
+#define AEAD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ChaCha20-Poly1305 authenticated encryption (RFC 8439).
+//
+// Encryption and authentication happen in one pass over the data: each
+// 64-byte block is XORed with keystream and fed to Poly1305 while it is
+// still in cache. The *_in_place calls work on the caller's buffer; seal
+// can also read plaintext from a separate source so a copy and the cipher
+// pass are the same pass.
+
+#define AEAD_KEY_SIZE 32
+#define AEAD_NONCE_SIZE 12
+#define AEAD_TAG_SIZE 16
+
+// Messages sealed side by side by aead_seal_batch
+#define AEAD_BATCH_LANES 4
+
+// Expanded key schedule: the ChaCha20 constants and key words, ready to be
+// copied into every block's state. Expand once per key, not per message.
+typedef struct {
+    uint32_t words[12];
+} aead_key_t;
+
+// Incremental Poly1305 state
+typedef struct {
+    uint32_t r[5];
+    uint32_t h[5];
+    uint32_t pad[4];
+    size_t leftover;
+    unsigned char buffer[16];
+} poly1305_state_t;
+
+// Poly1305 one-time authenticator
+void poly1305_init(poly1305_state_t* state, const unsigned char key[32]);
+void poly1305_update(poly1305_state_t* state, const unsigned char* data, size_t length);
+void poly1305_finish(poly1305_state_t* state, unsigned char tag[16]);
+
+// Expand a raw key into a schedule
+void aead_key_init(aead_key_t* schedule, const unsigned char key[AEAD_KEY_SIZE]);
+
+// Clear a schedule
+void aead_key_wipe(aead_key_t* schedule);
+
+// HChaCha20: derive a 32-byte subkey from a key and a 16-byte input
+void hchacha20(const unsigned char key[AEAD_KEY_SIZE], const unsigned char input[16],
+               unsigned char out[AEAD_KEY_SIZE]);
+
+// ChaCha20 block function: 64 bytes of keystream for one counter value
+void chacha20_block(const aead_key_t* key, uint32_t counter,
+                    const unsigned char nonce[AEAD_NONCE_SIZE], unsigned char out[64]);
+
+// One message of a batch, sealed in place
+typedef struct {
+    const unsigned char* nonce;
+    const void* aad;
+    size_t aad_length;
+    void* data;
+    size_t length;
+    unsigned char* tag;
+} aead_batch_item_t;
+
+// ChaCha20 block function for AEAD_BATCH_LANES independent (counter, nonce) pairs
+void chacha20_block_lanes(const aead_key_t* key,
+                          const uint32_t counters[AEAD_BATCH_LANES],
+                          const unsigned char* const nonces[AEAD_BATCH_LANES],
+                          unsigned char out[AEAD_BATCH_LANES][64]);
+
+// Encrypt length bytes from source into destination (which may equal source)
+// and produce the tag over aad and the ciphertext
+void aead_seal(const aead_key_t* key, const unsigned char nonce[AEAD_NONCE_SIZE],
+               const void* aad, size_t aad_length,
+               const void* source, void* destination, size_t length,
+               unsigned char tag[AEAD_TAG_SIZE]);
+
+// Encrypt data in place
+void aead_seal_in_place(const aead_key_t* key,
+                        const unsigned char nonce[AEAD_NONCE_SIZE],
+                        const void* aad, size_t aad_length,
+                        void* data, size_t length, unsigned char tag[AEAD_TAG_SIZE]);
+
+// Seal count independent messages under one key. Messages occupy lanes
+// that share each keystream computation; a lane that finishes is refilled
+// with the next message, so bursts of mixed sizes keep every lane busy.
+void aead_seal_batch(const aead_key_t* key, aead_batch_item_t* items, size_t count);
+
+// Decrypt data in place and check the tag, 0 or -1. On failure the
+// buffer is wiped so unauthenticated plaintext never reaches the caller.
+int aead_open_in_place(const aead_key_t* key,
+                       const unsigned char nonce[AEAD_NONCE_SIZE],
+                       const void* aad, size_t aad_length,
+                       void* data, size_t length, const unsigned char tag[AEAD_TAG_SIZE]);
+
+#endif
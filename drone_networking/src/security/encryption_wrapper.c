@@ -1,7 +1,16 @@
 // src/security/encryption_wrapper.c
 #include "encryption_wrapper.h"
+#include "../core/buffer_pool.h"
+#include "../core/log.h"
+#include <sys/random.h>
+#include <time.h>
 
-security_context_t* security_init(const char* key, const char* iv) {
+security_context_t* security_init(const unsigned char key[AEAD_KEY_SIZE], const char* iv) {
+    if (!key) {
+        LOG_WARN("Security: no key given, refusing to start");
+        return NULL;
+    }
+    
     security_context_t* ctx = (security_context_t*)malloc(sizeof(security_context_t));
     if (!ctx) return NULL;
     
@@ -14,14 +23,7 @@ security_context_t* security_init(const char* key, const char* iv) {
         return NULL;
     }
     
-    // Set encryption key
-    if (key) {
-        strncpy(ctx->encryption_key, key, 31);
-        ctx->encryption_key[31] = '\0';
-    } else {
-        // Generate random key (in real implementation)
-        strcpy(ctx->encryption_key, "DEFAULT_DRONE_KEY_32_CHARS");
-    }
+    memcpy(ctx->encryption_key, key, AEAD_KEY_SIZE);
     
     // Set IV
     if (iv) {
@@ -35,6 +37,20 @@ security_context_t* security_init(const char* key, const char* iv) {
     ctx->encryption_enabled = 1;
     ctx->authentication_enabled = 1;
     
+    // AEAD key and a random nonce prefix so two senders sharing the key
+    // never reuse a nonce
+    aead_key_init(&ctx->aead_key, ctx->encryption_key);
+    if (getrandom(ctx->nonce_prefix, sizeof(ctx->nonce_prefix), 0) != (ssize_t)sizeof(ctx->nonce_prefix)) {
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        uint32_t seed = (uint32_t)now.tv_nsec ^ ((uint32_t)getpid() << 16);
+        memcpy(ctx->nonce_prefix, &seed, sizeof(seed));
+    }
+    
+    // The counter doubles as the sequence number receivers' replay windows
+    // track; starting from the clock keeps it rising across restarts
+    ctx->nonce_counter = message_timestamp_ns();
+    
     printf("Security context initialized\n");
     return ctx;
 }
@@ -44,10 +60,38 @@ void security_cleanup(security_context_t* ctx) {
         if (ctx->mithril_ctx) {
             mithril_cleanup(ctx->mithril_ctx);
         }
+        aead_key_wipe(&ctx->aead_key);
+        volatile unsigned char* key = ctx->encryption_key;
+        for (size_t i = 0; i < sizeof(ctx->encryption_key); i++) {
+            key[i] = 0;
+        }
         free(ctx);
     }
 }
 
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+int security_parse_key(const char* hex, unsigned char key[AEAD_KEY_SIZE]) {
+    if (!hex || !key || strlen(hex) != 2 * AEAD_KEY_SIZE) return -1;
+    
+    for (int i = 0; i < AEAD_KEY_SIZE; i++) {
+        int high = hex_digit(hex[2 * i]);
+        int low = hex_digit(hex[2 * i + 1]);
+        if (high < 0 || low < 0) return -1;
+        key[i] = (unsigned char)(high << 4 | low);
+    }
+    return 0;
+}
+
+void security_set_filter(security_context_t* ctx, frame_filter_t* filter) {
+    if (ctx) ctx->filter = filter;
+}
+
 int encrypt_message(security_context_t* ctx, void* data, size_t length) {
     if (!ctx || !data || !ctx->encryption_enabled) return -1;
     
@@ -55,7 +99,7 @@ int encrypt_message(security_context_t* ctx, void* data, size_t length) {
     return Mithril_Framework(ctx->mithril_ctx, 
                           (unsigned char*)data, 
                           length,
-                          (unsigned char*)ctx->encryption_key,
+                          ctx->encryption_key,
                           (unsigned char*)ctx->iv);
 }
 
@@ -66,7 +110,7 @@ int decrypt_message(security_context_t* ctx, void* data, size_t length) {
     return Mithril_Framework(ctx->mithril_ctx, 
                           (unsigned char*)data, 
                           length,
-                          (unsigned char*)ctx->encryption_key,
+                          ctx->encryption_key,
                           (unsigned char*)ctx->iv);
 }
 
@@ -101,72 +145,228 @@ int verify_security_headers(security_context_t* ctx, const message_header_t* hea
     return 0; // Simplified for now
 }
 
+// Header is associated data; with encryption off so is the payload
+static size_t frame_aad_length(const security_context_t* ctx, size_t length) {
+    return ctx->encryption_enabled ? sizeof(message_header_t) : length;
+}
+
+static void next_nonce(security_context_t* ctx, unsigned char nonce[AEAD_NONCE_SIZE]) {
+    uint64_t counter = __atomic_fetch_add(&ctx->nonce_counter, 1, __ATOMIC_RELAXED);
+    memcpy(nonce, ctx->nonce_prefix, sizeof(ctx->nonce_prefix));
+    for (int i = 0; i < 8; i++) {
+        nonce[4 + i] = (unsigned char)(counter >> (8 * i));
+    }
+}
+
+// Seal length bytes of source into frame; source may equal frame
+static int seal_frame(security_context_t* ctx, const void* source, void* frame,
+                      size_t length, size_t capacity) {
+    if (length < sizeof(message_header_t)) return -1;
+    if (capacity < length + SECURE_TRAILER_SIZE) return -1;
+    
+    unsigned char* bytes = (unsigned char*)frame;
+    unsigned char* nonce = bytes + length;
+    unsigned char* tag = nonce + AEAD_NONCE_SIZE;
+    size_t aad_length = frame_aad_length(ctx, length);
+    
+    if (source != frame) {
+        memcpy(bytes, source, aad_length);
+    }
+    next_nonce(ctx, nonce);
+    aead_seal(&ctx->aead_key, nonce, bytes, aad_length,
+              (const unsigned char*)source + aad_length, bytes + aad_length,
+              length - aad_length, tag);
+    
+    __atomic_fetch_add(&ctx->frames_sealed, 1, __ATOMIC_RELAXED);
+    return (int)(length + SECURE_TRAILER_SIZE);
+}
+
+int secure_seal_frame(security_context_t* ctx, void* frame, size_t length, size_t capacity) {
+    if (!ctx || !frame) return -1;
+    return seal_frame(ctx, frame, frame, length, capacity);
+}
+
+// Items are staged on the stack in chunks of this many frames
+#define SECURE_BATCH_CHUNK 64
+
+int secure_seal_batch(security_context_t* ctx, secure_frame_t* frames, size_t count) {
+    if (!ctx || !frames) return -1;
+    
+    aead_batch_item_t items[SECURE_BATCH_CHUNK];
+    int sealed = 0;
+    
+    for (size_t start = 0; start < count; start += SECURE_BATCH_CHUNK) {
+        size_t end = count - start < SECURE_BATCH_CHUNK ? count : start + SECURE_BATCH_CHUNK;
+        size_t staged = 0;
+        
+        for (size_t i = start; i < end; i++) {
+            secure_frame_t* frame = &frames[i];
+            frame->frame_length = -1;
+            if (!frame->data || frame->length < sizeof(message_header_t) ||
+                frame->capacity < frame->length + SECURE_TRAILER_SIZE) {
+                continue;
+            }
+            
+            unsigned char* bytes = (unsigned char*)frame->data;
+            unsigned char* nonce = bytes + frame->length;
+            size_t aad_length = frame_aad_length(ctx, frame->length);
+            next_nonce(ctx, nonce);
+            
+            aead_batch_item_t* item = &items[staged++];
+            item->nonce = nonce;
+            item->aad = bytes;
+            item->aad_length = aad_length;
+            item->data = bytes + aad_length;
+            item->length = frame->length - aad_length;
+            item->tag = nonce + AEAD_NONCE_SIZE;
+            frame->frame_length = (int)(frame->length + SECURE_TRAILER_SIZE);
+        }
+        
+        aead_seal_batch(&ctx->aead_key, items, staged);
+        sealed += (int)staged;
+    }
+    
+    __atomic_fetch_add(&ctx->frames_sealed, (uint64_t)sealed, __ATOMIC_RELAXED);
+    return sealed;
+}
+
+int secure_open_frame(security_context_t* ctx, void* frame, size_t length) {
+    if (!ctx || !frame) return -1;
+    if (length < sizeof(message_header_t) + SECURE_TRAILER_SIZE) {
+        __atomic_fetch_add(&ctx->frames_rejected, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+    
+    unsigned char* bytes = (unsigned char*)frame;
+    size_t message_length = length - SECURE_TRAILER_SIZE;
+    const unsigned char* nonce = bytes + message_length;
+    const unsigned char* tag = nonce + AEAD_NONCE_SIZE;
+    size_t aad_length = frame_aad_length(ctx, message_length);
+    
+    if (aead_open_in_place(&ctx->aead_key, nonce, bytes, aad_length,
+                           bytes + aad_length, message_length - aad_length, tag) != 0) {
+        __atomic_fetch_add(&ctx->frames_rejected, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+    return (int)message_length;
+}
+
 network_result_t secure_send_message(security_context_t* ctx, 
                                    network_config_t* net_config,
                                    const void* message, 
                                    size_t length) {
     if (!ctx || !net_config || !message) return NET_ERROR;
     
-    // Create a copy of the message for encryption
-    void* encrypted_buffer = malloc(length + 1024); // Extra space for security overhead
-    if (!encrypted_buffer) return NET_ERROR;
+    if (!ctx->encryption_enabled && !ctx->authentication_enabled) {
+        return network_send_data(net_config, message, length);
+    }
     
-    memcpy(encrypted_buffer, message, length);
+    // The message is const, so encrypt it straight into a pooled buffer:
+    // the cipher pass doubles as the copy
+    if (length > MAX_BUFFER_SIZE) return NET_ERROR;
+    void* frame = buffer_pool_acquire();
+    if (!frame) return NET_ERROR;
     
-    // Encrypt the message if security is enabled
-    if (ctx->encryption_enabled) {
-        int result = encrypt_message(ctx, encrypted_buffer, length);
-        if (result != 0) {
-            free(encrypted_buffer);
-            return NET_ERROR;
-        }
+    int frame_length = seal_frame(ctx, message, frame, length, BUFFER_POOL_BUFFER_SIZE);
+    if (frame_length < 0) {
+        buffer_pool_release(frame);
+        return NET_ERROR;
     }
     
-    // Authenticate the message
-    if (ctx->authentication_enabled) {
-        int result = authenticate_message(ctx, encrypted_buffer, length);
-        if (result != 0) {
-            free(encrypted_buffer);
-            return NET_ERROR;
+    // Send the secured message
+    network_result_t send_result = network_send_data(net_config, frame, (size_t)frame_length);
+    
+    buffer_pool_release(frame);
+    return send_result;
+}
+
+network_result_t secure_send_message_in_place(security_context_t* ctx,
+                                            network_config_t* net_config,
+                                            void* message,
+                                            size_t length,
+                                            size_t capacity) {
+    if (!ctx || !net_config || !message) return NET_ERROR;
+    
+    if (!ctx->encryption_enabled && !ctx->authentication_enabled) {
+        return network_send_data(net_config, message, length);
+    }
+    
+    int frame_length = secure_seal_frame(ctx, message, length, capacity);
+    if (frame_length < 0) return NET_ERROR;
+    
+    return network_send_data(net_config, message, (size_t)frame_length);
+}
+
+network_result_t secure_send_batch(security_context_t* ctx,
+                                 network_config_t* net_config,
+                                 secure_frame_t* frames,
+                                 size_t count) {
+    if (!ctx || !net_config || !frames) return NET_ERROR;
+    
+    network_result_t result = NET_SUCCESS;
+    if (ctx->encryption_enabled || ctx->authentication_enabled) {
+        if (secure_seal_batch(ctx, frames, count) != (int)count) result = NET_ERROR;
+    } else {
+        for (size_t i = 0; i < count; i++) {
+            frames[i].frame_length = (int)frames[i].length;
         }
     }
     
-    // Send the secured message
-    network_result_t send_result = network_send_data(net_config, encrypted_buffer, length);
+    for (size_t i = 0; i < count; i++) {
+        if (frames[i].frame_length < 0) continue;
+        if (network_send_data(net_config, frames[i].data, (size_t)frames[i].frame_length) != NET_SUCCESS) {
+            result = NET_ERROR;
+        }
+    }
+    network_flush(net_config);
     
-    free(encrypted_buffer);
-    return send_result;
+    return result;
 }
 
 network_result_t secure_receive_message(security_context_t* ctx,
                                      network_config_t* net_config,
                                      void* buffer,
                                      size_t buffer_size) {
+    return secure_receive_message_from(ctx, net_config, buffer, buffer_size, NULL, NULL);
+}
+
+network_result_t secure_receive_message_from(security_context_t* ctx,
+                                          network_config_t* net_config,
+                                          void* buffer,
+                                          size_t buffer_size,
+                                          size_t* received,
+                                          struct sockaddr_in* source) {
     if (!ctx || !net_config || !buffer) return NET_ERROR;
     
-    // Receive the message
-    network_result_t result = network_receive_data(net_config, buffer, buffer_size);
+    // Receive the message; everything below works on the length that arrived
+    size_t length = 0;
+    network_result_t result = network_receive_data_from(net_config, buffer, buffer_size,
+                                                        &length, source);
     if (result != NET_SUCCESS) {
         return result;
     }
     
-    // Authenticate the received message
-    if (ctx->authentication_enabled) {
-        int auth_result = authenticate_message(ctx, buffer, buffer_size);
-        if (auth_result != 0) {
-            printf("Message authentication failed\n");
-            return NET_ERROR;
+    if (ctx->encryption_enabled || ctx->authentication_enabled) {
+        // Junk, strangers and replays are dropped before any crypto runs
+        frame_filter_peer_t* peer = NULL;
+        if (ctx->filter) {
+            frame_filter_verdict_t verdict = frame_filter_check(ctx->filter, buffer, length, &peer);
+            if (verdict != FRAME_FILTER_PASS) {
+                __atomic_fetch_add(&ctx->frames_filtered, 1, __ATOMIC_RELAXED);
+                LOG_DEBUG("Frame filtered: %s", frame_filter_verdict_name(verdict));
+                return NET_ERROR;
+            }
         }
-    }
-    
-    // Decrypt the message if security is enabled
-    if (ctx->encryption_enabled) {
-        int decrypt_result = decrypt_message(ctx, buffer, buffer_size);
-        if (decrypt_result != 0) {
-            printf("Message decryption failed\n");
+        
+        int message_length = secure_open_frame(ctx, buffer, length);
+        if (message_length < 0) {
+            LOG_WARN("Message authentication failed");
             return NET_ERROR;
         }
+        if (peer) frame_filter_accept(ctx->filter, peer, buffer, length);
+        length = (size_t)message_length;
     }
     
+    if (received) *received = length;
     return NET_SUCCESS;
-}
\ No newline at end of file
+}
@@ -3,26 +3,72 @@
 #define ENCRYPTION_WRAPPER_H
 
 #include "common.h"
+#include "../core/network_core.h"
 #include "../protocols/message_protocol.h"
+#include "aead.h"
+#include "replay_filter.h"
 
 // Include Mithril headers (adjust path as needed)
 #include "../security/mithril/Mithril_Cryptography_API.xcodeproj"
 
+// Secured frames are sealed in place with ChaCha20-Poly1305: the message
+// header travels in clear as associated data, the payload is encrypted and
+// a trailer carrying the nonce and tag is appended. Encryption and the tag
+// are one pass over the payload, and the receiver verifies over the length
+// that actually arrived. With encryption disabled the whole message is
+// associated data and only the tag is added. All frames here share the
+// context key; session.h derives per-drone keys on top of the same format.
+//
+// The nonce counter is shared by every destination as well, since a
+// counter per destination would repeat nonces under the one key. A
+// receiver's replay window therefore sees this sender's sequence jump by
+// the number of destinations it interleaves, and with N of them tolerates
+// reordering of only about REPLAY_WINDOW_BITS / N of its own frames.
+// Traffic that needs a sequence per peer belongs on session.h, which keeps
+// a counter per peer key.
+#define SECURE_TRAILER_SIZE (AEAD_NONCE_SIZE + AEAD_TAG_SIZE)
+
+// One message of a burst handed to secure_seal_batch; frame_length is
+// set to the sealed length or -1 if the buffer has no room for the trailer
+typedef struct {
+    void* data;
+    size_t length;
+    size_t capacity;
+    int frame_length;
+} secure_frame_t;
+
 // Security context structure
 typedef struct {
     mithril_context_t* mithril_ctx;
-    char encryption_key[32];    // AES-256 key
+    unsigned char encryption_key[AEAD_KEY_SIZE];    // Raw key, also the AEAD key
     char iv[16];               // Initialization vector
     int encryption_enabled;
     int authentication_enabled;
+    
+    // AEAD frame sealing
+    aead_key_t aead_key;
+    unsigned char nonce_prefix[4];  // Random per context, keeps senders apart
+    uint64_t nonce_counter;         // From wall-clock ns; one for all destinations
+    uint64_t frames_sealed;
+    uint64_t frames_rejected;
+    uint64_t frames_filtered;       // Dropped by the filter before any crypto
+    frame_filter_t* filter;         // Optional, not owned
+
 } security_context_t;
 
-// Initialize security context
-security_context_t* security_init(const char* key, const char* iv);
+// Initialize security context with a raw AEAD_KEY_SIZE-byte key (not a
+// string; NULL is refused). iv may be NULL.
+security_context_t* security_init(const unsigned char key[AEAD_KEY_SIZE], const char* iv);
+
+// Parse a key written as 2 * AEAD_KEY_SIZE hex digits, 0 or -1
+int security_parse_key(const char* hex, unsigned char key[AEAD_KEY_SIZE]);
 
 // Cleanup security context
 void security_cleanup(security_context_t* ctx);
 
+// Screen received frames with filter before opening them (NULL disables)
+void security_set_filter(security_context_t* ctx, frame_filter_t* filter);
+
 // Encrypt message
 int encrypt_message(security_context_t* ctx, void* data, size_t length);
 
@@ -38,16 +84,48 @@ int add_security_headers(security_context_t* ctx, message_header_t* header);
 // Verify security headers
 int verify_security_headers(security_context_t* ctx, const message_header_t* header);
 
+// Seal a message in place; capacity must leave SECURE_TRAILER_SIZE of
+// tail room. Returns the frame length or -1
+int secure_seal_frame(security_context_t* ctx, void* frame, size_t length, size_t capacity);
+
+// Verify and open a frame in place. Returns the message length or -1
+int secure_open_frame(security_context_t* ctx, void* frame, size_t length);
+
+// Seal a burst of independent messages in one interleaved pass.
+// Returns the number of frames sealed
+int secure_seal_batch(security_context_t* ctx, secure_frame_t* frames, size_t count);
+
 // Secure send function
 network_result_t secure_send_message(security_context_t* ctx, 
                                    network_config_t* net_config,
                                    const void* message, 
                                    size_t length);
 
+// Seal the caller's buffer in place and send it without a copy
+network_result_t secure_send_message_in_place(security_context_t* ctx,
+                                            network_config_t* net_config,
+                                            void* message,
+                                            size_t length,
+                                            size_t capacity);
+
+// Seal a burst in place and send every frame; NET_ERROR if any failed
+network_result_t secure_send_batch(security_context_t* ctx,
+                                 network_config_t* net_config,
+                                 secure_frame_t* frames,
+                                 size_t count);
+
 // Secure receive function
 network_result_t secure_receive_message(security_context_t* ctx,
                                      network_config_t* net_config,
                                      void* buffer,
                                      size_t buffer_size);
 
+// Secure receive reporting the opened message length and the sender
+network_result_t secure_receive_message_from(security_context_t* ctx,
+                                          network_config_t* net_config,
+                                          void* buffer,
+                                          size_t buffer_size,
+                                          size_t* received,
+                                          struct sockaddr_in* source);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,183 @@
+// src/security/replay_filter.c
+#include "replay_filter.h"
+#include <stddef.h>
+
+_Static_assert(REPLAY_WINDOW_BITS % 64 == 0, "replay window must be whole words");
+
+static const char* const verdict_names[] = {
+    "pass", "malformed", "length", "unknown sender", "replay"
+};
+
+const char* frame_filter_verdict_name(frame_filter_verdict_t verdict) {
+    return (unsigned)verdict < 5 ? verdict_names[verdict] : "invalid";
+}
+
+void replay_window_init(replay_window_t* window) {
+    if (!window) return;
+    memset(window, 0, sizeof(replay_window_t));
+}
+
+int replay_window_check(const replay_window_t* window, uint64_t sequence) {
+    if (!window->initialized || sequence > window->highest) return 0;
+    if (window->highest - sequence >= REPLAY_WINDOW_BITS) return -1;
+    
+    uint64_t bit = sequence % REPLAY_WINDOW_BITS;
+    return (window->bitmap[bit / 64] >> (bit % 64)) & 1 ? -1 : 0;
+}
+
+// Clear the bits of count sequences from first on, a word at a time.
+// count < REPLAY_WINDOW_BITS; words never straddle the wrap since the
+// window is a whole number of words.
+static void clear_bits(replay_window_t* window, uint64_t first, uint64_t count) {
+    while (count > 0) {
+        uint64_t bit = first % REPLAY_WINDOW_BITS;
+        uint64_t offset = bit % 64;
+        uint64_t span = 64 - offset < count ? 64 - offset : count;
+        uint64_t mask = span == 64 ? ~0ULL : ((1ULL << span) - 1) << offset;
+        window->bitmap[bit / 64] &= ~mask;
+        first += span;
+        count -= span;
+    }
+}
+
+void replay_window_accept(replay_window_t* window, uint64_t sequence) {
+    if (!window->initialized) {
+        memset(window->bitmap, 0, sizeof(window->bitmap));
+        window->highest = sequence;
+        window->initialized = 1;
+    } else if (sequence > window->highest) {
+        // Clear the bits of the sequences the window slides past
+        uint64_t advance = sequence - window->highest;
+        if (advance >= REPLAY_WINDOW_BITS) {
+            memset(window->bitmap, 0, sizeof(window->bitmap));
+        } else {
+            clear_bits(window, window->highest + 1, advance);
+        }
+        window->highest = sequence;
+    } else if (window->highest - sequence >= REPLAY_WINDOW_BITS) {
+        return;
+    }
+    
+    uint64_t bit = sequence % REPLAY_WINDOW_BITS;
+    window->bitmap[bit / 64] |= 1ULL << (bit % 64);
+}
+
+static frame_filter_peer_t* find_peer(frame_filter_t* filter, const char* drone_id, int create) {
+    long entry = drone_index_find(&filter->index, drone_id);
+    if (entry >= 0) return &filter->peers[entry];
+    
+    if (!create || filter->peer_count >= filter->max_peers) return NULL;
+    
+    frame_filter_peer_t* peer = &filter->peers[filter->peer_count];
+    memset(peer, 0, sizeof(frame_filter_peer_t));
+    strncpy(peer->drone_id, drone_id, MAX_DRONE_ID - 1);
+    replay_window_init(&peer->window);
+    drone_index_insert(&filter->index, (uint32_t)filter->peer_count++);
+    return peer;
+}
+
+frame_filter_t* frame_filter_init(size_t max_peers) {
+    if (max_peers == 0) return NULL;
+    
+    frame_filter_t* filter = (frame_filter_t*)calloc(1, sizeof(frame_filter_t));
+    if (!filter) return NULL;
+    
+    filter->peers = (frame_filter_peer_t*)calloc(max_peers, sizeof(frame_filter_peer_t));
+    if (!filter->peers ||
+        drone_index_init(&filter->index, max_peers, filter->peers,
+                         sizeof(frame_filter_peer_t), offsetof(frame_filter_peer_t, drone_id)) < 0) {
+        frame_filter_cleanup(filter);
+        return NULL;
+    }
+    
+    filter->max_peers = max_peers;
+    filter->min_length = sizeof(message_header_t) + REPLAY_FRAME_TRAILER_SIZE;
+    filter->max_length = MAX_BUFFER_SIZE + REPLAY_FRAME_TRAILER_SIZE;
+    return filter;
+}
+
+int frame_filter_add_peer(frame_filter_t* filter, const char* drone_id) {
+    if (!filter || !drone_id) return -1;
+    return find_peer(filter, drone_id, 1) ? 0 : -1;
+}
+
+void frame_filter_set_bounds(frame_filter_t* filter, size_t min_length, size_t max_length) {
+    if (!filter) return;
+    
+    size_t floor = sizeof(message_header_t) + REPLAY_FRAME_TRAILER_SIZE;
+    filter->min_length = min_length > floor ? min_length : floor;
+    filter->max_length = max_length;
+}
+
+static uint64_t frame_sequence(const void* frame, size_t length) {
+    const unsigned char* counter = (const unsigned char*)frame + length -
+                                   REPLAY_FRAME_TRAILER_SIZE + REPLAY_FRAME_SEQUENCE_OFFSET;
+    uint64_t sequence = 0;
+    for (int i = 7; i >= 0; i--) {
+        sequence = (sequence << 8) | counter[i];
+    }
+    return sequence;
+}
+
+frame_filter_verdict_t frame_filter_check(frame_filter_t* filter, const void* frame,
+                                          size_t length, frame_filter_peer_t** peer) {
+    if (peer) *peer = NULL;
+    if (!filter || !frame) return FRAME_FILTER_MALFORMED;
+    
+    if (length < filter->min_length || length > filter->max_length) {
+        filter->stats.bad_length++;
+        return FRAME_FILTER_LENGTH;
+    }
+    
+    // The header is associated data, so it is readable before decryption
+    message_header_t header;
+    memcpy(&header, frame, sizeof(header));
+    if (header.magic_number != MESSAGE_MAGIC_NUMBER ||
+        header.message_type >= MESSAGE_DISPATCH_MAX_TYPES ||
+        header.payload_length > length - sizeof(message_header_t) - REPLAY_FRAME_TRAILER_SIZE) {
+        filter->stats.malformed++;
+        return FRAME_FILTER_MALFORMED;
+    }
+    
+    char drone_id[MAX_DRONE_ID];
+    memcpy(drone_id, header.drone_id, MAX_DRONE_ID);
+    drone_id[MAX_DRONE_ID - 1] = '\0';
+    
+    frame_filter_peer_t* sender = find_peer(filter, drone_id, 0);
+    if (!sender) {
+        if (!filter->allow_unknown) {
+            filter->stats.unknown_sender++;
+            return FRAME_FILTER_UNKNOWN_SENDER;
+        }
+    } else if (replay_window_check(&sender->window, frame_sequence(frame, length)) != 0) {
+        sender->replays++;
+        filter->stats.replays++;
+        return FRAME_FILTER_REPLAY;
+    }
+    
+    filter->stats.passed++;
+    if (peer) *peer = sender;
+    return FRAME_FILTER_PASS;
+}
+
+void frame_filter_accept(frame_filter_t* filter, frame_filter_peer_t* peer,
+                         const void* frame, size_t length) {
+    if (!filter || !peer || !frame || length < REPLAY_FRAME_TRAILER_SIZE) return;
+    
+    replay_window_accept(&peer->window, frame_sequence(frame, length));
+    peer->accepted++;
+    filter->stats.accepted++;
+}
+
+void frame_filter_get_stats(const frame_filter_t* filter, frame_filter_stats_t* stats) {
+    if (!filter || !stats) return;
+    *stats = filter->stats;
+}
+
+void frame_filter_cleanup(frame_filter_t* filter) {
+    if (filter) {
+        free(filter->peers);
+        drone_index_free(&filter->index);
+        free(filter);
+    }
+}
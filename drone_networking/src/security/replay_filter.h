@@ -0,0 +1,111 @@
+// src/security/replay_filter.h
+#ifndef REPLAY_FILTER_H
+#define REPLAY_FILTER_H
+
+#include "common.h"
+#include "aead.h"
+#include "../protocols/message_protocol.h"
+#include "../core/drone_index.h"
+
+// Cheap rejection of secured frames before any crypto runs.
+//
+// A flood of junk, duplicates or replays should cost a few compares per
+// datagram, not a full authenticate-and-decrypt. frame_filter_check looks
+// only at the clear header and the trailer: magic number, declared length
+// against received length, bounds, a registered sender, and the frame's
+// sequence number (the counter half of its nonce) against that sender's
+// replay window. Frames that pass still have to authenticate; only then is
+// the sequence number committed with frame_filter_accept, so forged frames
+// cannot move a window.
+//
+// The window is IPsec-style: the highest sequence seen plus a
+// REPLAY_WINDOW_BITS bitmap of the ones below it. Anything older than the
+// window or already marked is a replay.
+
+#define REPLAY_WINDOW_BITS 1024
+#define REPLAY_WINDOW_WORDS (REPLAY_WINDOW_BITS / 64)
+
+// Bytes after the message: nonce, then tag (encryption_wrapper.h, session.h)
+#define REPLAY_FRAME_TRAILER_SIZE (AEAD_NONCE_SIZE + AEAD_TAG_SIZE)
+#define REPLAY_FRAME_SEQUENCE_OFFSET 4      // Counter within the nonce
+
+typedef struct {
+    uint64_t highest;
+    uint64_t bitmap[REPLAY_WINDOW_WORDS];   // Bit (sequence % BITS) marks seen
+    int initialized;
+} replay_window_t;
+
+typedef enum {
+    FRAME_FILTER_PASS,
+    FRAME_FILTER_MALFORMED,     // Bad magic or type, or length disagrees with header
+    FRAME_FILTER_LENGTH,        // Outside the configured bounds
+    FRAME_FILTER_UNKNOWN_SENDER,
+    FRAME_FILTER_REPLAY         // Duplicate or older than the window
+} frame_filter_verdict_t;
+
+typedef struct {
+    char drone_id[MAX_DRONE_ID];
+    replay_window_t window;
+    unsigned long accepted;
+    unsigned long replays;
+} frame_filter_peer_t;
+
+typedef struct {
+    unsigned long passed;
+    unsigned long malformed;
+    unsigned long bad_length;
+    unsigned long unknown_sender;
+    unsigned long replays;
+    unsigned long accepted;
+} frame_filter_stats_t;
+
+// Peers are registered up front; check and accept run on one receive
+// thread, so the data path takes no lock.
+typedef struct {
+    frame_filter_peer_t* peers;
+    drone_index_t index;
+    size_t peer_count;
+    size_t max_peers;
+    size_t min_length;
+    size_t max_length;
+    int allow_unknown;              // Pass unregistered senders without a window
+    frame_filter_stats_t stats;
+} frame_filter_t;
+
+// Start an empty window
+void replay_window_init(replay_window_t* window);
+
+// 0 if sequence has not been seen and is inside the window, -1 otherwise
+int replay_window_check(const replay_window_t* window, uint64_t sequence);
+
+// Mark sequence as seen, sliding the window forward if it is the newest
+void replay_window_accept(replay_window_t* window, uint64_t sequence);
+
+// Create a filter for up to max_peers registered senders
+frame_filter_t* frame_filter_init(size_t max_peers);
+
+// Register a sender; 0 on success, -1 if the table is full
+int frame_filter_add_peer(frame_filter_t* filter, const char* drone_id);
+
+// Set accepted frame lengths, trailer included
+void frame_filter_set_bounds(frame_filter_t* filter, size_t min_length, size_t max_length);
+
+// Look at a received frame without touching crypto. On PASS, *peer is the
+// sender's entry (NULL for an allowed unknown sender).
+frame_filter_verdict_t frame_filter_check(frame_filter_t* filter, const void* frame,
+                                          size_t length, frame_filter_peer_t** peer);
+
+// Commit an authenticated frame's sequence number to its sender's window
+void frame_filter_accept(frame_filter_t* filter, frame_filter_peer_t* peer,
+                         const void* frame, size_t length);
+
+// Copy out the counters
+void frame_filter_get_stats(const frame_filter_t* filter, frame_filter_stats_t* stats);
+
+// Name of a verdict, for logs
+const char* frame_filter_verdict_name(frame_filter_verdict_t verdict);
+
+// Free the filter
+void frame_filter_cleanup(frame_filter_t* filter);
+
+#endif
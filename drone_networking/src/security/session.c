@@ -0,0 +1,640 @@
+// src/security/session.c
+#include "session.h"
+#include "../core/log.h"
+#include <stddef.h>
+#include <sys/random.h>
+
+// HChaCha20 inputs separating the derived keys
+static const unsigned char label_initiator_key[16] = "session i->r key";
+static const unsigned char label_responder_key[16] = "session r->i key";
+static const unsigned char label_rekey[16] = "session rekey   ";
+
+static int fill_random(void* buffer, size_t length) {
+    unsigned char* bytes = (unsigned char*)buffer;
+    while (length > 0) {
+        ssize_t got = getrandom(bytes, length, 0);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        bytes += got;
+        length -= (size_t)got;
+    }
+    return 0;
+}
+
+static void session_key_set(session_key_t* key, const unsigned char secret[AEAD_KEY_SIZE],
+                            uint32_t epoch) {
+    memcpy(key->secret, secret, AEAD_KEY_SIZE);
+    aead_key_init(&key->schedule, secret);
+    key->epoch = epoch;
+    replay_window_init(&key->window);
+}
+
+static void session_key_wipe(session_key_t* key) {
+    volatile unsigned char* secret = key->secret;
+    for (size_t i = 0; i < AEAD_KEY_SIZE; i++) {
+        secret[i] = 0;
+    }
+    aead_key_wipe(&key->schedule);
+}
+
+// The key of the epoch after current
+static void session_key_next(const session_key_t* current, session_key_t* next) {
+    unsigned char secret[AEAD_KEY_SIZE];
+    hchacha20(current->secret, label_rekey, secret);
+    session_key_set(next, secret, current->epoch + 1);
+    memset(secret, 0, sizeof(secret));
+}
+
+// Caller holds table->lock
+static security_session_t* find_session(session_table_t* table, const char* drone_id, int create) {
+    long entry = drone_index_find(&table->index, drone_id);
+    if (entry >= 0) return &table->sessions[entry];
+    
+    if (!create || table->session_count >= table->max_sessions) return NULL;
+    
+    security_session_t* session = &table->sessions[table->session_count];
+    memset(session, 0, sizeof(security_session_t));
+    strncpy(session->drone_id, drone_id, MAX_DRONE_ID - 1);
+    session->state = SESSION_PENDING;
+    pthread_mutex_init(&session->lock, NULL);
+    drone_index_insert(&table->index, (uint32_t)table->session_count++);
+    return session;
+}
+
+session_table_t* session_table_init(const char* local_id,
+                                    const unsigned char fleet_key[AEAD_KEY_SIZE],
+                                    size_t max_sessions) {
+    if (!local_id || !fleet_key || max_sessions == 0) return NULL;
+    
+    session_table_t* table = (session_table_t*)calloc(1, sizeof(session_table_t));
+    if (!table) return NULL;
+    
+    table->sessions = (security_session_t*)calloc(max_sessions, sizeof(security_session_t));
+    if (!table->sessions ||
+        drone_index_init(&table->index, max_sessions, table->sessions,
+                         sizeof(security_session_t), offsetof(security_session_t, drone_id)) < 0) {
+        free(table->sessions);
+        free(table);
+        return NULL;
+    }
+    
+    strncpy(table->local_id, local_id, MAX_DRONE_ID - 1);
+    memcpy(table->fleet_secret, fleet_key, AEAD_KEY_SIZE);
+    aead_key_init(&table->fleet_key, fleet_key);
+    table->max_sessions = max_sessions;
+    table->rekey_messages = SESSION_DEFAULT_REKEY_MESSAGES;
+    table->rekey_ns = SESSION_DEFAULT_REKEY_NS;
+    pthread_mutex_init(&table->lock, NULL);
+    
+    return table;
+}
+
+void session_table_set_rekey(session_table_t* table, uint64_t messages, uint64_t interval_ns) {
+    if (!table) return;
+    
+    pthread_mutex_lock(&table->lock);
+    if (messages) table->rekey_messages = messages;
+    if (interval_ns) table->rekey_ns = interval_ns;
+    pthread_mutex_unlock(&table->lock);
+}
+
+security_session_t* session_find(session_table_t* table, const char* drone_id) {
+    if (!table || !drone_id) return NULL;
+    
+    pthread_mutex_lock(&table->lock);
+    security_session_t* session = find_session(table, drone_id, 0);
+    pthread_mutex_unlock(&table->lock);
+    return session;
+}
+
+// Tag over the hello with its checksum and tag fields taken as zero; the
+// random value doubles as the nonce
+static void hello_tag(session_table_t* table, const session_hello_message_t* hello,
+                      unsigned char tag[SESSION_HELLO_TAG_SIZE]) {
+    session_hello_message_t copy = *hello;
+    copy.header.checksum = 0;
+    aead_seal(&table->fleet_key, copy.random, &copy, offsetof(session_hello_message_t, tag),
+              NULL, NULL, 0, tag);
+}
+
+static int build_hello(session_table_t* table, session_hello_message_t* hello,
+                       uint32_t is_response, uint32_t session_id,
+                       const unsigned char random[SESSION_RANDOM_SIZE]) {
+    memset(hello, 0, sizeof(session_hello_message_t));
+    init_message_header(&hello->header, MSG_SESSION_HELLO, table->local_id);
+    hello->header.payload_length = sizeof(session_hello_message_t) - sizeof(message_header_t);
+    hello->is_response = is_response;
+    hello->session_id = session_id;
+    memcpy(hello->random, random, SESSION_RANDOM_SIZE);
+    hello_tag(table, hello, hello->tag);
+    
+    session_hello_message_t unsigned_hello = *hello;
+    return serialize_message(&unsigned_hello, hello, sizeof(session_hello_message_t)) < 0 ? -1 : 0;
+}
+
+// Derive both directions' keys of a handshake from the two random values;
+// epochs start at the session_id
+static void derive_keys(session_table_t* table, int initiator, uint32_t session_id,
+                        const unsigned char initiator_random[SESSION_RANDOM_SIZE],
+                        const unsigned char responder_random[SESSION_RANDOM_SIZE],
+                        session_key_t* tx, session_key_t* rx) {
+    unsigned char root[AEAD_KEY_SIZE];
+    hchacha20(table->fleet_secret, initiator_random, root);
+    hchacha20(root, initiator_random + 16, root);
+    hchacha20(root, responder_random, root);
+    hchacha20(root, responder_random + 16, root);
+    
+    unsigned char initiator_key[AEAD_KEY_SIZE];
+    unsigned char responder_key[AEAD_KEY_SIZE];
+    hchacha20(root, label_initiator_key, initiator_key);
+    hchacha20(root, label_responder_key, responder_key);
+    
+    session_key_set(tx, initiator ? initiator_key : responder_key, session_id);
+    session_key_set(rx, initiator ? responder_key : initiator_key, session_id);
+    
+    memset(root, 0, sizeof(root));
+    memset(initiator_key, 0, sizeof(initiator_key));
+    memset(responder_key, 0, sizeof(responder_key));
+}
+
+// Caller holds session->lock. Drop new keys that were never confirmed.
+static void drop_pending_keys(security_session_t* session) {
+    session_key_wipe(&session->pending_tx);
+    session_key_wipe(&session->pending_rx);
+    session->key_switch = SESSION_SWITCH_NONE;
+}
+
+// Caller holds session->lock. Take up the responder's new send key once
+// its receive side has switched.
+static void adopt_pending_tx(security_session_t* session) {
+    session_key_wipe(&session->tx);
+    session->tx = session->pending_tx;
+    session_key_wipe(&session->pending_tx);
+    session->tx_counter = 0;
+    session->tx_epoch_started_ns = network_monotonic_ns();
+    session->key_switch = SESSION_SWITCH_NONE;
+}
+
+// Caller holds table->lock. Start using new keys; a replaced session's
+// receive key stays as rx_previous for frames still in flight.
+static void install_keys(session_table_t* table, security_session_t* session,
+                         const session_key_t* tx, const session_key_t* rx) {
+    pthread_mutex_lock(&session->lock);
+    if (session->key_switch == SESSION_SWITCH_CONFIRMED) {
+        adopt_pending_tx(session);
+    }
+    drop_pending_keys(session);
+    
+    session_key_wipe(&session->rx_previous);
+    session->has_rx_previous = session->state == SESSION_ESTABLISHED;
+    if (session->has_rx_previous) session->rx_previous = session->rx;
+    session_key_wipe(&session->tx);
+    session->tx = *tx;
+    session->rx = *rx;
+    session->tx_counter = 0;
+    session->established_ns = network_monotonic_ns();
+    session->tx_epoch_started_ns = session->established_ns;
+    session->state = SESSION_ESTABLISHED;
+    pthread_mutex_unlock(&session->lock);
+    table->handshakes_completed++;
+}
+
+static int epochs_near(uint32_t a, uint32_t b) {
+    uint32_t distance = a - b;
+    return distance < SESSION_EPOCH_GAP || distance > (uint32_t)0 - SESSION_EPOCH_GAP;
+}
+
+// Caller holds table->lock. Whether a session_id would start epochs too
+// close to those of the established session, so frames could pick the
+// wrong key.
+static int session_id_clashes(security_session_t* session, uint32_t session_id) {
+    if (session->state != SESSION_ESTABLISHED) return 0;
+    
+    pthread_mutex_lock(&session->lock);
+    int clashes = epochs_near(session_id, session->tx.epoch) ||
+                  epochs_near(session_id, session->rx.epoch);
+    pthread_mutex_unlock(&session->lock);
+    return clashes;
+}
+
+int session_initiate(session_table_t* table, const char* peer_id,
+                     session_hello_message_t* hello) {
+    if (!table || !peer_id || !hello) return -1;
+    
+    unsigned char random[SESSION_RANDOM_SIZE];
+    uint32_t session_id;
+    if (fill_random(random, sizeof(random)) != 0 ||
+        fill_random(&session_id, sizeof(session_id)) != 0) {
+        LOG_ERROR("No randomness for session handshake");
+        return -1;
+    }
+    
+    pthread_mutex_lock(&table->lock);
+    security_session_t* session = find_session(table, peer_id, 1);
+    if (!session) {
+        pthread_mutex_unlock(&table->lock);
+        LOG_WARN("Session table full, cannot open session with %s", peer_id);
+        return -1;
+    }
+    
+    // Both directions' epochs stay near the current session_id, so half the
+    // epoch space away is clear of them
+    if (session_id_clashes(session, session_id)) session_id ^= 0x80000000u;
+    
+    // An established session keeps working until the new one completes
+    if (session->state != SESSION_ESTABLISHED) session->state = SESSION_PENDING;
+    session->initiator = 1;
+    session->awaiting_response = 1;
+    session->session_id = session_id;
+    memcpy(session->local_random, random, sizeof(random));
+    int result = build_hello(table, hello, 0, session_id, random);
+    pthread_mutex_unlock(&table->lock);
+    
+    memset(random, 0, sizeof(random));
+    return result;
+}
+
+// Caller holds table->lock. Whether an authenticated hello is recent and
+// newer than any hello taken from the peer before.
+static int hello_is_fresh(const security_session_t* session, const session_hello_message_t* hello) {
+    uint64_t now = message_timestamp_ns();
+    uint64_t sent = hello->header.timestamp;
+    if (sent > now + SESSION_HELLO_MAX_SKEW_NS || now > sent + SESSION_HELLO_MAX_SKEW_NS) {
+        return 0;
+    }
+    return !session || sent > session->peer_hello_ns;
+}
+
+int session_handle_hello(session_table_t* table, const message_view_t* view,
+                         session_hello_message_t* response) {
+    if (!table || !view || view->type != MSG_SESSION_HELLO) return -1;
+    
+    const session_hello_message_t* hello = view->as.session_hello;
+    unsigned char expected[SESSION_HELLO_TAG_SIZE];
+    hello_tag(table, hello, expected);
+    
+    unsigned char difference = 0;
+    for (int i = 0; i < SESSION_HELLO_TAG_SIZE; i++) {
+        difference |= (unsigned char)(expected[i] ^ hello->tag[i]);
+    }
+    
+    char peer_id[MAX_DRONE_ID];
+    strncpy(peer_id, hello->header.drone_id, MAX_DRONE_ID - 1);
+    peer_id[MAX_DRONE_ID - 1] = '\0';
+    
+    pthread_mutex_lock(&table->lock);
+    if (difference != 0) {
+        table->handshakes_rejected++;
+        pthread_mutex_unlock(&table->lock);
+        LOG_WARN("Session hello from %s failed authentication", peer_id);
+        return -1;
+    }
+    
+    security_session_t* session = find_session(table, peer_id, 0);
+    if (!hello_is_fresh(session, hello)) {
+        table->handshakes_stale++;
+        pthread_mutex_unlock(&table->lock);
+        LOG_WARN("Stale or replayed session hello from %s", peer_id);
+        return -1;
+    }
+    if (session) session->peer_hello_ns = hello->header.timestamp;
+    
+    if (hello->is_response) {
+        if (!session || !session->awaiting_response || session->session_id != hello->session_id) {
+            table->handshakes_rejected++;
+            pthread_mutex_unlock(&table->lock);
+            LOG_DEBUG("Unexpected session response from %s", peer_id);
+            return -1;
+        }
+        session_key_t tx, rx;
+        derive_keys(table, 1, session->session_id, session->local_random, hello->random,
+                    &tx, &rx);
+        install_keys(table, session, &tx, &rx);
+        memset(session->local_random, 0, sizeof(session->local_random));
+        session->awaiting_response = 0;
+        pthread_mutex_unlock(&table->lock);
+        session_key_wipe(&tx);
+        session_key_wipe(&rx);
+        LOG_INFO("Session with %s established", peer_id);
+        return 0;
+    }
+    
+    // Hellos crossed: the lower drone_id stays initiator and the other side
+    // answers its hello instead
+    if (session && session->awaiting_response) {
+        if (strncmp(table->local_id, peer_id, MAX_DRONE_ID) < 0) {
+            pthread_mutex_unlock(&table->lock);
+            LOG_DEBUG("Session hello from %s crossed ours, staying initiator", peer_id);
+            return -1;
+        }
+        memset(session->local_random, 0, sizeof(session->local_random));
+        session->awaiting_response = 0;
+    }
+    
+    if (!response) {
+        pthread_mutex_unlock(&table->lock);
+        return -1;
+    }
+    if (session && session_id_clashes(session, hello->session_id)) {
+        table->handshakes_rejected++;
+        pthread_mutex_unlock(&table->lock);
+        LOG_WARN("Session hello from %s reuses live epochs", peer_id);
+        return -1;
+    }
+    
+    unsigned char random[SESSION_RANDOM_SIZE];
+    if (fill_random(random, sizeof(random)) != 0) {
+        pthread_mutex_unlock(&table->lock);
+        LOG_ERROR("No randomness for session handshake");
+        return -1;
+    }
+    
+    if (!session) {
+        session = find_session(table, peer_id, 1);
+        if (session) session->peer_hello_ns = hello->header.timestamp;
+    }
+    if (!session || build_hello(table, response, 1, hello->session_id, random) != 0) {
+        pthread_mutex_unlock(&table->lock);
+        memset(random, 0, sizeof(random));
+        return -1;
+    }
+    session->initiator = 0;
+    session->session_id = hello->session_id;
+    
+    session_key_t tx, rx;
+    derive_keys(table, 0, hello->session_id, hello->random, random, &tx, &rx);
+    if (session->state == SESSION_ESTABLISHED) {
+        // The live keys stay until the initiator shows it has the new ones
+        pthread_mutex_lock(&session->lock);
+        if (session->key_switch == SESSION_SWITCH_CONFIRMED) {
+            adopt_pending_tx(session);
+        }
+        drop_pending_keys(session);
+        session->pending_tx = tx;
+        session->pending_rx = rx;
+        session->key_switch = SESSION_SWITCH_WAITING;
+        pthread_mutex_unlock(&session->lock);
+        table->handshakes_completed++;
+    } else {
+        install_keys(table, session, &tx, &rx);
+    }
+    pthread_mutex_unlock(&table->lock);
+    
+    session_key_wipe(&tx);
+    session_key_wipe(&rx);
+    memset(random, 0, sizeof(random));
+    LOG_INFO("Session with %s accepted", peer_id);
+    return 1;
+}
+
+// Caller holds session->lock
+static void rekey_tx(security_session_t* session) {
+    session_key_t next;
+    session_key_next(&session->tx, &next);
+    session_key_wipe(&session->tx);
+    session->tx = next;
+    session_key_wipe(&next);
+    session->tx_counter = 0;
+    session->tx_epoch_started_ns = network_monotonic_ns();
+    session->rekeys++;
+}
+
+void session_rekey(security_session_t* session) {
+    if (!session) return;
+    
+    pthread_mutex_lock(&session->lock);
+    if (session->state == SESSION_ESTABLISHED) rekey_tx(session);
+    pthread_mutex_unlock(&session->lock);
+}
+
+static void store_nonce(unsigned char nonce[AEAD_NONCE_SIZE], uint32_t epoch, uint64_t counter) {
+    for (int i = 0; i < 4; i++) {
+        nonce[i] = (unsigned char)(epoch >> (8 * i));
+    }
+    for (int i = 0; i < 8; i++) {
+        nonce[4 + i] = (unsigned char)(counter >> (8 * i));
+    }
+}
+
+static uint32_t nonce_epoch(const unsigned char nonce[AEAD_NONCE_SIZE]) {
+    return (uint32_t)nonce[0] | ((uint32_t)nonce[1] << 8) |
+           ((uint32_t)nonce[2] << 16) | ((uint32_t)nonce[3] << 24);
+}
+
+int session_seal(session_table_t* table, security_session_t* session,
+                 void* frame, size_t length, size_t capacity) {
+    if (!table || !session || !frame) return -1;
+    if (length < sizeof(message_header_t) || capacity < length + SESSION_TRAILER_SIZE) return -1;
+    
+    // Key, counter and seal under one hold, so a handshake replacing the
+    // keys cannot pair a new key with a used counter
+    pthread_mutex_lock(&session->lock);
+    if (session->state != SESSION_ESTABLISHED) {
+        pthread_mutex_unlock(&session->lock);
+        return -1;
+    }
+    if (session->key_switch == SESSION_SWITCH_CONFIRMED) {
+        adopt_pending_tx(session);
+    }
+    if (session->tx_counter >= table->rekey_messages ||
+        ((session->tx_counter & 0xff) == 0 && session->tx_counter > 0 &&
+         network_monotonic_ns() - session->tx_epoch_started_ns >= table->rekey_ns)) {
+        rekey_tx(session);
+    }
+    
+    unsigned char* bytes = (unsigned char*)frame;
+    unsigned char* nonce = bytes + length;
+    store_nonce(nonce, session->tx.epoch, session->tx_counter++);
+    aead_seal_in_place(&session->tx.schedule, nonce, bytes, sizeof(message_header_t),
+                       bytes + sizeof(message_header_t), length - sizeof(message_header_t),
+                       nonce + AEAD_NONCE_SIZE);
+    
+    session->frames_sealed++;
+    pthread_mutex_unlock(&session->lock);
+    return (int)(length + SESSION_TRAILER_SIZE);
+}
+
+// Caller holds session->lock
+static int open_locked(security_session_t* session, void* frame, size_t length) {
+    if (session->state != SESSION_ESTABLISHED ||
+        length < sizeof(message_header_t) + SESSION_TRAILER_SIZE) {
+        session->frames_rejected++;
+        return -1;
+    }
+    
+    unsigned char* bytes = (unsigned char*)frame;
+    size_t message_length = length - SESSION_TRAILER_SIZE;
+    const unsigned char* nonce = bytes + message_length;
+    const unsigned char* tag = nonce + AEAD_NONCE_SIZE;
+    uint32_t epoch = nonce_epoch(nonce);
+    
+    // Pick the key for the frame's epoch; the next epoch is tried on a copy
+    // and only adopted once a frame under it authenticates
+    session_key_t next;
+    session_key_t* key = NULL;
+    if (epoch == session->rx.epoch) {
+        key = &session->rx;
+    } else if (epoch == session->rx.epoch + 1) {
+        session_key_next(&session->rx, &next);
+        key = &next;
+    } else if (session->has_rx_previous && epoch == session->rx_previous.epoch) {
+        key = &session->rx_previous;
+    } else if (session->key_switch == SESSION_SWITCH_WAITING &&
+               epoch == session->pending_rx.epoch) {
+        key = &session->pending_rx;
+    } else {
+        session->frames_rejected++;
+        return -1;
+    }
+    
+    uint64_t counter = 0;
+    for (int i = AEAD_NONCE_SIZE - 1; i >= 4; i--) {
+        counter = (counter << 8) | nonce[i];
+    }
+    if (replay_window_check(&key->window, counter) != 0) {
+        if (key == &next) session_key_wipe(&next);
+        session->replays++;
+        session->frames_rejected++;
+        return -1;
+    }
+    
+    int result = aead_open_in_place(&key->schedule, nonce, bytes, sizeof(message_header_t),
+                                    bytes + sizeof(message_header_t),
+                                    message_length - sizeof(message_header_t), tag);
+    if (result == 0) {
+        replay_window_accept(&key->window, counter);
+    }
+    if (key == &next) {
+        if (result == 0) {
+            session_key_wipe(&session->rx_previous);
+            session->rx_previous = session->rx;
+            session->has_rx_previous = 1;
+            session->rx = next;
+        }
+        session_key_wipe(&next);
+    }
+    if (key == &session->pending_rx && result == 0) {
+        // The initiator has the new keys: receive on them now, send on them
+        // from the next seal
+        session_key_wipe(&session->rx_previous);
+        session->rx_previous = session->rx;
+        session->has_rx_previous = 1;
+        session->rx = session->pending_rx;
+        session_key_wipe(&session->pending_rx);
+        session->key_switch = SESSION_SWITCH_CONFIRMED;
+    }
+    
+    if (result != 0) {
+        session->frames_rejected++;
+        return -1;
+    }
+    session->frames_opened++;
+    return (int)message_length;
+}
+
+int session_open(security_session_t* session, void* frame, size_t length) {
+    if (!session || !frame) return -1;
+    
+    pthread_mutex_lock(&session->lock);
+    int result = open_locked(session, frame, length);
+    pthread_mutex_unlock(&session->lock);
+    return result;
+}
+
+int session_open_frame(session_table_t* table, void* frame, size_t length,
+                       security_session_t** session) {
+    if (!table || !frame || length < sizeof(message_header_t)) return -1;
+    
+    // Cheap checks on the clear header before the lookup and any crypto
+    message_header_t header;
+    memcpy(&header, frame, sizeof(header));
+    if (session) *session = NULL;
+    if (header.magic_number != MESSAGE_MAGIC_NUMBER ||
+        length < sizeof(message_header_t) + SESSION_TRAILER_SIZE ||
+        header.payload_length > length - sizeof(message_header_t) - SESSION_TRAILER_SIZE) {
+        return -1;
+    }
+    
+    char drone_id[MAX_DRONE_ID];
+    memcpy(drone_id, header.drone_id, MAX_DRONE_ID);
+    drone_id[MAX_DRONE_ID - 1] = '\0';
+    
+    security_session_t* found = session_find(table, drone_id);
+    if (session) *session = found;
+    if (!found) return -1;
+    return session_open(found, frame, length);
+}
+
+network_result_t session_send(session_table_t* table, security_session_t* session,
+                              network_config_t* net_config,
+                              void* message, size_t length, size_t capacity) {
+    if (!net_config) return NET_ERROR;
+    
+    int frame_length = session_seal(table, session, message, length, capacity);
+    if (frame_length < 0) return NET_ERROR;
+    
+    return network_send_data(net_config, message, (size_t)frame_length);
+}
+
+network_result_t session_receive(session_table_t* table, network_config_t* net_config,
+                                 void* buffer, size_t buffer_size, size_t* received,
+                                 struct sockaddr_in* source, security_session_t** session) {
+    if (!table || !net_config || !buffer) return NET_ERROR;
+    
+    size_t length = 0;
+    network_result_t result = network_receive_data_from(net_config, buffer, buffer_size,
+                                                        &length, source);
+    if (result != NET_SUCCESS) return result;
+    
+    int message_length = session_open_frame(table, buffer, length, session);
+    if (message_length < 0) {
+        LOG_DEBUG("Dropped frame without a valid session");
+        return NET_ERROR;
+    }
+    
+    if (received) *received = (size_t)message_length;
+    return NET_SUCCESS;
+}
+
+void session_table_print_stats(session_table_t* table) {
+    if (!table) return;
+    
+    pthread_mutex_lock(&table->lock);
+    printf("=== Sessions (%s) ===\n", table->local_id);
+    printf("Handshakes: %lu completed, %lu rejected, %lu stale\n",
+           table->handshakes_completed, table->handshakes_rejected, table->handshakes_stale);
+    for (size_t i = 0; i < table->session_count; i++) {
+        security_session_t* session = &table->sessions[i];
+        pthread_mutex_lock(&session->lock);
+        printf("%s: %s tx_epoch=%u rx_epoch=%u sealed=%lu opened=%lu rejected=%lu "
+               "replays=%lu rekeys=%lu\n",
+               session->drone_id,
+               session->state == SESSION_ESTABLISHED ? "established" : "pending",
+               session->tx.epoch, session->rx.epoch, session->frames_sealed,
+               session->frames_opened, session->frames_rejected, session->replays,
+               session->rekeys);
+        pthread_mutex_unlock(&session->lock);
+    }
+    pthread_mutex_unlock(&table->lock);
+}
+
+void session_table_cleanup(session_table_t* table) {
+    if (table) {
+        for (size_t i = 0; i < table->session_count; i++) {
+            session_key_wipe(&table->sessions[i].tx);
+            session_key_wipe(&table->sessions[i].rx);
+            session_key_wipe(&table->sessions[i].rx_previous);
+            session_key_wipe(&table->sessions[i].pending_tx);
+            session_key_wipe(&table->sessions[i].pending_rx);
+            pthread_mutex_destroy(&table->sessions[i].lock);
+        }
+        aead_key_wipe(&table->fleet_key);
+        memset(table->fleet_secret, 0, sizeof(table->fleet_secret));
+        pthread_mutex_destroy(&table->lock);
+        free(table->sessions);
+        drone_index_free(&table->index);
+        free(table);
+    }
+}
@@ -0,0 +1,175 @@
+// src/security/session.h
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "common.h"
+#include "aead.h"
+#include "replay_filter.h"
+#include "../core/network_core.h"
+#include "../core/drone_index.h"
+#include "../protocols/message_protocol.h"
+
+// Per-drone secure sessions.
+//
+// Every drone shares a fleet key, but traffic is never sealed with it
+// directly. A MSG_SESSION_HELLO exchange, tagged with the fleet key, mixes
+// a fresh random value from each side through HChaCha20 into a session
+// root, from which each direction gets its own key. Keys are held as
+// expanded schedules, so sealing a frame costs a table lookup and a copy
+// of twelve words rather than a key setup.
+//
+// A hello is only taken if its header timestamp, covered by the tag, is
+// within SESSION_HELLO_MAX_SKEW_NS of local time and newer than the last
+// hello accepted from that peer, so a recorded hello cannot be replayed.
+// When both sides initiate at once, the side with the lower drone_id stays
+// initiator and the other answers its hello. A new handshake over an
+// established session does not disturb it: the initiator switches once the
+// response arrives and keeps the replaced receive key for frames in
+// flight; the responder keeps sending and receiving on the live keys until
+// a frame from the initiator opens under the new ones.
+//
+// Frames use the secure trailer layout (header in clear as associated
+// data, payload encrypted, nonce and tag appended). The nonce is the
+// sender's key epoch and a per-key counter, so a nonce can only repeat if
+// the counter wraps, and the key is ratcheted long before that: after
+// rekey_messages frames or rekey_ns of use the sender replaces its key
+// with HChaCha20(key, "rekey") and bumps the epoch. The receiver follows
+// when it sees the next epoch, keeping the previous key for frames still
+// in flight. Rekeying needs no round trip. Each receive key has its own
+// replay window, checked before the tag and committed after it. A
+// session's epochs count up from its session_id, which the initiator
+// keeps well away from the epochs of the session it replaces.
+//
+// Each session has its own lock, taken by seals, opens and every key
+// change a handshake makes, so a thread may seal while the receive thread
+// handles a hello for the same peer. The table lock is taken first when
+// both are held.
+//
+// There is no ephemeral Diffie-Hellman, so a leaked fleet key exposes
+// recorded sessions; the handshake only guarantees fresh, per-peer keys.
+
+#define SESSION_TRAILER_SIZE (AEAD_NONCE_SIZE + AEAD_TAG_SIZE)
+#define SESSION_DEFAULT_REKEY_MESSAGES (1ULL << 24)
+#define SESSION_DEFAULT_REKEY_NS (600ULL * 1000000000ULL)
+#define SESSION_HELLO_MAX_SKEW_NS (60ULL * 1000000000ULL)
+#define SESSION_EPOCH_GAP (1u << 20)    // Minimum distance between sessions' epochs
+
+typedef enum {
+    SESSION_PENDING,        // Hello sent, waiting for the response
+    SESSION_ESTABLISHED
+} session_state_t;
+
+// New keys of a handshake over an established session, responder side
+typedef enum {
+    SESSION_SWITCH_NONE,
+    SESSION_SWITCH_WAITING,     // pending_* held until the initiator uses them
+    SESSION_SWITCH_CONFIRMED    // Receive side switched; the next seal switches tx
+} session_switch_t;
+
+// One direction's key
+typedef struct {
+    unsigned char secret[AEAD_KEY_SIZE];    // Ratcheted on rekey
+    aead_key_t schedule;
+    uint32_t epoch;
+    replay_window_t window;                 // Receive side: counters seen
+} session_key_t;
+
+typedef struct {
+    char drone_id[MAX_DRONE_ID];
+    session_state_t state;
+    int initiator;
+    uint32_t session_id;
+    int awaiting_response;          // Our hello is out; local_random is live
+    unsigned char local_random[SESSION_RANDOM_SIZE];
+    
+    session_key_t tx;
+    uint64_t tx_counter;            // Next nonce counter under tx
+    uint64_t tx_epoch_started_ns;
+    
+    session_key_t rx;
+    session_key_t rx_previous;      // Epoch before rx, or the replaced session's rx
+    int has_rx_previous;
+    
+    int key_switch;                 // session_switch_t
+    session_key_t pending_tx;
+    session_key_t pending_rx;
+    uint64_t peer_hello_ns;         // Timestamp of the newest hello taken from the peer
+    
+    uint64_t established_ns;
+    unsigned long frames_sealed;
+    unsigned long frames_opened;
+    unsigned long frames_rejected;
+    unsigned long replays;
+    unsigned long rekeys;
+    pthread_mutex_t lock;           // Keys, counters and key_switch
+} security_session_t;
+
+typedef struct {
+    char local_id[MAX_DRONE_ID];
+    aead_key_t fleet_key;
+    unsigned char fleet_secret[AEAD_KEY_SIZE];
+    security_session_t* sessions;
+    drone_index_t index;
+    size_t session_count;
+    size_t max_sessions;
+    uint64_t rekey_messages;
+    uint64_t rekey_ns;
+    unsigned long handshakes_completed;
+    unsigned long handshakes_rejected;
+    unsigned long handshakes_stale;     // Too old, too far ahead or replayed
+    pthread_mutex_t lock;
+} session_table_t;
+
+// Create a table for up to max_sessions peers under a 32-byte fleet key
+session_table_t* session_table_init(const char* local_id,
+                                    const unsigned char fleet_key[AEAD_KEY_SIZE],
+                                    size_t max_sessions);
+
+// Override the rekey thresholds (0 keeps the current value)
+void session_table_set_rekey(session_table_t* table, uint64_t messages, uint64_t interval_ns);
+
+// Look up a peer's session, NULL if there is none
+security_session_t* session_find(session_table_t* table, const char* drone_id);
+
+// Start a handshake with a peer. Fills a serialized hello to send to it.
+int session_initiate(session_table_t* table, const char* peer_id,
+                     session_hello_message_t* hello);
+
+// Handle a received MSG_SESSION_HELLO. Returns 1 if response was filled and
+// should be sent back, 0 if a pending session was completed, -1 if rejected
+// (including a peer's hello that crossed ours when we stay initiator).
+int session_handle_hello(session_table_t* table, const message_view_t* view,
+                         session_hello_message_t* response);
+
+// Replace the session's send key with the next epoch's
+void session_rekey(security_session_t* session);
+
+// Seal a message in place; capacity must leave SESSION_TRAILER_SIZE of
+// tail room. Returns the frame length or -1.
+int session_seal(session_table_t* table, security_session_t* session,
+                 void* frame, size_t length, size_t capacity);
+
+// Verify and open a frame in place. Returns the message length or -1.
+int session_open(security_session_t* session, void* frame, size_t length);
+
+// Open a frame with the session of the drone named in its header
+int session_open_frame(session_table_t* table, void* frame, size_t length,
+                       security_session_t** session);
+
+// Seal in place and send to the session's peer over net_config
+network_result_t session_send(session_table_t* table, security_session_t* session,
+                              network_config_t* net_config,
+                              void* message, size_t length, size_t capacity);
+
+// Receive one frame and open it with its sender's session
+network_result_t session_receive(session_table_t* table, network_config_t* net_config,
+                                 void* buffer, size_t buffer_size, size_t* received,
+                                 struct sockaddr_in* source, security_session_t** session);
+
+// Print handshake and per-session counters
+void session_table_print_stats(session_table_t* table);
+
+// Wipe all keys and free the table
+void session_table_cleanup(session_table_t* table);
+
+#endif
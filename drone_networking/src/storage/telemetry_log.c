@@ -0,0 +1,769 @@
+// src/storage/telemetry_log.c
+#include "telemetry_log.h"
+#include "../core/log.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define TELEMETRY_LOG_PAGE_SIZE 4096
+#define TELEMETRY_LOG_DIRECTORY_FILE "drones.dir"
+
+_Static_assert(sizeof(telemetry_record_t) == 64, "telemetry_record_t must stay one cache line");
+
+static size_t round_to_page(size_t size) {
+    return (size + TELEMETRY_LOG_PAGE_SIZE - 1) & ~(size_t)(TELEMETRY_LOG_PAGE_SIZE - 1);
+}
+
+static uint64_t saturating_add(uint64_t a, uint64_t b) {
+    return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+}
+
+static void segment_path(char* buffer, size_t size, const char* path, uint64_t first_record) {
+    snprintf(buffer, size, "%s/segment-%020llu.log", path, (unsigned long long)first_record);
+}
+
+static void set_segment_pointers(telemetry_segment_t* segment, void* map, size_t map_size) {
+    segment->header = (telemetry_segment_header_t*)map;
+    segment->index = (telemetry_index_entry_t*)(segment->header + 1);
+    segment->records = (telemetry_record_t*)((char*)map + segment->header->header_size);
+    segment->map_size = map_size;
+}
+
+// Map an existing segment file and check its header
+static int map_segment(const char* file, int writable, telemetry_segment_t* segment) {
+    int fd = open(file, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) return -1;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(telemetry_segment_header_t)) {
+        close(fd);
+        return -1;
+    }
+    
+    size_t map_size = (size_t)info.st_size;
+    void* map = mmap(NULL, map_size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                     MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+    
+    const telemetry_segment_header_t* header = (const telemetry_segment_header_t*)map;
+    if (header->magic != TELEMETRY_LOG_MAGIC || header->version != TELEMETRY_LOG_VERSION ||
+        header->record_size != sizeof(telemetry_record_t) || header->capacity == 0 ||
+        header->header_size + header->capacity * sizeof(telemetry_record_t) > map_size) {
+        munmap(map, map_size);
+        return -1;
+    }
+    
+    set_segment_pointers(segment, map, map_size);
+    return 0;
+}
+
+static void unmap_segment(telemetry_segment_t* segment) {
+    if (segment->header) munmap(segment->header, segment->map_size);
+    memset(segment, 0, sizeof(telemetry_segment_t));
+}
+
+static telemetry_segment_t* segment_slot(telemetry_log_t* log, uint64_t number) {
+    return &log->segments[number % TELEMETRY_LOG_MAX_SEGMENTS];
+}
+
+// Segment numbers [*oldest, *end) without the lock. The end is loaded
+// first, so a retirement in between only narrows the range.
+static void load_segment_range(telemetry_log_t* log, uint64_t* oldest, uint64_t* end) {
+    *end = __atomic_load_n(&log->end_segment, __ATOMIC_ACQUIRE);
+    *oldest = __atomic_load_n(&log->oldest_segment, __ATOMIC_ACQUIRE);
+}
+
+// Caller holds log->lock (or is opening the log)
+static void retire_segment(telemetry_log_t* log) {
+    uint64_t number = log->oldest_segment;
+    telemetry_segment_t* segment = segment_slot(log, number);
+    char file[TELEMETRY_LOG_PATH_SIZE + 48];
+    segment_path(file, sizeof(file), log->path, segment->header->first_record);
+    
+    __atomic_store_n(&log->oldest_segment, number + 1, __ATOMIC_RELEASE);
+    unmap_segment(segment);
+    if (unlink(file) != 0) LOG_WARN("Telemetry log: cannot remove %s", file);
+    log->stats.segments_retired++;
+}
+
+// Create segment number end_segment, retiring the oldest if the log is
+// at max_segments. Caller holds log->lock (or is opening the log).
+static int create_segment(telemetry_log_t* log) {
+    uint64_t capacity = log->config.segment_records;
+    uint64_t number = log->end_segment;
+    uint64_t first_record = number * capacity;
+    uint64_t index_entries = capacity / log->config.index_interval + 1;
+    size_t header_size = round_to_page(sizeof(telemetry_segment_header_t) +
+                                       index_entries * sizeof(telemetry_index_entry_t));
+    size_t map_size = header_size + capacity * sizeof(telemetry_record_t);
+    
+    char file[TELEMETRY_LOG_PATH_SIZE + 48];
+    segment_path(file, sizeof(file), log->path, first_record);
+    int fd = open(file, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        LOG_WARN("Telemetry log: cannot create %s", file);
+        return -1;
+    }
+    if (ftruncate(fd, (off_t)map_size) != 0) {
+        close(fd);
+        unlink(file);
+        return -1;
+    }
+    void* map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        unlink(file);
+        return -1;
+    }
+    
+    // The running maximum carries across segments
+    uint64_t max_timestamp_ns = number > log->oldest_segment
+        ? segment_slot(log, number - 1)->header->max_timestamp_ns : 0;
+    // At max_segments the oldest makes room (and frees its ring slot)
+    if (number - log->oldest_segment >= log->config.max_segments) retire_segment(log);
+    
+    telemetry_segment_header_t* header = (telemetry_segment_header_t*)map;
+    header->version = TELEMETRY_LOG_VERSION;
+    header->record_size = sizeof(telemetry_record_t);
+    header->first_record = first_record;
+    header->capacity = capacity;
+    header->header_size = (uint32_t)header_size;
+    header->index_interval = log->config.index_interval;
+    header->max_timestamp_ns = max_timestamp_ns;
+    __atomic_store_n(&header->magic, TELEMETRY_LOG_MAGIC, __ATOMIC_RELEASE);
+    
+    set_segment_pointers(segment_slot(log, number), map, map_size);
+    __atomic_store_n(&log->end_segment, number + 1, __ATOMIC_RELEASE);
+    log->stats.segments_created++;
+    return 0;
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// First record numbers of the segment files under path, sorted. Returns
+// the count or -1.
+static long list_segments(const char* path, uint64_t* firsts, size_t max_firsts) {
+    DIR* dir = opendir(path);
+    if (!dir) return -1;
+    
+    size_t count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        unsigned long long first;
+        char suffix[8];
+        if (sscanf(entry->d_name, "segment-%20llu.%7s", &first, suffix) == 2 &&
+            strcmp(suffix, "log") == 0 && count < max_firsts) {
+            firsts[count++] = first;
+        }
+    }
+    closedir(dir);
+    
+    qsort(firsts, count, sizeof(uint64_t), compare_u64);
+    return (long)count;
+}
+
+// First record number of the oldest segment file under path
+static int find_oldest_segment(const char* path, uint64_t* oldest) {
+    uint64_t* firsts = (uint64_t*)malloc(TELEMETRY_LOG_MAX_SEGMENTS * sizeof(uint64_t));
+    long found = firsts ? list_segments(path, firsts, TELEMETRY_LOG_MAX_SEGMENTS) : -1;
+    if (found > 0) *oldest = firsts[0];
+    free(firsts);
+    return found > 0 ? 0 : -1;
+}
+
+static int open_directory(telemetry_log_t* log) {
+    char file[TELEMETRY_LOG_PATH_SIZE + 16];
+    snprintf(file, sizeof(file), "%s/%s", log->path, TELEMETRY_LOG_DIRECTORY_FILE);
+    
+    int fd = open(file, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return -1;
+    
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        return -1;
+    }
+    
+    int created = info.st_size == 0;
+    size_t map_size = created
+        ? round_to_page(sizeof(telemetry_directory_header_t) +
+                        (size_t)log->config.max_drones * sizeof(telemetry_drone_entry_t))
+        : (size_t)info.st_size;
+    if (created && ftruncate(fd, (off_t)map_size) != 0) {
+        close(fd);
+        return -1;
+    }
+    void* map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+    
+    telemetry_directory_header_t* directory = (telemetry_directory_header_t*)map;
+    if (created) {
+        directory->version = TELEMETRY_LOG_VERSION;
+        directory->capacity = log->config.max_drones;
+        __atomic_store_n(&directory->magic, TELEMETRY_LOG_MAGIC, __ATOMIC_RELEASE);
+    } else if (directory->magic != TELEMETRY_LOG_MAGIC ||
+               directory->version != TELEMETRY_LOG_VERSION ||
+               sizeof(telemetry_directory_header_t) +
+               (size_t)directory->capacity * sizeof(telemetry_drone_entry_t) > map_size ||
+               directory->count > directory->capacity) {
+        LOG_WARN("Telemetry log: bad directory %s", file);
+        munmap(map, map_size);
+        return -1;
+    }
+    
+    log->directory = directory;
+    log->drones = (telemetry_drone_entry_t*)(directory + 1);
+    log->directory_size = map_size;
+    log->config.max_drones = directory->capacity;
+    return 0;
+}
+
+// Caller holds log->lock (or is opening the log)
+static telemetry_drone_entry_t* find_drone(telemetry_log_t* log, const char* drone_id,
+                                           int create) {
+    long entry = drone_index_find(&log->index, drone_id);
+    if (entry >= 0) return &log->drones[entry];
+    
+    if (!create || log->directory->count >= log->directory->capacity) return NULL;
+    
+    telemetry_drone_entry_t* drone = &log->drones[log->directory->count];
+    memset(drone, 0, sizeof(telemetry_drone_entry_t));
+    strncpy(drone->drone_id, drone_id, MAX_DRONE_ID - 1);
+    drone->last_record = TELEMETRY_LOG_NONE;
+    drone_index_insert(&log->index, log->directory->count);
+    // Readers check slots against count, so the entry goes first
+    __atomic_store_n(&log->directory->count, log->directory->count + 1, __ATOMIC_RELEASE);
+    return drone;
+}
+
+// Segment holding record_number, NULL if outside segments [oldest, end)
+static telemetry_segment_t* segment_of(telemetry_log_t* log, uint64_t oldest, uint64_t end,
+                                       uint64_t record_number) {
+    uint64_t number = record_number / log->config.segment_records;
+    return number >= oldest && number < end ? segment_slot(log, number) : NULL;
+}
+
+// Bring the directory up to date with records committed after it was last
+// written (the writer stopped between the two)
+static void recover_directory(telemetry_log_t* log) {
+    uint64_t oldest = log->oldest_segment * log->config.segment_records;
+    uint64_t applied = log->directory->applied;
+    if (applied < oldest) applied = oldest;
+    
+    // Entries ahead of the segments can only come from a lost page;
+    // walk them back to committed records
+    for (uint32_t slot = 0; slot < log->directory->count; slot++) {
+        telemetry_drone_entry_t* drone = &log->drones[slot];
+        while (drone->last_record != TELEMETRY_LOG_NONE && drone->last_record >= log->next_record) {
+            telemetry_segment_t* segment = segment_of(log, log->oldest_segment, log->end_segment,
+                                                      drone->last_record);
+            drone->last_record = segment
+                ? segment->records[drone->last_record - segment->header->first_record].previous
+                : TELEMETRY_LOG_NONE;
+            if (drone->records > 0) drone->records--;
+        }
+    }
+    
+    for (uint64_t number = applied; number < log->next_record; number++) {
+        telemetry_segment_t* segment = segment_of(log, log->oldest_segment, log->end_segment,
+                                                  number);
+        const telemetry_record_t* record = &segment->records[number - segment->header->first_record];
+        if (record->drone >= log->directory->count) continue;
+        
+        telemetry_drone_entry_t* drone = &log->drones[record->drone];
+        if (drone->last_record != TELEMETRY_LOG_NONE && drone->last_record >= number) continue;
+        drone->last_record = number;
+        drone->records++;
+        log->stats.recovered++;
+    }
+    log->directory->applied = log->next_record;
+    
+    if (log->stats.recovered > 0) {
+        LOG_INFO("Telemetry log: replayed %lu records into the directory", log->stats.recovered);
+    }
+}
+
+void telemetry_log_default_config(telemetry_log_config_t* config) {
+    if (!config) return;
+    
+    config->segment_records = TELEMETRY_LOG_DEFAULT_SEGMENT_RECORDS;
+    config->index_interval = TELEMETRY_LOG_DEFAULT_INDEX_INTERVAL;
+    config->max_drones = TELEMETRY_LOG_DEFAULT_MAX_DRONES;
+    config->max_skew_ns = TELEMETRY_LOG_DEFAULT_MAX_SKEW_NS;
+    config->max_segments = TELEMETRY_LOG_MAX_SEGMENTS;
+}
+
+telemetry_log_t* telemetry_log_open(const char* path, const telemetry_log_config_t* config) {
+    if (!path || strlen(path) >= TELEMETRY_LOG_PATH_SIZE) return NULL;
+    
+    telemetry_log_t* log = (telemetry_log_t*)calloc(1, sizeof(telemetry_log_t));
+    if (!log) return NULL;
+    
+    strcpy(log->path, path);
+    if (config) {
+        log->config = *config;
+    } else {
+        telemetry_log_default_config(&log->config);
+    }
+    if (log->config.segment_records == 0 || log->config.index_interval == 0 ||
+        log->config.max_drones == 0 || log->config.max_segments < TELEMETRY_LOG_MIN_SEGMENTS ||
+        log->config.max_segments > TELEMETRY_LOG_MAX_SEGMENTS) {
+        free(log);
+        return NULL;
+    }
+    
+    if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+        free(log);
+        return NULL;
+    }
+    
+    uint64_t* firsts = (uint64_t*)malloc(TELEMETRY_LOG_MAX_SEGMENTS * sizeof(uint64_t));
+    long found = firsts ? list_segments(path, firsts, TELEMETRY_LOG_MAX_SEGMENTS) : -1;
+    if (found < 0) {
+        free(firsts);
+        free(log);
+        return NULL;
+    }
+    
+    int ok = 1;
+    for (long i = 0; i < found && ok; i++) {
+        char file[TELEMETRY_LOG_PATH_SIZE + 48];
+        segment_path(file, sizeof(file), path, firsts[i]);
+        telemetry_segment_t segment;
+        ok = map_segment(file, 1, &segment) == 0;
+        if (!ok) break;
+        
+        // An existing log keeps the geometry it was written with
+        uint64_t capacity = segment.header->capacity;
+        uint64_t number = firsts[i] / capacity;
+        if (i == 0) log->oldest_segment = log->end_segment = number;
+        ok = segment.header->first_record == firsts[i] && firsts[i] % capacity == 0 &&
+             number == log->end_segment && (i == 0 || capacity == log->config.segment_records);
+        if (!ok) {
+            unmap_segment(&segment);
+            break;
+        }
+        log->config.segment_records = capacity;
+        log->config.index_interval = segment.header->index_interval;
+        *segment_slot(log, number) = segment;
+        log->end_segment++;
+    }
+    free(firsts);
+    
+    if (ok && log->end_segment == 0) {
+        ok = create_segment(log) == 0;
+    }
+    while (ok && log->end_segment - log->oldest_segment > log->config.max_segments) {
+        retire_segment(log);
+    }
+    if (ok) {
+        const telemetry_segment_header_t* last = segment_slot(log, log->end_segment - 1)->header;
+        log->next_record = last->first_record + last->committed;
+        ok = open_directory(log) == 0;
+    }
+    
+    if (ok) {
+        ok = drone_index_init(&log->index, log->config.max_drones, log->drones,
+                              sizeof(telemetry_drone_entry_t),
+                              offsetof(telemetry_drone_entry_t, drone_id)) == 0;
+    }
+    if (!ok) {
+        LOG_WARN("Telemetry log: cannot open %s", path);
+        telemetry_log_close(log);
+        return NULL;
+    }
+    
+    for (uint32_t slot = 0; slot < log->directory->count; slot++) {
+        drone_index_insert(&log->index, slot);
+    }
+    recover_directory(log);
+    
+    pthread_mutex_init(&log->lock, NULL);
+    LOG_INFO("Telemetry log %s: %llu records, %u drones", path,
+             (unsigned long long)log->next_record, log->directory->count);
+    return log;
+}
+
+int telemetry_log_append(telemetry_log_t* log, const char* drone_id,
+                         const telemetry_record_t* record, uint64_t received_ns,
+                         uint64_t* record_number) {
+    if (!log || !drone_id || !record) return -1;
+    
+    pthread_mutex_lock(&log->lock);
+    telemetry_drone_entry_t* drone = find_drone(log, drone_id, 1);
+    if (!drone) {
+        log->stats.rejected++;
+        pthread_mutex_unlock(&log->lock);
+        return -1;
+    }
+    
+    telemetry_segment_t* segment = segment_slot(log, log->end_segment - 1);
+    telemetry_segment_header_t* header = segment->header;
+    if (header->committed == header->capacity) {
+        if (create_segment(log) != 0) {
+            log->stats.rejected++;
+            pthread_mutex_unlock(&log->lock);
+            return -1;
+        }
+        __atomic_store_n(&header->sealed, 1, __ATOMIC_RELEASE);
+        msync(segment->header, segment->map_size, MS_ASYNC);
+        segment = segment_slot(log, log->end_segment - 1);
+        header = segment->header;
+    }
+    
+    uint64_t number = log->next_record;
+    uint64_t slot = header->committed;
+    telemetry_record_t* destination = &segment->records[slot];
+    *destination = *record;
+    destination->drone = (uint32_t)(drone - log->drones);
+    destination->previous = drone->last_record;
+    
+    // Only timestamps near the receive time reach the index
+    uint64_t skew_ns = log->config.max_skew_ns;
+    if (record->timestamp_ns > saturating_add(received_ns, skew_ns) ||
+        (received_ns > skew_ns && record->timestamp_ns < received_ns - skew_ns)) {
+        destination->timestamp_ns = received_ns;
+        destination->flags |= TELEMETRY_RECORD_CLAMPED;
+        log->stats.clamped++;
+    }
+    if (destination->timestamp_ns > header->max_timestamp_ns) {
+        header->max_timestamp_ns = destination->timestamp_ns;
+    }
+    if (slot % header->index_interval == 0) {
+        telemetry_index_entry_t* entry = &segment->index[header->index_count];
+        entry->max_timestamp_ns = header->max_timestamp_ns;
+        entry->record = number;
+        header->index_count++;
+    }
+    __atomic_store_n(&header->committed, slot + 1, __ATOMIC_RELEASE);
+    
+    __atomic_store_n(&drone->last_record, number, __ATOMIC_RELEASE);
+    drone->records++;
+    log->directory->applied = number + 1;
+    log->next_record = number + 1;
+    log->stats.appended++;
+    pthread_mutex_unlock(&log->lock);
+    
+    if (record_number) *record_number = number;
+    return 0;
+}
+
+int telemetry_log_append_status(telemetry_log_t* log, const status_update_message_t* status,
+                                uint64_t received_ns) {
+    if (!status) return -1;
+    
+    telemetry_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.timestamp_ns = status->header.timestamp;
+    record.state = (int16_t)status->state;
+    record.construction_progress = (uint8_t)(status->construction_progress < 0 ? 0
+                                   : status->construction_progress > 100 ? 100
+                                   : status->construction_progress);
+    record.x = status->x;
+    record.y = status->y;
+    record.z = status->z;
+    record.vx = (float)status->vx;
+    record.vy = (float)status->vy;
+    record.vz = (float)status->vz;
+    record.battery_level = (float)status->battery_level;
+    
+    char drone_id[MAX_DRONE_ID];
+    memcpy(drone_id, status->header.drone_id, MAX_DRONE_ID);
+    drone_id[MAX_DRONE_ID - 1] = '\0';
+    return telemetry_log_append(log, drone_id, &record, received_ns, NULL);
+}
+
+// Committed records are immutable and a segment keeps its slot until it
+// is retired, so lookups need only the published counts
+const telemetry_record_t* telemetry_log_record(telemetry_log_t* log, uint64_t record_number) {
+    if (!log) return NULL;
+    
+    uint64_t oldest, end;
+    load_segment_range(log, &oldest, &end);
+    telemetry_segment_t* segment = segment_of(log, oldest, end, record_number);
+    if (!segment) return NULL;
+    
+    uint64_t slot = record_number - segment->header->first_record;
+    if (slot >= __atomic_load_n(&segment->header->committed, __ATOMIC_ACQUIRE)) return NULL;
+    return &segment->records[slot];
+}
+
+const char* telemetry_log_drone_id(telemetry_log_t* log, uint32_t drone) {
+    if (!log || drone >= __atomic_load_n(&log->directory->count, __ATOMIC_ACQUIRE)) return NULL;
+    return log->drones[drone].drone_id;
+}
+
+int telemetry_log_query_drone(telemetry_log_t* log, const char* drone_id,
+                              uint64_t from_ns, uint64_t to_ns,
+                              const telemetry_record_t** records, size_t max_records) {
+    if (!log || !drone_id || (!records && max_records > 0)) return -1;
+    
+    pthread_mutex_lock(&log->lock);
+    telemetry_drone_entry_t* drone = find_drone(log, drone_id, 0);
+    uint64_t number = drone ? drone->last_record : TELEMETRY_LOG_NONE;
+    pthread_mutex_unlock(&log->lock);
+    if (!drone) return -1;
+    
+    // Newest first along the back-chain; an older record can be up to
+    // twice max_skew_ns later than a newer one, so stop only past that
+    uint64_t disorder_ns = saturating_add(log->config.max_skew_ns, log->config.max_skew_ns);
+    uint64_t floor_ns = from_ns > disorder_ns ? from_ns - disorder_ns : 0;
+    size_t count = 0;
+    while (number != TELEMETRY_LOG_NONE && count < max_records) {
+        const telemetry_record_t* record = telemetry_log_record(log, number);
+        if (!record || record->timestamp_ns < floor_ns) break;
+        if (record->timestamp_ns >= from_ns && record->timestamp_ns <= to_ns) {
+            records[count++] = record;
+        }
+        number = record->previous;
+    }
+    
+    for (size_t i = 0; i < count / 2; i++) {
+        const telemetry_record_t* swap = records[i];
+        records[i] = records[count - 1 - i];
+        records[count - 1 - i] = swap;
+    }
+    return (int)count;
+}
+
+// First record that can hold timestamps >= from_ns: the last index entry
+// whose running maximum is still below from_ns bounds everything before it
+// Caller holds log->lock
+static uint64_t seek_time(telemetry_log_t* log, uint64_t from_ns) {
+    uint64_t oldest = log->oldest_segment;
+    uint64_t start = oldest * log->config.segment_records;
+    
+    uint64_t low = 0, high = log->end_segment - oldest;
+    while (low < high) {
+        uint64_t middle = low + (high - low) / 2;
+        const telemetry_segment_t* segment = segment_slot(log, oldest + middle);
+        if (__atomic_load_n(&segment->header->committed, __ATOMIC_ACQUIRE) > 0 &&
+            segment->index[0].max_timestamp_ns < from_ns) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == 0) return start;
+    
+    const telemetry_segment_t* segment = segment_slot(log, oldest + low - 1);
+    size_t entries = __atomic_load_n(&segment->header->committed, __ATOMIC_ACQUIRE) == 0 ? 0
+                   : (size_t)((segment->header->committed - 1) / segment->header->index_interval + 1);
+    low = 0;
+    high = entries;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (segment->index[middle].max_timestamp_ns < from_ns) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low == 0 ? segment->header->first_record : segment->index[low - 1].record;
+}
+
+long telemetry_log_query_range(telemetry_log_t* log, uint64_t from_ns, uint64_t to_ns,
+                               telemetry_visitor_t visitor, void* user_data) {
+    if (!log || !visitor || from_ns > to_ns) return 0;
+    
+    pthread_mutex_lock(&log->lock);
+    uint64_t end_segment = log->end_segment;
+    uint64_t end = log->next_record;
+    uint64_t number = seek_time(log, from_ns);
+    pthread_mutex_unlock(&log->lock);
+    
+    uint64_t stop_ns = saturating_add(to_ns, saturating_add(log->config.max_skew_ns,
+                                                            log->config.max_skew_ns));
+    long visited = 0;
+    while (number < end) {
+        // Segments retired since the seek are skipped, not read
+        uint64_t oldest = __atomic_load_n(&log->oldest_segment, __ATOMIC_ACQUIRE);
+        const telemetry_segment_t* segment = segment_of(log, oldest, end_segment, number);
+        if (!segment) {
+            number = oldest * log->config.segment_records;
+            continue;
+        }
+        uint64_t first = segment->header->first_record;
+        uint64_t last = first + segment->header->capacity;
+        if (last > end) last = end;
+        
+        for (; number < last; number++) {
+            const telemetry_record_t* record = &segment->records[number - first];
+            if (record->timestamp_ns > stop_ns) return visited;
+            if (record->timestamp_ns < from_ns || record->timestamp_ns > to_ns) continue;
+            visited++;
+            if (visitor(number, record, user_data) != 0) return visited;
+        }
+    }
+    return visited;
+}
+
+uint64_t telemetry_log_size(telemetry_log_t* log) {
+    if (!log) return 0;
+    
+    pthread_mutex_lock(&log->lock);
+    uint64_t size = log->next_record;
+    pthread_mutex_unlock(&log->lock);
+    return size;
+}
+
+int telemetry_log_sync(telemetry_log_t* log, int wait) {
+    if (!log) return -1;
+    
+    int flags = wait ? MS_SYNC : MS_ASYNC;
+    pthread_mutex_lock(&log->lock);
+    // Older segments were scheduled for writeback when they sealed
+    telemetry_segment_t* segment = segment_slot(log, log->end_segment - 1);
+    int result = msync(segment->header, segment->map_size, flags);
+    if (msync(log->directory, log->directory_size, flags) != 0) result = -1;
+    pthread_mutex_unlock(&log->lock);
+    
+    return result == 0 ? 0 : -1;
+}
+
+void telemetry_log_get_stats(telemetry_log_t* log, telemetry_log_stats_t* stats) {
+    if (!log || !stats) return;
+    
+    pthread_mutex_lock(&log->lock);
+    *stats = log->stats;
+    pthread_mutex_unlock(&log->lock);
+}
+
+void telemetry_log_close(telemetry_log_t* log) {
+    if (!log) return;
+    
+    for (uint64_t number = log->oldest_segment; number < log->end_segment; number++) {
+        unmap_segment(segment_slot(log, number));
+    }
+    if (log->directory) munmap(log->directory, log->directory_size);
+    drone_index_free(&log->index);
+    pthread_mutex_destroy(&log->lock);
+    free(log);
+}
+
+static void reader_map_directory(telemetry_reader_t* reader) {
+    char file[TELEMETRY_LOG_PATH_SIZE + 16];
+    snprintf(file, sizeof(file), "%s/%s", reader->path, TELEMETRY_LOG_DIRECTORY_FILE);
+    
+    int fd = open(file, O_RDONLY);
+    if (fd < 0) return;
+    
+    struct stat info;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(telemetry_directory_header_t)) {
+        void* map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (map != MAP_FAILED) {
+            reader->directory = (const telemetry_directory_header_t*)map;
+            reader->drones = (const telemetry_drone_entry_t*)(reader->directory + 1);
+            reader->directory_size = (size_t)info.st_size;
+        }
+    }
+    close(fd);
+}
+
+// Map the segment holding reader->position, moving up to the oldest
+// retained record if that segment was retired; -1 if it does not exist yet
+static int reader_map_position(telemetry_reader_t* reader) {
+    for (int attempt = 0; attempt < 2; attempt++) {
+        char file[TELEMETRY_LOG_PATH_SIZE + 48];
+        segment_path(file, sizeof(file), reader->path,
+                     reader->position - reader->position % reader->capacity);
+        
+        if (map_segment(file, 0, &reader->segment) == 0) {
+            // A segment still being initialised has no magic yet
+            if (__atomic_load_n(&reader->segment.header->magic, __ATOMIC_ACQUIRE) ==
+                TELEMETRY_LOG_MAGIC) {
+                return 0;
+            }
+            unmap_segment(&reader->segment);
+            return -1;
+        }
+        
+        uint64_t oldest;
+        if (find_oldest_segment(reader->path, &oldest) != 0 || oldest <= reader->position) {
+            return -1;
+        }
+        reader->skipped += oldest - reader->position;
+        reader->position = oldest;
+    }
+    return -1;
+}
+
+telemetry_reader_t* telemetry_reader_open(const char* path, uint64_t start) {
+    if (!path || strlen(path) >= TELEMETRY_LOG_PATH_SIZE) return NULL;
+    
+    uint64_t oldest;
+    if (find_oldest_segment(path, &oldest) != 0) return NULL;
+    
+    telemetry_reader_t* reader = (telemetry_reader_t*)calloc(1, sizeof(telemetry_reader_t));
+    if (!reader) return NULL;
+    strcpy(reader->path, path);
+    
+    // The oldest segment gives the geometry
+    char file[TELEMETRY_LOG_PATH_SIZE + 48];
+    segment_path(file, sizeof(file), path, oldest);
+    if (map_segment(file, 0, &reader->segment) != 0) {
+        free(reader);
+        return NULL;
+    }
+    reader->capacity = reader->segment.header->capacity;
+    reader->position = start > oldest ? start : oldest;
+    if (reader->position >= oldest + reader->capacity) {
+        // Mapped on the first call to next if it does not exist yet
+        unmap_segment(&reader->segment);
+        reader_map_position(reader);
+    }
+    reader_map_directory(reader);
+    return reader;
+}
+
+const telemetry_record_t* telemetry_reader_next(telemetry_reader_t* reader,
+                                                uint64_t* record_number) {
+    if (!reader) return NULL;
+    
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if (!reader->segment.header && reader_map_position(reader) != 0) return NULL;
+        
+        const telemetry_segment_header_t* header = reader->segment.header;
+        uint64_t slot = reader->position - header->first_record;
+        if (slot < __atomic_load_n(&header->committed, __ATOMIC_ACQUIRE)) {
+            if (record_number) *record_number = reader->position;
+            reader->position++;
+            return &reader->segment.records[slot];
+        }
+        if (slot < header->capacity) return NULL;
+        
+        // Segment exhausted: move on to the next file
+        unmap_segment(&reader->segment);
+    }
+    return NULL;
+}
+
+const char* telemetry_reader_drone_id(telemetry_reader_t* reader, uint32_t drone) {
+    if (!reader) return NULL;
+    if (!reader->directory) reader_map_directory(reader);
+    if (!reader->directory) return NULL;
+    
+    uint32_t count = __atomic_load_n(&reader->directory->count, __ATOMIC_ACQUIRE);
+    if (drone >= count ||
+        sizeof(telemetry_directory_header_t) + (size_t)(drone + 1) * sizeof(telemetry_drone_entry_t)
+        > reader->directory_size) {
+        return NULL;
+    }
+    return reader->drones[drone].drone_id;
+}
+
+void telemetry_reader_close(telemetry_reader_t* reader) {
+    if (!reader) return;
+    
+    if (reader->segment.header) unmap_segment(&reader->segment);
+    if (reader->directory) munmap((void*)reader->directory, reader->directory_size);
+    free(reader);
+}
@@ -0,0 +1,237 @@
+// src/storage/telemetry_log.h
+#ifndef TELEMETRY_LOG_H
+#define TELEMETRY_LOG_H
+
+#include "common.h"
+#include "../protocols/message_protocol.h"
+#include "../core/drone_index.h"
+#include <stdint.h>
+
+// Append-only telemetry store.
+//
+// A log is a directory of segment files, each preallocated for a fixed
+// number of 64-byte records and memory-mapped, plus a drone directory
+// file. Appending is a hash lookup and a 64-byte store into the mapping;
+// nothing is written through the page cache by hand and nothing is
+// allocated until a segment fills and the next one is created. Records
+// are numbered from 0 across the whole log, so a record number maps to
+// (segment, slot) by division.
+//
+// Each record carries the number of the same drone's previous record, and
+// the directory holds every drone's latest record, so a drone's history is
+// a back-chain walk that never touches other drones' records. Each segment
+// header holds a sparse time index: every index_interval records, the
+// record number and the highest timestamp seen up to it. That running
+// maximum only grows even when drones' clocks disagree, so a time range
+// starts with two binary searches (segment, then index entry) instead of
+// a scan.
+//
+// Timestamps come from the drones, so they are checked against the time
+// the caller received the report: one more than max_skew_ns away from it
+// is replaced by the receive time and the record flagged
+// TELEMETRY_RECORD_CLAMPED. A drone with a bad clock (or a forged report)
+// therefore cannot push the running maximum past the rest of the fleet.
+// As receive times follow log order, two records in the log disagree by
+// at most twice max_skew_ns, and range scans stop once timestamps pass the
+// end of the range by that much. A wall clock stepping back by more than
+// that can still end a scan early.
+//
+// The writer publishes a record by storing the segment's committed count
+// with release ordering after the record is written, and updates the
+// directory after that; on open, records past the directory's applied
+// count are replayed into it. Readers in any process map the same files
+// read-only and follow the committed count, getting pointers straight into
+// the mapping. Queries in the writing process take the lock only to find
+// their starting point, so a long scan does not hold up appends.
+//
+// The log keeps at most max_segments segments. Creating one more first
+// retires the oldest: it is unmapped and its file unlinked, and its
+// records read as no longer retained. A record pointer from this process
+// stays valid only until its segment is retired, so a query must finish
+// before max_segments - 1 further segments fill. Readers in other
+// processes keep their mapping of an unlinked file and skip ahead to the
+// oldest retained record when they move on.
+
+#define TELEMETRY_LOG_MAGIC 0x474f4c4d454c4554ULL   // "TELEMLOG"
+#define TELEMETRY_LOG_VERSION 1
+#define TELEMETRY_LOG_NONE UINT64_MAX
+#define TELEMETRY_LOG_DEFAULT_SEGMENT_RECORDS (1u << 20)    // 64 MB segments
+#define TELEMETRY_LOG_DEFAULT_INDEX_INTERVAL 1024
+#define TELEMETRY_LOG_DEFAULT_MAX_DRONES 65536
+#define TELEMETRY_LOG_DEFAULT_MAX_SKEW_NS (5ULL * 1000000000ULL)
+#define TELEMETRY_LOG_MAX_SEGMENTS 4096                     // 256 GB at the default size
+#define TELEMETRY_LOG_MIN_SEGMENTS 2                        // The open one and the one it follows
+#define TELEMETRY_LOG_PATH_SIZE 256
+
+#define TELEMETRY_RECORD_CLAMPED 0x01   // timestamp_ns is the receive time
+
+// One status update, one cache line
+typedef struct {
+    uint64_t timestamp_ns;      // Sender's clock, ns since the epoch (see CLAMPED)
+    uint64_t previous;          // Same drone's previous record, or TELEMETRY_LOG_NONE
+    uint32_t drone;             // Slot in the drone directory
+    int16_t state;              // drone_state_t
+    uint8_t construction_progress;
+    uint8_t flags;
+    double x, y, z;
+    float vx, vy, vz;
+    float battery_level;
+} telemetry_record_t;
+
+typedef struct {
+    uint64_t max_timestamp_ns;  // Highest timestamp in records [0, record]
+    uint64_t record;
+} telemetry_index_entry_t;
+
+// First page(s) of every segment file; index entries follow the header
+typedef struct {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t first_record;
+    uint64_t capacity;          // Records per segment
+    uint32_t header_size;       // Offset of the first record
+    uint32_t index_interval;
+    uint64_t committed;         // Records published; written with release ordering
+    uint64_t max_timestamp_ns;  // Running maximum through committed
+    uint32_t index_count;
+    uint32_t sealed;            // Full; the next segment exists
+} telemetry_segment_header_t;
+
+typedef struct {
+    char drone_id[MAX_DRONE_ID];
+    uint64_t last_record;
+    uint64_t records;
+} telemetry_drone_entry_t;
+
+typedef struct {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t capacity;          // Drone entries that follow
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t applied;           // Records reflected in the entries
+} telemetry_directory_header_t;
+
+typedef struct {
+    telemetry_segment_header_t* header;
+    telemetry_index_entry_t* index;
+    telemetry_record_t* records;
+    size_t map_size;
+} telemetry_segment_t;
+
+typedef struct {
+    uint64_t segment_records;
+    uint32_t index_interval;
+    uint32_t max_drones;
+    uint64_t max_skew_ns;
+    uint32_t max_segments;          // Retained; MIN_SEGMENTS to MAX_SEGMENTS
+} telemetry_log_config_t;
+
+typedef struct {
+    unsigned long appended;
+    unsigned long rejected;         // Directory full
+    unsigned long clamped;          // Timestamps replaced by the receive time
+    unsigned long segments_created;
+    unsigned long segments_retired;
+    unsigned long recovered;        // Records replayed into the directory on open
+} telemetry_log_stats_t;
+
+typedef struct {
+    char path[TELEMETRY_LOG_PATH_SIZE];
+    telemetry_log_config_t config;
+    telemetry_segment_t segments[TELEMETRY_LOG_MAX_SEGMENTS];   // Ring, by segment number
+    uint64_t oldest_segment;        // Segment numbers [oldest, end) are mapped;
+    uint64_t end_segment;           // both published with release ordering
+    uint64_t next_record;
+    
+    telemetry_directory_header_t* directory;
+    telemetry_drone_entry_t* drones;
+    size_t directory_size;
+    drone_index_t index;            // drone_id -> directory slot
+    
+    telemetry_log_stats_t stats;
+    pthread_mutex_t lock;
+} telemetry_log_t;
+
+// Follows a log through its mappings, in this or another process
+typedef struct {
+    char path[TELEMETRY_LOG_PATH_SIZE];
+    telemetry_segment_t segment;    // Mapped read-only; unmapped while waiting for the next file
+    uint64_t capacity;              // Records per segment
+    uint64_t position;              // Next record to return
+    uint64_t skipped;               // Records retired before the reader got to them
+    const telemetry_directory_header_t* directory;
+    const telemetry_drone_entry_t* drones;
+    size_t directory_size;
+} telemetry_reader_t;
+
+// Called for each record of a range query; return nonzero to stop
+typedef int (*telemetry_visitor_t)(uint64_t record_number, const telemetry_record_t* record,
+                                   void* user_data);
+
+// Fill a configuration with the defaults above
+void telemetry_log_default_config(telemetry_log_config_t* config);
+
+// Open the log in directory path, creating it if needed (config may be
+// NULL). An existing log keeps its own segment size and directory capacity;
+// segments beyond max_segments are retired straight away.
+telemetry_log_t* telemetry_log_open(const char* path, const telemetry_log_config_t* config);
+
+// Append a record for drone_id received at received_ns (wall clock, ns
+// since the epoch); record->drone and ->previous are filled in and the
+// timestamp clamped as above. Returns 0 with the record's number in
+// *record_number (may be NULL), or -1.
+int telemetry_log_append(telemetry_log_t* log, const char* drone_id,
+                         const telemetry_record_t* record, uint64_t received_ns,
+                         uint64_t* record_number);
+
+// Append a MSG_STATUS_UPDATE received at received_ns
+int telemetry_log_append_status(telemetry_log_t* log, const status_update_message_t* status,
+                                uint64_t received_ns);
+
+// Record by number, NULL if not yet written or no longer retained
+const telemetry_record_t* telemetry_log_record(telemetry_log_t* log, uint64_t record_number);
+
+// Drone ID of a directory slot, NULL if unknown
+const char* telemetry_log_drone_id(telemetry_log_t* log, uint32_t drone);
+
+// A drone's records with from_ns <= timestamp <= to_ns, oldest first, via
+// its back-chain. Fills at most max_records (the newest ones) and returns
+// the count, or -1 for an unknown drone.
+int telemetry_log_query_drone(telemetry_log_t* log, const char* drone_id,
+                              uint64_t from_ns, uint64_t to_ns,
+                              const telemetry_record_t** records, size_t max_records);
+
+// Visit every record with from_ns <= timestamp <= to_ns, in log order.
+// Returns the number visited.
+long telemetry_log_query_range(telemetry_log_t* log, uint64_t from_ns, uint64_t to_ns,
+                               telemetry_visitor_t visitor, void* user_data);
+
+// Number of records appended so far
+uint64_t telemetry_log_size(telemetry_log_t* log);
+
+// Flush mappings to disk (wait 0: schedule only)
+int telemetry_log_sync(telemetry_log_t* log, int wait);
+
+// Snapshot counters
+void telemetry_log_get_stats(telemetry_log_t* log, telemetry_log_stats_t* stats);
+
+// Unmap everything and free the log; files stay on disk
+void telemetry_log_close(telemetry_log_t* log);
+
+// Start following the log at path from record start
+telemetry_reader_t* telemetry_reader_open(const char* path, uint64_t start);
+
+// Next committed record, or NULL when caught up with the writer.
+// The pointer stays valid until the reader moves past its segment.
+const telemetry_record_t* telemetry_reader_next(telemetry_reader_t* reader,
+                                                uint64_t* record_number);
+
+// Drone ID of a directory slot, NULL if unknown
+const char* telemetry_reader_drone_id(telemetry_reader_t* reader, uint32_t drone);
+
+// Unmap and free the reader
+void telemetry_reader_close(telemetry_reader_t* reader);
+
+#endif
@@ -0,0 +1,22 @@
+// tests/test.h
+// Minimal assertion helpers for the unit tests under tests/. Each test
+// program counts failed checks and exits nonzero if there were any.
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+
+static int test_failures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+        test_failures++; \
+    } \
+} while (0)
+
+// Print the outcome and give main its exit status
+#define TEST_RESULT(name) \
+    (printf("%s: %s\n", name, test_failures ? "FAILED" : "ok"), test_failures ? 1 : 0)
+
+#endif
@@ -0,0 +1,136 @@
+// tests/test_aead.c
+// ChaCha20-Poly1305 against the RFC 8439 section 2.8.2 AEAD vector, a
+// tampered frame, the batch path, and HChaCha20 against the test vector
+// of draft-irtf-cfrg-xchacha section 2.2.1.
+#include "../src/security/aead.h"
+#include "test.h"
+#include <string.h>
+
+static const char plaintext[] =
+    "Ladies and Gentlemen of the class of '99: If I could offer you only one "
+    "tip for the future, sunscreen would be it.";
+
+static const unsigned char aad[12] = {
+    0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7
+};
+
+static const unsigned char nonce[AEAD_NONCE_SIZE] = {
+    0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47
+};
+
+static const unsigned char ciphertext[114] = {
+    0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+    0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+    0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+    0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+    0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+    0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+    0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+    0x61, 0x16
+};
+
+static const unsigned char tag[AEAD_TAG_SIZE] = {
+    0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91
+};
+
+static void make_key(aead_key_t* schedule) {
+    unsigned char key[AEAD_KEY_SIZE];
+    for (int i = 0; i < AEAD_KEY_SIZE; i++) {
+        key[i] = (unsigned char)(0x80 + i);
+    }
+    aead_key_init(schedule, key);
+}
+
+static void test_seal_vector(void) {
+    aead_key_t key;
+    make_key(&key);
+    
+    unsigned char data[sizeof(ciphertext)];
+    unsigned char sealed_tag[AEAD_TAG_SIZE];
+    CHECK(sizeof(plaintext) - 1 == sizeof(ciphertext));
+    memcpy(data, plaintext, sizeof(data));
+    aead_seal_in_place(&key, nonce, aad, sizeof(aad), data, sizeof(data), sealed_tag);
+    CHECK(memcmp(data, ciphertext, sizeof(ciphertext)) == 0);
+    CHECK(memcmp(sealed_tag, tag, sizeof(tag)) == 0);
+    
+    CHECK(aead_open_in_place(&key, nonce, aad, sizeof(aad), data, sizeof(data), tag) == 0);
+    CHECK(memcmp(data, plaintext, sizeof(data)) == 0);
+}
+
+static void test_tampered(void) {
+    aead_key_t key;
+    make_key(&key);
+    
+    // Flipping one bit of the ciphertext or the associated data fails the tag
+    unsigned char data[sizeof(ciphertext)];
+    memcpy(data, ciphertext, sizeof(data));
+    data[57] ^= 0x01;
+    CHECK(aead_open_in_place(&key, nonce, aad, sizeof(aad), data, sizeof(data), tag) == -1);
+    
+    unsigned char other_aad[sizeof(aad)];
+    memcpy(other_aad, aad, sizeof(aad));
+    other_aad[0] ^= 0x80;
+    memcpy(data, ciphertext, sizeof(data));
+    CHECK(aead_open_in_place(&key, nonce, other_aad, sizeof(aad), data, sizeof(data), tag) == -1);
+}
+
+static void test_batch(void) {
+    aead_key_t key;
+    make_key(&key);
+    
+    // Mixed lengths so lanes finish at different times and are refilled
+    enum { ITEMS = 6 };
+    const size_t lengths[ITEMS] = { 114, 0, 64, 1, 113, 65 };
+    unsigned char data[ITEMS][sizeof(ciphertext)];
+    unsigned char tags[ITEMS][AEAD_TAG_SIZE];
+    aead_batch_item_t items[ITEMS];
+    for (int i = 0; i < ITEMS; i++) {
+        memcpy(data[i], plaintext, lengths[i]);
+        items[i].nonce = nonce;
+        items[i].aad = aad;
+        items[i].aad_length = sizeof(aad);
+        items[i].data = data[i];
+        items[i].length = lengths[i];
+        items[i].tag = tags[i];
+    }
+    aead_seal_batch(&key, items, ITEMS);
+    
+    CHECK(memcmp(data[0], ciphertext, sizeof(ciphertext)) == 0);
+    CHECK(memcmp(tags[0], tag, sizeof(tag)) == 0);
+    for (int i = 1; i < ITEMS; i++) {
+        unsigned char single[sizeof(ciphertext)];
+        unsigned char single_tag[AEAD_TAG_SIZE];
+        memcpy(single, plaintext, lengths[i]);
+        aead_seal_in_place(&key, nonce, aad, sizeof(aad), single, lengths[i], single_tag);
+        CHECK(memcmp(data[i], single, lengths[i]) == 0);
+        CHECK(memcmp(tags[i], single_tag, sizeof(single_tag)) == 0);
+    }
+}
+
+static void test_hchacha20(void) {
+    unsigned char key[AEAD_KEY_SIZE];
+    for (int i = 0; i < AEAD_KEY_SIZE; i++) {
+        key[i] = (unsigned char)i;
+    }
+    static const unsigned char input[16] = {
+        0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x4a,
+        0x00, 0x00, 0x00, 0x00, 0x31, 0x41, 0x59, 0x27
+    };
+    static const unsigned char expected[AEAD_KEY_SIZE] = {
+        0x82, 0x41, 0x3b, 0x42, 0x27, 0xb2, 0x7b, 0xfe, 0xd3, 0x0e, 0x42, 0x50, 0x8a, 0x87, 0x7d, 0x73,
+        0xa0, 0xf9, 0xe4, 0xd5, 0x8a, 0x74, 0xa8, 0x53, 0xc1, 0x2e, 0xc4, 0x13, 0x26, 0xd3, 0xec, 0xdc
+    };
+    
+    unsigned char out[AEAD_KEY_SIZE];
+    hchacha20(key, input, out);
+    CHECK(memcmp(out, expected, sizeof(expected)) == 0);
+}
+
+int main(void) {
+    test_seal_vector();
+    test_tampered();
+    test_batch();
+    test_hchacha20();
+    
+    return TEST_RESULT("aead");
+}
@@ -0,0 +1,288 @@
+// tests/test_clock_sync.c
+// Clock synchronization: synthetic probe rounds against a remote clock
+// with a known offset and drift must recover both, the lowest-delay round
+// must win over a queued one, and the gateway must probe the drones that
+// report to it and record their one-way latency once an answer arrives.
+#include "../include/common.h"
+#include "../src/communication/clock_sync.h"
+#include "../src/communication/fleet_gateway.h"
+#include "test.h"
+
+#define TEST_PORT 47961
+#define TEST_BASE_NS 1700000000000000000ULL
+#define MS 1000000LL
+
+typedef union {
+    uint64_t align;
+    unsigned char bytes[MAX_BUFFER_SIZE];
+} frame_t;
+
+// Remote clock: local time plus a fixed offset, running fast by drift
+typedef struct {
+    int64_t offset_ns;
+    double drift;
+} remote_clock_t;
+
+static uint64_t remote_time(const remote_clock_t* clock, uint64_t local_ns) {
+    double elapsed = (double)(int64_t)(local_ns - TEST_BASE_NS);
+    return local_ns + (uint64_t)(clock->offset_ns + (int64_t)(elapsed * clock->drift));
+}
+
+static int64_t distance(int64_t a, int64_t b) {
+    return a > b ? a - b : b - a;
+}
+
+static int open_listener(void) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return -1;
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(TEST_PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    struct timeval timeout = { 1, 0 };
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static struct sockaddr_in listener_address(void) {
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(TEST_PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return address;
+}
+
+static udp_context_t* open_sender(void) {
+    udp_context_t* udp = udp_init("127.0.0.1", TEST_PORT);
+    if (udp && network_connect(udp->net_config) != NET_SUCCESS) {
+        udp_cleanup(udp);
+        return NULL;
+    }
+    return udp;
+}
+
+// Serialize a message into an aligned frame and view it; its length or -1
+static int make_view(const void* message, frame_t* frame, message_view_t* view) {
+    int length = serialize_message(message, frame->bytes, sizeof(frame->bytes));
+    if (length < 0 || message_view_init(view, frame->bytes, (size_t)length) != 0) return -1;
+    return length;
+}
+
+static void fill_response(clock_sync_message_t* response, const char* drone_id,
+                          uint32_t probe_id, uint64_t t1, uint64_t t2, uint64_t t3) {
+    memset(response, 0, sizeof(clock_sync_message_t));
+    init_message_header(&response->header, MSG_CLOCK_SYNC, drone_id);
+    response->header.payload_length = sizeof(clock_sync_message_t) - sizeof(message_header_t);
+    response->is_response = 1;
+    response->probe_id = probe_id;
+    response->origin_ns = t1;
+    response->receive_ns = t2;
+    response->transmit_ns = t3;
+}
+
+// One probe round with chosen timestamps: the probe really goes out, then
+// its origin is rewritten to t1 and answered with t2, t3, arriving at t4
+static int feed_round(clock_sync_t* sync, const char* drone_id, uint64_t t1,
+                      uint64_t t2, uint64_t t3, uint64_t t4) {
+    struct sockaddr_in address = listener_address();
+    if (clock_sync_probe(sync, drone_id, &address) != NET_SUCCESS) return -2;
+    
+    uint32_t probe_id = sync->next_probe_id - 1;
+    pthread_mutex_lock(&sync->lock);
+    for (int p = 0; p < sync->peer_count; p++) {
+        if (strcmp(sync->peers[p].drone_id, drone_id) != 0) continue;
+        for (int i = 0; i < CLOCK_SYNC_OUTSTANDING; i++) {
+            clock_probe_t* probe = &sync->peers[p].outstanding[i];
+            if (probe->pending && probe->probe_id == probe_id) probe->origin_ns = t1;
+        }
+    }
+    pthread_mutex_unlock(&sync->lock);
+    
+    clock_sync_message_t response;
+    fill_response(&response, drone_id, probe_id, t1, t2, t3);
+    frame_t frame;
+    message_view_t view;
+    if (make_view(&response, &frame, &view) < 0) return -2;
+    return clock_sync_handle_message(sync, &view, NULL, t4);
+}
+
+static clock_peer_t* peer_of(clock_sync_t* sync, const char* drone_id) {
+    for (int i = 0; i < sync->peer_count; i++) {
+        if (strcmp(sync->peers[i].drone_id, drone_id) == 0) return &sync->peers[i];
+    }
+    return NULL;
+}
+
+// Eight rounds two seconds apart, symmetric paths of 1 to 1.07 ms
+static void test_offset_and_drift(clock_sync_t* sync) {
+    const remote_clock_t clock = { 2500000, 40e-6 };
+    uint64_t first_t4 = 0;
+    for (int k = 0; k < CLOCK_SYNC_SAMPLES; k++) {
+        uint64_t t1 = TEST_BASE_NS + (uint64_t)k * 2000000000ULL;
+        uint64_t path = 1000000 + (uint64_t)k * 10000;
+        uint64_t hold = 100000;
+        uint64_t t4 = t1 + path + hold + path;
+        if (k == 0) first_t4 = t4;
+        CHECK(feed_round(sync, "drone-drift", t1, remote_time(&clock, t1 + path),
+                         remote_time(&clock, t1 + path + hold), t4) == 1);
+    }
+    
+    clock_estimate_t estimate;
+    CHECK(clock_sync_get_estimate(sync, "drone-drift", &estimate) == 0);
+    CHECK(estimate.samples == CLOCK_SYNC_SAMPLES);
+    CHECK(distance(estimate.delay_ns, 2 * MS) < 10);   // The remote hold runs 40 ppm fast
+    CHECK(estimate.reference_ns == first_t4);
+    // The round measures the offset at its midpoint, 1.05 ms before t4
+    int64_t expected = clock.offset_ns +
+                       (int64_t)((double)(first_t4 - TEST_BASE_NS) * clock.drift);
+    CHECK(distance(estimate.offset_ns, expected) < 100);
+    CHECK(estimate.drift_ppm > 39.99 && estimate.drift_ppm < 40.01);
+    
+    // Forty seconds on, drift has moved the offset by 1.6 ms
+    uint64_t local = TEST_BASE_NS + 40000000000ULL;
+    uint64_t converted = 0;
+    CHECK(clock_sync_to_local(sync, "drone-drift", remote_time(&clock, local), &converted) == 0);
+    CHECK(distance((int64_t)converted, (int64_t)local) < 1000);
+    
+    // A frame stamped remotely 3 ms before it arrives
+    status_update_message_t status;
+    memset(&status, 0, sizeof(status));
+    init_message_header(&status.header, MSG_STATUS_UPDATE, "drone-drift");
+    status.header.timestamp = remote_time(&clock, local - 3 * MS);
+    CHECK(clock_sync_record_arrival(sync, &status.header, local) == NET_SUCCESS);
+    clock_peer_t* peer = peer_of(sync, "drone-drift");
+    CHECK(peer && latency_histogram_count(&peer->one_way) == 1);
+    CHECK(peer && distance((int64_t)latency_histogram_mean(&peer->one_way), 3 * MS) < 1000);
+    CHECK(peer && peer->negative_latency == 0);
+}
+
+// A round queued 40 ms on the way out must not pull the offset with it
+static void test_lowest_delay(clock_sync_t* sync) {
+    const remote_clock_t clock = { -7 * MS, 0 };
+    for (int k = 0; k < 4; k++) {
+        uint64_t t1 = TEST_BASE_NS + (uint64_t)k * 500000000ULL;
+        uint64_t out = k == 3 ? 40 * MS : 2 * MS - k * 100000;
+        uint64_t back = 2 * MS - k * 100000;
+        CHECK(feed_round(sync, "drone-queued", t1, remote_time(&clock, t1 + out),
+                         remote_time(&clock, t1 + out), t1 + out + back) == 1);
+    }
+    
+    clock_estimate_t estimate;
+    CHECK(clock_sync_get_estimate(sync, "drone-queued", &estimate) == 0);
+    CHECK(estimate.offset_ns == clock.offset_ns);
+    CHECK(estimate.delay_ns == 2 * (2 * MS - 200000));
+    
+    // The answer to a probe already answered, and one never sent
+    clock_peer_t* peer = peer_of(sync, "drone-queued");
+    unsigned long unmatched = peer ? peer->unmatched : 0;
+    uint32_t probe_id = sync->next_probe_id - 1;
+    clock_sync_message_t response;
+    fill_response(&response, "drone-queued", probe_id, TEST_BASE_NS, TEST_BASE_NS, TEST_BASE_NS);
+    frame_t frame;
+    message_view_t view;
+    CHECK(make_view(&response, &frame, &view) > 0);
+    CHECK(clock_sync_handle_message(sync, &view, NULL, TEST_BASE_NS + MS) == -1);
+    fill_response(&response, "drone-queued", probe_id + 100, TEST_BASE_NS, TEST_BASE_NS,
+                  TEST_BASE_NS);
+    CHECK(make_view(&response, &frame, &view) > 0);
+    CHECK(clock_sync_handle_message(sync, &view, NULL, TEST_BASE_NS + MS) == -1);
+    CHECK(peer && peer->unmatched == unmatched + 2);
+    CHECK(clock_sync_get_estimate(sync, "drone-queued", &estimate) == 0);
+    CHECK(estimate.offset_ns == clock.offset_ns);
+}
+
+static int status_frame(frame_t* frame, const char* drone_id, uint64_t timestamp_ns) {
+    status_update_message_t status;
+    memset(&status, 0, sizeof(status));
+    init_message_header(&status.header, MSG_STATUS_UPDATE, drone_id);
+    status.header.payload_length = sizeof(status) - sizeof(message_header_t);
+    status.header.timestamp = timestamp_ns;
+    status.battery_level = 80;
+    return serialize_message(&status, frame->bytes, sizeof(frame->bytes));
+}
+
+// Frames through the gateway: the first one probes the drone, its answer
+// sets the offset, and later frames land in the one-way histogram
+static void test_gateway(clock_sync_t* sync, int fd) {
+    fleet_gateway_config_t config;
+    fleet_gateway_default_config(&config);
+    config.clock_probe_ms = 60000;
+    fleet_gateway_t* gateway = fleet_gateway_init(16, &config);
+    CHECK(gateway != NULL);
+    if (!gateway) return;
+    fleet_gateway_set_clock_sync(gateway, sync);
+    
+    // Drop the probes the synthetic rounds sent
+    frame_t frame;
+    while (recv(fd, frame.bytes, sizeof(frame.bytes), MSG_DONTWAIT) > 0) {}
+    
+    // The drone's clock runs five seconds ahead
+    const int64_t offset = 5000 * MS;
+    struct sockaddr_in drone = listener_address();
+    int length = status_frame(&frame, "drone-gw", message_timestamp_ns() + offset);
+    CHECK(length > 0);
+    CHECK(fleet_gateway_handle_datagram_from(gateway, frame.bytes, (size_t)length, &drone,
+                                             network_monotonic_ns()) == NET_SUCCESS);
+    CHECK(fleet_gateway_handle_datagram_from(gateway, frame.bytes, (size_t)length, &drone,
+                                             network_monotonic_ns()) == NET_SUCCESS);
+    clock_peer_t* peer = peer_of(sync, "drone-gw");
+    CHECK(peer && peer->probes_sent == 1);
+    CHECK(peer && latency_histogram_count(&peer->one_way) == 0);
+    
+    // The probe reaches the "drone", which answers through the gateway
+    clock_sync_message_t probe;
+    memset(&probe, 0, sizeof(probe));
+    ssize_t received = recv(fd, frame.bytes, sizeof(frame.bytes), 0);
+    CHECK(received == (ssize_t)sizeof(probe));
+    if (received == (ssize_t)sizeof(probe)) memcpy(&probe, frame.bytes, sizeof(probe));
+    CHECK(probe.header.message_type == MSG_CLOCK_SYNC && probe.is_response == 0);
+    
+    clock_sync_message_t response;
+    uint64_t t2 = probe.origin_ns + (uint64_t)offset;
+    fill_response(&response, "drone-gw", probe.probe_id, probe.origin_ns, t2, t2);
+    length = serialize_message(&response, frame.bytes, sizeof(frame.bytes));
+    CHECK(fleet_gateway_handle_datagram_from(gateway, frame.bytes, (size_t)length, &drone,
+                                             network_monotonic_ns()) == NET_SUCCESS);
+    clock_estimate_t estimate;
+    CHECK(clock_sync_get_estimate(sync, "drone-gw", &estimate) == 0);
+    CHECK(distance(estimate.offset_ns, offset) < 50 * MS);
+    
+    // Stamped 200 ms ago by the drone's clock
+    length = status_frame(&frame, "drone-gw", message_timestamp_ns() + offset - 200 * MS);
+    CHECK(fleet_gateway_handle_datagram_from(gateway, frame.bytes, (size_t)length, &drone,
+                                             network_monotonic_ns()) == NET_SUCCESS);
+    CHECK(peer && peer->probes_sent == 1);
+    CHECK(peer && latency_histogram_count(&peer->one_way) == 1);
+    CHECK(peer && distance((int64_t)latency_histogram_mean(&peer->one_way), 200 * MS) < 50 * MS);
+    CHECK(gateway->stats.rejected == 0);
+    
+    fleet_gateway_cleanup(gateway);
+}
+
+int main(void) {
+    int fd = open_listener();
+    udp_context_t* udp = open_sender();
+    clock_sync_t* sync = udp ? clock_sync_init(udp, "fleet_gateway", 8) : NULL;
+    CHECK(fd >= 0 && udp != NULL && sync != NULL);
+    if (fd < 0 || !sync) {
+        if (fd >= 0) close(fd);
+        udp_cleanup(udp);
+        return TEST_RESULT("clock_sync");
+    }
+    
+    test_offset_and_drift(sync);
+    test_lowest_delay(sync);
+    test_gateway(sync, fd);
+    
+    clock_sync_cleanup(sync);
+    udp_cleanup(udp);
+    close(fd);
+    return TEST_RESULT("clock_sync");
+}
@@ -0,0 +1,151 @@
+// tests/test_coalesce.c
+// Coalesced frames: records of every length arrive 8-byte aligned, so the
+// dispatcher views them in place instead of copying them to scratch, and
+// a frame whose length cuts into a record's padding is refused.
+#include "../include/common.h"
+#include "../src/communication/udp_comm.h"
+#include <stddef.h>
+#include <stdint.h>
+#include "test.h"
+
+#define TEST_PORT 47941
+#define TEST_RECORDS 24
+
+typedef struct {
+    int received;
+    int misaligned;
+    int mismatched;
+} tally_t;
+
+static void on_message(const message_view_t* view, void* user_data) {
+    tally_t* tally = (tally_t*)user_data;
+    if ((uintptr_t)view->as.header % UDP_COALESCE_ALIGN != 0) tally->misaligned++;
+    
+    char expected[MAX_DRONE_ID];
+    snprintf(expected, sizeof(expected), "drone-%02d", tally->received);
+    if (strcmp(view->as.header->drone_id, expected) != 0) tally->mismatched++;
+    if (view->type == MSG_COMMAND) {
+        size_t payload = view->length - offsetof(command_message_t, payload);
+        if (payload != (size_t)(tally->received % 7) ||
+            memcmp(view->as.command->payload, "abcdefg", payload) != 0) {
+            tally->mismatched++;
+        }
+    }
+    tally->received++;
+}
+
+// Status updates, heartbeats and commands trimmed to odd lengths
+static void queue_records(udp_coalescer_t* coalescer) {
+    for (int i = 0; i < TEST_RECORDS; i++) {
+        char drone_id[MAX_DRONE_ID];
+        snprintf(drone_id, sizeof(drone_id), "drone-%02d", i);
+        
+        if (i % 3 == 0) {
+            status_update_message_t status;
+            memset(&status, 0, sizeof(status));
+            init_message_header(&status.header, MSG_STATUS_UPDATE, drone_id);
+            status.header.payload_length = sizeof(status) - sizeof(message_header_t);
+            status.x = i;
+            CHECK(udp_coalesce_message(coalescer, &status.header) == NET_SUCCESS);
+        } else if (i % 3 == 1) {
+            heartbeat_message_t heartbeat;
+            memset(&heartbeat, 0, sizeof(heartbeat));
+            init_message_header(&heartbeat.header, MSG_HEARTBEAT, drone_id);
+            heartbeat.header.payload_length = sizeof(heartbeat) - sizeof(message_header_t);
+            heartbeat.sequence = (uint32_t)i;
+            CHECK(udp_coalesce_message(coalescer, &heartbeat.header) == NET_SUCCESS);
+        } else {
+            command_message_t command;
+            memset(&command, 0, sizeof(command));
+            init_message_header(&command.header, MSG_COMMAND, drone_id);
+            memcpy(command.payload, "abcdefg", 7);
+            size_t length = offsetof(command_message_t, payload) + (size_t)(i % 7);
+            command.header.payload_length = (uint32_t)(length - sizeof(message_header_t));
+            CHECK(udp_coalesce_message(coalescer, &command.header) == NET_SUCCESS);
+        }
+    }
+}
+
+static void test_aligned_dispatch(void) {
+    udp_context_t receiver;
+    memset(&receiver, 0, sizeof(receiver));
+    receiver.net_config = network_init("127.0.0.1", TEST_PORT, NETWORK_MODE_SERVER);
+    udp_context_t* sender = udp_init("127.0.0.1", TEST_PORT);
+    CHECK(receiver.net_config != NULL && sender != NULL);
+    if (!receiver.net_config || !sender) {
+        if (receiver.net_config) network_cleanup(receiver.net_config);
+        udp_cleanup(sender);
+        return;
+    }
+    receiver.net_config->local_addr.sin_port = htons(TEST_PORT);
+    CHECK(network_connect(receiver.net_config) == NET_SUCCESS);
+    CHECK(network_connect(sender->net_config) == NET_SUCCESS);
+    network_set_receive_timeout(receiver.net_config, 1000);
+    
+    udp_coalescer_t* coalescer = udp_coalescer_init(sender, 0, 1000);
+    CHECK(coalescer != NULL);
+    if (coalescer) {
+        queue_records(coalescer);
+        CHECK(udp_coalescer_flush(coalescer) == NET_SUCCESS);
+    }
+    
+    message_dispatcher_t* dispatcher = (message_dispatcher_t*)malloc(sizeof(message_dispatcher_t));
+    tally_t tally = { 0, 0, 0 };
+    CHECK(dispatcher != NULL);
+    if (dispatcher) {
+        message_dispatcher_init(dispatcher);
+        message_dispatcher_set_fallback(dispatcher, on_message, &tally);
+        for (unsigned long frames = 0; coalescer && frames < coalescer->frames_sent; frames++) {
+            CHECK(udp_receive_dispatch(&receiver, dispatcher) == NET_SUCCESS);
+        }
+        CHECK(coalescer && coalescer->frames_sent > 1);
+        CHECK(tally.received == TEST_RECORDS);
+        CHECK(dispatcher->dispatched == TEST_RECORDS);
+        CHECK(dispatcher->rejected == 0);
+        CHECK(dispatcher->realigned == 0);
+        CHECK(tally.misaligned == 0);
+        CHECK(tally.mismatched == 0);
+    }
+    
+    free(dispatcher);
+    udp_coalescer_cleanup(coalescer);
+    udp_cleanup(sender);
+    network_cleanup(receiver.net_config);
+}
+
+static void test_truncated_padding(void) {
+    union {
+        uint64_t align;
+        unsigned char bytes[64];
+    } frame;
+    memset(&frame, 0, sizeof(frame));
+    
+    // One 5-byte record takes 8 bytes of prefix and 8 of body and padding
+    coalesced_frame_header_t header = { UDP_COALESCE_MAGIC, 1, sizeof(header) + 16 };
+    uint16_t length = 5;
+    memcpy(frame.bytes, &header, sizeof(header));
+    memcpy(frame.bytes + sizeof(header), &length, sizeof(length));
+    
+    size_t offset = 0;
+    const void* record;
+    size_t record_length;
+    CHECK(udp_coalesced_next(frame.bytes, header.frame_length, &offset,
+                             &record, &record_length) == 1);
+    CHECK(record == frame.bytes + sizeof(header) + UDP_COALESCE_ALIGN);
+    CHECK(record_length == 5);
+    CHECK(udp_coalesced_next(frame.bytes, header.frame_length, &offset,
+                             &record, &record_length) == 0);
+    
+    header.frame_length -= 1;
+    memcpy(frame.bytes, &header, sizeof(header));
+    offset = 0;
+    CHECK(udp_coalesced_next(frame.bytes, header.frame_length, &offset,
+                             &record, &record_length) == -1);
+}
+
+int main(void) {
+    test_aligned_dispatch();
+    test_truncated_padding();
+    
+    return TEST_RESULT("coalesce");
+}
@@ -0,0 +1,98 @@
+// tests/test_fleet_gateway.c
+// Snapshot fan-out to a subscriber that stops reading: ticks must not
+// wait on it, and once it reads again every snapshot that follows a gap
+// in the sequence must be a full one.
+#include "../include/common.h"
+#include "../src/communication/fleet_gateway.h"
+#include "test.h"
+
+#define TEST_PORT 47921
+#define TEST_DRONES 4000
+
+static void report_all(fleet_gateway_t* gateway, int round, uint64_t now_ns) {
+    status_update_format_t status;
+    memset(&status, 0, sizeof(status));
+    strcpy(status.state, "scanning_terrain");
+    for (int d = 0; d < TEST_DRONES; d++) {
+        snprintf(status.drone_id, sizeof(status.drone_id), "DRONE_%05d", d);
+        status.position.x = d;
+        status.position.y = round;
+        status.battery_level = 90.0 - round * 0.01;
+        fleet_gateway_update(gateway, &status, now_ns);
+    }
+}
+
+// Read every frame waiting on the stream; -1 if a gap was not followed
+// by a full snapshot
+static int read_snapshots(tcp_connection_t* client, char* frame, size_t capacity,
+                          long* last_sequence, int* frames) {
+    size_t length;
+    int result = 0;
+    while (tcp_receive_frame(client, frame, capacity - 1, &length) == NET_SUCCESS) {
+        frame[length] = '\0';
+        const char* field = strstr(frame, "\"sequence\":");
+        if (!field) return -1;
+        long sequence = strtol(field + 11, NULL, 10);
+        int full = strstr(frame, "\"full\":true") != NULL;
+        if (*last_sequence >= 0 && sequence != *last_sequence + 1 && !full) result = -1;
+        *last_sequence = sequence;
+        (*frames)++;
+    }
+    return result;
+}
+
+int main(void) {
+    fleet_gateway_config_t config;
+    fleet_gateway_default_config(&config);
+    config.full_every = 0;
+    fleet_gateway_t* gateway = fleet_gateway_init(TEST_DRONES, &config);
+    CHECK(gateway != NULL);
+    if (!gateway) return TEST_RESULT("fleet_gateway");
+    CHECK(fleet_gateway_listen(gateway, TEST_PORT) == NET_SUCCESS);
+    
+    tcp_connection_t* client = tcp_connect("127.0.0.1", TEST_PORT);
+    CHECK(client != NULL);
+    if (!client) {
+        fleet_gateway_cleanup(gateway);
+        return TEST_RESULT("fleet_gateway");
+    }
+    
+    // The client reads nothing while every drone changes on every tick
+    uint64_t now = network_monotonic_ns();
+    uint64_t slowest = 0;
+    for (int round = 0; round < 40; round++) {
+        report_all(gateway, round, now);
+        uint64_t started = network_monotonic_ns();
+        fleet_gateway_tick(gateway, now);
+        uint64_t took = network_monotonic_ns() - started;
+        if (took > slowest) slowest = took;
+        now += 100000000ULL;
+    }
+    CHECK(gateway->subscriber_count == 1);
+    CHECK(slowest < 500000000ULL);
+    CHECK(gateway->stats.snapshots_skipped > 0);
+    
+    // Reading again, it catches up without losing track of the fleet
+    size_t capacity = gateway->snapshot_capacity + 1;
+    char* frame = (char*)malloc(capacity);
+    CHECK(frame != NULL);
+    long last_sequence = -1;
+    int frames = 0;
+    int consistent = 0;
+    for (int round = 40; frame && round < 140; round++) {
+        consistent |= read_snapshots(client, frame, capacity, &last_sequence, &frames);
+        report_all(gateway, round, now);
+        fleet_gateway_tick(gateway, now);
+        now += 100000000ULL;
+    }
+    if (frame) consistent |= read_snapshots(client, frame, capacity, &last_sequence, &frames);
+    CHECK(consistent == 0);
+    CHECK(frames > 0);
+    CHECK(gateway->subscriber_count == 1);
+    CHECK(last_sequence == (long)gateway->sequence - 1 || gateway->subscribers[0].needs_full);
+    
+    free(frame);
+    tcp_close(client);
+    fleet_gateway_cleanup(gateway);
+    return TEST_RESULT("fleet_gateway");
+}
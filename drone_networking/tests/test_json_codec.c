@@ -0,0 +1,243 @@
+// tests/test_json_codec.c
+// JSON codec: numbers read bit-for-bit like strtod on both sides of the
+// fast-path limits and written in their shortest exact form, escapes and
+// surrogate pairs decode to UTF-8 while broken ones are refused, and
+// skipped or raw-copied values must follow the grammar, not just balance.
+#include "../include/common.h"
+#include "../src/protocols/json_codec.h"
+#include "../src/protocols/message_formats.h"
+#include <math.h>
+#include "test.h"
+
+static int read_double(const char* text, double* value) {
+    json_reader_t reader;
+    json_reader_init(&reader, text, strlen(text));
+    if (json_read_double(&reader, value) != 0) return -1;
+    return json_reader_finish(&reader);
+}
+
+static int same_bits(double a, double b) {
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+static const char* write_double(double value, char* out, size_t capacity) {
+    json_writer_t writer;
+    json_writer_init(&writer, out, capacity - 1);
+    json_write_double(&writer, value);
+    int length = json_writer_finish(&writer);
+    out[length < 0 ? 0 : length] = '\0';
+    return out;
+}
+
+// Inputs inside the exact-multiply limits and just past them
+static void test_read_numbers(void) {
+    static const char* inputs[] = {
+        "0", "-0", "1", "0.1", "-2.5", "123.456", "1e22", "1e-22", "9007199254740992",
+        "4.5e15", "1234567890123456789", "0.30000000000000004",
+        // Past the fast path: 2^53 + 1, 20 digits, 10^23, tiny and huge
+        "9007199254740993", "12345678901234567890", "1e23", "1e-23", "8.5e-323",
+        "2.2250738585072014e-308", "4.9406564584124654e-324", "1.7976931348623157e308",
+        "0.1000000000000000055511151231257827", "3.141592653589793238462643383279",
+        "7.0e-10", "1E+2", "100000000000000000000000e-3"
+    };
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        double value = -1;
+        int ok = read_double(inputs[i], &value) == 0 && same_bits(value, strtod(inputs[i], NULL));
+        if (!ok) fprintf(stderr, "read %s gave %.17g\n", inputs[i], value);
+        CHECK(ok);
+    }
+    
+    static const char* malformed[] = { "", "-", "01", "1.", ".5", "1e", "1e+", "+1", "0x10", "--1" };
+    for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+        double value;
+        CHECK(read_double(malformed[i], &value) != 0);
+    }
+    
+    json_reader_t reader;
+    int64_t integer;
+    json_reader_init(&reader, "9223372036854775807", 19);
+    CHECK(json_read_int64(&reader, &integer) == 0 && integer == INT64_MAX);
+    json_reader_init(&reader, "-9223372036854775808", 20);
+    CHECK(json_read_int64(&reader, &integer) == 0 && integer == INT64_MIN);
+    json_reader_init(&reader, "9223372036854775808", 19);
+    CHECK(json_read_int64(&reader, &integer) == -1);
+    json_reader_init(&reader, "1.7e9", 5);
+    CHECK(json_read_int64(&reader, &integer) == 0 && integer == 1700000000);
+    json_reader_init(&reader, "1.5", 3);
+    CHECK(json_read_int64(&reader, &integer) == -1);
+}
+
+static void test_write_numbers(void) {
+    static const struct {
+        double value;
+        const char* text;
+    } cases[] = {
+        { 0.0, "0" }, { -0.0, "-0" }, { 1.0, "1" }, { 0.1, "0.1" }, { -2.25, "-2.25" },
+        { 100.0, "100" }, { 123.456, "123.456" }, { 1e-7, "0.0000001" },
+        { 1e300, "1e+300" }, { 0.30000000000000004, "0.30000000000000004" },
+        { 5e-324, "4.94065645841247e-324" }, { 1.0 / 3.0, "0.33333333333333331" }
+    };
+    char text[64];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        write_double(cases[i].value, text, sizeof(text));
+        if (strcmp(text, cases[i].text) != 0) {
+            fprintf(stderr, "wrote %s for %s\n", text, cases[i].text);
+        }
+        CHECK(strcmp(text, cases[i].text) == 0);
+    }
+    write_double(NAN, text, sizeof(text));
+    CHECK(strcmp(text, "null") == 0);
+    
+    // Every finite double reads back to the same bits
+    uint32_t state = 4242;
+    int mismatched = 0;
+    for (int i = 0; i < 100000; i++) {
+        uint64_t bits = 0;
+        for (int part = 0; part < 4; part++) {
+            state = state * 1103515245u + 12345u;
+            bits = (bits << 16) | (state >> 16);
+        }
+        double value;
+        memcpy(&value, &bits, sizeof(value));
+        if (!isfinite(value)) continue;
+        
+        double back;
+        if (read_double(write_double(value, text, sizeof(text)), &back) != 0 ||
+            !same_bits(value, back)) {
+            mismatched++;
+        }
+        
+        // Telemetry-like values with a few decimals
+        double decimal = (double)(int)(state % 2000001 - 1000000) / 1000.0;
+        if (read_double(write_double(decimal, text, sizeof(text)), &back) != 0 ||
+            !same_bits(decimal, back) || strlen(text) > 12) {
+            mismatched++;
+        }
+    }
+    CHECK(mismatched == 0);
+}
+
+static int read_string(const char* json, char* out, size_t capacity) {
+    json_reader_t reader;
+    json_reader_init(&reader, json, strlen(json));
+    if (json_read_string(&reader, out, capacity) != 0) return -1;
+    return json_reader_finish(&reader);
+}
+
+static int skip(const char* json) {
+    json_reader_t reader;
+    json_reader_init(&reader, json, strlen(json));
+    if (json_skip_value(&reader) != 0) return -1;
+    return json_reader_finish(&reader);
+}
+
+static void test_strings(void) {
+    char out[64];
+    CHECK(read_string("\"a\\n\\t\\\"\\\\\\/\\b\\f\\r\"", out, sizeof(out)) == 0);
+    CHECK(strcmp(out, "a\n\t\"\\/\b\f\r") == 0);
+    CHECK(read_string("\"\\u00e9\\u20AC\\ud83d\\ude00!\"", out, sizeof(out)) == 0);
+    CHECK(strcmp(out, "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80!") == 0);
+    CHECK(read_string("\"a string longer than sixteen bytes\"", out, sizeof(out)) == 0);
+    CHECK(strcmp(out, "a string longer than sixteen bytes") == 0);
+    CHECK(read_string("\"fits\"", out, 5) == 0);
+    CHECK(read_string("\"fits\"", out, 4) == -1);
+    
+    // Refused by the reader and by skip alike
+    static const char* malformed[] = {
+        "\"\\ude00\"",              // Low surrogate alone
+        "\"\\ud83d\"",              // High surrogate alone
+        "\"\\ud83dx\"",
+        "\"\\ud83d\\u0041\"",       // High surrogate, then not a low one
+        "\"\\ude00\\ud83d\"",       // Pair in the wrong order
+        "\"\\x41\"", "\"\\u12g4\"", "\"\\u12\"", "\"\\", "\"open", "\"tab\there\""
+    };
+    for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+        CHECK(read_string(malformed[i], out, sizeof(out)) != 0);
+        CHECK(skip(malformed[i]) != 0);
+    }
+    
+    // Written escapes read back to the original bytes
+    const char* original = "q\"uote\\ new\nline\ttab\x01\x1f end";
+    char json[128];
+    json_writer_t writer;
+    json_writer_init(&writer, json, sizeof(json) - 1);
+    json_write_string(&writer, original, 64);
+    int length = json_writer_finish(&writer);
+    CHECK(length > 0);
+    json[length < 0 ? 0 : length] = '\0';
+    CHECK(strstr(json, "\\u0001") != NULL && strstr(json, "\\u001f") != NULL);
+    CHECK(read_string(json, out, sizeof(out)) == 0);
+    CHECK(strcmp(out, original) == 0);
+}
+
+static void test_skip_grammar(void) {
+    static const char* valid[] = {
+        "{}", "[]", " [ 1 , 2 ] ", "\"s\"", "-0.5e+3", "true", "false", "null",
+        "{\"a\":[1,{\"b\":null}],\"c\":\"x\",\"d\":{}}", "[[],[[]],{}]",
+        "{ \"k\" : [ true , false ] , \"\\u00e9\" : \"\\ud83d\\ude00\" }"
+    };
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        int ok = skip(valid[i]) == 0;
+        if (!ok) fprintf(stderr, "refused %s\n", valid[i]);
+        CHECK(ok);
+    }
+    
+    static const char* malformed[] = {
+        "[1 2]", "[1,,2]", "{\"a\":}", "{]", "{1:2}", "[1,]", "[,1]", "{\"a\":1,}",
+        "{,}", "{\"a\" 1}", "{\"a\":1 \"b\":2}", "{\"a\"}", "{\"a\":1:2}", "[1:2]",
+        "{\"a\":1]", "[1}", "[", "]", "}", ",", ":", "{\"a\":", "tru", "nul", "01",
+        "[\"\\ude00\"]", "{\"\\ude00\":1}", "{null:1}", ""
+    };
+    for (size_t i = 0; i < sizeof(malformed) / sizeof(malformed[0]); i++) {
+        int refused = skip(malformed[i]) != 0;
+        if (!refused) fprintf(stderr, "accepted %s\n", malformed[i]);
+        CHECK(refused);
+    }
+    
+    // Nesting up to the limit, not past it
+    char nested[2 * JSON_MAX_DEPTH + 8];
+    memset(nested, '[', JSON_MAX_DEPTH);
+    memset(nested + JSON_MAX_DEPTH, ']', JSON_MAX_DEPTH);
+    nested[2 * JSON_MAX_DEPTH] = '\0';
+    CHECK(skip(nested) == 0);
+    memset(nested, '[', JSON_MAX_DEPTH + 1);
+    memset(nested + JSON_MAX_DEPTH + 1, ']', JSON_MAX_DEPTH + 1);
+    nested[2 * JSON_MAX_DEPTH + 2] = '\0';
+    CHECK(skip(nested) != 0);
+    
+    // Skipping leaves the cursor after the value
+    json_reader_t reader;
+    const char* pair = "{\"a\":[1,2]} [3]";
+    json_reader_init(&reader, pair, strlen(pair));
+    CHECK(json_skip_value(&reader) == 0);
+    CHECK(reader.position == 11);
+}
+
+// Command params are copied raw into the decoded message, so a malformed
+// value must fail the decode rather than be passed along
+static void test_raw_params(void) {
+    command_format_t command;
+    const char* good = "{\"message_type\":\"command\",\"drone_id\":\"d1\",\"command\":\"goto\","
+                       "\"params\":{\"x\":1.5,\"path\":[1,2]},\"timestamp\":5}";
+    CHECK(command_format_decode_json(&command, good, strlen(good)) == 0);
+    CHECK(strcmp(command.params, "{\"x\":1.5,\"path\":[1,2]}") == 0);
+    
+    static const char* bad_params[] = { "{\"x\":1 2}", "[1,,2]", "{\"a\":}", "{1:2}", "{]" };
+    for (size_t i = 0; i < sizeof(bad_params) / sizeof(bad_params[0]); i++) {
+        char json[256];
+        int length = snprintf(json, sizeof(json),
+                              "{\"message_type\":\"command\",\"drone_id\":\"d1\","
+                              "\"command\":\"goto\",\"params\":%s,\"timestamp\":5}", bad_params[i]);
+        CHECK(command_format_decode_json(&command, json, (size_t)length) != 0);
+    }
+}
+
+int main(void) {
+    test_read_numbers();
+    test_write_numbers();
+    test_strings();
+    test_skip_grammar();
+    test_raw_params();
+    
+    return TEST_RESULT("json_codec");
+}
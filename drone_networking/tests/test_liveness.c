@@ -0,0 +1,127 @@
+// tests/test_liveness.c
+// Liveness timer wheel: deadlines on level 0, deadlines that cascade down
+// from the upper levels, and deadlines past the top level's span.
+#include "../include/common.h"
+#include "../src/communication/liveness.h"
+#include "test.h"
+
+#define MS 1000000ULL
+#define LN10 2.302585092994046
+
+static const uint64_t start_ns = 5000 * MS + 3 * MS;   // Not on a tick boundary
+
+// Time after the heartbeat at which phi reaches threshold, as liveness.c computes it
+static uint64_t deadline_ns(double phi, unsigned int interval_ms) {
+    return start_ns + (uint64_t)(phi * interval_ms * LN10 * 1e6);
+}
+
+static liveness_t* make_liveness(unsigned int tick_ms, size_t max_drones) {
+    liveness_config_t config;
+    liveness_default_config(&config);
+    config.tick_ms = tick_ms;
+    config.max_detection_ms = 0;    // Uncapped, so long intervals reach the upper levels
+    return liveness_init(max_drones, &config, NULL, NULL);
+}
+
+static void test_expiry(void) {
+    liveness_t* liveness = make_liveness(10, 4);
+    CHECK(liveness != NULL);
+    if (!liveness) return;
+    
+    // 200 ms mean interval: both deadlines stay on level 0 or 1
+    CHECK(liveness_heartbeat(liveness, "drone-1", 1, 200, start_ns) == NET_SUCCESS);
+    uint64_t suspect_ns = deadline_ns(LIVENESS_DEFAULT_PHI_SUSPECT, 200);
+    uint64_t dead_ns = deadline_ns(LIVENESS_DEFAULT_PHI_DEAD, 200);
+    
+    CHECK(liveness_advance(liveness, suspect_ns - 20 * MS) == 0);
+    CHECK(liveness_get_state(liveness, "drone-1") == LIVENESS_ALIVE);
+    CHECK(liveness_advance(liveness, suspect_ns + 10 * MS) == 1);
+    CHECK(liveness_get_state(liveness, "drone-1") == LIVENESS_SUSPECT);
+    
+    CHECK(liveness_advance(liveness, dead_ns - 20 * MS) == 0);
+    CHECK(liveness_get_state(liveness, "drone-1") == LIVENESS_SUSPECT);
+    CHECK(liveness_advance(liveness, dead_ns + 10 * MS) == 1);
+    CHECK(liveness_get_state(liveness, "drone-1") == LIVENESS_DEAD);
+    
+    // A dead drone has no timer until it speaks again
+    CHECK(liveness_advance(liveness, dead_ns + 60000 * MS) == 0);
+    CHECK(liveness_heartbeat(liveness, "drone-1", 2, 200, dead_ns + 60000 * MS) == NET_SUCCESS);
+    CHECK(liveness_get_state(liveness, "drone-1") == LIVENESS_ALIVE);
+    
+    liveness_stats_t stats;
+    liveness_get_stats(liveness, &stats);
+    CHECK(stats.suspected == 1);
+    CHECK(stats.declared_dead == 1);
+    CHECK(stats.recovered == 1);
+    
+    liveness_cleanup(liveness);
+}
+
+static void test_cascade(void) {
+    enum { DRONES = 64 };
+    liveness_t* liveness = make_liveness(10, DRONES);
+    CHECK(liveness != NULL);
+    if (!liveness) return;
+    
+    // Intervals from 0.1 s to 20 s put the suspect deadlines from tick 46
+    // to tick 9210, across levels 0, 1 and 2
+    unsigned int intervals[DRONES];
+    int suspected_at[DRONES];
+    char ids[DRONES][MAX_DRONE_ID];
+    for (int i = 0; i < DRONES; i++) {
+        intervals[i] = 100 + (unsigned int)i * 315;
+        suspected_at[i] = -1;
+        snprintf(ids[i], MAX_DRONE_ID, "drone-%d", i);
+        CHECK(liveness_heartbeat(liveness, ids[i], 1, intervals[i], start_ns) == NET_SUCCESS);
+    }
+    
+    // Walk one tick at a time and note when each drone turns suspect
+    uint64_t end_ns = deadline_ns(LIVENESS_DEFAULT_PHI_SUSPECT, intervals[DRONES - 1]) + 20 * MS;
+    for (uint64_t now_ns = start_ns; now_ns <= end_ns; now_ns += 10 * MS) {
+        liveness_advance(liveness, now_ns);
+        for (int i = 0; i < DRONES; i++) {
+            if (suspected_at[i] < 0 &&
+                liveness_get_state(liveness, ids[i]) == LIVENESS_SUSPECT) {
+                suspected_at[i] = (int)((now_ns - start_ns) / MS);
+            }
+        }
+    }
+    
+    // Each one fires within two ticks of its own deadline, never early
+    for (int i = 0; i < DRONES; i++) {
+        int expected = (int)((deadline_ns(LIVENESS_DEFAULT_PHI_SUSPECT, intervals[i]) -
+                              start_ns) / MS);
+        CHECK(suspected_at[i] >= expected);
+        CHECK(suspected_at[i] <= expected + 20);
+    }
+    
+    liveness_cleanup(liveness);
+}
+
+static void test_beyond_wheel(void) {
+    liveness_t* liveness = make_liveness(1, 1);
+    CHECK(liveness != NULL);
+    if (!liveness) return;
+    
+    // 4000 s mean interval: the suspect deadline, about 18.4 million ticks
+    // out, is past the 2^24 ticks the wheel spans, so it is parked and
+    // rescheduled on the way
+    CHECK(liveness_heartbeat(liveness, "drone-far", 1, 4000000, start_ns) == NET_SUCCESS);
+    uint64_t suspect_ns = deadline_ns(LIVENESS_DEFAULT_PHI_SUSPECT, 4000000);
+    CHECK(suspect_ns - start_ns > (1ULL << 24) * MS);
+    
+    CHECK(liveness_advance(liveness, suspect_ns - 2 * MS) == 0);
+    CHECK(liveness_get_state(liveness, "drone-far") == LIVENESS_ALIVE);
+    CHECK(liveness_advance(liveness, suspect_ns + 1 * MS) == 1);
+    CHECK(liveness_get_state(liveness, "drone-far") == LIVENESS_SUSPECT);
+    
+    liveness_cleanup(liveness);
+}
+
+int main(void) {
+    test_expiry();
+    test_cascade();
+    test_beyond_wheel();
+    
+    return TEST_RESULT("liveness");
+}
@@ -0,0 +1,159 @@
+// tests/test_message_formats.c
+// Generated by scripts/generate_message_formats.rb from shared/message_formats.json.
+// Do not edit: change the schema and run `make generate`.
+//
+// Every message format survives a JSON and a binary round trip with its
+// fields at their limits and full of escapes, is detected from either
+// form, and refuses truncated, mistagged or undersized input.
+#include "../include/common.h"
+#include "../src/protocols/message_formats.h"
+#include <math.h>
+#include "test.h"
+
+#define TEST_ROUNDS 200
+
+static uint32_t test_state = 12345;
+
+static uint32_t next_random(void) {
+    test_state = test_state * 1103515245u + 12345u;
+    return test_state >> 8;
+}
+
+// Text JSON has to escape, filling the field on the first round
+static void fill_string(char* out, size_t size, int round) {
+    static const char alphabet[] = "azAZ09 _-/\"\\\n\t\x01\x1f\xc3\xa9";
+    size_t length = round == 0 ? size - 1 : next_random() % size;
+    for (size_t i = 0; i < length; i++) {
+        out[i] = alphabet[next_random() % (sizeof(alphabet) - 1)];
+    }
+}
+
+static void fill_raw(char* out, size_t size) {
+    snprintf(out, size, "{\"n\":%u,\"v\":[1,2.5,true,null],\"s\":\"q\\\"\\u00e9\"}",
+             next_random());
+}
+
+// Extremes first, then arbitrary finite bit patterns
+static double random_double(int round) {
+    static const double extremes[] = { 1.7976931348623157e308, -4.9406564584124654e-324, -0.0 };
+    if (round < 3) return extremes[round];
+    double value;
+    do {
+        uint64_t bits = ((uint64_t)next_random() << 40) ^ ((uint64_t)next_random() << 16) ^ next_random();
+        memcpy(&value, &bits, sizeof(value));
+    } while (!isfinite(value));
+    return value;
+}
+
+static int64_t random_int64(int round) {
+    if (round < 2) return round == 0 ? INT64_MAX : INT64_MIN;
+    return (int64_t)(((uint64_t)next_random() << 40) ^ ((uint64_t)next_random() << 16) ^ next_random());
+}
+
+static void fill_status_update(status_update_format_t* message, int round) {
+    memset(message, 0, sizeof(*message));
+    fill_string(message->drone_id, sizeof(message->drone_id), round);
+    message->position.x = random_double(round);
+    message->position.y = random_double(round);
+    message->position.z = random_double(round);
+    message->battery_level = random_double(round);
+    fill_string(message->state, sizeof(message->state), round);
+    message->timestamp = random_int64(round);
+}
+
+static void test_status_update(void) {
+    char json[8 * STATUS_UPDATE_BINARY_MAX_SIZE + 1024];
+    unsigned char binary[STATUS_UPDATE_BINARY_MAX_SIZE];
+    int mismatched = 0;
+    int accepted = 0;
+    for (int round = 0; round < TEST_ROUNDS; round++) {
+        status_update_format_t message, decoded;
+        fill_status_update(&message, round);
+        
+        int json_length = status_update_format_encode_json(&message, json, sizeof(json));
+        int binary_length = status_update_format_encode_binary(&message, binary, sizeof(binary));
+        CHECK(json_length > 0 && binary_length > 0);
+        if (json_length <= 0 || binary_length <= 0) continue;
+        CHECK(message_format_detect_json(json, (size_t)json_length) == MESSAGE_FORMAT_STATUS_UPDATE);
+        CHECK(message_format_detect_binary(binary, (size_t)binary_length) == MESSAGE_FORMAT_STATUS_UPDATE);
+        
+        CHECK(status_update_format_decode_json(&decoded, json, (size_t)json_length) == 0);
+        mismatched += memcmp(&decoded, &message, sizeof(message)) != 0;
+        CHECK(status_update_format_decode_binary(&decoded, binary, (size_t)binary_length) == 0);
+        mismatched += memcmp(&decoded, &message, sizeof(message)) != 0;
+        
+        // Every prefix is refused, and so is every other format's decoder
+        for (int cut = 0; cut < json_length; cut++) {
+            accepted += status_update_format_decode_json(&decoded, json, (size_t)cut) == 0;
+        }
+        for (int cut = 0; cut < binary_length; cut++) {
+            accepted += status_update_format_decode_binary(&decoded, binary, (size_t)cut) == 0;
+        }
+        command_format_t command;
+        accepted += command_format_decode_json(&command, json, (size_t)json_length) == 0;
+        accepted += command_format_decode_binary(&command, binary, (size_t)binary_length) == 0;
+        CHECK(status_update_format_encode_json(&message, json, (size_t)json_length - 1) == -1);
+    }
+    CHECK(mismatched == 0);
+    CHECK(accepted == 0);
+    
+    status_update_format_t message;
+    fill_status_update(&message, 0);
+    CHECK(status_update_format_encode_binary(&message, binary, sizeof(binary) - 1) == -1);
+}
+
+static void fill_command(command_format_t* message, int round) {
+    memset(message, 0, sizeof(*message));
+    fill_string(message->drone_id, sizeof(message->drone_id), round);
+    fill_string(message->command, sizeof(message->command), round);
+    fill_raw(message->params, sizeof(message->params));
+    message->timestamp = random_int64(round);
+}
+
+static void test_command(void) {
+    char json[8 * COMMAND_BINARY_MAX_SIZE + 1024];
+    unsigned char binary[COMMAND_BINARY_MAX_SIZE];
+    int mismatched = 0;
+    int accepted = 0;
+    for (int round = 0; round < TEST_ROUNDS; round++) {
+        command_format_t message, decoded;
+        fill_command(&message, round);
+        
+        int json_length = command_format_encode_json(&message, json, sizeof(json));
+        int binary_length = command_format_encode_binary(&message, binary, sizeof(binary));
+        CHECK(json_length > 0 && binary_length > 0);
+        if (json_length <= 0 || binary_length <= 0) continue;
+        CHECK(message_format_detect_json(json, (size_t)json_length) == MESSAGE_FORMAT_COMMAND);
+        CHECK(message_format_detect_binary(binary, (size_t)binary_length) == MESSAGE_FORMAT_COMMAND);
+        
+        CHECK(command_format_decode_json(&decoded, json, (size_t)json_length) == 0);
+        mismatched += memcmp(&decoded, &message, sizeof(message)) != 0;
+        CHECK(command_format_decode_binary(&decoded, binary, (size_t)binary_length) == 0);
+        mismatched += memcmp(&decoded, &message, sizeof(message)) != 0;
+        
+        // Every prefix is refused, and so is every other format's decoder
+        for (int cut = 0; cut < json_length; cut++) {
+            accepted += command_format_decode_json(&decoded, json, (size_t)cut) == 0;
+        }
+        for (int cut = 0; cut < binary_length; cut++) {
+            accepted += command_format_decode_binary(&decoded, binary, (size_t)cut) == 0;
+        }
+        status_update_format_t status_update;
+        accepted += status_update_format_decode_json(&status_update, json, (size_t)json_length) == 0;
+        accepted += status_update_format_decode_binary(&status_update, binary, (size_t)binary_length) == 0;
+        CHECK(command_format_encode_json(&message, json, (size_t)json_length - 1) == -1);
+    }
+    CHECK(mismatched == 0);
+    CHECK(accepted == 0);
+    
+    command_format_t message;
+    fill_command(&message, 0);
+    CHECK(command_format_encode_binary(&message, binary, sizeof(binary) - 1) == -1);
+}
+
+int main(void) {
+    test_status_update();
+    test_command();
+    
+    return TEST_RESULT("message_formats");
+}
@@ -0,0 +1,248 @@
+// tests/test_plan_stream.c
+// Plan streaming: a full transfer over loopback with chunks dropped on
+// the way, components released in plan order when chunks arrive out of
+// order, and announcements the receiver must refuse.
+#include "../include/common.h"
+#include "../src/communication/plan_stream.h"
+#include <stddef.h>
+#include "test.h"
+
+#define TEST_PORT 47931
+#define TEST_COMPONENTS 500
+#define TEST_CHUNKS ((TEST_COMPONENTS + PLAN_COMPONENTS_PER_CHUNK - 1) / PLAN_COMPONENTS_PER_CHUNK)
+
+typedef struct {
+    uint32_t next;              // Index the next component must have
+    int out_of_order;
+    int mismatched;
+} delivery_t;
+
+static void fill_component(plan_component_t* component, uint32_t index) {
+    memset(component, 0, sizeof(plan_component_t));
+    snprintf(component->component_id, sizeof(component->component_id), "beam-%05u", index);
+    component->x = index;
+    component->yaw = index * 0.5;
+    strcpy(component->material_type, "steel");
+}
+
+static void on_component(const plan_component_t* component, uint32_t index, void* user_data) {
+    delivery_t* delivery = (delivery_t*)user_data;
+    plan_component_t expected;
+    fill_component(&expected, index);
+    if (index != delivery->next) delivery->out_of_order++;
+    if (memcmp(component, &expected, sizeof(expected)) != 0) delivery->mismatched++;
+    delivery->next = index + 1;
+}
+
+// Build chunk `index` of a plan of `total` components; returns its length
+static size_t make_chunk(plan_chunk_message_t* chunk, uint32_t plan_id, uint32_t index,
+                         uint32_t total) {
+    uint32_t first = index * PLAN_COMPONENTS_PER_CHUNK;
+    uint32_t count = total - first;
+    if (count > PLAN_COMPONENTS_PER_CHUNK) count = PLAN_COMPONENTS_PER_CHUNK;
+    
+    memset(chunk, 0, sizeof(plan_chunk_message_t));
+    init_message_header(&chunk->header, MSG_PLAN_CHUNK, "planner");
+    chunk->plan_id = plan_id;
+    chunk->chunk_index = index;
+    chunk->total_chunks = (total + PLAN_COMPONENTS_PER_CHUNK - 1) / PLAN_COMPONENTS_PER_CHUNK;
+    chunk->total_components = total;
+    chunk->component_count = (uint16_t)count;
+    strcpy(chunk->building_name, "hangar");
+    for (uint32_t c = 0; c < count; c++) fill_component(&chunk->components[c], first + c);
+    
+    size_t length = offsetof(plan_chunk_message_t, components) + count * sizeof(plan_component_t);
+    chunk->header.payload_length = (uint32_t)(length - sizeof(message_header_t));
+    return length;
+}
+
+static int open_listener(void) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return -1;
+    
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(TEST_PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    struct timeval timeout = { 0, 2000 };
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) != 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Every third chunk of each seven is lost the first time it is sent
+static void test_round_trip(void) {
+    static plan_component_t components[TEST_COMPONENTS];
+    for (uint32_t i = 0; i < TEST_COMPONENTS; i++) fill_component(&components[i], i);
+    
+    int fd = open_listener();
+    udp_context_t* udp = udp_init("127.0.0.1", TEST_PORT);
+    if (udp && network_connect(udp->net_config) != NET_SUCCESS) {
+        udp_cleanup(udp);
+        udp = NULL;
+    }
+    plan_sender_t* sender = udp ? plan_sender_start(udp, "planner", 7, "hangar", 3,
+                                                    components, TEST_COMPONENTS, 16) : NULL;
+    CHECK(fd >= 0 && udp != NULL && sender != NULL);
+    if (fd < 0 || !sender) {
+        if (fd >= 0) close(fd);
+        udp_cleanup(udp);
+        return;
+    }
+    
+    delivery_t delivery = { 0, 0, 0 };
+    plan_receiver_t receiver;
+    plan_receiver_init(&receiver, "builder", on_component, &delivery);
+    
+    unsigned char seen[TEST_CHUNKS] = { 0 };
+    int dropped = 0;
+    int complete = 0;
+    union {
+        uint64_t align;
+        unsigned char bytes[MAX_BUFFER_SIZE];
+    } buffer;
+    uint64_t deadline = network_monotonic_ns() + 5000000000ULL;
+    
+    while (!plan_sender_is_complete(sender) && network_monotonic_ns() < deadline) {
+        CHECK(plan_sender_pump(sender) == NET_SUCCESS);
+        
+        ssize_t received;
+        while ((received = recv(fd, buffer.bytes, sizeof(buffer.bytes), 0)) > 0) {
+            CHECK(validate_message(buffer.bytes, (size_t)received));
+            const plan_chunk_message_t* chunk = (const plan_chunk_message_t*)buffer.bytes;
+            uint32_t index = chunk->chunk_index;
+            if (index < TEST_CHUNKS && seen[index]++ == 0 && index % 7 == 3) {
+                dropped++;
+                continue;
+            }
+            
+            plan_ack_message_t ack;
+            int result = plan_receiver_handle_chunk(&receiver, chunk, (size_t)received, &ack);
+            CHECK(result >= 0);
+            if (result == 1) complete = 1;
+            if (result >= 0) plan_sender_handle_ack(sender, &ack);
+        }
+    }
+    
+    CHECK(plan_sender_is_complete(sender));
+    CHECK(complete);
+    CHECK(dropped > 0);
+    CHECK(sender->chunks_retransmitted >= (unsigned long)dropped);
+    CHECK(delivery.next == TEST_COMPONENTS);
+    CHECK(delivery.out_of_order == 0);
+    CHECK(delivery.mismatched == 0);
+    CHECK(strcmp(receiver.building_name, "hangar") == 0);
+    
+    plan_receiver_cleanup(&receiver);
+    plan_sender_cleanup(sender);
+    udp_cleanup(udp);
+    close(fd);
+}
+
+static void test_out_of_order(void) {
+    delivery_t delivery = { 0, 0, 0 };
+    plan_receiver_t receiver;
+    plan_receiver_init(&receiver, "builder", on_component, &delivery);
+    
+    // Five chunks, the last one short
+    const uint32_t total = 4 * PLAN_COMPONENTS_PER_CHUNK + 5;
+    plan_chunk_message_t chunk;
+    plan_ack_message_t ack;
+    
+    size_t length = make_chunk(&chunk, 1, 4, total);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == 0);
+    length = make_chunk(&chunk, 1, 2, total);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == 0);
+    CHECK(delivery.next == 0);
+    CHECK(ack.plan_id == 1);
+    CHECK(ack.contiguous_chunks == 0);
+    CHECK(ack.chunk_bitmap == ((1ULL << 1) | (1ULL << 3)));
+    
+    // Chunk 0 releases itself only; chunk 1 then releases 1 and 2
+    length = make_chunk(&chunk, 1, 0, total);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == 0);
+    CHECK(delivery.next == PLAN_COMPONENTS_PER_CHUNK);
+    CHECK(ack.contiguous_chunks == 1);
+    length = make_chunk(&chunk, 1, 1, total);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == 0);
+    CHECK(delivery.next == 3 * PLAN_COMPONENTS_PER_CHUNK);
+    CHECK(ack.contiguous_chunks == 3);
+    CHECK(ack.chunk_bitmap == 1ULL);
+    
+    // A duplicate changes nothing
+    length = make_chunk(&chunk, 1, 2, total);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == 0);
+    CHECK(delivery.next == 3 * PLAN_COMPONENTS_PER_CHUNK);
+    
+    length = make_chunk(&chunk, 1, 3, total);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == 1);
+    CHECK(delivery.next == total);
+    CHECK(delivery.out_of_order == 0);
+    CHECK(delivery.mismatched == 0);
+    CHECK(ack.contiguous_chunks == 5);
+    
+    plan_receiver_cleanup(&receiver);
+}
+
+static void test_rejects(void) {
+    delivery_t delivery = { 0, 0, 0 };
+    plan_receiver_t receiver;
+    plan_receiver_init(&receiver, "builder", on_component, &delivery);
+    plan_chunk_message_t chunk;
+    plan_ack_message_t ack;
+    
+    // Larger than any plan the receiver will buffer
+    size_t length = make_chunk(&chunk, 1, 0, PLAN_MAX_COMPONENTS + 1);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == -1);
+    CHECK(!receiver.started);
+    
+    // Chunk count that does not match the component count
+    length = make_chunk(&chunk, 1, 0, 30);
+    chunk.total_chunks = 4;
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == -1);
+    
+    // Truncated datagram, and a component count the index does not allow
+    length = make_chunk(&chunk, 10, 0, 30);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length - 1, &ack) == -1);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, 16, &ack) == -1);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == 0);
+    length = make_chunk(&chunk, 10, 2, 30);
+    chunk.component_count = PLAN_COMPONENTS_PER_CHUNK;
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == -1);
+    length = make_chunk(&chunk, 10, 3, 30);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == -1);
+    
+    // A late chunk of an older plan is ignored, a newer plan restarts
+    length = make_chunk(&chunk, 9, 0, 30);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == -1);
+    CHECK(receiver.plan_id == 10);
+    length = make_chunk(&chunk, 11, 0, 30);
+    CHECK(plan_receiver_handle_chunk(&receiver, &chunk, length, &ack) == 0);
+    CHECK(receiver.plan_id == 11);
+    CHECK(receiver.contiguous_chunks == 1);
+    
+    // The sender refuses plans the receiver would reject
+    plan_component_t component;
+    fill_component(&component, 0);
+    udp_context_t* udp = udp_init("127.0.0.1", TEST_PORT);
+    CHECK(udp != NULL);
+    if (udp) {
+        CHECK(plan_sender_start(udp, "planner", 1, "hangar", 0, &component,
+                                PLAN_MAX_COMPONENTS + 1, 0) == NULL);
+        udp_cleanup(udp);
+    }
+    
+    plan_receiver_cleanup(&receiver);
+}
+
+int main(void) {
+    test_round_trip();
+    test_out_of_order();
+    test_rejects();
+    
+    return TEST_RESULT("plan_stream");
+}
@@ -0,0 +1,320 @@
+// tests/test_priority_queue.c
+// Priority queues: emergency and control strictly first, bulk's share of
+// the low-priority slots, status updates merged per drone, oldest
+// telemetry dropped when full, failed sends put back without loss while
+// pushes race them, and udp_send_message routed through the queue.
+#include "../include/common.h"
+#include "../src/communication/priority_queue.h"
+#include "test.h"
+
+#define TEST_PORT 47951
+
+static size_t make_status(status_update_message_t* status, const char* drone_id, int state,
+                          double x) {
+    memset(status, 0, sizeof(status_update_message_t));
+    init_message_header(&status->header, MSG_STATUS_UPDATE, drone_id);
+    status->header.payload_length = sizeof(status_update_message_t) - sizeof(message_header_t);
+    status->state = state;
+    status->x = x;
+    return sizeof(status_update_message_t);
+}
+
+static size_t make_command(command_message_t* command, int priority, int command_type) {
+    memset(command, 0, sizeof(command_message_t));
+    init_message_header(&command->header, MSG_COMMAND, "control");
+    command->header.payload_length = sizeof(command_message_t) - sizeof(message_header_t);
+    command->priority = priority;
+    command->command_type = command_type;
+    return sizeof(command_message_t);
+}
+
+static size_t make_chunk(plan_chunk_message_t* chunk, uint32_t index) {
+    memset(chunk, 0, sizeof(plan_chunk_message_t));
+    init_message_header(&chunk->header, MSG_PLAN_CHUNK, "planner");
+    chunk->header.payload_length = sizeof(plan_chunk_message_t) - sizeof(message_header_t);
+    chunk->chunk_index = index;
+    return sizeof(plan_chunk_message_t);
+}
+
+// Class of the next message, or -1 if the queue is empty
+static int pop_class(priority_queue_t* queue, void* buffer) {
+    queue_class_t queue_class;
+    size_t length;
+    if (priority_queue_pop(queue, buffer, MAX_BUFFER_SIZE, &length, &queue_class, 0) != NET_SUCCESS) {
+        return -1;
+    }
+    return (int)queue_class;
+}
+
+static void test_strict_priority(void) {
+    priority_queue_t* queue = priority_queue_init(8);
+    CHECK(queue != NULL);
+    if (!queue) return;
+    
+    status_update_message_t status;
+    command_message_t command;
+    plan_chunk_message_t chunk;
+    CHECK(priority_queue_push(queue, &chunk, make_chunk(&chunk, 0)) == NET_SUCCESS);
+    CHECK(priority_queue_push(queue, &status, make_status(&status, "d1", DRONE_STATE_IDLE, 0)) == NET_SUCCESS);
+    CHECK(priority_queue_push(queue, &command, make_command(&command, COMMAND_PRIORITY_NORMAL, 1)) == NET_SUCCESS);
+    CHECK(priority_queue_push(queue, &status, make_status(&status, "d2", DRONE_STATE_EMERGENCY_LANDING, 0)) == NET_SUCCESS);
+    CHECK(priority_queue_push(queue, &command, make_command(&command, COMMAND_PRIORITY_EMERGENCY, 2)) == NET_SUCCESS);
+    CHECK(priority_queue_depth(queue) == 5);
+    
+    char* buffer = (char*)malloc(MAX_BUFFER_SIZE);
+    CHECK(buffer != NULL);
+    if (buffer) {
+        CHECK(pop_class(queue, buffer) == QUEUE_CLASS_EMERGENCY);
+        CHECK(((message_header_t*)buffer)->message_type == MSG_STATUS_UPDATE);
+        CHECK(pop_class(queue, buffer) == QUEUE_CLASS_EMERGENCY);
+        CHECK(((command_message_t*)buffer)->command_type == 2);
+        CHECK(pop_class(queue, buffer) == QUEUE_CLASS_CONTROL);
+        int low = pop_class(queue, buffer);
+        int lowest = pop_class(queue, buffer);
+        CHECK((low == QUEUE_CLASS_BULK && lowest == QUEUE_CLASS_TELEMETRY) ||
+              (low == QUEUE_CLASS_TELEMETRY && lowest == QUEUE_CLASS_BULK));
+        CHECK(pop_class(queue, buffer) == -1);
+    }
+    
+    free(buffer);
+    priority_queue_cleanup(queue);
+}
+
+// With both waiting, bulk gets one of every PRIORITY_QUEUE_BULK_SHARE slots
+static void test_bulk_share(void) {
+    priority_queue_t* queue = priority_queue_init(64);
+    char* buffer = (char*)malloc(MAX_BUFFER_SIZE);
+    CHECK(queue != NULL && buffer != NULL);
+    if (!queue || !buffer) {
+        free(buffer);
+        priority_queue_cleanup(queue);
+        return;
+    }
+    
+    status_update_message_t status;
+    plan_chunk_message_t chunk;
+    for (int i = 0; i < 40; i++) {
+        char drone_id[MAX_DRONE_ID];
+        snprintf(drone_id, sizeof(drone_id), "drone-%02d", i);
+        CHECK(priority_queue_push(queue, &status, make_status(&status, drone_id, DRONE_STATE_IDLE, i)) == NET_SUCCESS);
+        CHECK(priority_queue_push(queue, &chunk, make_chunk(&chunk, (uint32_t)i)) == NET_SUCCESS);
+    }
+    
+    int bulk = 0;
+    uint32_t next_chunk = 0;
+    int in_order = 1;
+    for (int i = 0; i < 8 * PRIORITY_QUEUE_BULK_SHARE; i++) {
+        if (pop_class(queue, buffer) == QUEUE_CLASS_BULK) {
+            if (((plan_chunk_message_t*)buffer)->chunk_index != next_chunk++) in_order = 0;
+            bulk++;
+        }
+    }
+    CHECK(bulk == 8);
+    
+    // Once telemetry runs out bulk takes every slot, still in order
+    int queue_class;
+    while ((queue_class = pop_class(queue, buffer)) >= 0) {
+        if (queue_class == QUEUE_CLASS_BULK) {
+            if (((plan_chunk_message_t*)buffer)->chunk_index != next_chunk++) in_order = 0;
+        }
+    }
+    CHECK(next_chunk == 40);
+    CHECK(in_order);
+    
+    free(buffer);
+    priority_queue_cleanup(queue);
+}
+
+static void test_merge_and_drop(void) {
+    priority_queue_t* queue = priority_queue_init(4);
+    status_update_message_t* popped = (status_update_message_t*)malloc(MAX_BUFFER_SIZE);
+    CHECK(queue != NULL && popped != NULL);
+    if (!queue || !popped) {
+        free(popped);
+        priority_queue_cleanup(queue);
+        return;
+    }
+    
+    // A newer report replaces the queued one and keeps its place
+    status_update_message_t status;
+    CHECK(priority_queue_push(queue, &status, make_status(&status, "d1", DRONE_STATE_IDLE, 1)) == NET_SUCCESS);
+    CHECK(priority_queue_push(queue, &status, make_status(&status, "d2", DRONE_STATE_IDLE, 1)) == NET_SUCCESS);
+    CHECK(priority_queue_push(queue, &status, make_status(&status, "d1", DRONE_STATE_IDLE, 2)) == NET_SUCCESS);
+    CHECK(priority_queue_depth(queue) == 2);
+    CHECK(pop_class(queue, popped) == QUEUE_CLASS_TELEMETRY);
+    CHECK(strcmp(popped->header.drone_id, "d1") == 0 && popped->x == 2);
+    CHECK(pop_class(queue, popped) == QUEUE_CLASS_TELEMETRY);
+    
+    queue_class_stats_t stats;
+    priority_queue_get_stats(queue, QUEUE_CLASS_TELEMETRY, &stats);
+    CHECK(stats.merged == 1);
+    
+    // Six reports into four slots: the two oldest go
+    for (int i = 0; i < 6; i++) {
+        char drone_id[MAX_DRONE_ID];
+        snprintf(drone_id, sizeof(drone_id), "drone-%d", i);
+        CHECK(priority_queue_push(queue, &status, make_status(&status, drone_id, DRONE_STATE_IDLE, i)) == NET_SUCCESS);
+    }
+    for (int i = 2; i < 6; i++) {
+        CHECK(pop_class(queue, popped) == QUEUE_CLASS_TELEMETRY);
+        CHECK(popped->x == i);
+    }
+    priority_queue_get_stats(queue, QUEUE_CLASS_TELEMETRY, &stats);
+    CHECK(stats.dropped == 2);
+    
+    // Full control ring pushes back instead
+    command_message_t command;
+    for (int i = 0; i < 4; i++) {
+        CHECK(priority_queue_push(queue, &command, make_command(&command, 0, i)) == NET_SUCCESS);
+    }
+    CHECK(priority_queue_push(queue, &command, make_command(&command, 0, 4)) == NET_TIMEOUT);
+    priority_queue_get_stats(queue, QUEUE_CLASS_CONTROL, &stats);
+    CHECK(stats.rejected == 1);
+    
+    free(popped);
+    priority_queue_cleanup(queue);
+}
+
+typedef struct {
+    priority_queue_t* queue;
+    int pushed;
+    int popped;
+    int stop;
+} pusher_t;
+
+// Keeps the emergency ring full, making room by popping when refused
+static void* push_loop(void* arg) {
+    pusher_t* pusher = (pusher_t*)arg;
+    command_message_t command;
+    char* buffer = (char*)malloc(MAX_BUFFER_SIZE);
+    if (!buffer) return NULL;
+    
+    while (!__atomic_load_n(&pusher->stop, __ATOMIC_ACQUIRE)) {
+        make_command(&command, COMMAND_PRIORITY_EMERGENCY, pusher->pushed);
+        if (priority_queue_push(pusher->queue, &command, sizeof(command)) == NET_SUCCESS) {
+            pusher->pushed++;
+        } else if (pop_class(pusher->queue, buffer) == QUEUE_CLASS_EMERGENCY) {
+            pusher->popped++;
+        }
+    }
+    free(buffer);
+    return NULL;
+}
+
+// Sends through an unconnected socket fail, so every message taken goes
+// back; none may be lost however the pushes interleave
+static void test_failed_send(void) {
+    priority_queue_t* queue = priority_queue_init(4);
+    udp_context_t* udp = udp_init("127.0.0.1", TEST_PORT);
+    CHECK(queue != NULL && udp != NULL);
+    if (!queue || !udp) {
+        udp_cleanup(udp);
+        priority_queue_cleanup(queue);
+        return;
+    }
+    
+    command_message_t command;
+    for (int i = 0; i < 4; i++) {
+        CHECK(priority_queue_push(queue, &command, make_command(&command, COMMAND_PRIORITY_EMERGENCY, i)) == NET_SUCCESS);
+    }
+    CHECK(priority_queue_send(queue, udp, 4) == 0);
+    CHECK(priority_queue_depth(queue) == 4);
+    command_message_t* popped = (command_message_t*)malloc(MAX_BUFFER_SIZE);
+    CHECK(popped != NULL);
+    for (int i = 0; popped && i < 4; i++) {
+        CHECK(pop_class(queue, popped) == QUEUE_CLASS_EMERGENCY);
+        CHECK(popped->command_type == i);
+    }
+    free(popped);
+    
+    pusher_t pusher = { queue, 0, 0, 0 };
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, push_loop, &pusher) == 0);
+    for (int i = 0; i < 200000; i++) {
+        priority_queue_send(queue, udp, 1);
+    }
+    __atomic_store_n(&pusher.stop, 1, __ATOMIC_RELEASE);
+    pthread_join(thread, NULL);
+    
+    queue_class_stats_t stats;
+    priority_queue_get_stats(queue, QUEUE_CLASS_EMERGENCY, &stats);
+    CHECK(pusher.pushed > 4);
+    CHECK(stats.dropped == 0);
+    CHECK((size_t)(pusher.pushed - pusher.popped) == priority_queue_depth(queue));
+    
+    udp_cleanup(udp);
+    priority_queue_cleanup(queue);
+}
+
+// udp_send_message queues; priority_queue_send delivers most urgent first
+static void test_send_path(void) {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(TEST_PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    struct timeval timeout = { 1, 0 };
+    int bound = fd >= 0 && bind(fd, (struct sockaddr*)&address, sizeof(address)) == 0 &&
+                setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0;
+    
+    priority_queue_t* queue = priority_queue_init(0);
+    udp_context_t* udp = udp_init("127.0.0.1", TEST_PORT);
+    CHECK(bound && queue != NULL && udp != NULL);
+    if (!bound || !queue || !udp || network_connect(udp->net_config) != NET_SUCCESS) {
+        if (fd >= 0) close(fd);
+        udp_cleanup(udp);
+        priority_queue_cleanup(queue);
+        return;
+    }
+    udp_set_outbound_queue(udp, queue);
+    
+    status_update_message_t status;
+    command_message_t command;
+    plan_chunk_message_t chunk;
+    make_status(&status, "d1", DRONE_STATE_IDLE, 0);
+    CHECK(udp_send_message(udp, &status.header, sizeof(status)) == NET_SUCCESS);
+    make_chunk(&chunk, 0);
+    CHECK(udp_send_message(udp, &chunk.header, sizeof(chunk)) == NET_SUCCESS);
+    make_command(&command, COMMAND_PRIORITY_NORMAL, 1);
+    CHECK(udp_send_message(udp, &command.header, sizeof(command)) == NET_SUCCESS);
+    make_command(&command, COMMAND_PRIORITY_EMERGENCY, 2);
+    CHECK(udp_send_message(udp, &command.header, sizeof(command)) == NET_SUCCESS);
+    CHECK(priority_queue_depth(queue) == 4);
+    
+    CHECK(priority_queue_send(queue, udp, 16) == 4);
+    CHECK(priority_queue_depth(queue) == 0);
+    
+    union {
+        uint64_t align;
+        unsigned char bytes[MAX_BUFFER_SIZE];
+    } buffer;
+    const message_header_t* header = (const message_header_t*)buffer.bytes;
+    const command_message_t* received_command = (const command_message_t*)buffer.bytes;
+    ssize_t received = recv(fd, buffer.bytes, sizeof(buffer.bytes), 0);
+    CHECK(received > 0 && validate_message(buffer.bytes, (size_t)received));
+    CHECK(header->message_type == MSG_COMMAND && received_command->command_type == 2);
+    received = recv(fd, buffer.bytes, sizeof(buffer.bytes), 0);
+    CHECK(received > 0 && validate_message(buffer.bytes, (size_t)received));
+    CHECK(header->message_type == MSG_COMMAND && received_command->command_type == 1);
+    for (int i = 0; i < 2; i++) {
+        received = recv(fd, buffer.bytes, sizeof(buffer.bytes), 0);
+        CHECK(received > 0 && validate_message(buffer.bytes, (size_t)received));
+        CHECK(header->message_type == MSG_STATUS_UPDATE || header->message_type == MSG_PLAN_CHUNK);
+    }
+    
+    udp_set_outbound_queue(udp, NULL);
+    udp_cleanup(udp);
+    priority_queue_cleanup(queue);
+    close(fd);
+}
+
+int main(void) {
+    test_strict_priority();
+    test_bulk_share();
+    test_merge_and_drop();
+    test_failed_send();
+    test_send_path();
+    
+    return TEST_RESULT("priority_queue");
+}
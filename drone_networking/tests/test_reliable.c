@@ -0,0 +1,386 @@
+// tests/test_reliable.c
+// Reliable command receive window: sender and receiver restarts, late
+// commands from a replaced sender epoch, and the far-ahead window jump.
+// Then both ends over loopback with chosen datagrams dropped: selective
+// ACKs limit retransmission to what was lost, a lost ACK costs one
+// duplicate, and an unanswered command backs off exponentially until
+// it is reported as failed. Groups take every peer, members joining with
+// a command in flight are not owed it, and registrations past the limits
+// are refused.
+#include "../include/common.h"
+#include "../src/communication/reliable_comm.h"
+#include "test.h"
+
+#define STATION_PORT 47971
+#define DRONE_PORT 47972
+
+static struct sockaddr_in sender_address;
+
+// Deliver one command from "station" as the receiver would see it
+static int deliver(reliable_context_t* receiver, uint32_t epoch, uint16_t base,
+                   uint16_t sequence) {
+    command_message_t command, wire;
+    memset(&command, 0, sizeof(command));
+    init_message_header(&command.header, MSG_COMMAND, "station");
+    command.header.payload_length = sizeof(command_message_t) - sizeof(message_header_t);
+    command.header.message_id = sequence;
+    command.sender_epoch = epoch;
+    command.window_base = base;
+    int length = serialize_message(&command, &wire, sizeof(wire));
+    if (length < 0) return -1;
+    return reliable_handle_message(receiver, &wire, (size_t)length, &sender_address);
+}
+
+static void test_sender_restart(reliable_context_t* receiver) {
+    for (uint16_t sequence = 0; sequence < 500; sequence++) {
+        CHECK(deliver(receiver, 11, sequence, sequence) == 1);
+    }
+    CHECK(deliver(receiver, 11, 0, 499) == 0);
+    
+    // The station restarts with a new epoch and counts from 0 again;
+    // those commands are new, not duplicates of the first run's
+    CHECK(deliver(receiver, 22, 0, 0) == 1);
+    CHECK(deliver(receiver, 22, 0, 1) == 1);
+    CHECK(deliver(receiver, 22, 0, 1) == 0);
+    
+    // A late retransmission from the replaced run changes nothing
+    CHECK(deliver(receiver, 11, 498, 499) == 0);
+    CHECK(deliver(receiver, 22, 2, 2) == 1);
+    CHECK(deliver(receiver, 22, 2, 1) == 0);
+}
+
+static void test_receiver_restart(reliable_context_t* receiver) {
+    // A fresh receiver joins mid-stream: commands from the sender's oldest
+    // unacknowledged one on are still owed, even if they arrive late
+    CHECK(deliver(receiver, 33, 40000, 40002) == 1);
+    CHECK(deliver(receiver, 33, 40000, 40000) == 1);
+    CHECK(deliver(receiver, 33, 40000, 40001) == 1);
+    CHECK(deliver(receiver, 33, 40000, 40001) == 0);
+}
+
+static void test_far_ahead(reliable_context_t* receiver) {
+    CHECK(deliver(receiver, 44, 0, 2) == 1);
+    
+    // Sequence 66 pushes the window so that 2, already delivered, becomes
+    // receive_next; it must stay delivered
+    CHECK(deliver(receiver, 44, 0, 66) == 1);
+    CHECK(deliver(receiver, 44, 0, 2) == 0);
+    CHECK(deliver(receiver, 44, 0, 66) == 0);
+    CHECK(deliver(receiver, 44, 0, 3) == 1);
+}
+
+// Group ACK from member covering every sequence before cumulative
+static void group_ack(reliable_context_t* sender, const char* member, uint16_t tag,
+                      uint16_t cumulative) {
+    acknowledgment_message_t ack, wire;
+    memset(&ack, 0, sizeof(ack));
+    init_message_header(&ack.header, MSG_ACKNOWLEDGMENT, member);
+    ack.header.payload_length = sizeof(ack) - sizeof(message_header_t);
+    ack.cumulative_ack = cumulative;
+    ack.sender_epoch = sender->epoch;
+    ack.group_tag = tag;
+    CHECK(serialize_message(&ack, &wire, sizeof(wire)) > 0);
+    reliable_handle_message(sender, &wire, sizeof(wire), NULL);
+}
+
+static int send_to_group(reliable_context_t* sender) {
+    command_message_t command;
+    memset(&command, 0, sizeof(command));
+    init_message_header(&command.header, MSG_COMMAND, "station");
+    command.header.payload_length = sizeof(command_message_t) - sizeof(message_header_t);
+    return reliable_send_group(sender, "fleet", &command) == NET_SUCCESS ? 0 : -1;
+}
+
+static void test_group_members(reliable_context_t* sender) {
+    char drone_id[MAX_DRONE_ID];
+    CHECK(reliable_add_group(sender, "fleet", "127.0.0.1", 9) == NET_SUCCESS);
+    for (int i = 0; i < RELIABLE_MAX_PEERS; i++) {
+        snprintf(drone_id, sizeof(drone_id), "drone-%02d", i);
+        CHECK(reliable_add_peer(sender, drone_id, "127.0.0.1", 9) == NET_SUCCESS);
+        if (i < 5) CHECK(reliable_group_add_member(sender, "fleet", drone_id) == NET_SUCCESS);
+    }
+    CHECK(reliable_add_peer(sender, "one-too-many", "127.0.0.1", 9) == NET_ERROR);
+    reliable_group_t* group = sender->groups[0];
+    
+    // Addressed to five; the rest join while it is in flight
+    CHECK(send_to_group(sender) == 0);
+    for (int i = 5; i < RELIABLE_MAX_PEERS; i++) {
+        snprintf(drone_id, sizeof(drone_id), "drone-%02d", i);
+        CHECK(reliable_group_add_member(sender, "fleet", drone_id) == NET_SUCCESS);
+    }
+    CHECK(reliable_group_add_member(sender, "fleet", "drone-00") == NET_SUCCESS);
+    CHECK(reliable_group_add_member(sender, "fleet", "one-too-many") == NET_ERROR);
+    CHECK(reliable_group_add_member(sender, "nobody", "drone-00") == NET_ERROR);
+    CHECK(group->member_count == RELIABLE_MAX_PEERS);
+    CHECK(group->member_capacity >= RELIABLE_MAX_PEERS);
+    
+    for (int i = 0; i < 5; i++) {
+        CHECK(group->in_flight == 1);
+        snprintf(drone_id, sizeof(drone_id), "drone-%02d", i);
+        group_ack(sender, drone_id, group->tag, 1);
+    }
+    CHECK(group->in_flight == 0);
+    
+    // The next one is owed to everybody, and done only when all have it
+    CHECK(send_to_group(sender) == 0);
+    for (int i = RELIABLE_MAX_PEERS - 1; i >= 0; i--) {
+        CHECK(group->in_flight == 1);
+        snprintf(drone_id, sizeof(drone_id), "drone-%02d", i);
+        group_ack(sender, drone_id, group->tag, 2);
+        group_ack(sender, drone_id, group->tag, 2);
+    }
+    CHECK(group->in_flight == 0);
+    CHECK(sender->commands_acknowledged == 2);
+    
+    for (int i = 1; i < RELIABLE_MAX_GROUPS; i++) {
+        char name[MAX_DRONE_ID];
+        snprintf(name, sizeof(name), "wing-%d", i);
+        CHECK(reliable_add_group(sender, name, "127.0.0.1", 9) == NET_SUCCESS);
+    }
+    CHECK(reliable_add_group(sender, "one-group-too-many", "127.0.0.1", 9) == NET_ERROR);
+}
+
+// One end of a loopback link
+typedef struct {
+    network_config_t* config;
+    udp_context_t udp;
+    reliable_context_t* reliable;
+    int arrivals;                   // Datagrams received, dropped or not
+    uint64_t arrival_ns[16];        // Times of the first few
+    int delivered[64];              // Times each command sequence was new
+} endpoint_t;
+
+// Decides whether a received datagram is lost
+typedef int (*drop_fn_t)(endpoint_t* endpoint, const message_header_t* header);
+
+static int open_endpoint(endpoint_t* endpoint, int port, const char* local_id) {
+    memset(endpoint, 0, sizeof(*endpoint));
+    endpoint->config = network_init("127.0.0.1", port, NETWORK_MODE_SERVER);
+    if (!endpoint->config) return -1;
+    endpoint->config->local_addr.sin_port = htons(port);
+    if (network_connect(endpoint->config) != NET_SUCCESS) {
+        network_cleanup(endpoint->config);
+        return -1;
+    }
+    network_set_receive_timeout(endpoint->config, 1);
+    endpoint->udp.net_config = endpoint->config;
+    endpoint->reliable = reliable_init(&endpoint->udp, local_id);
+    return endpoint->reliable ? 0 : -1;
+}
+
+static void close_endpoint(endpoint_t* endpoint) {
+    reliable_cleanup(endpoint->reliable);
+    if (endpoint->config) network_cleanup(endpoint->config);
+}
+
+// Hand whatever has arrived to the reliable layer, minus the drops
+static void pump(endpoint_t* endpoint, drop_fn_t drop) {
+    union {
+        uint64_t align;
+        unsigned char bytes[MAX_BUFFER_SIZE];
+    } buffer;
+    size_t length;
+    struct sockaddr_in source;
+    while (network_receive_data_from(endpoint->config, buffer.bytes, sizeof(buffer.bytes),
+                                     &length, &source) == NET_SUCCESS) {
+        const message_header_t* header = (const message_header_t*)buffer.bytes;
+        if (endpoint->arrivals < 16) endpoint->arrival_ns[endpoint->arrivals] = network_monotonic_ns();
+        endpoint->arrivals++;
+        if (drop && drop(endpoint, header)) continue;
+        
+        if (reliable_handle_message(endpoint->reliable, buffer.bytes, length, &source) == 1 &&
+            header->message_id < 64) {
+            endpoint->delivered[header->message_id]++;
+        }
+    }
+}
+
+static int in_flight(endpoint_t* endpoint) {
+    pthread_mutex_lock(&endpoint->reliable->lock);
+    int count = endpoint->reliable->peers[0].in_flight;
+    pthread_mutex_unlock(&endpoint->reliable->lock);
+    return count;
+}
+
+// Run both ends until nothing is in flight or the deadline passes
+static void run_link(endpoint_t* station, endpoint_t* drone, drop_fn_t drop_at_drone,
+                     drop_fn_t drop_at_station, uint64_t timeout_ns) {
+    uint64_t deadline = network_monotonic_ns() + timeout_ns;
+    while (in_flight(station) > 0 && network_monotonic_ns() < deadline) {
+        reliable_poll(station->reliable);
+        pump(drone, drop_at_drone);
+        pump(station, drop_at_station);
+    }
+}
+
+static int send_commands(endpoint_t* station, int count) {
+    for (int i = 0; i < count; i++) {
+        command_message_t command;
+        memset(&command, 0, sizeof(command));
+        init_message_header(&command.header, MSG_COMMAND, "station");
+        command.header.payload_length = sizeof(command_message_t) - sizeof(message_header_t);
+        command.command_type = i;
+        if (reliable_send_command(station->reliable, "drone-1", &command) != NET_SUCCESS) return -1;
+    }
+    return 0;
+}
+
+// First transmissions of commands 3 and 7 are lost
+static int drop_3_and_7(endpoint_t* drone, const message_header_t* header) {
+    (void)drone;
+    static int dropped[2];
+    if (header->message_type != MSG_COMMAND) return 0;
+    if (header->message_id == 3 && !dropped[0]++) return 1;
+    if (header->message_id == 7 && !dropped[1]++) return 1;
+    return 0;
+}
+
+static int drop_first_ack(endpoint_t* station, const message_header_t* header) {
+    (void)station;
+    static int dropped;
+    return header->message_type == MSG_ACKNOWLEDGMENT && !dropped++;
+}
+
+static int drop_all(endpoint_t* drone, const message_header_t* header) {
+    (void)drone;
+    (void)header;
+    return 1;
+}
+
+static int open_link(endpoint_t* station, endpoint_t* drone) {
+    if (open_endpoint(station, STATION_PORT, "station") != 0 ||
+        open_endpoint(drone, DRONE_PORT, "drone-1") != 0 ||
+        reliable_add_peer(station->reliable, "drone-1", "127.0.0.1", DRONE_PORT) != NET_SUCCESS) {
+        close_endpoint(station);
+        close_endpoint(drone);
+        return -1;
+    }
+    return 0;
+}
+
+static void test_selective_retransmit(void) {
+    endpoint_t station, drone;
+    CHECK(open_link(&station, &drone) == 0);
+    if (station.reliable == NULL || drone.reliable == NULL) return;
+    
+    CHECK(send_commands(&station, 10) == 0);
+    
+    // The eight that arrived are acknowledged selectively before any timeout
+    uint64_t deadline = network_monotonic_ns() + 100000000ULL;
+    while (in_flight(&station) > 2 && network_monotonic_ns() < deadline) {
+        pump(&drone, drop_3_and_7);
+        pump(&station, NULL);
+    }
+    CHECK(in_flight(&station) == 2);
+    CHECK(station.reliable->retransmissions == 0);
+    
+    run_link(&station, &drone, drop_3_and_7, NULL, 2000000000ULL);
+    CHECK(in_flight(&station) == 0);
+    CHECK(station.reliable->retransmissions == 2);
+    CHECK(station.reliable->commands_acknowledged == 10);
+    CHECK(drone.reliable->duplicates_received == 0);
+    int delivered_once = 0;
+    for (int i = 0; i < 10; i++) delivered_once += drone.delivered[i] == 1;
+    CHECK(delivered_once == 10);
+    
+    close_endpoint(&station);
+    close_endpoint(&drone);
+}
+
+static void test_lost_ack(void) {
+    endpoint_t station, drone;
+    CHECK(open_link(&station, &drone) == 0);
+    if (station.reliable == NULL || drone.reliable == NULL) return;
+    
+    CHECK(send_commands(&station, 1) == 0);
+    run_link(&station, &drone, NULL, drop_first_ack, 2000000000ULL);
+    CHECK(in_flight(&station) == 0);
+    CHECK(station.reliable->retransmissions == 1);
+    CHECK(drone.delivered[0] == 1);
+    CHECK(drone.reliable->duplicates_received == 1);
+    
+    close_endpoint(&station);
+    close_endpoint(&drone);
+}
+
+static void on_failure(const char* drone_id, const command_message_t* command, void* user_data) {
+    int* failed = (int*)user_data;
+    if (strcmp(drone_id, "drone-1") == 0 && command->command_type == 0) (*failed)++;
+}
+
+// Nothing reaches the drone: each retransmission waits twice as long as
+// the one before, and after the last one the command is given up on
+static void test_backoff(void) {
+    endpoint_t station, drone;
+    CHECK(open_link(&station, &drone) == 0);
+    if (station.reliable == NULL || drone.reliable == NULL) return;
+    
+    int failed = 0;
+    reliable_set_failure_handler(station.reliable, on_failure, &failed);
+    const double rto_ms = 10;
+    station.reliable->peers[0].rto_ms = rto_ms;
+    CHECK(send_commands(&station, 1) == 0);
+    
+    // Watch the first five gaps in real time
+    const int watched = 6;
+    uint64_t deadline = network_monotonic_ns() + 2000000000ULL;
+    while (drone.arrivals < watched && network_monotonic_ns() < deadline) {
+        reliable_poll(station.reliable);
+        pump(&drone, drop_all);
+    }
+    CHECK(drone.arrivals == watched);
+    for (int i = 1; i < watched && i < drone.arrivals; i++) {
+        double gap_ms = (double)(drone.arrival_ns[i] - drone.arrival_ns[i - 1]) / 1e6;
+        double expected_ms = rto_ms * (double)(1 << (i - 1));
+        if (gap_ms < expected_ms * 0.9 || gap_ms > expected_ms + 50) {
+            fprintf(stderr, "retransmission %d after %.1f ms, expected %.1f\n", i, gap_ms, expected_ms);
+        }
+        CHECK(gap_ms >= expected_ms * 0.9 && gap_ms <= expected_ms + 50);
+    }
+    
+    // Skip the long waits by backdating the last send
+    deadline = network_monotonic_ns() + 2000000000ULL;
+    while (failed == 0 && network_monotonic_ns() < deadline) {
+        pthread_mutex_lock(&station.reliable->lock);
+        reliable_slot_t* slot = &station.reliable->peers[0].window[0];
+        if (slot->in_use) slot->last_sent_ns -= (uint64_t)RELIABLE_MAX_RTO_MS * 1000000ULL;
+        pthread_mutex_unlock(&station.reliable->lock);
+        reliable_poll(station.reliable);
+        pump(&drone, drop_all);
+    }
+    pump(&drone, drop_all);
+    CHECK(failed == 1);
+    CHECK(station.reliable->failures == 1);
+    CHECK(station.reliable->retransmissions == RELIABLE_MAX_RETRANSMITS);
+    CHECK(drone.arrivals == 1 + RELIABLE_MAX_RETRANSMITS);
+    CHECK(in_flight(&station) == 0);
+    
+    close_endpoint(&station);
+    close_endpoint(&drone);
+}
+
+int main(void) {
+    memset(&sender_address, 0, sizeof(sender_address));
+    sender_address.sin_family = AF_INET;
+    sender_address.sin_port = htons(9);
+    sender_address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    
+    void (*cases[])(reliable_context_t*) = {
+        test_sender_restart, test_receiver_restart, test_far_ahead, test_group_members
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        udp_context_t* udp = udp_init("127.0.0.1", 9);
+        reliable_context_t* receiver = udp ? reliable_init(udp, "drone-1") : NULL;
+        CHECK(receiver != NULL);
+        if (!receiver) break;
+        cases[i](receiver);
+        reliable_cleanup(receiver);
+        udp_cleanup(udp);
+    }
+    
+    test_selective_retransmit();
+    test_lost_ack();
+    test_backoff();
+    
+    return TEST_RESULT("reliable");
+}
@@ -0,0 +1,112 @@
+// tests/test_replay_window.c
+// Replay window: duplicates, reordering inside the window, sequences that
+// fell out of it, jumps across word boundaries and past the whole window,
+// and a long random stream checked against a plain list of what was seen.
+#include "../include/common.h"
+#include "../src/security/replay_filter.h"
+#include "test.h"
+
+static void test_basic(void) {
+    replay_window_t window;
+    replay_window_init(&window);
+    
+    CHECK(replay_window_check(&window, 5000) == 0);
+    replay_window_accept(&window, 5000);
+    CHECK(replay_window_check(&window, 5000) == -1);
+    
+    // Late but inside the window, once only
+    CHECK(replay_window_check(&window, 4990) == 0);
+    replay_window_accept(&window, 4990);
+    CHECK(replay_window_check(&window, 4990) == -1);
+    CHECK(replay_window_check(&window, 5000 - REPLAY_WINDOW_BITS + 1) == 0);
+    CHECK(replay_window_check(&window, 5000 - REPLAY_WINDOW_BITS) == -1);
+    
+    // Jump by less than the window: the skipped sequences stay acceptable,
+    // the old marks inside the window stay set
+    replay_window_accept(&window, 5000 + 130);
+    CHECK(replay_window_check(&window, 5000) == -1);
+    CHECK(replay_window_check(&window, 4990) == -1);
+    for (uint64_t s = 5001; s < 5130; s++) {
+        CHECK(replay_window_check(&window, s) == 0);
+    }
+    
+    // Jump past the whole window: everything before falls out
+    replay_window_accept(&window, 5130 + REPLAY_WINDOW_BITS + 3);
+    CHECK(replay_window_check(&window, 5130) == -1);
+    CHECK(replay_window_check(&window, 5130 + 4) == 0);
+    CHECK(replay_window_check(&window, 5130 + REPLAY_WINDOW_BITS + 3) == -1);
+}
+
+static void test_wrap(void) {
+    replay_window_t window;
+    replay_window_init(&window);
+    
+    // Slide by strides that end mid-word and wrap around the bitmap, with
+    // a stale mark left in each word the slide passes
+    uint64_t sequence = 60;
+    replay_window_accept(&window, sequence);
+    for (int round = 0; round < 200; round++) {
+        uint64_t stride = 1 + (uint64_t)(round * 37) % (REPLAY_WINDOW_BITS - 1);
+        uint64_t next = sequence + stride;
+        replay_window_accept(&window, next);
+        for (uint64_t s = sequence + 1; s < next; s++) {
+            CHECK(replay_window_check(&window, s) == 0);
+        }
+        CHECK(replay_window_check(&window, next) == -1);
+        sequence = next;
+    }
+}
+
+// Reference: the highest sequence and every sequence accepted so far
+#define MODEL_MAX 20000
+
+static uint64_t model_seen[MODEL_MAX];
+static size_t model_count;
+static uint64_t model_highest;
+
+static int model_check(uint64_t sequence) {
+    if (model_count == 0 || sequence > model_highest) return 0;
+    if (model_highest - sequence >= REPLAY_WINDOW_BITS) return -1;
+    for (size_t i = 0; i < model_count; i++) {
+        if (model_seen[i] == sequence) return -1;
+    }
+    return 0;
+}
+
+static void test_random_stream(void) {
+    replay_window_t window;
+    replay_window_init(&window);
+    model_count = 0;
+    
+    // Mostly forward, some big jumps, some late and duplicate arrivals
+    uint32_t state = 12345;
+    uint64_t front = 1000;
+    for (int i = 0; i < MODEL_MAX; i++) {
+        state = state * 1103515245u + 12345u;
+        uint32_t r = state >> 8;
+        uint64_t sequence;
+        switch (r % 8) {
+            case 0:  sequence = front + 1 + r % (2 * REPLAY_WINDOW_BITS); break;
+            case 1:
+            case 2:  sequence = front > 1200 ? front - r % 1200 : front; break;
+            default: sequence = front + 1 + r % 8; break;
+        }
+        
+        int expected = model_check(sequence);
+        CHECK(replay_window_check(&window, sequence) == expected);
+        if (expected == 0) {
+            replay_window_accept(&window, sequence);
+            model_seen[model_count++] = sequence;
+            if (sequence > model_highest || model_count == 1) model_highest = sequence;
+            if (sequence > front) front = sequence;
+        }
+    }
+}
+
+int main(void) {
+    test_basic();
+    test_wrap();
+    test_random_stream();
+    
+    return TEST_RESULT("replay_window");
+}
@@ -0,0 +1,256 @@
+// tests/test_session.c
+// Session handshake: forged and tampered hellos, replayed hellos and
+// responses, a new handshake over a live session (with and without a lost
+// response), hellos that cross when both sides initiate, and seals on
+// other threads while handshakes replace the keys under them.
+#include "../include/common.h"
+#include "../src/security/session.h"
+#include "test.h"
+
+static unsigned char fleet_key[AEAD_KEY_SIZE];
+
+// Hand a serialized hello to a table as its receive path would
+static int deliver(session_table_t* table, const session_hello_message_t* hello,
+                   session_hello_message_t* response) {
+    message_view_t view;
+    if (message_view_init(&view, hello, sizeof(*hello)) != 0) return -2;
+    return session_handle_hello(table, &view, response);
+}
+
+// Seal a heartbeat on one side and open it on the other, 0 if it arrived
+static int send_frame(session_table_t* from, session_table_t* to) {
+    union {
+        uint64_t align;
+        unsigned char bytes[sizeof(heartbeat_message_t) + SESSION_TRAILER_SIZE];
+    } frame;
+    heartbeat_message_t heartbeat;
+    memset(&heartbeat, 0, sizeof(heartbeat));
+    init_message_header(&heartbeat.header, MSG_HEARTBEAT, from->local_id);
+    heartbeat.header.payload_length = sizeof(heartbeat) - sizeof(message_header_t);
+    memcpy(frame.bytes, &heartbeat, sizeof(heartbeat));
+    
+    security_session_t* session = session_find(from, to->local_id);
+    int length = session_seal(from, session, frame.bytes, sizeof(heartbeat), sizeof(frame.bytes));
+    if (length < 0) return -1;
+    int opened = session_open_frame(to, frame.bytes, (size_t)length, NULL);
+    return opened == (int)sizeof(heartbeat) ? 0 : -1;
+}
+
+static int both_ways(session_table_t* a, session_table_t* b) {
+    return send_frame(a, b) == 0 && send_frame(b, a) == 0 ? 0 : -1;
+}
+
+static int handshake(session_table_t* initiator, session_table_t* responder) {
+    session_hello_message_t hello, response;
+    if (session_initiate(initiator, responder->local_id, &hello) != 0) return -1;
+    if (deliver(responder, &hello, &response) != 1) return -1;
+    return deliver(initiator, &response, NULL);
+}
+
+static void test_forgery(session_table_t* a, session_table_t* b) {
+    // Same drone_id, wrong fleet key
+    unsigned char other_key[AEAD_KEY_SIZE];
+    memset(other_key, 0x5a, sizeof(other_key));
+    session_table_t* intruder = session_table_init("drone-a", other_key, 4);
+    CHECK(intruder != NULL);
+    if (!intruder) return;
+    
+    session_hello_message_t hello, response;
+    CHECK(session_initiate(intruder, "drone-b", &hello) == 0);
+    CHECK(deliver(b, &hello, &response) == -1);
+    CHECK(session_find(b, "drone-a") == NULL);
+    
+    // A real hello with its random value changed, checksum redone
+    CHECK(session_initiate(a, "drone-b", &hello) == 0);
+    session_hello_message_t tampered = hello;
+    tampered.random[0] ^= 0x01;
+    session_hello_message_t wire;
+    CHECK(serialize_message(&tampered, &wire, sizeof(wire)) > 0);
+    CHECK(deliver(b, &wire, &response) == -1);
+    CHECK(b->handshakes_rejected == 2);
+    
+    // The untouched hello still works, and a forgery cannot disturb the
+    // session it set up
+    CHECK(deliver(b, &hello, &response) == 1);
+    CHECK(deliver(a, &response, NULL) == 0);
+    CHECK(both_ways(a, b) == 0);
+    CHECK(session_initiate(intruder, "drone-b", &hello) == 0);
+    CHECK(deliver(b, &hello, &response) == -1);
+    CHECK(both_ways(a, b) == 0);
+    
+    session_table_cleanup(intruder);
+}
+
+static void test_replay(session_table_t* a, session_table_t* b) {
+    session_hello_message_t hello, response;
+    CHECK(session_initiate(a, "drone-b", &hello) == 0);
+    CHECK(deliver(b, &hello, &response) == 1);
+    CHECK(deliver(a, &response, NULL) == 0);
+    CHECK(both_ways(a, b) == 0);
+    
+    // Recorded traffic played back changes nothing
+    session_hello_message_t ignored;
+    CHECK(deliver(b, &hello, &ignored) == -1);
+    CHECK(b->handshakes_stale == 1);
+    CHECK(deliver(a, &response, NULL) == -1);
+    CHECK(both_ways(a, b) == 0);
+    
+    // Also after a later handshake moved the session on
+    CHECK(handshake(a, b) == 0);
+    CHECK(both_ways(a, b) == 0);
+    CHECK(deliver(b, &hello, &ignored) == -1);
+    CHECK(both_ways(a, b) == 0);
+}
+
+static void test_rehandshake(session_table_t* a, session_table_t* b) {
+    CHECK(handshake(a, b) == 0);
+    CHECK(both_ways(a, b) == 0);
+    
+    // The response is lost: both sides stay on the live keys
+    session_hello_message_t hello, response;
+    CHECK(session_initiate(a, "drone-b", &hello) == 0);
+    CHECK(deliver(b, &hello, &response) == 1);
+    CHECK(both_ways(a, b) == 0);
+    CHECK(both_ways(a, b) == 0);
+    
+    // A retry completes. b sends on the old key until a's first frame
+    // under the new ones, and a still opens those frames meanwhile.
+    CHECK(session_initiate(a, "drone-b", &hello) == 0);
+    CHECK(deliver(b, &hello, &response) == 1);
+    CHECK(send_frame(b, a) == 0);
+    CHECK(deliver(a, &response, NULL) == 0);
+    CHECK(send_frame(b, a) == 0);
+    CHECK(send_frame(a, b) == 0);
+    CHECK(send_frame(b, a) == 0);
+    
+    security_session_t* at_a = session_find(a, "drone-b");
+    security_session_t* at_b = session_find(b, "drone-a");
+    CHECK(at_a && at_b && at_a->tx.epoch == at_b->rx.epoch && at_b->tx.epoch == at_a->rx.epoch);
+    CHECK(at_b && at_b->key_switch == SESSION_SWITCH_NONE);
+}
+
+static void test_crossed(session_table_t* a, session_table_t* b) {
+    // Both initiate; b's side arrives first at a. drone-a sorts lower, so
+    // it stays initiator and b answers its hello
+    session_hello_message_t from_a, from_b, response;
+    CHECK(session_initiate(a, "drone-b", &from_a) == 0);
+    CHECK(session_initiate(b, "drone-a", &from_b) == 0);
+    CHECK(deliver(a, &from_b, &response) == -1);
+    CHECK(deliver(b, &from_a, &response) == 1);
+    CHECK(deliver(a, &response, NULL) == 0);
+    CHECK(both_ways(a, b) == 0);
+    
+    // Again over the live session, with a hearing b's hello last
+    CHECK(session_initiate(a, "drone-b", &from_a) == 0);
+    CHECK(session_initiate(b, "drone-a", &from_b) == 0);
+    CHECK(deliver(b, &from_a, &response) == 1);
+    CHECK(deliver(a, &response, NULL) == 0);
+    session_hello_message_t stray;
+    CHECK(deliver(a, &from_b, &stray) == -1);  // Older than b's response
+    CHECK(both_ways(a, b) == 0);
+    CHECK(both_ways(a, b) == 0);
+}
+
+// Seals on one table's session for its peer until stopped, keeping each
+// frame's nonce
+#define SEALER_MAX_FRAMES 400000
+
+typedef struct {
+    session_table_t* table;
+    const char* peer_id;
+    unsigned char (*nonces)[AEAD_NONCE_SIZE];
+    size_t count;
+    int stop;
+} sealer_t;
+
+static void* seal_loop(void* arg) {
+    sealer_t* sealer = (sealer_t*)arg;
+    security_session_t* session = session_find(sealer->table, sealer->peer_id);
+    union {
+        uint64_t align;
+        unsigned char bytes[sizeof(heartbeat_message_t) + SESSION_TRAILER_SIZE];
+    } frame;
+    
+    while (!__atomic_load_n(&sealer->stop, __ATOMIC_RELAXED) && sealer->count < SEALER_MAX_FRAMES) {
+        memset(frame.bytes, 0, sizeof(frame.bytes));
+        init_message_header((message_header_t*)frame.bytes, MSG_HEARTBEAT, sealer->table->local_id);
+        int length = session_seal(sealer->table, session, frame.bytes, sizeof(heartbeat_message_t),
+                                  sizeof(frame.bytes));
+        if (length < 0) continue;
+        memcpy(sealer->nonces[sealer->count++], frame.bytes + sizeof(heartbeat_message_t),
+               AEAD_NONCE_SIZE);
+    }
+    return NULL;
+}
+
+static int compare_nonces(const void* a, const void* b) {
+    return memcmp(a, b, AEAD_NONCE_SIZE);
+}
+
+static size_t repeated_nonces(sealer_t* sealer) {
+    qsort(sealer->nonces, sealer->count, AEAD_NONCE_SIZE, compare_nonces);
+    size_t repeats = 0;
+    for (size_t i = 1; i < sealer->count; i++) {
+        if (memcmp(sealer->nonces[i - 1], sealer->nonces[i], AEAD_NONCE_SIZE) == 0) repeats++;
+    }
+    return repeats;
+}
+
+static void test_concurrent(session_table_t* a, session_table_t* b) {
+    CHECK(handshake(a, b) == 0);
+    
+    // Both sides seal nonstop while the main thread rehandshakes and
+    // confirms each new session with a frame each way
+    sealer_t sealers[2] = {
+        { a, "drone-b", calloc(SEALER_MAX_FRAMES, AEAD_NONCE_SIZE), 0, 0 },
+        { b, "drone-a", calloc(SEALER_MAX_FRAMES, AEAD_NONCE_SIZE), 0, 0 }
+    };
+    CHECK(sealers[0].nonces != NULL && sealers[1].nonces != NULL);
+    if (!sealers[0].nonces || !sealers[1].nonces) {
+        free(sealers[0].nonces);
+        free(sealers[1].nonces);
+        return;
+    }
+    pthread_t threads[2];
+    for (int i = 0; i < 2; i++) {
+        pthread_create(&threads[i], NULL, seal_loop, &sealers[i]);
+    }
+    
+    for (int round = 0; round < 2000; round++) {
+        CHECK(handshake(a, b) == 0);
+        CHECK(send_frame(a, b) == 0);
+        CHECK(send_frame(b, a) == 0);
+    }
+    for (int i = 0; i < 2; i++) {
+        __atomic_store_n(&sealers[i].stop, 1, __ATOMIC_RELAXED);
+        pthread_join(threads[i], NULL);
+    }
+    
+    // No nonce sealed twice on either side, and both still have working keys
+    CHECK(sealers[0].count > 0 && sealers[1].count > 0);
+    CHECK(repeated_nonces(&sealers[0]) == 0);
+    CHECK(repeated_nonces(&sealers[1]) == 0);
+    CHECK(both_ways(a, b) == 0);
+    free(sealers[0].nonces);
+    free(sealers[1].nonces);
+}
+
+int main(void) {
+    for (int i = 0; i < AEAD_KEY_SIZE; i++) {
+        fleet_key[i] = (unsigned char)(i * 7 + 1);
+    }
+    
+    void (*cases[])(session_table_t*, session_table_t*) = {
+        test_forgery, test_replay, test_rehandshake, test_crossed, test_concurrent
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        session_table_t* a = session_table_init("drone-a", fleet_key, 4);
+        session_table_t* b = session_table_init("drone-b", fleet_key, 4);
+        CHECK(a != NULL && b != NULL);
+        if (a && b) cases[i](a, b);
+        session_table_cleanup(a);
+        session_table_cleanup(b);
+    }
+    
+    return TEST_RESULT("session");
+}
@@ -0,0 +1,76 @@
+// tests/test_sharded_server.c
+// Sharded receive: datagrams reach the handler, and a shard whose socket
+// fails on every call backs off and gives up instead of spinning, while
+// the other shards keep receiving.
+#include "../include/common.h"
+#include "../src/core/sharded_server.h"
+#include <fcntl.h>
+#include "test.h"
+
+#define TEST_PORT 47981
+#define TEST_SHARDS 2
+
+static int received = 0;
+
+static void on_datagram(int shard_id, network_config_t* shard_config, const void* data,
+                        size_t length, const struct sockaddr_in* source, void* user_data) {
+    (void)shard_id;
+    (void)shard_config;
+    (void)data;
+    (void)length;
+    (void)source;
+    (void)user_data;
+    __atomic_fetch_add(&received, 1, __ATOMIC_RELAXED);
+}
+
+static void test_broken_shard(void) {
+    sharded_server_t* server = sharded_server_init(TEST_PORT, TEST_SHARDS, 0, on_datagram, NULL);
+    CHECK(server != NULL);
+    if (!server) return;
+    CHECK(sharded_server_start(server) == NET_SUCCESS);
+    
+    // Shard 0's descriptor now names a file, so every receive fails at once
+    server_shard_t* broken = &server->shards[0];
+    int null_fd = open("/dev/null", O_RDONLY);
+    CHECK(null_fd >= 0 && dup2(null_fd, broken->net_config->socket_fd) >= 0);
+    if (null_fd >= 0) close(null_fd);
+    
+    uint64_t started = network_monotonic_ns();
+    while (!__atomic_load_n(&broken->failed, __ATOMIC_ACQUIRE) &&
+           network_monotonic_ns() - started < 3000000000ULL) {
+        struct timespec pause = { 0, 1000000 };
+        nanosleep(&pause, NULL);
+    }
+    CHECK(broken->failed);
+    CHECK(!server->shards[1].failed);
+    network_stats_t stats;
+    network_get_stats(broken->net_config, &stats);
+    CHECK(stats.errors == SHARDED_SERVER_MAX_ERRORS);
+    
+    // The healthy shard still takes traffic for the port
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(TEST_PORT);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    for (int i = 0; i < 20 && fd >= 0; i++) {
+        sendto(fd, "ping", 4, 0, (struct sockaddr*)&address, sizeof(address));
+    }
+    started = network_monotonic_ns();
+    while (__atomic_load_n(&received, __ATOMIC_RELAXED) == 0 &&
+           network_monotonic_ns() - started < 1000000000ULL) {
+        struct timespec pause = { 0, 1000000 };
+        nanosleep(&pause, NULL);
+    }
+    CHECK(__atomic_load_n(&received, __ATOMIC_RELAXED) > 0);
+    if (fd >= 0) close(fd);
+    
+    sharded_server_cleanup(server);
+}
+
+int main(void) {
+    test_broken_shard();
+    
+    return TEST_RESULT("sharded_server");
+}
@@ -0,0 +1,173 @@
+// tests/test_status_delta.c
+// Delta telemetry codec: keyframe/delta round trip within the encoder's
+// tolerances, base-keyframe loss, stream separation, and routing through
+// the message dispatcher.
+#include "../include/common.h"
+#include "../src/protocols/message_protocol.h"
+#include "test.h"
+#include <stddef.h>
+
+#define TEST_FRAME_SIZE 512
+
+static void make_status(status_update_message_t* status, int step) {
+    memset(status, 0, sizeof(*status));
+    init_message_header(&status->header, MSG_STATUS_UPDATE, "drone-7");
+    status->header.payload_length = sizeof(*status) - sizeof(message_header_t);
+    status->header.timestamp = 1760000000000000000ULL + (uint64_t)step * 100000123ULL;
+    // Straight flight with a turn halfway, so some fields need residuals
+    double t = step * 0.1;
+    status->vx = 2.0;
+    status->vy = step < 20 ? 0.0 : 1.5;
+    status->x = 10.0 + 2.0 * t;
+    status->y = step < 20 ? 5.0 : 5.0 + 1.5 * (t - 2.0);
+    status->z = 30.0;
+    status->battery_level = 90.0 - step * 0.05;
+    status->state = step < 30 ? 1 : 3;
+    status->construction_progress = step / 4;
+}
+
+static int close_to(double a, double b, double epsilon) {
+    return a - b <= epsilon && b - a <= epsilon;
+}
+
+static void test_round_trip(void) {
+    status_delta_encoder_t encoder;
+    status_delta_decoder_t decoder;
+    status_delta_encoder_init(&encoder, 7, 0);
+    status_delta_decoder_init(&decoder);
+    
+    unsigned char frame[TEST_FRAME_SIZE];
+    int keyframes = 0, deltas = 0;
+    size_t delta_bytes = 0;
+    for (int step = 0; step < 100; step++) {
+        status_update_message_t sent, received;
+        make_status(&sent, step);
+        int length = encode_status_delta(&encoder, &sent, frame, sizeof(frame));
+        CHECK(length >= STATUS_DELTA_HEADER_SIZE);
+        
+        status_delta_header_t header;
+        CHECK(read_status_delta_header(frame, (size_t)length, &header) == 0);
+        CHECK(header.stream_id == 7);
+        
+        int kind = decode_status_delta(&decoder, frame, (size_t)length, &received);
+        CHECK(kind == 0 || kind == 1);
+        if (kind == 1) {
+            keyframes++;
+            CHECK(memcmp(&received.x, &sent.x,
+                         sizeof(sent) - offsetof(status_update_message_t, x)) == 0);
+            CHECK(received.header.timestamp == sent.header.timestamp);
+            status_delta_acknowledge(&encoder, received.header.message_id);
+        } else {
+            deltas++;
+            delta_bytes += (size_t)length;
+            CHECK(close_to(received.x, sent.x, encoder.position_epsilon));
+            CHECK(close_to(received.y, sent.y, encoder.position_epsilon));
+            CHECK(close_to(received.z, sent.z, encoder.position_epsilon));
+            CHECK(close_to(received.vy, sent.vy, encoder.velocity_epsilon));
+            CHECK(close_to(received.battery_level, sent.battery_level, encoder.battery_epsilon));
+            CHECK(received.state == sent.state);
+            CHECK(received.construction_progress == sent.construction_progress);
+            // Delta time travels in microseconds
+            uint64_t error = received.header.timestamp > sent.header.timestamp
+                           ? received.header.timestamp - sent.header.timestamp
+                           : sent.header.timestamp - received.header.timestamp;
+            CHECK(error <= STATUS_DELTA_TIME_UNIT_NS / 2);
+        }
+    }
+    CHECK(keyframes >= 100 / STATUS_DELTA_KEYFRAME_INTERVAL);
+    CHECK(deltas > 80);
+    CHECK(delta_bytes / (size_t)deltas < sizeof(status_update_message_t) / 2);
+}
+
+static void test_lost_keyframe(void) {
+    status_delta_encoder_t encoder;
+    status_delta_decoder_t decoder;
+    status_delta_encoder_init(&encoder, 1, 0);
+    encoder.auto_acknowledge = 1;
+    status_delta_decoder_init(&decoder);
+    
+    unsigned char frame[TEST_FRAME_SIZE];
+    status_update_message_t status, received;
+    make_status(&status, 0);
+    CHECK(encode_status_delta(&encoder, &status, frame, sizeof(frame)) > 0);
+    
+    // The keyframe never arrives, so the delta has no base
+    make_status(&status, 1);
+    int length = encode_status_delta(&encoder, &status, frame, sizeof(frame));
+    CHECK(length > 0);
+    CHECK(decode_status_delta(&decoder, frame, (size_t)length, &received) == -1);
+    CHECK(decode_status_delta(&decoder, frame, 4, &received) == -1);
+}
+
+static void test_streams_kept_apart(void) {
+    status_delta_encoder_t first, second;
+    status_delta_decoder_t decoder;
+    status_delta_encoder_init(&first, 1, 0);
+    status_delta_encoder_init(&second, 2, 0);
+    first.auto_acknowledge = 1;
+    second.auto_acknowledge = 1;
+    status_delta_decoder_init(&decoder);
+    
+    unsigned char frame[TEST_FRAME_SIZE];
+    status_update_message_t status, received;
+    make_status(&status, 0);
+    int length = encode_status_delta(&first, &status, frame, sizeof(frame));
+    CHECK(decode_status_delta(&decoder, frame, (size_t)length, &received) == 1);
+    
+    // Both streams start at sequence 0; the second one's keyframe must not
+    // replace the first one's
+    status.x = 500.0;
+    length = encode_status_delta(&second, &status, frame, sizeof(frame));
+    CHECK(decode_status_delta(&decoder, frame, (size_t)length, &received) == -1);
+    
+    make_status(&status, 1);
+    length = encode_status_delta(&first, &status, frame, sizeof(frame));
+    CHECK(decode_status_delta(&decoder, frame, (size_t)length, &received) == 0);
+    CHECK(close_to(received.x, status.x, first.position_epsilon));
+}
+
+typedef struct {
+    status_delta_decoder_t decoder;
+    int decoded;
+} delta_receiver_t;
+
+static void decode_delivered(const void* frame, size_t length, void* user_data) {
+    delta_receiver_t* receiver = (delta_receiver_t*)user_data;
+    status_update_message_t received;
+    if (decode_status_delta(&receiver->decoder, frame, length, &received) >= 0) {
+        receiver->decoded++;
+    }
+}
+
+static void test_dispatch(void) {
+    status_delta_encoder_t encoder;
+    delta_receiver_t receiver = { .decoded = 0 };
+    status_delta_encoder_init(&encoder, 1, 0);
+    encoder.auto_acknowledge = 1;
+    status_delta_decoder_init(&receiver.decoder);
+    
+    message_dispatcher_t dispatcher;
+    message_dispatcher_init(&dispatcher);
+    unsigned char frame[TEST_FRAME_SIZE];
+    status_update_message_t status;
+    make_status(&status, 0);
+    int length = encode_status_delta(&encoder, &status, frame, sizeof(frame));
+    
+    // Without a delta handler the frame is unhandled, not a checksum failure
+    CHECK(message_dispatch(&dispatcher, frame, (size_t)length) == 0);
+    
+    message_dispatcher_set_delta_handler(&dispatcher, decode_delivered, &receiver);
+    CHECK(message_dispatch(&dispatcher, frame, (size_t)length) == 1);
+    make_status(&status, 1);
+    length = encode_status_delta(&encoder, &status, frame, sizeof(frame));
+    CHECK(message_dispatch(&dispatcher, frame, (size_t)length) == 1);
+    CHECK(receiver.decoded == 2);
+}
+
+int main(void) {
+    test_round_trip();
+    test_lost_keyframe();
+    test_streams_kept_apart();
+    test_dispatch();
+    return TEST_RESULT("status_delta");
+}
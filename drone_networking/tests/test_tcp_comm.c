@@ -0,0 +1,222 @@
+// tests/test_tcp_comm.c
+// Bulk transport over loopback: a frame far larger than both socket
+// buffers goes out in many partial writes and arrives intact, a peer that
+// stops reading fails the send after the connection's I/O timeout (not
+// the default) and breaks the connection mid-frame, and a peer that
+// closes turns the next sends into errors instead of a hang or SIGPIPE.
+#include "../include/common.h"
+#include "../src/communication/tcp_comm.h"
+#include <time.h>
+#include "test.h"
+
+#define TEST_PORT 47991
+#define TEST_FRAME_SIZE (4 * 1024 * 1024)
+#define TEST_SOCKET_BUFFER 16384
+#define TEST_TIMEOUT_MS 200
+
+typedef struct {
+    tcp_connection_t* connection;
+    const unsigned char* data;
+    size_t length;
+    network_result_t result;
+} sender_t;
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+
+static void pause_ms(long ms) {
+    struct timespec pause = { ms / 1000, (ms % 1000) * 1000000 };
+    nanosleep(&pause, NULL);
+}
+
+static void shrink_buffers(tcp_connection_t* connection) {
+    int size = TEST_SOCKET_BUFFER;
+    setsockopt(connection->socket_fd, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+    setsockopt(connection->socket_fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+}
+
+// Connect a client to the listener and accept its server side
+static int open_pair(tcp_listener_t* listener, tcp_connection_t** client,
+                     tcp_connection_t** server) {
+    *server = NULL;
+    *client = tcp_connect("127.0.0.1", TEST_PORT);
+    if (!*client) return -1;
+    
+    for (int tries = 0; tries < 100 && !*server; tries++) {
+        *server = tcp_accept(listener);
+        if (!*server) pause_ms(10);
+    }
+    if (!*server) {
+        tcp_close(*client);
+        *client = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static void* send_frame(void* arg) {
+    sender_t* sender = (sender_t*)arg;
+    sender->result = tcp_send_frame(sender->connection, sender->data, sender->length);
+    return NULL;
+}
+
+static unsigned char* make_pattern(size_t length) {
+    unsigned char* data = (unsigned char*)malloc(length);
+    if (!data) return NULL;
+    
+    uint32_t state = 1234;
+    for (size_t i = 0; i < length; i++) {
+        state = state * 1103515245u + 12345u;
+        data[i] = (unsigned char)(state >> 16);
+    }
+    return data;
+}
+
+static void test_partial_writes(tcp_listener_t* listener) {
+    tcp_connection_t* client;
+    tcp_connection_t* server;
+    CHECK(open_pair(listener, &client, &server) == 0);
+    
+    unsigned char* data = make_pattern(TEST_FRAME_SIZE);
+    unsigned char* received = (unsigned char*)malloc(TEST_FRAME_SIZE);
+    CHECK(data != NULL && received != NULL);
+    if (!client || !server || !data || !received) {
+        free(data);
+        free(received);
+        tcp_close(client);
+        tcp_close(server);
+        return;
+    }
+    shrink_buffers(client);
+    shrink_buffers(server);
+    
+    // The sender blocks in write_all while this thread reads slowly
+    sender_t sender = { client, data, TEST_FRAME_SIZE, NET_ERROR };
+    pthread_t thread;
+    CHECK(pthread_create(&thread, NULL, send_frame, &sender) == 0);
+    
+    size_t length = 0;
+    network_result_t result = NET_TIMEOUT;
+    uint64_t deadline = now_ms() + 10000;
+    while (result == NET_TIMEOUT && now_ms() < deadline) {
+        result = tcp_receive_frame(server, received, TEST_FRAME_SIZE, &length);
+        if (result == NET_TIMEOUT) pause_ms(1);
+    }
+    pthread_join(thread, NULL);
+    
+    CHECK(sender.result == NET_SUCCESS);
+    CHECK(result == NET_SUCCESS);
+    CHECK(length == TEST_FRAME_SIZE);
+    CHECK(memcmp(received, data, TEST_FRAME_SIZE) == 0);
+    CHECK(client->bytes_sent == TEST_FRAME_SIZE + sizeof(uint32_t));
+    CHECK(client->frames_sent == 1 && server->frames_received == 1);
+    CHECK(client->is_connected);
+    
+    // The stream stays framed for the next message
+    CHECK(tcp_send_frame(client, "next", 4) == NET_SUCCESS);
+    result = NET_TIMEOUT;
+    deadline = now_ms() + 1000;
+    while (result == NET_TIMEOUT && now_ms() < deadline) {
+        result = tcp_receive_frame(server, received, TEST_FRAME_SIZE, &length);
+    }
+    CHECK(result == NET_SUCCESS && length == 4 && memcmp(received, "next", 4) == 0);
+    
+    free(data);
+    free(received);
+    tcp_close(client);
+    tcp_close(server);
+}
+
+static void test_send_timeout(tcp_listener_t* listener) {
+    tcp_connection_t* client;
+    tcp_connection_t* server;
+    CHECK(open_pair(listener, &client, &server) == 0);
+    
+    unsigned char* data = make_pattern(TEST_FRAME_SIZE);
+    CHECK(data != NULL);
+    if (!client || !server || !data) {
+        free(data);
+        tcp_close(client);
+        tcp_close(server);
+        return;
+    }
+    shrink_buffers(client);
+    shrink_buffers(server);
+    
+    CHECK(client->io_timeout_ms == TCP_IO_TIMEOUT_MS);
+    CHECK(tcp_set_io_timeout(client, -1) == NET_ERROR);
+    CHECK(tcp_set_io_timeout(client, TEST_TIMEOUT_MS) == NET_SUCCESS);
+    
+    // Nobody reads, so the frame stops partway and the stream is unusable
+    uint64_t started = now_ms();
+    CHECK(tcp_send_frame(client, data, TEST_FRAME_SIZE) == NET_TIMEOUT);
+    uint64_t elapsed = now_ms() - started;
+    CHECK(elapsed >= TEST_TIMEOUT_MS && elapsed < TCP_IO_TIMEOUT_MS);
+    CHECK(client->bytes_sent > 0 && client->bytes_sent < TEST_FRAME_SIZE);
+    CHECK(client->frames_sent == 0);
+    CHECK(!client->is_connected);
+    CHECK(tcp_send_frame(client, "late", 4) == NET_ERROR);
+    
+    free(data);
+    tcp_close(client);
+    tcp_close(server);
+}
+
+static void test_peer_close(tcp_listener_t* listener) {
+    tcp_connection_t* client;
+    tcp_connection_t* server;
+    CHECK(open_pair(listener, &client, &server) == 0);
+    if (!client || !server) {
+        tcp_close(client);
+        tcp_close(server);
+        return;
+    }
+    
+    // The first send after the close may still be accepted; the reset it
+    // provokes fails a later one
+    tcp_close(server);
+    network_result_t result = NET_SUCCESS;
+    for (int i = 0; i < 100 && result == NET_SUCCESS; i++) {
+        result = tcp_send_frame(client, "after close", 11);
+        if (result == NET_SUCCESS) pause_ms(5);
+    }
+    CHECK(result == NET_DISCONNECTED || result == NET_ERROR);
+    CHECK(!client->is_connected);
+    tcp_close(client);
+    
+    // A reader sees end of stream
+    CHECK(open_pair(listener, &client, &server) == 0);
+    if (!client || !server) {
+        tcp_close(client);
+        tcp_close(server);
+        return;
+    }
+    tcp_close(client);
+    
+    char buffer[64];
+    result = NET_TIMEOUT;
+    uint64_t deadline = now_ms() + 1000;
+    while (result == NET_TIMEOUT && now_ms() < deadline) {
+        result = tcp_receive_frame(server, buffer, sizeof(buffer), NULL);
+        if (result == NET_TIMEOUT) pause_ms(1);
+    }
+    CHECK(result == NET_DISCONNECTED);
+    CHECK(!server->is_connected);
+    tcp_close(server);
+}
+
+int main(void) {
+    tcp_listener_t* listener = tcp_listen(TEST_PORT);
+    CHECK(listener != NULL);
+    if (listener) {
+        test_partial_writes(listener);
+        test_send_timeout(listener);
+        test_peer_close(listener);
+        tcp_listener_close(listener);
+    }
+    
+    return TEST_RESULT("tcp_comm");
+}
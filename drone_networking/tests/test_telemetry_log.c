@@ -0,0 +1,285 @@
+// tests/test_telemetry_log.c
+// Telemetry log timestamps: a drone reporting an hour ahead must not hide
+// the records after it from range queries, range and per-drone queries
+// must agree with a full scan under clock disagreement and wild
+// timestamps, the gateway's JSON path must not overflow seconds, and a
+// log that outgrows max_segments keeps appending by retiring its oldest.
+#include "../include/common.h"
+#include "../src/storage/telemetry_log.h"
+#include "../src/communication/fleet_gateway.h"
+#include <dirent.h>
+#include "test.h"
+
+#define TEST_EPOCH_NS 1760000000000000000ULL
+#define MS 1000000ULL
+
+static int count_visit(uint64_t record_number, const telemetry_record_t* record, void* user_data) {
+    (void)record_number;
+    (void)record;
+    (*(long*)user_data)++;
+    return 0;
+}
+
+static telemetry_log_t* open_log(char* path, uint64_t max_skew_ns) {
+    if (!mkdtemp(path)) return NULL;
+    
+    telemetry_log_config_t config;
+    telemetry_log_default_config(&config);
+    config.segment_records = 512;
+    config.index_interval = 16;
+    config.max_drones = 64;
+    if (max_skew_ns) config.max_skew_ns = max_skew_ns;
+    return telemetry_log_open(path, &config);
+}
+
+static void remove_log(const char* path) {
+    char command[TELEMETRY_LOG_PATH_SIZE + 16];
+    snprintf(command, sizeof(command), "rm -rf '%s'", path);
+    if (system(command) != 0) fprintf(stderr, "could not remove %s\n", path);
+}
+
+static void test_future_drone(void) {
+    char path[] = "/tmp/test_telemetry_log.XXXXXX";
+    telemetry_log_t* log = open_log(path, 0);
+    CHECK(log != NULL);
+    if (!log) return;
+    
+    // 3000 records 1 ms apart; at record 1000 one drone is an hour ahead
+    telemetry_record_t record;
+    memset(&record, 0, sizeof(record));
+    for (int i = 0; i < 3000; i++) {
+        uint64_t received = TEST_EPOCH_NS + (uint64_t)i * MS;
+        record.timestamp_ns = i == 1000 ? received + 3600000000000ULL : received;
+        CHECK(telemetry_log_append(log, i == 1000 ? "drone-ahead" : "drone-0", &record,
+                                   received, NULL) == 0);
+    }
+    
+    long visited = 0;
+    long returned = telemetry_log_query_range(log, TEST_EPOCH_NS + 2000 * MS,
+                                              TEST_EPOCH_NS + 2100 * MS, count_visit, &visited);
+    CHECK(returned == 101);
+    CHECK(visited == 101);
+    
+    const telemetry_record_t* ahead = telemetry_log_record(log, 1000);
+    CHECK(ahead && ahead->timestamp_ns == TEST_EPOCH_NS + 1000 * MS);
+    CHECK(ahead && (ahead->flags & TELEMETRY_RECORD_CLAMPED));
+    telemetry_log_stats_t stats;
+    telemetry_log_get_stats(log, &stats);
+    CHECK(stats.clamped == 1);
+    
+    telemetry_log_close(log);
+    remove_log(path);
+}
+
+// Range and per-drone queries against a scan of every record
+static void test_against_scan(void) {
+    char path[] = "/tmp/test_telemetry_log.XXXXXX";
+    const uint64_t skew = 50 * MS;
+    telemetry_log_t* log = open_log(path, skew);
+    CHECK(log != NULL);
+    if (!log) return;
+    
+    enum { RECORDS = 6000, DRONES = 12 };
+    char ids[DRONES][MAX_DRONE_ID];
+    for (int d = 0; d < DRONES; d++) snprintf(ids[d], MAX_DRONE_ID, "drone-%02d", d);
+    
+    // Clocks within the skew, plus the odd timestamp from nowhere
+    uint32_t state = 777;
+    telemetry_record_t record;
+    memset(&record, 0, sizeof(record));
+    for (int i = 0; i < RECORDS; i++) {
+        state = state * 1103515245u + 12345u;
+        uint32_t r = state >> 8;
+        uint64_t received = TEST_EPOCH_NS + (uint64_t)i * MS;
+        uint64_t jitter = (uint64_t)(r % 90) * MS;
+        switch (r % 97) {
+            case 0:  record.timestamp_ns = received + 3600000000000ULL; break;
+            case 1:  record.timestamp_ns = 0; break;
+            case 2:  record.timestamp_ns = UINT64_MAX; break;
+            case 3:  record.timestamp_ns = received - 600000000000ULL; break;
+            default: record.timestamp_ns = received + jitter - 45 * MS; break;
+        }
+        CHECK(telemetry_log_append(log, ids[r % DRONES], &record, received, NULL) == 0);
+    }
+    
+    const telemetry_record_t** found = calloc(RECORDS, sizeof(*found));
+    CHECK(found != NULL);
+    for (int q = 0; found && q < 200; q++) {
+        state = state * 1103515245u + 12345u;
+        uint64_t from = TEST_EPOCH_NS - 100 * MS + (uint64_t)(state >> 8) % (RECORDS + 200) * MS;
+        uint64_t to = from + (uint64_t)(state % 500) * MS;
+        
+        long scanned = 0;
+        long per_drone[DRONES] = { 0 };
+        for (uint64_t i = 0; i < RECORDS; i++) {
+            const telemetry_record_t* stored = telemetry_log_record(log, i);
+            if (stored->timestamp_ns >= from && stored->timestamp_ns <= to) {
+                scanned++;
+                per_drone[stored->drone]++;
+            }
+        }
+        
+        long visited = 0;
+        CHECK(telemetry_log_query_range(log, from, to, count_visit, &visited) == scanned);
+        CHECK(visited == scanned);
+        for (int d = 0; d < DRONES; d++) {
+            uint32_t slot = 0;
+            while (slot < DRONES && strcmp(telemetry_log_drone_id(log, slot), ids[d]) != 0) slot++;
+            CHECK(telemetry_log_query_drone(log, ids[d], from, to, found, RECORDS) == per_drone[slot]);
+        }
+    }
+    
+    free(found);
+    telemetry_log_close(log);
+    remove_log(path);
+}
+
+// A JSON report dated far beyond 2554 is logged at its receive time
+static void test_gateway_seconds(void) {
+    char path[] = "/tmp/test_telemetry_log.XXXXXX";
+    telemetry_log_t* log = open_log(path, 0);
+    fleet_gateway_t* gateway = fleet_gateway_init(16, NULL);
+    CHECK(log != NULL && gateway != NULL);
+    if (!log || !gateway) {
+        fleet_gateway_cleanup(gateway);
+        telemetry_log_close(log);
+        return;
+    }
+    fleet_gateway_set_log(gateway, log);
+    
+    status_update_format_t status;
+    memset(&status, 0, sizeof(status));
+    strcpy(status.drone_id, "drone-json");
+    strcpy(status.state, "idle");
+    status.battery_level = 50;
+    status.timestamp = INT64_MAX / 4;
+    char json[FLEET_GATEWAY_DRONE_JSON_SIZE];
+    int length = status_update_format_encode_json(&status, json, sizeof(json));
+    CHECK(length > 0);
+    
+    uint64_t before = message_timestamp_ns();
+    CHECK(fleet_gateway_handle_datagram(gateway, json, (size_t)length,
+                                        network_monotonic_ns()) == NET_SUCCESS);
+    uint64_t after = message_timestamp_ns();
+    
+    const telemetry_record_t* logged = telemetry_log_record(log, 0);
+    CHECK(logged && (logged->flags & TELEMETRY_RECORD_CLAMPED));
+    CHECK(logged && logged->timestamp_ns >= before && logged->timestamp_ns <= after);
+    
+    fleet_gateway_cleanup(gateway);
+    telemetry_log_close(log);
+    remove_log(path);
+}
+
+static int count_segment_files(const char* path) {
+    DIR* dir = opendir(path);
+    if (!dir) return -1;
+    
+    int count = 0;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "segment-", 8) == 0) count++;
+    }
+    closedir(dir);
+    return count;
+}
+
+// Six segments' worth of records into a log that keeps three
+static void test_retention(void) {
+    char path[] = "/tmp/test_telemetry_log.XXXXXX";
+    CHECK(mkdtemp(path) != NULL);
+    telemetry_log_config_t config;
+    telemetry_log_default_config(&config);
+    config.segment_records = 512;
+    config.index_interval = 16;
+    config.max_drones = 64;
+    config.max_segments = 3;
+    telemetry_log_t* log = telemetry_log_open(path, &config);
+    telemetry_reader_t* reader = telemetry_reader_open(path, 0);
+    CHECK(log != NULL && reader != NULL);
+    if (!log || !reader) {
+        telemetry_reader_close(reader);
+        telemetry_log_close(log);
+        remove_log(path);
+        return;
+    }
+    
+    // The reader falls behind by more than the log keeps
+    uint64_t number = TELEMETRY_LOG_NONE;
+    CHECK(telemetry_reader_next(reader, &number) == NULL);
+    
+    enum { RECORDS = 5 * 512 + 100, OLDEST = 3 * 512 };
+    telemetry_record_t record;
+    memset(&record, 0, sizeof(record));
+    for (int i = 0; i < RECORDS; i++) {
+        uint64_t received = TEST_EPOCH_NS + (uint64_t)i * MS;
+        record.timestamp_ns = received;
+        CHECK(telemetry_log_append(log, i % 2 ? "drone-odd" : "drone-even", &record,
+                                   received, NULL) == 0);
+    }
+    
+    telemetry_log_stats_t stats;
+    telemetry_log_get_stats(log, &stats);
+    CHECK(stats.appended == RECORDS);
+    CHECK(stats.rejected == 0);
+    CHECK(stats.segments_created == 6);
+    CHECK(stats.segments_retired == 3);
+    CHECK(count_segment_files(path) == 3);
+    CHECK(telemetry_log_size(log) == RECORDS);
+    CHECK(telemetry_log_record(log, 0) == NULL);
+    CHECK(telemetry_log_record(log, OLDEST - 1) == NULL);
+    CHECK(telemetry_log_record(log, OLDEST) != NULL);
+    CHECK(telemetry_log_record(log, RECORDS - 1) != NULL);
+    
+    // Queries see only what is retained
+    long visited = 0;
+    CHECK(telemetry_log_query_range(log, 0, UINT64_MAX, count_visit, &visited) == RECORDS - OLDEST);
+    const telemetry_record_t* found[RECORDS];
+    CHECK(telemetry_log_query_drone(log, "drone-odd", 0, UINT64_MAX, found, RECORDS) ==
+          (RECORDS - OLDEST) / 2);
+    
+    // It finishes the segment it has mapped, then skips what was retired
+    long read = 0;
+    uint64_t after_first = TELEMETRY_LOG_NONE;
+    while (telemetry_reader_next(reader, &number) != NULL) {
+        if (read++ == 512) after_first = number;
+    }
+    CHECK(read == 512 + RECORDS - OLDEST);
+    CHECK(after_first == OLDEST);
+    CHECK(number == RECORDS - 1);
+    CHECK(reader->skipped == OLDEST - 512);
+    telemetry_reader_close(reader);
+    
+    // Reopened with a smaller limit, the log sheds segments before appending
+    telemetry_log_close(log);
+    config.max_segments = 2;
+    log = telemetry_log_open(path, &config);
+    CHECK(log != NULL);
+    if (log) {
+        CHECK(count_segment_files(path) == 2);
+        CHECK(telemetry_log_size(log) == RECORDS);
+        CHECK(telemetry_log_record(log, OLDEST) == NULL);
+        CHECK(telemetry_log_record(log, OLDEST + 512) != NULL);
+        for (int i = RECORDS; i < 7 * 512; i++) {
+            uint64_t received = TEST_EPOCH_NS + (uint64_t)i * MS;
+            record.timestamp_ns = received;
+            CHECK(telemetry_log_append(log, "drone-even", &record, received, NULL) == 0);
+        }
+        CHECK(count_segment_files(path) == 2);
+        CHECK(telemetry_log_record(log, 7 * 512 - 1) != NULL);
+        telemetry_log_close(log);
+    }
+    
+    config.max_segments = 1;
+    CHECK(telemetry_log_open(path, &config) == NULL);
+    remove_log(path);
+}
+
+int main(void) {
+    test_future_drone();
+    test_against_scan();
+    test_gateway_seconds();
+    test_retention();
+    
+    return TEST_RESULT("telemetry_log");
+}
@@ -0,0 +1,660 @@
+#!/usr/bin/env ruby
+# scripts/generate_message_formats.rb
+#
+# Generates the C side of the command-center protocol from
+# shared/message_formats.json: one struct per message with fixed field
+# sizes, plus straight-line JSON and binary encoders and decoders.
+#
+#   ruby scripts/generate_message_formats.rb shared/message_formats.json \
+#        drone_networking/src/protocols drone_networking/tests
+#
+# The optional third directory receives tests/test_message_formats.c, a
+# JSON and binary round trip of every format.
+#
+# Schema mapping:
+#   {"const": "x"}                    discriminator, checked on decode, not stored
+#   {"type": "string", "maxLength"}   char[maxLength + 1] (default 31)
+#   {"type": "number"}                double
+#   {"type": "integer"}               int64_t
+#   {"type": "object", "properties"}  nested struct
+#   {"type": "object"} (free-form)    raw JSON text, char[RAW_OBJECT_SIZE]
+#
+# Binary form: the message's tag byte, then the fields in schema order,
+# little-endian; strings and raw objects are length-prefixed.
+#
+# A message may name the hand-laid-out protocol struct that also carries
+# it on the drone link:
+#
+#   "x-c-wire": {"struct": "status_update_message_t", "header": "message_protocol.h",
+#                "members": {"position.x": "x", "state": {"member": "state", "as": "enum"}}}
+#
+# Every schema field must map to a member (generation fails otherwise),
+# and the generated source asserts at compile time that each member
+# exists with a compatible size, so neither side can change alone.
+require 'json'
+
+DEFAULT_STRING_LENGTH = 31
+RAW_OBJECT_SIZE = 256
+
+Field = Struct.new(:name, :kind, :size, :const, :children, :c_type, keyword_init: true)
+
+def upcase_name(name)
+  name.gsub(/[^A-Za-z0-9]/, '_').upcase
+end
+
+def parse_fields(properties, type_prefix, structs, path = [])
+  properties.map do |name, spec|
+    if spec.key?('const')
+      Field.new(name: name, kind: :const, const: spec['const'])
+    else
+      case spec['type']
+      when 'string'
+        Field.new(name: name, kind: :string, size: (spec['maxLength'] || DEFAULT_STRING_LENGTH) + 1)
+      when 'number'
+        Field.new(name: name, kind: :double)
+      when 'integer'
+        Field.new(name: name, kind: :int64)
+      when 'object'
+        if spec['properties']
+          c_type = "#{type_prefix}_#{name}_t"
+          children = parse_fields(spec['properties'], "#{type_prefix}_#{name}", structs, path + [name])
+          structs << [c_type, path + [name], children]
+          Field.new(name: name, kind: :object, children: children, c_type: c_type)
+        else
+          Field.new(name: name, kind: :raw, size: RAW_OBJECT_SIZE)
+        end
+      else
+        abort "#{name}: unsupported schema type #{spec['type'].inspect}"
+      end
+    end
+  end
+end
+
+def load_schema(path)
+  # Schema files start with a path comment like every other file in the tree
+  text = File.readlines(path).reject { |line| line.lstrip.start_with?('//') }.join
+  JSON.parse(text)
+end
+
+def size_macro(message, path, field)
+  "#{upcase_name(message)}_#{path.map { |p| upcase_name(p) }.join('_')}#{path.empty? ? '' : '_'}#{upcase_name(field.name)}_SIZE"
+end
+
+def binary_size(fields)
+  fields.sum do |field|
+    case field.kind
+    when :const then 0
+    when :string then 1 + field.size - 1
+    when :raw then 2 + field.size - 1
+    when :double, :int64 then 8
+    when :object then binary_size(field.children)
+    end
+  end
+end
+
+def struct_members(message, path, fields)
+  fields.reject { |f| f.kind == :const }.map do |field|
+    case field.kind
+    when :string, :raw then "    char #{field.name}[#{size_macro(message, path, field)}];"
+    when :double then "    double #{field.name};"
+    when :int64 then "    int64_t #{field.name};"
+    when :object then "    #{field.c_type} #{field.name};"
+    end
+  end
+end
+
+def size_defines(message, path, fields)
+  fields.flat_map do |field|
+    case field.kind
+    when :string, :raw then ["#define #{size_macro(message, path, field)} #{field.size}"]
+    when :object then size_defines(message, path + [field.name], field.children)
+    else []
+    end
+  end
+end
+
+def c_string(text)
+  '"' + text.gsub('\\', '\\\\\\\\').gsub('"', '\\"') + '"'
+end
+
+# JSON encoder segments: literal text and field writes, in output order
+def json_segments(fields, access)
+  segments = [[:literal, '{']]
+  fields.each_with_index do |field, index|
+    segments << [:literal, "#{index.zero? ? '' : ','}\"#{field.name}\":"]
+    case field.kind
+    when :const then segments << [:literal, JSON.generate(field.const)]
+    when :object then segments.concat(json_segments(field.children, "#{access}#{field.name}."))
+    else segments << [:write, field, "#{access}#{field.name}"]
+    end
+  end
+  segments << [:literal, '}']
+end
+
+# Adjacent literals are merged so each field costs one key write
+def json_encode_lines(fields, access)
+  merged = []
+  json_segments(fields, access).each do |segment|
+    if segment[0] == :literal && merged.last && merged.last[0] == :literal
+      merged.last[1] += segment[1]
+    else
+      merged << segment.dup
+    end
+  end
+  merged.flat_map do |kind, field, value|
+    next ["    json_write_raw(&writer, #{c_string(field)}, #{field.bytesize});"] if kind == :literal
+
+    case field.kind
+    when :string then ["    json_write_string(&writer, #{value}, sizeof(#{value}));"]
+    when :raw
+      ["    if (#{value}[0]) {",
+       "        json_write_raw(&writer, #{value}, strnlen(#{value}, sizeof(#{value})));",
+       '    } else {',
+       '        json_write_raw(&writer, "{}", 2);',
+       '    }']
+    when :double then ["    json_write_double(&writer, #{value});"]
+    when :int64 then ["    json_write_int64(&writer, #{value});"]
+    end
+  end
+end
+
+def json_decode_member(message, field, access, indent)
+  value = "#{access}#{field.name}"
+  pad = ' ' * indent
+  case field.kind
+  when :const
+    ["#{pad}if (json_match_string(reader, #{c_string(field.const)}, #{field.const.bytesize}) != 1) return -1;",
+     "#{pad}seen_discriminator = 1;"]
+  when :string then ["#{pad}if (json_read_string(reader, #{value}, sizeof(#{value})) != 0) return -1;"]
+  when :raw then ["#{pad}if (json_read_raw(reader, #{value}, sizeof(#{value})) != 0) return -1;"]
+  when :double then ["#{pad}if (json_read_double(reader, &#{value}) != 0) return -1;"]
+  when :int64 then ["#{pad}if (json_read_int64(reader, &#{value}) != 0) return -1;"]
+  when :object then ["#{pad}if (decode_#{field.c_type.sub(/_t\z/, '')}_json(reader, &#{value}) != 0) return -1;"]
+  end
+end
+
+def json_decode_body(message, fields, access, has_discriminator)
+  lines = []
+  lines << '    const char* key;'
+  lines << '    size_t key_length;'
+  lines << '    int member;'
+  lines << '    int seen_discriminator = 0;' if has_discriminator
+  lines << '    if (json_object_begin(reader) != 0) return -1;'
+  lines << '    while ((member = json_object_next(reader, &key, &key_length)) > 0) {'
+  fields.each_with_index do |field, index|
+    keyword = index.zero? ? 'if' : '} else if'
+    lines << "        #{keyword} (key_length == #{field.name.bytesize} && memcmp(key, #{c_string(field.name)}, #{field.name.bytesize}) == 0) {"
+    lines.concat(json_decode_member(message, field, access, 12))
+  end
+  lines << '        } else if (json_skip_value(reader) != 0) {'
+  lines << '            return -1;'
+  lines << '        }'
+  lines << '    }'
+  lines << (has_discriminator ? '    return member == 0 && seen_discriminator ? 0 : -1;' : '    return member == 0 ? 0 : -1;')
+  lines
+end
+
+def binary_encode_lines(fields, access)
+  fields.flat_map do |field|
+    value = "#{access}#{field.name}"
+    case field.kind
+    when :const then []
+    when :string then ["    out = put_string(out, #{value}, sizeof(#{value}));"]
+    when :raw then ["    out = put_raw(out, #{value}, sizeof(#{value}));"]
+    when :double then ["    out = put_double(out, #{value});"]
+    when :int64 then ["    out = put_u64(out, (uint64_t)#{value});"]
+    when :object then binary_encode_lines(field.children, "#{value}.")
+    end
+  end
+end
+
+def binary_decode_lines(fields, access)
+  fields.flat_map do |field|
+    value = "#{access}#{field.name}"
+    case field.kind
+    when :const then []
+    when :string then ["    if (get_string(&in, end, #{value}, sizeof(#{value})) != 0) return -1;"]
+    when :raw then ["    if (get_raw(&in, end, #{value}, sizeof(#{value})) != 0) return -1;"]
+    when :double then ["    if (get_double(&in, end, &#{value}) != 0) return -1;"]
+    when :int64 then ["    if (get_u64(&in, end, (uint64_t*)&#{value}) != 0) return -1;"]
+    when :object then binary_decode_lines(field.children, "#{value}.")
+    end
+  end
+end
+
+# Leaf fields as [path, field], path being the names from the message down
+def leaf_fields(fields, path = [])
+  fields.flat_map do |field|
+    case field.kind
+    when :const then []
+    when :object then leaf_fields(field.children, path + [field.name])
+    else [[path + [field.name], field]]
+    end
+  end
+end
+
+# Compile-time checks that the x-c-wire struct carries every schema field
+def wire_asserts(message)
+  wire = message[:wire]
+  struct = wire['struct']
+  members = wire['members'] || {}
+  leaves = leaf_fields(message[:fields])
+  names = leaves.map { |path, _field| path.join('.') }
+  missing = names - members.keys
+  unknown = members.keys - names
+  abort "#{message[:name]}: #{struct} has no member for #{missing.join(', ')}" unless missing.empty?
+  abort "#{message[:name]}: x-c-wire maps unknown fields #{unknown.join(', ')}" unless unknown.empty?
+
+  leaves.flat_map do |path, field|
+    mapping = members[path.join('.')]
+    member, as = mapping.is_a?(Hash) ? [mapping['member'], mapping['as']] : [mapping, nil]
+    wire_member = "((#{struct}*)0)->#{member}"
+    condition, problem =
+      if as == 'enum'
+        ["sizeof(#{wire_member}) == sizeof(int)", 'is not an enum']
+      elsif field.kind == :string || field.kind == :raw
+        ["sizeof(#{wire_member}[0]) == 1 &&\n               " \
+         "sizeof(#{wire_member}) <= #{size_macro(message[:name], path[0...-1], field)}",
+         'is not text that fits']
+      else
+        ["sizeof(#{wire_member}) == 8", 'is not 8 bytes']
+      end
+    ["_Static_assert(#{condition},",
+     "               \"#{message[:name]}.#{path.join('.')}: #{struct}.#{member} #{problem}\");"]
+  end
+end
+
+BINARY_HELPERS = <<~C
+  static unsigned char* put_u64(unsigned char* out, uint64_t value) {
+      for (int i = 0; i < 8; i++) {
+          out[i] = (unsigned char)(value >> (8 * i));
+      }
+      return out + 8;
+  }
+
+  static unsigned char* put_double(unsigned char* out, double value) {
+      uint64_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      return put_u64(out, bits);
+  }
+
+  static unsigned char* put_string(unsigned char* out, const char* value, size_t size) {
+      size_t length = strnlen(value, size - 1);
+      *out++ = (unsigned char)length;
+      memcpy(out, value, length);
+      return out + length;
+  }
+
+  static unsigned char* put_raw(unsigned char* out, const char* value, size_t size) {
+      size_t length = strnlen(value, size - 1);
+      out[0] = (unsigned char)length;
+      out[1] = (unsigned char)(length >> 8);
+      memcpy(out + 2, value, length);
+      return out + 2 + length;
+  }
+
+  static int get_u64(const unsigned char** in, const unsigned char* end, uint64_t* value) {
+      if (end - *in < 8) return -1;
+      uint64_t result = 0;
+      for (int i = 7; i >= 0; i--) {
+          result = (result << 8) | (*in)[i];
+      }
+      *value = result;
+      *in += 8;
+      return 0;
+  }
+
+  static int get_double(const unsigned char** in, const unsigned char* end, double* value) {
+      uint64_t bits;
+      if (get_u64(in, end, &bits) != 0) return -1;
+      memcpy(value, &bits, sizeof(bits));
+      return 0;
+  }
+
+  static int get_string(const unsigned char** in, const unsigned char* end, char* value, size_t size) {
+      if (*in >= end) return -1;
+      size_t length = *(*in)++;
+      if (length >= size || (size_t)(end - *in) < length) return -1;
+      memcpy(value, *in, length);
+      value[length] = '\\0';
+      *in += length;
+      return 0;
+  }
+
+  static int get_raw(const unsigned char** in, const unsigned char* end, char* value, size_t size) {
+      if (end - *in < 2) return -1;
+      size_t length = (size_t)(*in)[0] | ((size_t)(*in)[1] << 8);
+      *in += 2;
+      if (length >= size || (size_t)(end - *in) < length) return -1;
+      memcpy(value, *in, length);
+      value[length] = '\\0';
+      *in += length;
+      return 0;
+  }
+C
+
+def generate(schema, schema_path)
+  messages = schema.map.with_index(1) do |(name, spec), tag|
+    structs = []
+    fields = parse_fields(spec['properties'] || {}, name, structs)
+    discriminator = fields.find { |f| f.kind == :const }
+    { name: name, tag: tag, fields: fields, structs: structs, discriminator: discriminator,
+      type: "#{name}_format_t", upper: upcase_name(name), wire: spec['x-c-wire'] }
+  end
+
+  source_note = "Generated by scripts/generate_message_formats.rb from #{schema_path}.\n" \
+                "// Do not edit: change the schema and run `make generate`."
+
+  header = []
+  header << '// src/protocols/message_formats.h'
+  header << "// #{source_note}"
+  header << '#ifndef MESSAGE_FORMATS_H'
+  header << '#define MESSAGE_FORMATS_H'
+  header << ''
+  header << '#include <stddef.h>'
+  header << '#include <stdint.h>'
+  header << ''
+  header << '// Command-center message formats. Each has a struct with fixed field'
+  header << '// sizes and four codecs: JSON as the Ruby side speaks it, and a compact'
+  header << "// little-endian binary form led by the format's tag byte."
+  header << ''
+  header << 'typedef enum {'
+  header << '    MESSAGE_FORMAT_UNKNOWN = 0,'
+  header << messages.map { |m| "    MESSAGE_FORMAT_#{m[:upper]} = #{m[:tag]}" }.join(",\n")
+  header << '} message_format_t;'
+  messages.each do |m|
+    header << ''
+    header << "// #{m[:name]}"
+    header.concat(size_defines(m[:name], [], m[:fields]))
+    header << "#define #{m[:upper]}_BINARY_MAX_SIZE #{1 + binary_size(m[:fields])}"
+    m[:structs].each do |c_type, path, children|
+      header << ''
+      header << 'typedef struct {'
+      header.concat(struct_members(m[:name], path, children))
+      header << "} #{c_type};"
+    end
+    header << ''
+    header << 'typedef struct {'
+    header.concat(struct_members(m[:name], [], m[:fields]))
+    header << "} #{m[:type]};"
+    header << ''
+    header << '// Encode as JSON; returns bytes written (no terminator) or -1 if out is too small'
+    header << "int #{m[:name]}_format_encode_json(const #{m[:type]}* message, char* out, size_t capacity);"
+    header << ''
+    header << "// Decode JSON; 0 on success, -1 if malformed or not a #{m[:name]}"
+    header << "int #{m[:name]}_format_decode_json(#{m[:type]}* message, const char* json, size_t length);"
+    header << ''
+    header << "// Encode in binary; capacity must be at least #{m[:upper]}_BINARY_MAX_SIZE"
+    header << "int #{m[:name]}_format_encode_binary(const #{m[:type]}* message, unsigned char* out, size_t capacity);"
+    header << ''
+    header << '// Decode binary; 0 on success, -1 if truncated or of another format'
+    header << "int #{m[:name]}_format_decode_binary(#{m[:type]}* message, const unsigned char* data, size_t length);"
+  end
+  header << ''
+  header << '// Which format a JSON document holds, from its discriminator member'
+  header << 'message_format_t message_format_detect_json(const char* json, size_t length);'
+  header << ''
+  header << '// Which format a binary frame holds, from its tag byte'
+  header << 'message_format_t message_format_detect_binary(const unsigned char* data, size_t length);'
+  header << ''
+  header << '#endif'
+
+  source = []
+  source << '// src/protocols/message_formats.c'
+  source << "// #{source_note}"
+  source << '#include "message_formats.h"'
+  source << '#include "json_codec.h"'
+  wired = messages.select { |m| m[:wire] }
+  wired.map { |m| m[:wire]['header'] }.compact.uniq.each { |h| source << "#include \"#{h}\"" }
+  source << '#include <string.h>'
+  source << ''
+  unless wired.empty?
+    source << '// Protocol structs that carry these formats on the drone link (x-c-wire)'
+    source << '// must keep a member of a compatible size for every schema field.'
+    wired.each { |m| source.concat(wire_asserts(m)) }
+    source << ''
+  end
+  source << BINARY_HELPERS.chomp
+  messages.each do |m|
+    # Nested object decoders, innermost first
+    m[:structs].each do |c_type, _path, children|
+      source << ''
+      source << "static int decode_#{c_type.sub(/_t\z/, '')}_json(json_reader_t* reader, #{c_type}* value) {"
+      source.concat(json_decode_body(m[:name], children, 'value->', false))
+      source << '}'
+    end
+
+    source << ''
+    source << "static int decode_#{m[:name]}_members(json_reader_t* reader, #{m[:type]}* message) {"
+    source.concat(json_decode_body(m[:name], m[:fields], 'message->', !m[:discriminator].nil?))
+    source << '}'
+
+    source << ''
+    source << "int #{m[:name]}_format_encode_json(const #{m[:type]}* message, char* out, size_t capacity) {"
+    source << '    if (!message || !out) return -1;'
+    source << '    '
+    source << '    json_writer_t writer;'
+    source << '    json_writer_init(&writer, out, capacity);'
+    source.concat(json_encode_lines(m[:fields], 'message->'))
+    source << '    return json_writer_finish(&writer);'
+    source << '}'
+
+    source << ''
+    source << "int #{m[:name]}_format_decode_json(#{m[:type]}* message, const char* json, size_t length) {"
+    source << '    if (!message || !json) return -1;'
+    source << '    '
+    source << '    json_reader_t reader;'
+    source << '    json_reader_init(&reader, json, length);'
+    source << '    memset(message, 0, sizeof(*message));'
+    source << "    if (decode_#{m[:name]}_members(&reader, message) != 0) return -1;"
+    source << '    return json_reader_finish(&reader);'
+    source << '}'
+
+    source << ''
+    source << "int #{m[:name]}_format_encode_binary(const #{m[:type]}* message, unsigned char* out, size_t capacity) {"
+    source << "    if (!message || !out || capacity < #{m[:upper]}_BINARY_MAX_SIZE) return -1;"
+    source << '    '
+    source << '    unsigned char* start = out;'
+    source << "    *out++ = MESSAGE_FORMAT_#{m[:upper]};"
+    source.concat(binary_encode_lines(m[:fields], 'message->'))
+    source << '    return (int)(out - start);'
+    source << '}'
+
+    source << ''
+    source << "int #{m[:name]}_format_decode_binary(#{m[:type]}* message, const unsigned char* data, size_t length) {"
+    source << "    if (!message || !data || length == 0 || data[0] != MESSAGE_FORMAT_#{m[:upper]}) return -1;"
+    source << '    '
+    source << '    const unsigned char* in = data + 1;'
+    source << '    const unsigned char* end = data + length;'
+    source << '    memset(message, 0, sizeof(*message));'
+    source.concat(binary_decode_lines(m[:fields], 'message->'))
+    source << '    return in == end ? 0 : -1;'
+    source << '}'
+  end
+
+  discriminated = messages.select { |m| m[:discriminator] }
+  keys = discriminated.map { |m| m[:discriminator].name }.uniq
+  source << ''
+  source << 'message_format_t message_format_detect_json(const char* json, size_t length) {'
+  source << '    if (!json) return MESSAGE_FORMAT_UNKNOWN;'
+  source << '    '
+  source << '    json_reader_t reader;'
+  source << '    json_reader_init(&reader, json, length);'
+  source << '    if (json_object_begin(&reader) != 0) return MESSAGE_FORMAT_UNKNOWN;'
+  source << '    '
+  source << '    const char* key;'
+  source << '    size_t key_length;'
+  source << '    while (json_object_next(&reader, &key, &key_length) > 0) {'
+  keys.each do |key|
+    source << "        if (key_length == #{key.bytesize} && memcmp(key, #{c_string(key)}, #{key.bytesize}) == 0) {"
+    source << '            json_reader_t value = reader;'
+    discriminated.select { |m| m[:discriminator].name == key }.each_with_index do |m, index|
+      const = m[:discriminator].const
+      source << '            value = reader;' unless index.zero?
+      source << "            if (json_match_string(&value, #{c_string(const)}, #{const.bytesize}) == 1) return MESSAGE_FORMAT_#{m[:upper]};"
+    end
+    source << '        }'
+  end
+  source << '        if (json_skip_value(&reader) != 0) break;'
+  source << '    }'
+  source << '    return MESSAGE_FORMAT_UNKNOWN;'
+  source << '}'
+  source << ''
+  source << 'message_format_t message_format_detect_binary(const unsigned char* data, size_t length) {'
+  source << '    if (!data || length == 0) return MESSAGE_FORMAT_UNKNOWN;'
+  source << '    '
+  source << '    switch (data[0]) {'
+  messages.each do |m|
+    source << "        case MESSAGE_FORMAT_#{m[:upper]}: return MESSAGE_FORMAT_#{m[:upper]};"
+  end
+  source << '    }'
+  source << '    return MESSAGE_FORMAT_UNKNOWN;'
+  source << '}'
+
+  [header.join("\n") + "\n", source.join("\n") + "\n", generate_test(messages, source_note)]
+end
+
+TEST_HELPERS = <<~C
+  #define TEST_ROUNDS 200
+
+  static uint32_t test_state = 12345;
+
+  static uint32_t next_random(void) {
+      test_state = test_state * 1103515245u + 12345u;
+      return test_state >> 8;
+  }
+
+  // Text JSON has to escape, filling the field on the first round
+  static void fill_string(char* out, size_t size, int round) {
+      static const char alphabet[] = "azAZ09 _-/\\"\\\\\\n\\t\\x01\\x1f\\xc3\\xa9";
+      size_t length = round == 0 ? size - 1 : next_random() % size;
+      for (size_t i = 0; i < length; i++) {
+          out[i] = alphabet[next_random() % (sizeof(alphabet) - 1)];
+      }
+  }
+
+  static void fill_raw(char* out, size_t size) {
+      snprintf(out, size, "{\\"n\\":%u,\\"v\\":[1,2.5,true,null],\\"s\\":\\"q\\\\\\"\\\\u00e9\\"}",
+               next_random());
+  }
+
+  // Extremes first, then arbitrary finite bit patterns
+  static double random_double(int round) {
+      static const double extremes[] = { 1.7976931348623157e308, -4.9406564584124654e-324, -0.0 };
+      if (round < 3) return extremes[round];
+      double value;
+      do {
+          uint64_t bits = ((uint64_t)next_random() << 40) ^ ((uint64_t)next_random() << 16) ^ next_random();
+          memcpy(&value, &bits, sizeof(value));
+      } while (!isfinite(value));
+      return value;
+  }
+
+  static int64_t random_int64(int round) {
+      if (round < 2) return round == 0 ? INT64_MAX : INT64_MIN;
+      return (int64_t)(((uint64_t)next_random() << 40) ^ ((uint64_t)next_random() << 16) ^ next_random());
+  }
+C
+
+def fill_lines(fields, access)
+  fields.flat_map do |field|
+    value = "#{access}#{field.name}"
+    case field.kind
+    when :const then []
+    when :string then ["    fill_string(#{value}, sizeof(#{value}), round);"]
+    when :raw then ["    fill_raw(#{value}, sizeof(#{value}));"]
+    when :double then ["    #{value} = random_double(round);"]
+    when :int64 then ["    #{value} = random_int64(round);"]
+    when :object then fill_lines(field.children, "#{value}.")
+    end
+  end
+end
+
+def generate_test(messages, source_note)
+  test = []
+  test << '// tests/test_message_formats.c'
+  test << "// #{source_note}"
+  test << '//'
+  test << '// Every message format survives a JSON and a binary round trip with its'
+  test << '// fields at their limits and full of escapes, is detected from either'
+  test << '// form, and refuses truncated, mistagged or undersized input.'
+  test << '#include "../include/common.h"'
+  test << '#include "../src/protocols/message_formats.h"'
+  test << '#include <math.h>'
+  test << '#include "test.h"'
+  test << ''
+  test << TEST_HELPERS.chomp
+  messages.each do |m|
+    others = messages.reject { |o| o.equal?(m) }
+    test << ''
+    test << "static void fill_#{m[:name]}(#{m[:type]}* message, int round) {"
+    test << '    memset(message, 0, sizeof(*message));'
+    test.concat(fill_lines(m[:fields], 'message->'))
+    test << '}'
+    test << ''
+    test << "static void test_#{m[:name]}(void) {"
+    test << "    char json[8 * #{m[:upper]}_BINARY_MAX_SIZE + 1024];"
+    test << "    unsigned char binary[#{m[:upper]}_BINARY_MAX_SIZE];"
+    test << '    int mismatched = 0;'
+    test << '    int accepted = 0;'
+    test << '    for (int round = 0; round < TEST_ROUNDS; round++) {'
+    test << "        #{m[:type]} message, decoded;"
+    test << "        fill_#{m[:name]}(&message, round);"
+    test << '        '
+    test << "        int json_length = #{m[:name]}_format_encode_json(&message, json, sizeof(json));"
+    test << "        int binary_length = #{m[:name]}_format_encode_binary(&message, binary, sizeof(binary));"
+    test << '        CHECK(json_length > 0 && binary_length > 0);'
+    test << '        if (json_length <= 0 || binary_length <= 0) continue;'
+    if m[:discriminator]
+      test << "        CHECK(message_format_detect_json(json, (size_t)json_length) == MESSAGE_FORMAT_#{m[:upper]});"
+    end
+    test << "        CHECK(message_format_detect_binary(binary, (size_t)binary_length) == MESSAGE_FORMAT_#{m[:upper]});"
+    test << '        '
+    test << "        CHECK(#{m[:name]}_format_decode_json(&decoded, json, (size_t)json_length) == 0);"
+    test << '        mismatched += memcmp(&decoded, &message, sizeof(message)) != 0;'
+    test << "        CHECK(#{m[:name]}_format_decode_binary(&decoded, binary, (size_t)binary_length) == 0);"
+    test << '        mismatched += memcmp(&decoded, &message, sizeof(message)) != 0;'
+    test << '        '
+    test << "        // Every prefix is refused, and so is every other format's decoder"
+    test << '        for (int cut = 0; cut < json_length; cut++) {'
+    test << "            accepted += #{m[:name]}_format_decode_json(&decoded, json, (size_t)cut) == 0;"
+    test << '        }'
+    test << '        for (int cut = 0; cut < binary_length; cut++) {'
+    test << "            accepted += #{m[:name]}_format_decode_binary(&decoded, binary, (size_t)cut) == 0;"
+    test << '        }'
+    others.each do |o|
+      test << "        #{o[:type]} #{o[:name]};"
+      if m[:discriminator] && o[:discriminator]
+        test << "        accepted += #{o[:name]}_format_decode_json(&#{o[:name]}, json, (size_t)json_length) == 0;"
+      end
+      test << "        accepted += #{o[:name]}_format_decode_binary(&#{o[:name]}, binary, (size_t)binary_length) == 0;"
+    end
+    test << "        CHECK(#{m[:name]}_format_encode_json(&message, json, (size_t)json_length - 1) == -1);"
+    test << '    }'
+    test << '    CHECK(mismatched == 0);'
+    test << '    CHECK(accepted == 0);'
+    test << '    '
+    test << "    #{m[:type]} message;"
+    test << "    fill_#{m[:name]}(&message, 0);"
+    test << "    CHECK(#{m[:name]}_format_encode_binary(&message, binary, sizeof(binary) - 1) == -1);"
+    test << '}'
+  end
+  test << ''
+  test << 'int main(void) {'
+  messages.each { |m| test << "    test_#{m[:name]}();" }
+  test << '    '
+  test << '    return TEST_RESULT("message_formats");'
+  test << '}'
+  test.join("\n") + "\n"
+end
+
+unless [2, 3].include?(ARGV.length)
+  warn "usage: #{$PROGRAM_NAME} SCHEMA OUTPUT_DIR [TEST_DIR]"
+  exit 1
+end
+
+schema_path, output_dir, test_dir = ARGV
+header, source, test = generate(load_schema(schema_path), File.join('shared', File.basename(schema_path)))
+File.write(File.join(output_dir, 'message_formats.h'), header)
+File.write(File.join(output_dir, 'message_formats.c'), source)
+File.write(File.join(test_dir, 'test_message_formats.c'), test) if test_dir